@@ -0,0 +1,120 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ibh {
+    template <typename Fn>
+    struct dispatch_entry {
+        uint64_t type;
+        Fn fn;
+    };
+
+    // Perfect hash table from message type to function pointer, built at compile time.
+    //
+    // Message types are generate_type<T>() wyhash outputs, so the bits are already well distributed and it suffices to find
+    // a window of bits that is unique for every type in the table. A lookup is then a shift, a mask, one compare and a direct call.
+    // When no window is found, construction throws, which is a compile error when the table is constexpr.
+    template <typename Fn, size_t Count>
+    class dispatch_table {
+        static constexpr uint32_t log2_ceil(size_t n) noexcept {
+            uint32_t bits = 0;
+            while((size_t{1} << bits) < n) {
+                bits++;
+            }
+            return bits;
+        }
+
+        static constexpr uint32_t min_bits = log2_ceil(Count);
+        static constexpr uint32_t max_bits = min_bits + 3;
+
+    public:
+        constexpr explicit dispatch_table(array<dispatch_entry<Fn>, Count> const &entries) : _shift(0), _mask(0), _slots() {
+            for(size_t i = 0; i < Count; i++) {
+                for(size_t j = i + 1; j < Count; j++) {
+                    if(entries[i].type == entries[j].type) {
+                        throw logic_error("duplicate type in dispatch_table");
+                    }
+                }
+            }
+
+            for(uint32_t bits = min_bits; bits <= max_bits; bits++) {
+                for(uint32_t shift = 0; shift <= 64 - bits; shift++) {
+                    if(try_build(entries, shift, (uint64_t{1} << bits) - 1)) {
+                        return;
+                    }
+                }
+            }
+
+            throw logic_error("no perfect hash found for dispatch_table");
+        }
+
+        // Returns nullptr for unknown types
+        [[nodiscard]] constexpr Fn find(uint64_t type) const noexcept {
+            auto const &slot = _slots[(type >> _shift) & _mask];
+            return slot.type == type ? slot.fn : nullptr;
+        }
+
+        [[nodiscard]] constexpr size_t table_size() const noexcept {
+            return _mask + 1;
+        }
+
+        [[nodiscard]] static constexpr size_t size() noexcept {
+            return Count;
+        }
+
+    private:
+        constexpr bool try_build(array<dispatch_entry<Fn>, Count> const &entries, uint32_t shift, uint64_t mask) noexcept {
+            for(auto &slot : _slots) {
+                slot = dispatch_entry<Fn>{0, nullptr};
+            }
+
+            for(auto const &entry : entries) {
+                auto &slot = _slots[(entry.type >> shift) & mask];
+                if(slot.fn != nullptr) {
+                    return false;
+                }
+                slot = entry;
+            }
+
+            _shift = shift;
+            _mask = mask;
+            return true;
+        }
+
+        uint32_t _shift;
+        uint64_t _mask;
+        array<dispatch_entry<Fn>, size_t{1} << max_bits> _slots;
+    };
+
+    // make_dispatch_table<handler_fn>({{login_request::type, handle_login}, {register_request::type, handle_register}})
+    template <typename Fn, size_t Count>
+    constexpr auto make_dispatch_table(dispatch_entry<Fn> const (&entries)[Count]) {
+        array<dispatch_entry<Fn>, Count> arr{};
+        for(size_t i = 0; i < Count; i++) {
+            arr[i] = entries[i];
+        }
+        return dispatch_table<Fn, Count>(arr);
+    }
+}
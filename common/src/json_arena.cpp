@@ -0,0 +1,104 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "json_arena.h"
+
+using namespace std;
+using namespace ibh;
+
+namespace ibh {
+    thread_local json_arena inbound_arena;
+
+    // Builds values the way rapidjson::Document's own handler does, except that the stack is a vector that keeps its capacity.
+    // Strings aren't copied when parsing in-situ, objects and arrays are allocated from the arena's pool.
+    class value_builder {
+    public:
+        value_builder(vector<rapidjson::Value> &stack, rapidjson::MemoryPoolAllocator<> &allocator) noexcept : _stack(stack), _allocator(allocator) {}
+
+        bool Null() { _stack.emplace_back(); return true; }
+        bool Bool(bool b) { _stack.emplace_back(b); return true; }
+        bool Int(int i) { _stack.emplace_back(i); return true; }
+        bool Uint(unsigned i) { _stack.emplace_back(i); return true; }
+        bool Int64(int64_t i) { _stack.emplace_back(i); return true; }
+        bool Uint64(uint64_t i) { _stack.emplace_back(i); return true; }
+        bool Double(double d) { _stack.emplace_back(d); return true; }
+        bool RawNumber(char const *str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+
+        bool String(char const *str, rapidjson::SizeType length, bool copy) {
+            if(copy) {
+                _stack.emplace_back(str, length, _allocator);
+            } else {
+                _stack.emplace_back(rapidjson::StringRef(str, length));
+            }
+            return true;
+        }
+
+        bool StartObject() { return true; }
+        bool Key(char const *str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+
+        bool EndObject(rapidjson::SizeType member_count) {
+            rapidjson::Value object(rapidjson::kObjectType);
+            object.MemberReserve(member_count, _allocator);
+            auto first = end(_stack) - static_cast<ptrdiff_t>(member_count) * 2;
+            for(auto it = first; it != end(_stack); it += 2) {
+                object.AddMember(it[0], it[1], _allocator);
+            }
+            _stack.erase(first, end(_stack));
+            _stack.push_back(move(object));
+            return true;
+        }
+
+        bool StartArray() { return true; }
+
+        bool EndArray(rapidjson::SizeType element_count) {
+            rapidjson::Value array(rapidjson::kArrayType);
+            array.Reserve(element_count, _allocator);
+            auto first = end(_stack) - static_cast<ptrdiff_t>(element_count);
+            for(auto it = first; it != end(_stack); ++it) {
+                array.PushBack(*it, _allocator);
+            }
+            _stack.erase(first, end(_stack));
+            _stack.push_back(move(array));
+            return true;
+        }
+
+    private:
+        vector<rapidjson::Value> &_stack;
+        rapidjson::MemoryPoolAllocator<> &_allocator;
+    };
+}
+
+json_arena::json_arena() : _buffer(make_unique<char[]>(buffer_size)), _allocator(_buffer.get(), buffer_size), _document(&_allocator), _reader(), _stack() {
+    _stack.reserve(stack_capacity);
+}
+
+rapidjson::Document& json_arena::parse_insitu(char *buffer) {
+    // the document doesn't own anything, the allocator doesn't free individual values, so dropping everything at once is fine
+    _document.SetNull();
+    _stack.clear();
+    _allocator.Clear();
+
+    rapidjson::InsituStringStream stream(buffer);
+    value_builder builder(_stack, _allocator);
+    if(_reader.Parse<rapidjson::kParseInsituFlag>(stream, builder) && _stack.size() == 1) {
+        rapidjson::Value &root = _document;
+        root = _stack.back();
+    }
+    _stack.clear();
+    return _document;
+}
@@ -0,0 +1,59 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <rapidjson/document.h>
+#include <rapidjson/reader.h>
+
+using namespace std;
+
+namespace ibh {
+    // Reusable per-thread parse state for inbound messages.
+    // Values are allocated from a pool backed by a fixed buffer that is reset on every parse,
+    // strings are parsed in-situ so they point into the (mutable) payload instead of being copied.
+    // The reader and its value stack are reused too, Document::ParseInsitu would free and malloc its stack on every parse.
+    // The returned document is only valid until the next parse on the same thread and as long as the payload lives,
+    // it is null when the payload isn't valid JSON.
+    class json_arena {
+    public:
+        static constexpr size_t buffer_size = 64 * 1024;
+        // values reserved on the parse stack, nested objects and arrays deeper or wider than that grow it once
+        static constexpr size_t stack_capacity = 256;
+
+        json_arena();
+        json_arena(json_arena const &) = delete;
+        json_arena(json_arena &&) = delete;
+        json_arena& operator=(json_arena const &) = delete;
+        json_arena& operator=(json_arena &&) = delete;
+
+        // buffer has to be null-terminated and will be modified
+        rapidjson::Document& parse_insitu(char *buffer);
+
+    private:
+        unique_ptr<char[]> _buffer;
+        rapidjson::MemoryPoolAllocator<> _allocator;
+        rapidjson::Document _document;
+        rapidjson::Reader _reader;
+        vector<rapidjson::Value> _stack;
+    };
+
+    extern thread_local json_arena inbound_arena;
+}
@@ -29,7 +29,7 @@ battle_finished_response::battle_finished_response(bool mob_died, bool player_di
 }
 
 string battle_finished_response::serialize() const {
-    spdlog::trace("[battle_finished_response] type {}", type);
+    SPDLOG_TRACE("[battle_finished_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -32,6 +32,10 @@ namespace ibh {
         battle_finished_response(bool mob_died, bool player_died, uint64_t xp_gained, uint64_t money_gained) noexcept;
 
         ~battle_finished_response() noexcept override = default;
+        battle_finished_response(battle_finished_response&&) noexcept = default;
+        battle_finished_response(const battle_finished_response&) = default;
+        battle_finished_response& operator=(battle_finished_response&&) noexcept = default;
+        battle_finished_response& operator=(const battle_finished_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
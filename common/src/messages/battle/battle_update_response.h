@@ -32,6 +32,10 @@ namespace ibh {
         battle_update_response(uint64_t mob_turns, uint64_t player_turns, uint64_t mob_hits, uint64_t player_hits, uint64_t mob_damage, uint64_t player_damage) noexcept;
 
         ~battle_update_response() noexcept override = default;
+        battle_update_response(battle_update_response&&) noexcept = default;
+        battle_update_response(const battle_update_response&) = default;
+        battle_update_response& operator=(battle_update_response&&) noexcept = default;
+        battle_update_response& operator=(const battle_update_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
@@ -33,6 +33,10 @@ namespace ibh {
         level_up_response(ibh_flat_map<uint64_t, stat_component> added_stats, uint64_t new_xp_goal, uint64_t current_xp) noexcept;
 
         ~level_up_response() noexcept override = default;
+        level_up_response(level_up_response&&) noexcept = default;
+        level_up_response(const level_up_response&) = default;
+        level_up_response& operator=(level_up_response&&) noexcept = default;
+        level_up_response& operator=(const level_up_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
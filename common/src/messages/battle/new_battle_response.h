@@ -31,6 +31,10 @@ namespace ibh {
         new_battle_response(string mob_name, uint64_t mob_level, uint64_t mob_hp, uint64_t mob_max_hp, uint64_t player_hp, uint64_t player_max_hp) noexcept;
 
         ~new_battle_response() noexcept override = default;
+        new_battle_response(new_battle_response&&) noexcept = default;
+        new_battle_response(const new_battle_response&) = default;
+        new_battle_response& operator=(new_battle_response&&) noexcept = default;
+        new_battle_response& operator=(const new_battle_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
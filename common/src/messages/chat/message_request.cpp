@@ -28,7 +28,7 @@ message_request::message_request(string content) noexcept : content(move(content
 }
 
 string message_request::serialize() const {
-    spdlog::trace("[message_request] type {}", type);
+    SPDLOG_TRACE("[message_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -58,3 +58,17 @@ unique_ptr<message_request> message_request::deserialize(rapidjson::Document con
 
     return make_unique<message_request>(d["content"].GetString());
 }
+
+optional<message_request_view> message_request_view::deserialize(rapidjson::Document const &d) {
+    if (!d.HasMember("type") || !d.HasMember("content")) {
+        spdlog::warn("[message_request_view] deserialize failed");
+        return {};
+    }
+
+    if(d["type"].GetUint64() != type) {
+        spdlog::warn("[message_request_view] deserialize failed wrong type");
+        return {};
+    }
+
+    return message_request_view{string_view(d["content"].GetString(), d["content"].GetStringLength())};
+}
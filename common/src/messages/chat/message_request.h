@@ -19,6 +19,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <optional>
 #include <rapidjson/document.h>
 #include "messages/message.h"
 
@@ -40,4 +42,14 @@ namespace ibh {
 
         static constexpr uint64_t type = generate_type<message_request>();
     };
+
+    // Non-owning variant for the server, content points into the parsed document and is only valid as long as it is.
+    struct message_request_view {
+        string_view content;
+
+        [[nodiscard]]
+        static optional<message_request_view> deserialize(rapidjson::Document const &d);
+
+        static constexpr uint64_t type = message_request::type;
+    };
 }
@@ -28,7 +28,7 @@ message_response::message_response(string user, string content, string source, u
 }
 
 string message_response::serialize() const {
-    spdlog::trace("[message_response] type {}", type);
+    SPDLOG_TRACE("[message_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
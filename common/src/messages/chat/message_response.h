@@ -29,6 +29,10 @@ namespace ibh {
         message_response(string user, string content, string source, uint64_t unix_timestamp) noexcept;
 
         ~message_response() noexcept override = default;
+        message_response(message_response&&) noexcept = default;
+        message_response(const message_response&) = default;
+        message_response& operator=(message_response&&) noexcept = default;
+        message_response& operator=(const message_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
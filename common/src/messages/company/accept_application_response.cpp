@@ -28,7 +28,7 @@ accept_application_response::accept_application_response(string error) noexcept
 }
 
 string accept_application_response::serialize() const {
-    spdlog::trace("[accept_application_response] type {}", type);
+    SPDLOG_TRACE("[accept_application_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -29,6 +29,10 @@ namespace ibh {
         explicit accept_application_response(string error) noexcept;
 
         ~accept_application_response() noexcept override = default;
+        accept_application_response(accept_application_response&&) noexcept = default;
+        accept_application_response(const accept_application_response&) = default;
+        accept_application_response& operator=(accept_application_response&&) noexcept = default;
+        accept_application_response& operator=(const accept_application_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
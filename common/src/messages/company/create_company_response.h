@@ -29,6 +29,10 @@ namespace ibh {
         explicit create_company_response(string error) noexcept;
 
         ~create_company_response() noexcept override = default;
+        create_company_response(create_company_response&&) noexcept = default;
+        create_company_response(const create_company_response&) = default;
+        create_company_response& operator=(create_company_response&&) noexcept = default;
+        create_company_response& operator=(const create_company_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
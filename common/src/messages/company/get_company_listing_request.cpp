@@ -23,10 +23,12 @@
 using namespace ibh;
 using namespace rapidjson;
 
-get_company_listing_request::get_company_listing_request() noexcept = default;
+get_company_listing_request::get_company_listing_request(uint32_t page, string name_prefix) noexcept : page(page), name_prefix(move(name_prefix)) {
+
+}
 
 string get_company_listing_request::serialize() const {
-    spdlog::trace("[get_company_listing_request] type {}", type);
+    SPDLOG_TRACE("[get_company_listing_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -36,12 +38,18 @@ string get_company_listing_request::serialize() const {
     writer.String(KEY_STRING("type"));
     writer.Uint64(type);
 
+    writer.String(KEY_STRING("page"));
+    writer.Uint(page);
+
+    writer.String(KEY_STRING("name_prefix"));
+    writer.String(name_prefix.c_str(), name_prefix.size());
+
     writer.EndObject();
     return sb.GetString();
 }
 
 unique_ptr<get_company_listing_request> get_company_listing_request::deserialize(rapidjson::Document const &d) {
-    if (!d.HasMember("type")) {
+    if (!d.HasMember("type") || !d.HasMember("page") || !d.HasMember("name_prefix")) {
         spdlog::warn("[get_company_listing_request] deserialize failed");
         return nullptr;
     }
@@ -51,5 +59,5 @@ unique_ptr<get_company_listing_request> get_company_listing_request::deserialize
         return nullptr;
     }
 
-    return make_unique<get_company_listing_request>();
+    return make_unique<get_company_listing_request>(d["page"].GetUint(), d["name_prefix"].GetString());
 }
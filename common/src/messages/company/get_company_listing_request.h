@@ -26,7 +26,7 @@ using namespace std;
 
 namespace ibh {
     struct get_company_listing_request : message {
-        get_company_listing_request() noexcept;
+        get_company_listing_request(uint32_t page, string name_prefix) noexcept;
 
         ~get_company_listing_request() noexcept override = default;
 
@@ -36,6 +36,10 @@ namespace ibh {
         [[nodiscard]]
         static unique_ptr<get_company_listing_request> deserialize(rapidjson::Document const &d);
 
+        uint32_t page;
+        // only list companies whose name starts with this, case insensitive
+        string name_prefix;
+
         static constexpr uint64_t type = generate_type<get_company_listing_request>();
     };
 }
@@ -25,12 +25,13 @@
 using namespace ibh;
 using namespace rapidjson;
 
-get_company_listing_response::get_company_listing_response(string error, vector<company_object> companies) noexcept : error(move(error)), companies(move(companies)) {
+get_company_listing_response::get_company_listing_response(string error, vector<company_object> companies, uint32_t page, uint32_t page_count, uint64_t version) noexcept
+    : error(move(error)), companies(move(companies)), page(page), page_count(page_count), version(version) {
 
 }
 
 string get_company_listing_response::serialize() const {
-    spdlog::trace("[get_company_listing_response] type {}", type);
+    SPDLOG_TRACE("[get_company_listing_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -54,12 +55,21 @@ string get_company_listing_response::serialize() const {
     }
     writer.EndArray();
 
+    writer.String(KEY_STRING("page"));
+    writer.Uint(page);
+
+    writer.String(KEY_STRING("page_count"));
+    writer.Uint(page_count);
+
+    writer.String(KEY_STRING("version"));
+    writer.Uint64(version);
+
     writer.EndObject();
     return sb.GetString();
 }
 
 unique_ptr<get_company_listing_response> get_company_listing_response::deserialize(rapidjson::Document const &d) {
-    if (!d.HasMember("type") || !d.HasMember("error") || !d.HasMember("companies")) {
+    if (!d.HasMember("type") || !d.HasMember("error") || !d.HasMember("companies") || !d.HasMember("page") || !d.HasMember("page_count") || !d.HasMember("version")) {
         spdlog::warn("[get_company_listing_response] deserialize failed");
         return nullptr;
     }
@@ -84,5 +94,5 @@ unique_ptr<get_company_listing_response> get_company_listing_response::deseriali
         }
     }
 
-    return make_unique<get_company_listing_response>(d["error"].GetString(), move(companies));
+    return make_unique<get_company_listing_response>(d["error"].GetString(), move(companies), d["page"].GetUint(), d["page_count"].GetUint(), d["version"].GetUint64());
 }
@@ -27,7 +27,7 @@ using namespace std;
 
 namespace ibh {
     struct get_company_listing_response : message {
-        explicit get_company_listing_response(string error, vector<company_object> companies) noexcept;
+        explicit get_company_listing_response(string error, vector<company_object> companies, uint32_t page, uint32_t page_count, uint64_t version) noexcept;
 
         ~get_company_listing_response() noexcept override = default;
 
@@ -39,6 +39,10 @@ namespace ibh {
 
         string error;
         vector<company_object> companies;
+        uint32_t page;
+        uint32_t page_count;
+        // increases whenever any company changes
+        uint64_t version;
 
         static constexpr uint64_t type = generate_type<get_company_listing_response>();
     };
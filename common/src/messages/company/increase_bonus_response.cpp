@@ -28,7 +28,7 @@ increase_bonus_response::increase_bonus_response(string error) noexcept : error(
 }
 
 string increase_bonus_response::serialize() const {
-    spdlog::trace("[increase_bonus_response] type {}", type);
+    SPDLOG_TRACE("[increase_bonus_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -29,6 +29,10 @@ namespace ibh {
         explicit increase_bonus_response(string error) noexcept;
 
         ~increase_bonus_response() noexcept override = default;
+        increase_bonus_response(increase_bonus_response&&) noexcept = default;
+        increase_bonus_response(const increase_bonus_response&) = default;
+        increase_bonus_response& operator=(increase_bonus_response&&) noexcept = default;
+        increase_bonus_response& operator=(const increase_bonus_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
@@ -29,6 +29,10 @@ namespace ibh {
         explicit join_company_response(string error) noexcept;
 
         ~join_company_response() noexcept override = default;
+        join_company_response(join_company_response&&) noexcept = default;
+        join_company_response(const join_company_response&) = default;
+        join_company_response& operator=(join_company_response&&) noexcept = default;
+        join_company_response& operator=(const join_company_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
@@ -29,6 +29,10 @@ namespace ibh {
         explicit leave_company_response(string error) noexcept;
 
         ~leave_company_response() noexcept override = default;
+        leave_company_response(leave_company_response&&) noexcept = default;
+        leave_company_response(const leave_company_response&) = default;
+        leave_company_response& operator=(leave_company_response&&) noexcept = default;
+        leave_company_response& operator=(const leave_company_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
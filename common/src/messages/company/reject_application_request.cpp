@@ -28,7 +28,7 @@ reject_application_request::reject_application_request(uint64_t applicant_id) no
 }
 
 string reject_application_request::serialize() const {
-    spdlog::trace("[reject_application_request] type {}", type);
+    SPDLOG_TRACE("[reject_application_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
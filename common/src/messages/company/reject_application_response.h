@@ -29,6 +29,10 @@ namespace ibh {
         explicit reject_application_response(string error) noexcept;
 
         ~reject_application_response() noexcept override = default;
+        reject_application_response(reject_application_response&&) noexcept = default;
+        reject_application_response(const reject_application_response&) = default;
+        reject_application_response& operator=(reject_application_response&&) noexcept = default;
+        reject_application_response& operator=(const reject_application_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
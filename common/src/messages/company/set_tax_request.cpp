@@ -28,7 +28,7 @@ set_tax_request::set_tax_request(uint32_t rate) noexcept : rate(rate) {
 }
 
 string set_tax_request::serialize() const {
-    spdlog::trace("[set_tax_request] type {}", type);
+    SPDLOG_TRACE("[set_tax_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
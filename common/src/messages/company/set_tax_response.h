@@ -29,6 +29,10 @@ namespace ibh {
         explicit set_tax_response(string error) noexcept;
 
         ~set_tax_response() noexcept override = default;
+        set_tax_response(set_tax_response&&) noexcept = default;
+        set_tax_response(const set_tax_response&) = default;
+        set_tax_response& operator=(set_tax_response&&) noexcept = default;
+        set_tax_response& operator=(const set_tax_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
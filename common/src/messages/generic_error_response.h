@@ -29,6 +29,10 @@ namespace ibh {
         generic_error_response(string error, string pretty_error_name, string pretty_error_description, bool clear_login_data) noexcept;
 
         ~generic_error_response() noexcept override = default;
+        generic_error_response(generic_error_response&&) noexcept = default;
+        generic_error_response(const generic_error_response&) = default;
+        generic_error_response& operator=(generic_error_response&&) noexcept = default;
+        generic_error_response& operator=(const generic_error_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
@@ -29,7 +29,7 @@ set_motd_request::set_motd_request(string motd) noexcept
 }
 
 string set_motd_request::serialize() const {
-    spdlog::trace("[set_motd_request] type {}", type);
+    SPDLOG_TRACE("[set_motd_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
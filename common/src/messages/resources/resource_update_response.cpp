@@ -29,7 +29,7 @@ resource_update_response::resource_update_response(vector<resource> resources) n
 }
 
 string resource_update_response::serialize() const {
-    spdlog::trace("[resource_update_response] type {}", type);
+    SPDLOG_TRACE("[resource_update_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -45,6 +45,10 @@ namespace ibh {
         explicit resource_update_response(vector<resource> resources) noexcept;
 
         ~resource_update_response() noexcept override = default;
+        resource_update_response(resource_update_response&&) noexcept = default;
+        resource_update_response(const resource_update_response&) = default;
+        resource_update_response& operator=(resource_update_response&&) noexcept = default;
+        resource_update_response& operator=(const resource_update_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
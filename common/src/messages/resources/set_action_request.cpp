@@ -29,7 +29,7 @@ set_action_request::set_action_request(uint32_t resource_id) noexcept :
 }
 
 string set_action_request::serialize() const {
-    spdlog::trace("[set_action_request] type {}", type);
+    SPDLOG_TRACE("[set_action_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -59,3 +59,17 @@ unique_ptr<set_action_request> set_action_request::deserialize(rapidjson::Docume
 
     return make_unique<set_action_request>(d["resource_id"].GetUint());
 }
+
+optional<set_action_request_view> set_action_request_view::deserialize(rapidjson::Document const &d) {
+    if (!d.HasMember("type") || !d.HasMember("resource_id")) {
+        spdlog::warn("[set_action_request_view] deserialize failed");
+        return {};
+    }
+
+    if(d["type"].GetUint64() != type) {
+        spdlog::warn("[set_action_request_view] deserialize failed wrong type");
+        return {};
+    }
+
+    return set_action_request_view{d["resource_id"].GetUint()};
+}
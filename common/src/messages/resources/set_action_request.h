@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <rapidjson/document.h>
@@ -43,4 +44,14 @@ namespace ibh {
 
         static constexpr uint64_t type = generate_type<set_action_request>();
     };
+
+    // Allocation-free variant for the server.
+    struct set_action_request_view {
+        uint32_t resource_id;
+
+        [[nodiscard]]
+        static optional<set_action_request_view> deserialize(rapidjson::Document const &d);
+
+        static constexpr uint64_t type = set_action_request::type;
+    };
 }
@@ -32,6 +32,10 @@ namespace ibh {
         explicit set_action_response(string error) noexcept;
 
         ~set_action_response() noexcept override = default;
+        set_action_response(set_action_response&&) noexcept = default;
+        set_action_response(const set_action_response&) = default;
+        set_action_response& operator=(set_action_response&&) noexcept = default;
+        set_action_response& operator=(const set_action_response&) = default;
 
         [[nodiscard]]
         string serialize() const override;
@@ -29,7 +29,7 @@ delete_character_request::delete_character_request(uint32_t slot) noexcept
 }
 
 string delete_character_request::serialize() const {
-    spdlog::trace("[delete_character_request] type {}", type);
+    SPDLOG_TRACE("[delete_character_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -28,7 +28,7 @@ login_request::login_request(string username, string password) noexcept : userna
 }
 
 string login_request::serialize() const {
-    spdlog::trace("[login_request] type {}", type);
+    SPDLOG_TRACE("[login_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -61,3 +61,17 @@ unique_ptr<login_request> login_request::deserialize(rapidjson::Document const &
 
     return make_unique<login_request>(d["username"].GetString(), d["password"].GetString());
 }
+
+optional<login_request_view> login_request_view::deserialize(rapidjson::Document const &d) {
+    if (!d.HasMember("type") || !d.HasMember("username") || !d.HasMember("password")) {
+        spdlog::warn("[login_request_view] deserialize failed");
+        return {};
+    }
+
+    if(d["type"].GetUint64() != type) {
+        spdlog::warn("[login_request_view] deserialize failed wrong type");
+        return {};
+    }
+
+    return login_request_view{string_view(d["username"].GetString(), d["username"].GetStringLength()), string_view(d["password"].GetString(), d["password"].GetStringLength())};
+}
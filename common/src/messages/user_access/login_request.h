@@ -19,6 +19,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <optional>
 #include <rapidjson/document.h>
 #include "messages/message.h"
 
@@ -41,4 +43,15 @@ namespace ibh {
 
         static constexpr uint64_t type = generate_type<login_request>();
     };
+
+    // Non-owning variant for the server, username and password point into the parsed document and are only valid as long as it is.
+    struct login_request_view {
+        string_view username;
+        string_view password;
+
+        [[nodiscard]]
+        static optional<login_request_view> deserialize(rapidjson::Document const &d);
+
+        static constexpr uint64_t type = login_request::type;
+    };
 }
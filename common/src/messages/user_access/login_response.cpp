@@ -27,7 +27,7 @@ login_response::login_response(vector<character_object> players, vector<account_
 }
 
 string login_response::serialize() const {
-    spdlog::trace("[login_response] type {}", type);
+    SPDLOG_TRACE("[login_response] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
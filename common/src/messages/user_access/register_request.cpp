@@ -29,7 +29,7 @@ register_request::register_request(string username, string password, string emai
 }
 
 string register_request::serialize() const {
-    spdlog::trace("[register_request] type {}", type);
+    SPDLOG_TRACE("[register_request] type {}", type);
 
     StringBuffer sb;
     Writer<StringBuffer> writer(sb);
@@ -40,7 +40,7 @@ T random_helper::generate_single(T from, T end) {
     dist_type uniform_dist(from, end);
     T ret = uniform_dist(_rng64);
 #ifdef EXTREME_RANDOM_LOGGING
-    spdlog::trace("[{}] ret {}", __FUNCTION__, ret);
+    SPDLOG_TRACE("[{}] ret {}", __FUNCTION__, ret);
 #endif
     return ret;
 }
@@ -53,7 +53,7 @@ T random_helper::generate_single() {
     dist_type uniform_dist(numeric_limits<T>::min(), numeric_limits<T>::max());
     T ret = uniform_dist(_rng64);
 #ifdef EXTREME_RANDOM_LOGGING
-    spdlog::trace("[{}] ret {}", __FUNCTION__, ret);
+    SPDLOG_TRACE("[{}] ret {}", __FUNCTION__, ret);
 #endif
     return ret;
 }
@@ -66,7 +66,7 @@ bool random_helper::one_in_x(uint32_t x) {
     uniform_int_distribution<uint32_t> uniform_dist(0, x);
     bool ret = uniform_dist(_rng64) == 0;
 #ifdef EXTREME_RANDOM_LOGGING
-    spdlog::trace("[{}] ret {}", __FUNCTION__, ret);
+    SPDLOG_TRACE("[{}] ret {}", __FUNCTION__, ret);
 #endif
     return ret;
 }
@@ -0,0 +1,68 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <limits>
+#include "dispatch_table.h"
+#include "constexpr_wyhash.h"
+#include <messages/user_access/login_request.h>
+#include <messages/user_access/login_response.h>
+#include <messages/generic_error_response.h>
+#include <messages/chat/message_request.h>
+
+using namespace std;
+using namespace ibh;
+
+int dispatch_login() {
+    return 1;
+}
+
+int dispatch_error() {
+    return 2;
+}
+
+int dispatch_chat() {
+    return 3;
+}
+
+TEST_CASE("dispatch_table tests") {
+    static constexpr auto table = make_dispatch_table<int(*)()>({
+        {login_request::type, dispatch_login},
+        {generic_error_response::type, dispatch_error},
+        {message_request::type, dispatch_chat},
+    });
+
+    SECTION("lookup is resolved at compile time") {
+        static_assert(table.find(login_request::type) == dispatch_login);
+        static_assert(table.find(login_response::type) == nullptr);
+        static_assert(table.size() == 3);
+        static_assert(table.table_size() >= 4);
+    }
+
+    SECTION("finds every registered type") {
+        REQUIRE(table.find(login_request::type)() == 1);
+        REQUIRE(table.find(generic_error_response::type)() == 2);
+        REQUIRE(table.find(message_request::type)() == 3);
+    }
+
+    SECTION("unknown types return nullptr") {
+        REQUIRE(table.find(login_response::type) == nullptr);
+        REQUIRE(table.find(0) == nullptr);
+        REQUIRE(table.find(numeric_limits<uint64_t>::max()) == nullptr);
+    }
+}
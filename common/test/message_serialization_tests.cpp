@@ -59,6 +59,7 @@
 #include <messages/resources/resource_update_response.h>
 #include <messages/resources/set_action_request.h>
 #include <messages/resources/set_action_response.h>
+#include <json_arena.h>
 
 using namespace std;
 using namespace ibh;
@@ -87,6 +88,35 @@ TEST_CASE("message serialization tests") {
         REQUIRE(msg.password == msg2->password);
     }
 
+    SECTION("arena parses nested values and rejects invalid json") {
+        string json = R"({"a":[1,2,{"b":"c"}],"d":null,"e":true,"f":-1.5,"g":18446744073709551615})";
+        auto &d = inbound_arena.parse_insitu(&json[0]);
+        REQUIRE(d.IsObject());
+        REQUIRE(d.MemberCount() == 5);
+        REQUIRE(d["a"].IsArray());
+        REQUIRE(d["a"].Size() == 3);
+        REQUIRE(d["a"][1u].GetInt() == 2);
+        REQUIRE(d["a"][2u]["b"].GetString() == string("c"));
+        REQUIRE(d["d"].IsNull());
+        REQUIRE(d["e"].GetBool());
+        REQUIRE(d["f"].GetDouble() == -1.5);
+        REQUIRE(d["g"].GetUint64() == 18446744073709551615ull);
+
+        string invalid = R"({"a":[1,2)";
+        auto &d2 = inbound_arena.parse_insitu(&invalid[0]);
+        REQUIRE(d2.IsNull());
+    }
+
+    SECTION("login request view") {
+        login_request msg("user", "pass");
+        auto ser = msg.serialize();
+        auto &d = inbound_arena.parse_insitu(&ser[0]);
+        auto msg2 = login_request_view::deserialize(d);
+        REQUIRE(msg2);
+        REQUIRE(msg.username == msg2->username);
+        REQUIRE(msg.password == msg2->password);
+    }
+
     SECTION("empty login response") {
         vector<character_object> players;
         vector<account_object> users;
@@ -254,6 +284,15 @@ TEST_CASE("message serialization tests") {
         REQUIRE(msg.content == msg2->content);
     }
 
+    SECTION("message request view") {
+        message_request msg("content");
+        auto ser = msg.serialize();
+        auto &d = inbound_arena.parse_insitu(&ser[0]);
+        auto msg2 = message_request_view::deserialize(d);
+        REQUIRE(msg2);
+        REQUIRE(msg.content == msg2->content);
+    }
+
     SECTION("message response") {
         SERDE(message_response, "user", "content", "source", 1234);
         REQUIRE(msg.user == msg2->user);
@@ -354,8 +393,9 @@ TEST_CASE("message serialization tests") {
     }
 
     SECTION("get company listing request") {
-        SERDE_SINGLE(get_company_listing_request);
-        REQUIRE(msg2);
+        SERDE(get_company_listing_request, 2, "prefix");
+        REQUIRE(msg2->page == 2);
+        REQUIRE(msg2->name_prefix == "prefix");
     }
 
     SECTION("get company listing response") {
@@ -375,8 +415,11 @@ TEST_CASE("message serialization tests") {
         members2.emplace_back("m4");
         companies.emplace_back("c1", members1, bonuses1);
         companies.emplace_back("c2", members2, bonuses2);
-        SERDE(get_company_listing_response, "error", companies);
+        SERDE(get_company_listing_response, "error", companies, 1, 3, 4);
         REQUIRE(msg2->error == "error");
+        REQUIRE(msg2->page == 1);
+        REQUIRE(msg2->page_count == 3);
+        REQUIRE(msg2->version == 4);
         REQUIRE(msg2->companies.size() == 2);
         REQUIRE(msg2->companies[0].name == "c1");
         REQUIRE(msg2->companies[0].members.size() == 2);
@@ -463,6 +506,15 @@ TEST_CASE("message serialization tests") {
         REQUIRE(msg2->resource_id == 1);
     }
 
+    SECTION("set action request view") {
+        set_action_request msg(1);
+        auto ser = msg.serialize();
+        auto &d = inbound_arena.parse_insitu(&ser[0]);
+        auto msg2 = set_action_request_view::deserialize(d);
+        REQUIRE(msg2);
+        REQUIRE(msg2->resource_id == 1);
+    }
+
     SECTION("set action response") {
         SERDE(set_action_response, "test");
         REQUIRE(msg2->error == "test");
@@ -48,6 +48,7 @@
 #include <messages/company/set_tax_response.h>
 #include <on_leaving_scope.h>
 #include <macros.h>
+#include <dispatch_table.h>
 
 
 using namespace std;
@@ -170,64 +171,40 @@ void scene_system::init_main_menu() {
     _scenes.push_back(move(alpha_window));
 }
 
-unique_ptr<message> deserialize_message(uint64_t const &type, rapidjson::Document const &d) {
-    switch(type){
+using deserialize_fn = unique_ptr<message>(*)(rapidjson::Document const &);
+
+template <typename T>
+unique_ptr<message> deserialize_as(rapidjson::Document const &d) {
+    return T::deserialize(d);
+}
+
+template <typename... Msgs>
+constexpr auto make_deserialize_table() {
+    return make_dispatch_table<deserialize_fn>({{Msgs::type, deserialize_as<Msgs>}...});
+}
+
+static constexpr auto deserialize_table = make_deserialize_table<
         // UAC
-        case login_response::type:
-            return login_response::deserialize(d);
-        case generic_error_response::type:
-            return generic_error_response::deserialize(d);
-        case generic_ok_response::type:
-            return generic_ok_response::deserialize(d);
-        case character_select_response::type:
-            return character_select_response::deserialize(d);
-        case create_character_response::type:
-            return create_character_response::deserialize(d);
-        case delete_character_response::type:
-            return delete_character_response::deserialize(d);
-        case user_entered_game_response::type:
-            return user_entered_game_response::deserialize(d);
-        case user_left_game_response::type:
-            return user_left_game_response::deserialize(d);
-        case play_character_response::type:
-            return play_character_response::deserialize(d);
+        login_response, generic_error_response, generic_ok_response, character_select_response, create_character_response, delete_character_response,
+        user_entered_game_response, user_left_game_response, play_character_response,
 
         // Chat
-        case message_response::type:
-            return message_response::deserialize(d);
+        message_response,
 
         // Companies
-        case accept_application_response::type:
-            return accept_application_response::deserialize(d);
-        case create_company_response::type:
-            return create_company_response::deserialize(d);
-        case get_company_applications_response::type:
-            return get_company_applications_response::deserialize(d);
-        case get_company_listing_response::type:
-            return get_company_listing_response::deserialize(d);
-        case increase_bonus_response::type:
-            return increase_bonus_response::deserialize(d);
-        case join_company_response::type:
-            return join_company_response::deserialize(d);
-        case leave_company_response::type:
-            return leave_company_response::deserialize(d);
-        case reject_application_response::type:
-            return reject_application_response::deserialize(d);
-        case set_tax_response::type:
-            return set_tax_response::deserialize(d);
+        accept_application_response, create_company_response, get_company_applications_response, get_company_listing_response, increase_bonus_response,
+        join_company_response, leave_company_response, reject_application_response, set_tax_response,
 
         // Gameplay
-        case new_battle_response::type:
-            return new_battle_response::deserialize(d);
-        case level_up_response::type:
-            return level_up_response::deserialize(d);
-        case battle_update_response::type:
-            return battle_update_response::deserialize(d);
-        case battle_finished_response::type:
-            return battle_finished_response::deserialize(d);
-        default:
-            return nullptr;
+        new_battle_response, level_up_response, battle_update_response, battle_finished_response>();
+
+unique_ptr<message> deserialize_message(uint64_t const &type, rapidjson::Document const &d) {
+    auto deserialize = deserialize_table.find(type);
+    if(deserialize == nullptr) {
+        return nullptr;
     }
+
+    return deserialize(d);
 }
 
 void scene_system::handle_message(rapidjson::Document const &d) {
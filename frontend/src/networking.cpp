@@ -28,6 +28,7 @@
 #endif
 
 #include <ecs/systems/scene_system.h>
+#include <json_arena.h>
 
 using namespace std;
 
@@ -93,8 +94,8 @@ EM_BOOL WebSocketMessage(int eventType, const EmscriptenWebSocketMessageEvent *e
             return 0;
         }
 
-        rapidjson::Document d{};
-        d.Parse(reinterpret_cast<char *>(e->data), e->numBytes);
+        // emscripten null-terminates text data and frees it after this callback, so it can be parsed in-situ
+        auto &d = ibh::inbound_arena.parse_insitu(reinterpret_cast<char *>(e->data));
 
         if (d.HasParseError() || !d.IsObject() || !d.HasMember("type") || !d["type"].IsUint64()) {
             spdlog::warn("[{}] deserialize failed", __FUNCTION__);
@@ -187,7 +188,7 @@ void on_open(ibh::client *c, entt::entity entt, entt::registry *es, ibh::scene_s
 
 void on_message(ibh::client *c, ibh::scene_system *manager, websocketpp::connection_hdl hdl, ibh::client::message_ptr msg) {
     try {
-        string const &message = msg->get_payload();
+        string &message = msg->get_raw_payload();
 
         if (message.empty() || message.length() < 4) {
             spdlog::warn("[{}] deserialize encountered empty buffer", __FUNCTION__);
@@ -196,8 +197,7 @@ void on_message(ibh::client *c, ibh::scene_system *manager, websocketpp::connect
 
         spdlog::trace("[{}] text data: {}", __FUNCTION__, message);
 
-        rapidjson::Document d{};
-        d.Parse(message.c_str(), message.size());
+        auto &d = ibh::inbound_arena.parse_insitu(&message[0]);
 
         if (d.HasParseError() || !d.IsObject() || !d.HasMember("type") || !d["type"].IsUint64()) {
             spdlog::warn("[{}] deserialize failed", __FUNCTION__);
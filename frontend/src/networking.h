@@ -25,6 +25,7 @@
 #include <thread>
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/client.hpp>
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
 #endif
 
 namespace ibh {
@@ -32,7 +33,44 @@ namespace ibh {
 #ifdef __EMSCRIPTEN__
     void init_net(config const &config, entt::registry &es, scene_system &ss);
 #else
-    typedef websocketpp::client<websocketpp::config::asio_tls_client> client;
+    // asio_tls_client with permessage-deflate, the server decides per message whether it is worth compressing
+    struct asio_tls_client_deflate : public websocketpp::config::asio_tls_client {
+        typedef asio_tls_client_deflate type;
+        typedef websocketpp::config::asio_tls_client base;
+
+        typedef base::concurrency_type concurrency_type;
+
+        typedef base::request_type request_type;
+        typedef base::response_type response_type;
+
+        typedef base::message_type message_type;
+        typedef base::con_msg_manager_type con_msg_manager_type;
+        typedef base::endpoint_msg_manager_type endpoint_msg_manager_type;
+
+        typedef base::alog_type alog_type;
+        typedef base::elog_type elog_type;
+
+        typedef base::rng_type rng_type;
+
+        struct transport_config : public base::transport_config {
+            typedef type::concurrency_type concurrency_type;
+            typedef type::alog_type alog_type;
+            typedef type::elog_type elog_type;
+            typedef type::request_type request_type;
+            typedef type::response_type response_type;
+            typedef websocketpp::transport::asio::tls_socket::endpoint socket_type;
+        };
+
+        typedef websocketpp::transport::asio::endpoint<transport_config> transport_type;
+
+        struct permessage_deflate_config {
+            typedef type::request_type request_type;
+        };
+
+        typedef websocketpp::extensions::permessage_deflate::enabled<permessage_deflate_config> permessage_deflate_type;
+    };
+
+    typedef websocketpp::client<asio_tls_client_deflate> client;
     std::thread init_net(config const &config, entt::registry &es, scene_system &ss);
 #endif
 }
\ No newline at end of file
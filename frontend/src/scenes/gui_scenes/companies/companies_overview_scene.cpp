@@ -30,8 +30,8 @@
 using namespace std;
 using namespace ibh;
 
-companies_overview_scene::companies_overview_scene(iscene_manager *manager) : scene(generate_type<companies_overview_scene>()), _error(), _waiting_for_reply(true), _waiting_for_companies(true), _selected_company(), _companies() {
-    send_message<get_company_listing_request>(manager);
+companies_overview_scene::companies_overview_scene(iscene_manager *manager) : scene(generate_type<companies_overview_scene>()), _error(), _waiting_for_reply(true), _waiting_for_companies(true), _selected_company(), _companies(), _page(), _page_count() {
+    send_message<get_company_listing_request>(manager, _page, ""s);
 }
 
 void companies_overview_scene::update(iscene_manager *manager, TimeDelta dt) {
@@ -86,6 +86,22 @@ void companies_overview_scene::update(iscene_manager *manager, TimeDelta dt) {
 
             reenable_buttons();
 
+            disable_buttons_when(_waiting_for_reply || _page == 0);
+            if (ImGui::Button("Previous")) {
+                send_message<get_company_listing_request>(manager, _page - 1, ""s);
+                _waiting_for_reply = true;
+            }
+            reenable_buttons();
+
+            ImGui::SameLine();
+
+            disable_buttons_when(_waiting_for_reply || _page + 1 >= _page_count);
+            if (ImGui::Button("Next")) {
+                send_message<get_company_listing_request>(manager, _page + 1, ""s);
+                _waiting_for_reply = true;
+            }
+            reenable_buttons();
+
             if (ImGui::Button("Done")) {
                 _closed = true;
             }
@@ -113,6 +129,8 @@ void companies_overview_scene::handle_message(iscene_manager *manager, uint64_t
             }
 
             _companies = resp_msg->companies;
+            _page = resp_msg->page;
+            _page_count = resp_msg->page_count;
             break;
         }
 
@@ -36,5 +36,7 @@ namespace ibh {
         bool _waiting_for_companies;
         string _selected_company;
         vector<company_object> _companies;
+        uint32_t _page;
+        uint32_t _page_count;
     };
 }
@@ -0,0 +1,49 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "allocation_counter.h"
+#include <cstddef>
+
+namespace ibh {
+    std::atomic<uint64_t> allocation_count{0};
+}
+
+// Interposes glibc's malloc family, which also covers operator new and rapidjson's CrtAllocator.
+// Sanitizers bring their own allocator, so counting is disabled for those builds.
+#if !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+extern "C" {
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void *ptr, std::size_t size);
+
+    void* malloc(std::size_t size) {
+        ibh::allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) {
+        ibh::allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void *ptr, std::size_t size) {
+        ibh::allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(ptr, size);
+    }
+}
+#endif
@@ -18,10 +18,9 @@
 
 #pragma once
 
-#include <entt/entt.hpp>
-
-using namespace std;
+#include <atomic>
 
 namespace ibh {
-    void load_assets(entt::registry &registry, atomic<bool> const &quit);
+    // Number of malloc/calloc/realloc calls in the benchmark binary, stays 0 in sanitizer builds.
+    extern std::atomic<uint64_t> allocation_count;
 }
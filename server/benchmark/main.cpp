@@ -18,6 +18,7 @@
 
 #include <spdlog/spdlog.h>
 #include <filesystem>
+#include <fstream>
 #include <chrono>
 #include <game_logic/censor_sensor.h>
 #include <sodium.h>
@@ -31,8 +32,9 @@
 #include "../src/config.h"
 #include "../src/config_parsers.h"
 #include "benchmark_helpers/startup_helper.h"
+#include "benchmark_helpers/allocation_counter.h"
 #include "../src/working_directory_manipulation.h"
-#include <asset_loading/load_assets.h>
+#include <asset_loading/monster_definitions.h>
 #include <messages/generic_error_response.h>
 #include <random_helper.h>
 #include <random>
@@ -41,6 +43,50 @@
 #include <ecs/battle_system.h>
 #include <ecs/resource_system.h>
 #include <tbb/task_scheduler_init.h>
+#include <zlib.h>
+#include <messages/battle/battle_update_response.h>
+#include <messages/resources/resource_update_response.h>
+#include <messages/user_access/login_response.h>
+#include <messages/company/get_company_listing_response.h>
+#include <connection_registry.h>
+#include <json_arena.h>
+#include <messages/chat/message_request.h>
+#include <messages/user_access/login_request.h>
+#include <messages/resources/set_action_request.h>
+#include <messages/user_access/register_request.h>
+#include <messages/user_access/play_character_request.h>
+#include <messages/user_access/create_character_request.h>
+#include <messages/user_access/delete_character_request.h>
+#include <messages/user_access/character_select_request.h>
+#include <messages/moderator/set_motd_request.h>
+#include <messages/company/accept_application_request.h>
+#include <messages/company/create_company_request.h>
+#include <messages/company/get_company_applications_request.h>
+#include <messages/company/get_company_listing_request.h>
+#include <messages/company/increase_bonus_request.h>
+#include <messages/company/join_company_request.h>
+#include <messages/company/leave_company_request.h>
+#include <messages/company/reject_application_request.h>
+#include <messages/company/set_tax_request.h>
+#include <dispatch_table.h>
+#include <group_commit.h>
+#include <ecs/components.h>
+#include <game_queue_message_handlers/game_queue_router.h>
+#include <repositories/companies_repository.h>
+#include <repositories/company_stats_repository.h>
+#include <repositories/users_repository.h>
+#include <repositories/company_members_repository.h>
+#include <repositories/character_stats_repository.h>
+#include <repositories/packed_character_stats_repository.h>
+#include <magic_enum.hpp>
+#include <database/array_parsing.h>
+#include <ibh_containers.h>
+#include <shared_mutex>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
 
 using namespace std;
 using namespace ibh;
@@ -55,6 +101,8 @@ namespace ibh {
     }
 }
 
+int64_t battle_turn(pc_component &pc, ibh_flat_map<uint32_t, int64_t> &attacker, ibh_flat_map<uint32_t, int64_t> &defender, bool &attacker_dead, bool &defender_dead, string const &attacker_name, string const &defender_name);
+
 void on_sigint(int sig) {
     quit = true;
 }
@@ -107,23 +155,76 @@ void bench_hash_verify() {
     }
 }
 
+template <typename T, typename ViewT>
+void bench_inbound_parsing(string const &msg) {
+    const int iterations = 1'000'000;
+
+    {
+        auto allocations_before = allocation_count.load(memory_order_relaxed);
+        auto start = chrono::system_clock::now();
+        for(int i = 0; i < iterations && !quit; i++) {
+            rapidjson::Document d;
+            d.Parse(&msg[0], msg.size());
+            auto msg2 = T::deserialize(d);
+            if(!msg2) {
+                spdlog::error("[{}] err in serialization", __FUNCTION__);
+            }
+        }
+        auto end = chrono::system_clock::now();
+        spdlog::info("[{}] Document + {}::deserialize {:n} µs, {:.2f} allocations per message", __FUNCTION__, type_name<T>(), chrono::duration_cast<chrono::microseconds>(end - start).count(),
+                     (allocation_count.load(memory_order_relaxed) - allocations_before) / static_cast<double>(iterations));
+    }
+
+    {
+        // copying into the payload buffer is what websocketpp does for us, so keep that outside of the count
+        string payload;
+        payload.reserve(msg.size());
+        // the first parse on a thread sets up the reader's stack, after that parsing shouldn't allocate at all
+        payload.assign(msg);
+        (void)inbound_arena.parse_insitu(&payload[0]);
+        auto allocations_before = allocation_count.load(memory_order_relaxed);
+        auto start = chrono::system_clock::now();
+        for(int i = 0; i < iterations && !quit; i++) {
+            payload.assign(msg);
+            auto &d = inbound_arena.parse_insitu(&payload[0]);
+            auto msg2 = ViewT::deserialize(d);
+            if(!msg2) {
+                spdlog::error("[{}] err in serialization", __FUNCTION__);
+            }
+        }
+        auto end = chrono::system_clock::now();
+        auto allocations = allocation_count.load(memory_order_relaxed) - allocations_before;
+        spdlog::info("[{}] insitu arena + {}::deserialize {:n} µs, {:.2f} allocations per message", __FUNCTION__, type_name<ViewT>(), chrono::duration_cast<chrono::microseconds>(end - start).count(),
+                     allocations / static_cast<double>(iterations));
+        if(allocations != 0) {
+            spdlog::error("[{}] insitu arena allocated {} times, expected none", __FUNCTION__, allocations);
+        }
+    }
+}
+
 void bench_serialization() {
     if(quit) {
         return;
     }
 
-    MEASURE_TIME_OF_FUNCTION(info);
-    generic_error_response resp{"err", "pretty err", "desc", true};
+    {
+        MEASURE_TIME(info, "generic_error_response roundtrip");
+        generic_error_response resp{"err", "pretty err", "desc", true};
 
-    for(int i = 0; i < 1'000'000; i++) {
-        auto msg = resp.serialize();
-        rapidjson::Document d;
-        d.Parse(&msg[0], msg.size());
-        auto resp2 = generic_error_response::deserialize(d);
-        if(resp.clear_login_data != resp2->clear_login_data) {
-            spdlog::error("[{}] err in serialization", __FUNCTION__);
+        for(int i = 0; i < 1'000'000; i++) {
+            auto msg = resp.serialize();
+            rapidjson::Document d;
+            d.Parse(&msg[0], msg.size());
+            auto resp2 = generic_error_response::deserialize(d);
+            if(resp.clear_login_data != resp2->clear_login_data) {
+                spdlog::error("[{}] err in serialization", __FUNCTION__);
+            }
         }
     }
+
+    bench_inbound_parsing<message_request, message_request_view>(message_request("a chat message that is a bit longer than the small string optimization").serialize());
+    bench_inbound_parsing<login_request, login_request_view>(login_request("some_username", "very_secure_password").serialize());
+    bench_inbound_parsing<set_action_request, set_action_request_view>(set_action_request(1).serialize());
 }
 
 void bench_serialization_cereal() {
@@ -213,6 +314,25 @@ void bench_pcg() {
     }
 }
 
+// runs the system for simulated_turns ticks and reports the per tick distribution, which is what shows up as frame time spikes
+template <typename SystemT>
+void bench_tick_times(string const &name, SystemT &s, entt::registry &es, int64_t simulated_turns) {
+    vector<uint64_t> tick_times;
+    tick_times.reserve(simulated_turns);
+    for(int64_t i = 0; i < simulated_turns && !quit; i++) {
+        auto start = chrono::steady_clock::now();
+        s.do_tick(es);
+        tick_times.push_back(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+    }
+
+    if(tick_times.empty()) {
+        return;
+    }
+
+    sort(begin(tick_times), end(tick_times));
+    spdlog::info("[{}] {} tick times p50/p99/max: {} / {} / {} µs", __FUNCTION__, name, tick_times[tick_times.size() / 2], tick_times[tick_times.size() * 99 / 100], tick_times.back());
+}
+
 void bench_battle() {
     if(quit) {
         return;
@@ -224,24 +344,23 @@ void bench_battle() {
     const int simulated_turns = 1'000;
     es.group<battle_component>(entt::get<pc_component>);
 
+    auto definitions = make_shared<monster_definition_table>();
     for(int64_t i = 0; i < entity_count; i++) {
-        auto entt = es.create();
         decltype(monster_definition_component::stats) stats;
         stats.reserve(stat_name_ids.size());
         for(auto &stat : stat_name_ids) {
             stats.emplace(stat, i+1);
         }
-        es.emplace<monster_definition_component>(entt, to_string(i), stats);
+        definitions->monsters.emplace_back(to_string(i), stats);
     }
 
     for(int64_t i = 0; i < entity_count; i++) {
-        auto entt = es.create();
         decltype(monster_special_definition_component::stats) stats;
         stats.reserve(stat_name_ids.size());
         for(auto &stat : stat_name_ids) {
             stats.emplace(stat, i+1);
         }
-        es.emplace<monster_special_definition_component>(entt, fmt::format("{}", i), stats, false);
+        definitions->specials.emplace_back(fmt::format("{}", i), stats, false);
     }
 
     for(int64_t i = 0; i < entity_count; i++) {
@@ -255,13 +374,45 @@ void bench_battle() {
         es.emplace<battle_component>(entt);
     }
 
-    battle_system s{1, &q};
+    tbb::task_scheduler_init anonymous;
+    for(auto engine : {battle_engine::scalar, battle_engine::batched}) {
+        for(uint32_t every_n_ticks : {1u, 10u}) {
+            battle_system s{every_n_ticks, &q, engine};
+            s.set_definitions(definitions);
+            auto name = fmt::format("{} battle every {} ticks", engine == battle_engine::scalar ? "scalar" : "batched", every_n_ticks);
+            auto start = chrono::steady_clock::now();
+            bench_tick_times(name, s, es, simulated_turns);
+            auto seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            auto battles = static_cast<double>(entity_count) * simulated_turns / every_n_ticks;
+            spdlog::info("[{}] {} {:.0f} battles/s/core", __FUNCTION__, name, battles / seconds / max(thread::hardware_concurrency(), 1u));
+        }
+    }
+}
+
+void bench_monster_reload() {
+    if(quit) {
+        return;
+    }
+
+    const uint32_t file_count = 5'000;
+    auto directory = filesystem::temp_directory_path() / "ibh_bench_monsters";
+    filesystem::create_directories(directory / "monsters");
+    filesystem::create_directories(directory / "specials");
+    auto remove_directory = on_leaving_scope([&directory] {
+        filesystem::remove_all(directory);
+    });
+
+    for(uint32_t i = 0; i < file_count; i++) {
+        ofstream(directory / "monsters" / fmt::format("{}.json", i)) << fmt::format(R"({{"name": "monster {}", "stats": {{"str": {}, "agi": 10, "vit": 10, "spd": 10, "xp": 5, "gold": 5}}}})", i, i);
+        ofstream(directory / "specials" / fmt::format("{}.json", i)) << fmt::format(R"({{"name": "special {}", "teleport_when_beat": false, "stats": {{"str": {}}}}})", i, i);
+    }
 
     tbb::task_scheduler_init anonymous;
-    {
+    for(int i = 0; i < 5 && !quit; i++) {
         MEASURE_TIME_OF_FUNCTION(info);
-        for (int64_t i = 0; i < simulated_turns && !quit; i++) {
-            s.do_tick(es);
+        auto definitions = load_monster_definitions((directory / "monsters").string(), (directory / "specials").string(), quit);
+        if(definitions->monsters.size() != file_count || definitions->specials.size() != file_count) {
+            spdlog::error("[{}] loaded {} monsters and {} specials, expected {}", __FUNCTION__, definitions->monsters.size(), definitions->specials.size(), file_count);
         }
     }
 }
@@ -304,15 +455,577 @@ void bench_resource() {
         es.emplace<timber_gathering_component>(entt);
     }
 
-    resource_system s{1, &q};
-
     tbb::task_scheduler_init anonymous;
-    {
+    for(uint32_t every_n_ticks : {1u, 10u}) {
+        resource_system s{every_n_ticks, &q};
         MEASURE_TIME_OF_FUNCTION(info);
-        for (int64_t i = 0; i < simulated_turns && !quit; i++) {
-            s.do_tick(es);
+        bench_tick_times(fmt::format("resource every {} ticks", every_n_ticks), s, es, simulated_turns);
+    }
+}
+
+void bench_logging_of(string const &name, shared_ptr<spdlog::logger> logger, spdlog::level::level_enum level) {
+    const int turns = 100'000;
+    auto previous_logger = spdlog::default_logger();
+    logger->set_level(level);
+    spdlog::set_default_logger(logger);
+
+    pc_component pc{};
+    ibh_flat_map<uint32_t, int64_t> attacker;
+    ibh_flat_map<uint32_t, int64_t> defender;
+    for(auto *stats : {&attacker, &defender}) {
+        stats->emplace(stat_str_id, 100);
+        stats->emplace(stat_agi_id, 100);
+        stats->emplace(stat_hp_id, 1'000);
+    }
+    bool attacker_dead = false;
+    bool defender_dead = false;
+    string attacker_name = "attacker";
+    string defender_name = "defender";
+
+    int64_t total_dmg = 0;
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < turns && !quit; i++) {
+        get_stat(defender, stat_hp_id) = 1'000'000;
+        total_dmg += battle_turn(pc, attacker, defender, attacker_dead, defender_dead, attacker_name, defender_name);
+    }
+    auto end = chrono::steady_clock::now();
+    logger->flush();
+
+    spdlog::set_default_logger(previous_logger);
+    spdlog::info("[{}] {} at level {}: {} ns per battle turn ({})", __FUNCTION__, name, spdlog::level::to_string_view(level),
+                 chrono::duration_cast<chrono::nanoseconds>(end - start).count() / turns, total_dmg);
+}
+
+void bench_logging() {
+    if(quit) {
+        return;
+    }
+
+    // trace calls in battle_turn are compiled out entirely unless SPDLOG_ACTIVE_LEVEL is trace, which is the case for Debug and RelWithDebInfo
+    spdlog::info("[{}] SPDLOG_ACTIVE_LEVEL {}", __FUNCTION__, SPDLOG_ACTIVE_LEVEL);
+
+    auto path = (filesystem::temp_directory_path() / "ibh_bench_logging.txt").string();
+    auto file_sink = make_shared<spdlog::sinks::basic_file_sink_mt>(path, true);
+    spdlog::init_thread_pool(8192, 1);
+
+    for(auto level : {spdlog::level::info, spdlog::level::trace}) {
+        bench_logging_of("sync", make_shared<spdlog::logger>("bench_sync", file_sink), level);
+        bench_logging_of("async block", make_shared<spdlog::async_logger>("bench_async", file_sink, spdlog::thread_pool(), spdlog::async_overflow_policy::block), level);
+        bench_logging_of("async overrun_oldest", make_shared<spdlog::async_logger>("bench_async", file_sink, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest), level);
+    }
+
+    filesystem::remove(path);
+}
+
+// mirrors what permessage-deflate does on the wire: raw deflate, sync flush, trailing 00 00 ff ff stripped
+uint64_t deflate_message(z_stream &stream, string const &payload, vector<unsigned char> &out, bool reset_context) {
+    if(reset_context) {
+        deflateReset(&stream);
+    }
+
+    out.resize(deflateBound(&stream, payload.size()) + 16);
+    stream.next_in = (unsigned char*)payload.data();
+    stream.avail_in = payload.size();
+    stream.next_out = out.data();
+    stream.avail_out = out.size();
+
+    if(deflate(&stream, Z_SYNC_FLUSH) != Z_OK) {
+        spdlog::error("[{}] deflate failed", __FUNCTION__);
+        return 0;
+    }
+
+    return out.size() - stream.avail_out - 4;
+}
+
+void bench_compression_of(string const &name, string const &payload) {
+    const int iterations = 10'000;
+    vector<unsigned char> out;
+
+    for(bool shared_context : {false, true}) {
+        z_stream stream{};
+        if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            spdlog::error("[{}] deflateInit2 failed", __FUNCTION__);
+            return;
+        }
+
+        uint64_t compressed_bytes = 0;
+        auto start = chrono::system_clock::now();
+        for(int i = 0; i < iterations && !quit; i++) {
+            compressed_bytes += deflate_message(stream, payload, out, !shared_context);
+        }
+        auto end = chrono::system_clock::now();
+        deflateEnd(&stream);
+
+        spdlog::info("[{}] {} shared_context {} raw {} bytes compressed {} bytes {:.3f} µs per message", __FUNCTION__, name, shared_context, payload.size(),
+                     compressed_bytes / iterations, chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (iterations * 1000.));
+    }
+}
+
+void bench_compression() {
+    if(quit) {
+        return;
+    }
+
+    MEASURE_TIME_OF_FUNCTION(info);
+
+    vector<stat_component> stats;
+    for(auto &stat : stat_name_ids) {
+        stats.emplace_back(stat, 100);
+    }
+
+    generic_error_response error_resp{"err", "pretty err", "desc", true};
+    bench_compression_of("generic_error_response", error_resp.serialize());
+
+    battle_update_response battle_resp{1, 2, 3, 4, 500, 600};
+    bench_compression_of("battle_update_response", battle_resp.serialize());
+
+    vector<resource> resources;
+    for(auto &resource_id : resource_ids) {
+        resources.emplace_back(resource_id, 1'000, 2'000, 10);
+    }
+    resource_update_response resource_resp{resources};
+    bench_compression_of("resource_update_response", resource_resp.serialize());
+
+    vector<character_object> characters;
+    for(uint32_t i = 0; i < 4; i++) {
+        vector<item_object> items;
+        for(uint32_t j = 0; j < 12; j++) {
+            items.emplace_back(j, fmt::format("item {}", j), "an item", "armor", stats);
         }
+        characters.emplace_back(fmt::format("character {}", i), "human", "warrior", "company", 10, i, 1'000, 1'000, 0, stats, items, vector<skill_object>{});
     }
+    vector<account_object> online_users;
+    for(uint32_t i = 0; i < 500; i++) {
+        online_users.emplace_back(false, false, false, 0, 0, fmt::format("user {}", i));
+    }
+    login_response login_resp{characters, online_users, "user", "user@example.com", "motd"};
+    bench_compression_of("login_response", login_resp.serialize());
+
+    vector<company_object> companies;
+    for(uint32_t i = 0; i < 100; i++) {
+        vector<string> members;
+        for(uint32_t j = 0; j < 20; j++) {
+            members.emplace_back(fmt::format("character {}", j));
+        }
+        companies.emplace_back(fmt::format("company {}", i), members, stats);
+    }
+    get_company_listing_response listing_resp{"", companies, 0, 2, 1};
+    bench_compression_of("get_company_listing_response", listing_resp.serialize());
+}
+
+struct bench_connection {
+    uint64_t connection_id;
+};
+
+void bench_connection_registry() {
+    if(quit) {
+        return;
+    }
+
+    const int connection_count = 50'000;
+    const int lookups = 1'000'000;
+    const int broadcasts = 100;
+    vector<shared_ptr<bench_connection>> connections;
+    connections.reserve(connection_count);
+
+    ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> map_connections;
+    ibh_flat_map<websocketpp::connection_hdl, uint64_t> handle_to_connection_id_map;
+    shared_mutex map_mutex;
+    connection_registry<websocketpp::connection_hdl> registry;
+
+    for(int i = 0; i < connection_count; i++) {
+        auto &con = connections.emplace_back(make_shared<bench_connection>());
+        websocketpp::connection_hdl hdl = con;
+        per_socket_data<websocketpp::connection_hdl> user_data{};
+        user_data.connection_id = i + 1;
+        user_data.ws = hdl;
+        handle_to_connection_id_map[hdl] = user_data.connection_id;
+        map_connections[user_data.connection_id] = user_data;
+        con->connection_id = registry.add(hdl)->connection_id;
+    }
+
+    uint64_t found = 0;
+    {
+        MEASURE_TIME(info, "map lookups");
+        for(int i = 0; i < lookups && !quit; i++) {
+            websocketpp::connection_hdl hdl = connections[i % connection_count];
+            auto id_map_it = handle_to_connection_id_map.find(hdl);
+            shared_lock lock(map_mutex);
+            auto user_data_it = map_connections.find(id_map_it->second);
+            found += user_data_it->second.connection_id;
+        }
+    }
+
+    {
+        MEASURE_TIME(info, "registry lookups");
+        for(int i = 0; i < lookups && !quit; i++) {
+            websocketpp::connection_hdl hdl = connections[i % connection_count];
+            auto connection_id = static_pointer_cast<bench_connection>(hdl.lock())->connection_id;
+            found += registry.find(connection_id)->connection_id;
+        }
+    }
+
+    {
+        MEASURE_TIME(info, "map broadcasts");
+        for(int i = 0; i < broadcasts && !quit; i++) {
+            shared_lock lock(map_mutex);
+            for(auto &[conn_id, user_data] : map_connections) {
+                found += !user_data.ws.expired();
+            }
+        }
+    }
+
+    {
+        MEASURE_TIME(info, "registry broadcasts");
+        for(int i = 0; i < broadcasts && !quit; i++) {
+            for(auto &user_data : registry) {
+                found += !user_data.ws.expired();
+            }
+        }
+    }
+
+    spdlog::trace("[{}] {}", __FUNCTION__, found);
+}
+
+using bench_dispatch_fn = void(*)(uint64_t &);
+
+template <typename T>
+void count_dispatch(uint64_t &sink) {
+    sink += T::type & 0xFFU;
+}
+
+template <typename... Msgs>
+void bench_dispatch_of() {
+    const int dispatches = 10'000'000;
+    vector<uint64_t> const types{Msgs::type...};
+    vector<uint64_t> stream;
+    stream.reserve(dispatches);
+    mt19937_64 rng{1234};
+    uniform_int_distribution<size_t> dist(0, types.size() - 1);
+    for(int i = 0; i < dispatches; i++) {
+        stream.push_back(types[dist(rng)]);
+    }
+
+    ibh_flat_map<uint64_t, function<void(uint64_t &)>> map_router;
+    (map_router.emplace(Msgs::type, count_dispatch<Msgs>), ...);
+    static constexpr auto table_router = make_dispatch_table<bench_dispatch_fn>({{Msgs::type, count_dispatch<Msgs>}...});
+
+    uint64_t sink = 0;
+    {
+        auto start = chrono::system_clock::now();
+        for(auto type : stream) {
+            auto handler = map_router.find(type);
+            if(handler != end(map_router)) {
+                handler->second(sink);
+            }
+        }
+        auto end = chrono::system_clock::now();
+        spdlog::info("[{}] flat_map + function: {:.2f} ns per message", __FUNCTION__, chrono::duration_cast<chrono::nanoseconds>(end - start).count() / static_cast<double>(dispatches));
+    }
+
+    {
+        auto start = chrono::system_clock::now();
+        for(auto type : stream) {
+            auto handler = table_router.find(type);
+            if(handler != nullptr) {
+                handler(sink);
+            }
+        }
+        auto end = chrono::system_clock::now();
+        spdlog::info("[{}] dispatch_table with {} slots: {:.2f} ns per message", __FUNCTION__, table_router.table_size(),
+                     chrono::duration_cast<chrono::nanoseconds>(end - start).count() / static_cast<double>(dispatches));
+    }
+
+    spdlog::trace("[{}] {}", __FUNCTION__, sink);
+}
+
+void bench_dispatch() {
+    if(quit) {
+        return;
+    }
+
+    bench_dispatch_of<login_request, register_request, play_character_request, create_character_request, delete_character_request, character_select_request,
+                      message_request, set_motd_request, accept_application_request, create_company_request, get_company_applications_request,
+                      get_company_listing_request, increase_bonus_request, join_company_request, leave_company_request, reject_application_request,
+                      set_tax_request, set_action_request>();
+}
+
+template <typename OutwardT, typename GameT, typename MakeOutward, typename MakeGame>
+void bench_queue_messages_of(string const &name, MakeOutward make_outward, MakeGame make_game) {
+    const int ticks = 1'000;
+    const int outward_per_tick = 10'000;
+    const int game_per_tick = 1'000;
+    moodycamel::ConcurrentQueue<OutwardT> outward_queue;
+    moodycamel::ConcurrentQueue<GameT> game_queue;
+    moodycamel::ProducerToken outward_ptok(outward_queue);
+    moodycamel::ConsumerToken outward_ctok(outward_queue);
+    moodycamel::ProducerToken game_ptok(game_queue);
+    moodycamel::ConsumerToken game_ctok(game_queue);
+    uint64_t sink = 0;
+
+    auto do_tick = [&](uint64_t tick) {
+        for(int i = 0; i < game_per_tick; i++) {
+            game_queue.enqueue(game_ptok, make_game(tick + i));
+        }
+        GameT game_msg{};
+        while(game_queue.try_dequeue(game_ctok, game_msg)) {
+            sink++;
+        }
+
+        for(int i = 0; i < outward_per_tick; i++) {
+            outward_queue.enqueue(outward_ptok, make_outward(tick + i));
+        }
+        OutwardT outward_msg{};
+        while(outward_queue.try_dequeue(outward_ctok, outward_msg)) {
+            sink++;
+        }
+    };
+
+    // first tick allocates the queue blocks, which are reused afterwards
+    do_tick(0);
+
+    auto allocations_before = allocation_count.load(memory_order_relaxed);
+    auto start = chrono::system_clock::now();
+    for(int tick = 1; tick <= ticks && !quit; tick++) {
+        do_tick(tick);
+    }
+    auto end = chrono::system_clock::now();
+    spdlog::info("[{}] {} {:n} µs, {:.2f} allocations per tick", __FUNCTION__, name, chrono::duration_cast<chrono::microseconds>(end - start).count(),
+                 (allocation_count.load(memory_order_relaxed) - allocations_before) / static_cast<double>(ticks));
+    spdlog::trace("[{}] {}", __FUNCTION__, sink);
+}
+
+void bench_queue_messages() {
+    if(quit) {
+        return;
+    }
+
+    // what the queues used to carry
+    bench_queue_messages_of<unique_ptr<message>, unique_ptr<set_action_message>>("unique_ptr", [](uint64_t i) -> unique_ptr<message> {
+        return make_unique<battle_update_response>(i, i, i, i, i, i);
+    }, [](uint64_t i) {
+        return make_unique<set_action_message>(i, 1);
+    });
+
+    bench_queue_messages_of<outward_message, queue_message>("variant", [](uint64_t i) {
+        return outward_message{i, battle_update_response(i, i, i, i, i, i)};
+    }, [](uint64_t i) -> queue_message {
+        return set_action_message(i, 1);
+    });
+}
+
+void bench_group_commit_of(game_queue_commit_mode mode, entt::registry &es, uint32_t players) {
+    const int ticks = 200;
+    const uint32_t messages_per_tick = 100;
+    moodycamel::ConcurrentQueue<outward_message> outward_queue;
+    moodycamel::ConcurrentQueue<outward_message> staged_outward_queue;
+    outward_queues outward_queue_abstraction(&outward_queue);
+    outward_queues staged_outward_queue_abstraction(&staged_outward_queue);
+    optional<group_committer> committer;
+    if(mode == game_queue_commit_mode::group) {
+        committer.emplace(&outward_queue);
+    }
+
+    auto &message_changes = es.set<game_state_changes>();
+    auto commits_before = commit_stats.commits.load(memory_order_relaxed);
+    auto start = chrono::system_clock::now();
+    for(int tick = 0; tick < ticks && !quit; tick++) {
+        if(committer) {
+            committer->wait_idle();
+            auto transaction = db_pool->create_transaction();
+            game_state_changes tick_changes;
+            for(uint32_t i = 0; i < messages_per_tick; i++) {
+                queue_message msg = set_tax_message((tick * messages_per_tick + i) % players + 1, (tick + i) % 100);
+                handle_grouped_game_queue_message(msg, es, staged_outward_queue_abstraction, transaction, tick_changes);
+            }
+            vector<outward_message> responses;
+            outward_message response{};
+            while(staged_outward_queue.try_dequeue(response)) {
+                responses.push_back(move(response));
+            }
+            committer->commit_async(move(transaction), move(responses), messages_per_tick, move(tick_changes));
+        } else {
+            for(uint32_t i = 0; i < messages_per_tick; i++) {
+                queue_message msg = set_tax_message((tick * messages_per_tick + i) % players + 1, (tick + i) % 100);
+                auto transaction = db_pool->create_transaction();
+                if(handle_game_queue_message(msg, es, outward_queue_abstraction, transaction)) {
+                    transaction->commit();
+                    commit_stats.commits.fetch_add(1, memory_order_relaxed);
+                    message_changes.committed();
+                } else {
+                    message_changes.undo(es);
+                }
+            }
+        }
+
+        outward_message msg{};
+        while(outward_queue.try_dequeue(msg)) {}
+    }
+    committer.reset();
+    auto end = chrono::system_clock::now();
+
+    auto elapsed_us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+    spdlog::info("[{}] {} {} µs, {:.2f} commits/s, {:.2f} messages/s, {:.2f} µs per tick", __FUNCTION__, magic_enum::enum_name(mode), elapsed_us,
+                 (commit_stats.commits.load(memory_order_relaxed) - commits_before) * 1'000'000.0 / elapsed_us,
+                 ticks * messages_per_tick * 1'000'000.0 / elapsed_us, elapsed_us / static_cast<double>(ticks));
+}
+
+void bench_group_commit() {
+    if(quit) {
+        return;
+    }
+
+    const uint32_t players = 100;
+    entt::registry es;
+    vector<uint64_t> company_ids;
+    {
+        companies_repository<database_transaction> company_repo{};
+        company_stats_repository<database_transaction> company_stats_repo{};
+        auto transaction = db_pool->create_transaction();
+        auto time_since_epoch = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch());
+        for(uint32_t i = 0; i < players; i++) {
+            db_company company{0, fmt::format("bench_company_{}_{}", time_since_epoch.count(), i), 0, 0};
+            company_repo.insert(company, transaction);
+            company_ids.push_back(company.id);
+
+            db_company_stat tax_stat{0, company.id, company_stat_tax_id, 5};
+            company_stats_repo.insert(tax_stat, transaction);
+
+            auto entt = es.create();
+            pc_component pc{};
+            pc.id = i + 1;
+            pc.connection_id = i + 1;
+            es.emplace<pc_component>(entt, move(pc));
+            company_component cc{company.id, magic_enum::enum_integer(company_member_level::COMPANY_ADMIN), company.name, ibh_flat_map<uint32_t, int64_t>{{company_stat_tax_id, tax_stat.value}}};
+            es.emplace<company_component>(entt, move(cc));
+        }
+        transaction->commit();
+    }
+
+    bench_group_commit_of(game_queue_commit_mode::per_message, es, players);
+    bench_group_commit_of(game_queue_commit_mode::group, es, players);
+
+    auto transaction = db_pool->create_transaction();
+    auto ids = to_bigint_array(company_ids);
+    transaction->execute(fmt::format("DELETE FROM company_stats WHERE company_id = ANY({})", ids));
+    transaction->execute(fmt::format("DELETE FROM companies WHERE id = ANY({})", ids));
+    transaction->commit();
+}
+
+// Round trips dominate here, so run against a database with some network latency to see the difference, e.g.
+// tc qdisc add dev lo root netem delay 1ms
+void bench_pipelining() {
+    if(quit) {
+        return;
+    }
+
+    const int lookups = 1'000;
+    company_members_repository<database_transaction> member_repo{};
+    companies_repository<database_transaction> company_repo{};
+    auto transaction = db_pool->create_transaction();
+    uint64_t found = 0;
+
+    {
+        MEASURE_TIME(info, "sequential");
+        for(int i = 0; i < lookups && !quit; i++) {
+            found += member_repo.get_by_character_id(i, transaction).has_value();
+            found += company_repo.get(i, transaction).has_value();
+        }
+    }
+
+    {
+        MEASURE_TIME(info, "pipelined");
+        for(int i = 0; i < lookups && !quit; i++) {
+            auto pipeline = transaction->create_pipeline();
+            auto member_result = member_repo.get_by_character_id_async(i, *pipeline);
+            auto company_result = company_repo.get_async(i, *pipeline);
+            found += member_result.get().has_value();
+            found += company_result.get().has_value();
+        }
+    }
+
+    spdlog::trace("[{}] {}", __FUNCTION__, found);
+}
+
+// Everything runs in a transaction that is never committed, so the database is left as it was.
+void bench_character_stats_storage() {
+    if(quit) {
+        return;
+    }
+
+    const uint32_t characters = 100'000;
+    const uint32_t batch_size = 1'000;
+    const uint32_t single_row_characters = 1'000;
+    users_repository<database_transaction> user_repo{};
+    character_stats_repository<database_transaction> stats_repo{};
+    packed_character_stats_repository<database_transaction> packed_stats_repo{};
+    auto transaction = db_pool->create_transaction();
+
+    db_user usr{0, fmt::format("bench_stats_{}", chrono::system_clock::now().time_since_epoch().count()), "", "", 0, "", 0, 0};
+    user_repo.insert_if_not_exists(usr, transaction);
+    auto result = transaction->execute(fmt::format("INSERT INTO characters (user_id, slot, level, gold, xp, skill_points, character_name, race, class, x, y, map) "
+                                                   "SELECT {}, g, 1, 0, 0, 0, 'bench_' || g, 'human', 'warrior', 0, 0, '' FROM generate_series(1, {}) g RETURNING id", usr.id, characters));
+    vector<uint64_t> character_ids;
+    character_ids.reserve(result.size());
+    for(auto const &res : result) {
+        character_ids.push_back(res[0].as(uint64_t{}));
+    }
+
+    auto stats_of = [](span<uint64_t const> ids) {
+        vector<db_character_stat> stats;
+        stats.reserve(ids.size() * stat_name_ids.size());
+        for(auto id : ids) {
+            for(auto stat_id : stat_name_ids) {
+                stats.emplace_back(0, id, stat_id, static_cast<int64_t>(id + stat_id));
+            }
+        }
+        return stats;
+    };
+
+    auto measure = [&](string const &name, uint64_t count, auto &&f) {
+        auto start = chrono::system_clock::now();
+        f();
+        auto us = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now() - start).count();
+        spdlog::info("[{}] {} {} µs, {:.0f} characters/s", __FUNCTION__, name, us, count * 1'000'000.0 / max(us, 1L));
+    };
+
+    measure("rows save one statement per stat", single_row_characters, [&] {
+        for(auto stat : stats_of(span<uint64_t const>(character_ids).first(single_row_characters))) {
+            stats_repo.insert(stat, transaction);
+        }
+    });
+    transaction->execute("DELETE FROM character_stats WHERE character_id = ANY(" + to_bigint_array(character_ids) + ")");
+
+    measure("rows save", characters, [&] {
+        for(uint32_t i = 0; i < characters && !quit; i += batch_size) {
+            auto batch = span<uint64_t const>(character_ids).subspan(i, min(batch_size, characters - i));
+            stats_repo.insert_many(stats_of(batch), transaction);
+        }
+    });
+
+    measure("packed save", characters, [&] {
+        for(uint32_t i = 0; i < characters && !quit; i += batch_size) {
+            auto batch = span<uint64_t const>(character_ids).subspan(i, min(batch_size, characters - i));
+            packed_stats_repo.save(stats_of(batch), transaction);
+        }
+    });
+
+    uint64_t loaded = 0;
+    measure("rows load", characters, [&] {
+        for(uint32_t i = 0; i < characters && !quit; i += batch_size) {
+            auto batch = span<uint64_t const>(character_ids).subspan(i, min(batch_size, characters - i));
+            loaded += stats_repo.get_by_character_ids(batch, transaction).size();
+        }
+    });
+
+    measure("packed load", characters, [&] {
+        for(uint32_t i = 0; i < characters && !quit; i += batch_size) {
+            auto batch = span<uint64_t const>(character_ids).subspan(i, min(batch_size, characters - i));
+            loaded += packed_stats_repo.get_by_character_ids(batch, transaction).size();
+        }
+    });
+
+    spdlog::trace("[{}] {}", __FUNCTION__, loaded);
 }
 
 int main(int argc, char **argv) {
@@ -342,7 +1055,7 @@ int main(int argc, char **argv) {
     fill_mappers();
 
     entt::registry registry;
-//    load_assets(registry, quit);
+//    auto definitions = load_monster_definitions("assets/monsters", "assets/monster_specials", quit);
 
 //    bench_censor_sensor();
 //    bench_hashing();
@@ -354,5 +1067,14 @@ int main(int argc, char **argv) {
 //    bench_random_helper();
 //    bench_pcg();
 //    bench_battle();
-    bench_resource();
+//    bench_monster_reload();
+//    bench_resource();
+//    bench_compression();
+//    bench_connection_registry();
+//    bench_dispatch();
+//    bench_queue_messages();
+//    bench_group_commit();
+//    bench_pipelining();
+//    bench_character_stats_storage();
+    bench_logging();
 }
@@ -0,0 +1,139 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "binary_copy.h"
+#include <stdexcept>
+#include <type_traits>
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+
+using namespace ibh;
+
+// see https://www.postgresql.org/docs/current/sql-copy.html#id-1.9.3.55.9.4
+static constexpr char copy_signature[] = "PGCOPY\n\377\r\n";
+static constexpr size_t flush_size = 1 << 20;
+static constexpr int32_t int8_oid = 20;
+
+binary_copy::binary_copy(PGconn *connection, string const &table, vector<string> const &columns)
+    : _connection(connection), _table(table), _columns(static_cast<int16_t>(columns.size())), _rows(), _buffer() {
+    string column_list;
+    for(auto const &column : columns) {
+        column_list += fmt::format("{}{}", column_list.empty() ? "" : ", ", column);
+    }
+
+    auto *result = PQexec(_connection, fmt::format("COPY {} ({}) FROM STDIN (FORMAT binary)", _table, column_list).c_str());
+    auto status = PQresultStatus(result);
+    PQclear(result);
+    if(status != PGRES_COPY_IN) {
+        throw runtime_error(fmt::format("could not start copy into {}: {}", _table, PQerrorMessage(_connection)));
+    }
+
+    _buffer.reserve(flush_size + 4'096);
+    _buffer.insert(end(_buffer), copy_signature, copy_signature + sizeof(copy_signature)); // includes the terminating \0
+    put<int32_t>(0); // flags
+    put<int32_t>(0); // header extension length
+}
+
+void binary_copy::start_row() {
+    if(_buffer.size() >= flush_size) {
+        flush();
+    }
+    put<int16_t>(_columns);
+    _rows++;
+}
+
+void binary_copy::add_int16(int16_t value) {
+    put<int32_t>(sizeof(value));
+    put(value);
+}
+
+void binary_copy::add_int32(int32_t value) {
+    put<int32_t>(sizeof(value));
+    put(value);
+}
+
+void binary_copy::add_int64(int64_t value) {
+    put<int32_t>(sizeof(value));
+    put(value);
+}
+
+void binary_copy::add_text(string_view value) {
+    put<int32_t>(static_cast<int32_t>(value.size()));
+    _buffer.insert(end(_buffer), begin(value), end(value));
+}
+
+void binary_copy::add_int64_array(span<int64_t const> values) {
+    // ndim, has nulls, element type, then length and lower bound of the only dimension
+    put<int32_t>(static_cast<int32_t>(5 * sizeof(int32_t) + values.size() * (sizeof(int32_t) + sizeof(int64_t))));
+    put<int32_t>(1);
+    put<int32_t>(0);
+    put<int32_t>(int8_oid);
+    put<int32_t>(static_cast<int32_t>(values.size()));
+    put<int32_t>(1);
+    for(auto value : values) {
+        put<int32_t>(sizeof(value));
+        put(value);
+    }
+}
+
+void binary_copy::add_null() {
+    put<int32_t>(-1);
+}
+
+uint64_t binary_copy::complete() {
+    put<int16_t>(-1);
+    flush();
+
+    if(PQputCopyEnd(_connection, nullptr) != 1) {
+        throw runtime_error(fmt::format("could not end copy into {}: {}", _table, PQerrorMessage(_connection)));
+    }
+
+    auto *result = PQgetResult(_connection);
+    auto status = PQresultStatus(result);
+    PQclear(result);
+    while((result = PQgetResult(_connection)) != nullptr) {
+        PQclear(result);
+    }
+    if(status != PGRES_COMMAND_OK) {
+        throw runtime_error(fmt::format("copy into {} failed: {}", _table, PQerrorMessage(_connection)));
+    }
+
+    SPDLOG_TRACE("[{}] copied {} rows into {}", __FUNCTION__, _rows, _table);
+    return _rows;
+}
+
+template<typename T>
+void binary_copy::put(T value) {
+    // network byte order
+    auto unsigned_value = static_cast<make_unsigned_t<T>>(value);
+    for(int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+        _buffer.push_back(static_cast<char>((unsigned_value >> shift) & 0xFF));
+    }
+}
+
+void binary_copy::flush() {
+    if(_buffer.empty()) {
+        return;
+    }
+
+    if(PQputCopyData(_connection, _buffer.data(), static_cast<int>(_buffer.size())) != 1) {
+        throw runtime_error(fmt::format("could not send copy data into {}: {}", _table, PQerrorMessage(_connection)));
+    }
+    _buffer.clear();
+}
@@ -0,0 +1,61 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <libpq-fe.h>
+
+using namespace std;
+
+namespace ibh {
+    // Streams rows into a table with COPY ... FROM STDIN (FORMAT binary). Values have to be added in the order of the columns
+    // and with the width of the column type, e.g. add_int64 for BIGINT and add_int16 for SMALLINT.
+    class binary_copy {
+    public:
+        binary_copy(PGconn *connection, string const &table, vector<string> const &columns);
+        binary_copy(binary_copy const &) = delete;
+        binary_copy& operator=(binary_copy const &) = delete;
+
+        void start_row();
+        void add_int16(int16_t value);
+        void add_int32(int32_t value);
+        void add_int64(int64_t value);
+        void add_text(string_view value);
+        void add_int64_array(span<int64_t const> values);
+        void add_null();
+
+        // sends the trailer and waits for the server to accept the rows, returns the amount of rows copied
+        uint64_t complete();
+
+    private:
+        template<typename T>
+        void put(T value);
+        void flush();
+
+        PGconn *_connection;
+        string _table;
+        int16_t _columns;
+        uint64_t _rows;
+        vector<char> _buffer;
+    };
+}
@@ -0,0 +1,112 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <string_view>
+#include <libpq-fe.h>
+#include <sodium.h>
+
+#include "../src/config.h"
+#include "../src/config_parsers.h"
+#include "../src/working_directory_manipulation.h"
+#include "synthetic_data.h"
+#include <common_components.h>
+#include <on_leaving_scope.h>
+
+using namespace std;
+using namespace ibh;
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+    spdlog::set_pattern("[%C-%m-%d %H:%M:%S.%e] [%L] %v");
+    set_cwd(get_selfpath());
+
+    synthetic_data_config generator_config{1, 100'000, 5, 20, 5'000, 0.4, 0.1, true, "generated_password"};
+
+    try {
+        for(int i = 1; i < argc; i++) {
+            string_view arg = argv[i];
+            if(arg == "--no-packed-stats") {
+                generator_config.packed_stats = false;
+            } else if(i + 1 < argc && arg == "--seed") {
+                generator_config.seed = stoull(argv[++i]);
+            } else if(i + 1 < argc && arg == "--users") {
+                generator_config.users = stoull(argv[++i]);
+            } else if(i + 1 < argc && arg == "--max-characters") {
+                generator_config.max_characters_per_user = stoul(argv[++i]);
+            } else if(i + 1 < argc && arg == "--max-items") {
+                generator_config.max_items_per_character = stoul(argv[++i]);
+            } else if(i + 1 < argc && arg == "--companies") {
+                generator_config.companies = stoull(argv[++i]);
+            } else if(i + 1 < argc && arg == "--member-ratio") {
+                generator_config.member_ratio = stod(argv[++i]);
+            } else if(i + 1 < argc && arg == "--applicant-ratio") {
+                generator_config.applicant_ratio = stod(argv[++i]);
+            } else if(i + 1 < argc && arg == "--password") {
+                generator_config.password = argv[++i];
+            } else {
+                spdlog::error("[{}] usage: {} [--seed 1] [--users 100000] [--max-characters 5] [--max-items 20] [--companies 5000] [--member-ratio 0.4] [--applicant-ratio 0.1] [--password generated_password] [--no-packed-stats]", __FUNCTION__, argv[0]);
+                return 1;
+            }
+        }
+    } catch (const exception& e) {
+        spdlog::error("[{}] invalid argument: {}", __FUNCTION__, e.what());
+        return 1;
+    }
+
+    config config;
+    try {
+        auto config_opt = parse_env_file();
+        if(!config_opt) {
+            return 1;
+        }
+        config = config_opt.value();
+    } catch (const exception& e) {
+        spdlog::error("[{}] config.json file is malformed json.", __FUNCTION__);
+        return 1;
+    }
+    fill_mappers();
+
+    if(sodium_init() != 0) {
+        spdlog::error("[{}] sodium init failure", __FUNCTION__);
+        return 1;
+    }
+
+    auto *connection = PQconnectdb(config.connection_string.c_str());
+    auto connection_guard = on_leaving_scope([connection] {
+        PQfinish(connection);
+    });
+    if(PQstatus(connection) != CONNECTION_OK) {
+        spdlog::error("[{}] could not connect to database: {}", __FUNCTION__, PQerrorMessage(connection));
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    try {
+        auto counts = generate_synthetic_data(connection, generator_config);
+        auto seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        spdlog::info("[{}] generated {} rows with seed {} in {:.2f} s, {:.0f} rows/min", __FUNCTION__, counts.total(), generator_config.seed, seconds, counts.total() / seconds * 60);
+    } catch (const exception& e) {
+        spdlog::error("[{}] generating failed, nothing was committed: {}", __FUNCTION__, e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,401 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "synthetic_data.h"
+#include "binary_copy.h"
+#include <array>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <numbers>
+#include <pcg_random.hpp>
+#include <spdlog/spdlog.h>
+#include <sodium.h>
+#include <fmt/format.h>
+#include <common_components.h>
+
+using namespace ibh;
+
+// The distributions are implemented here instead of using <random>, whose distributions produce different values
+// between standard library implementations and would break reproducing a data set from its seed.
+
+static double unit(pcg64 &rng) {
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+}
+
+static double normal(pcg64 &rng) {
+    auto u1 = 1.0 - unit(rng);
+    auto u2 = unit(rng);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * numbers::pi * u2);
+}
+
+// P(k) proportional to 1 / k^exponent for k in [1, n], used for characters per user and company sizes
+class power_law {
+public:
+    power_law(uint64_t n, double exponent) : _cumulative() {
+        _cumulative.reserve(n);
+        double total = 0;
+        for(uint64_t k = 1; k <= n; k++) {
+            total += 1.0 / pow(static_cast<double>(k), exponent);
+            _cumulative.push_back(total);
+        }
+    }
+
+    // returns a value in [0, n)
+    uint64_t operator()(pcg64 &rng) const {
+        auto it = lower_bound(begin(_cumulative), end(_cumulative), unit(rng) * _cumulative.back());
+        return min(static_cast<uint64_t>(distance(begin(_cumulative), it)), static_cast<uint64_t>(_cumulative.size() - 1));
+    }
+
+private:
+    vector<double> _cumulative;
+};
+
+// every table gets its own stream, so adding rows to one table doesn't change the rows of the others
+enum class stream : uint64_t {
+    characters = 1,
+    character_stats,
+    items,
+    item_stats,
+    companies,
+    members
+};
+
+static pcg64 create_rng(uint64_t seed, stream s, uint64_t index = 0) {
+    return pcg64(seed, (index << 4) | static_cast<uint64_t>(s));
+}
+
+static uint64_t query_uint64(PGconn *connection, string const &query) {
+    auto *result = PQexec(connection, query.c_str());
+    if(PQresultStatus(result) != PGRES_TUPLES_OK) {
+        auto error = fmt::format("query {} failed: {}", query, PQerrorMessage(connection));
+        PQclear(result);
+        throw runtime_error(error);
+    }
+    auto value = PQgetisnull(result, 0, 0) ? 0 : stoull(PQgetvalue(result, 0, 0));
+    PQclear(result);
+    return value;
+}
+
+static void execute(PGconn *connection, string const &query) {
+    auto *result = PQexec(connection, query.c_str());
+    auto status = PQresultStatus(result);
+    PQclear(result);
+    if(status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+        throw runtime_error(fmt::format("query {} failed: {}", query, PQerrorMessage(connection)));
+    }
+}
+
+static uint64_t next_id(PGconn *connection, string const &table) {
+    return query_uint64(connection, fmt::format("SELECT COALESCE(MAX(id), 0) + 1 FROM {}", table));
+}
+
+static void log_table(string const &table, uint64_t rows, chrono::steady_clock::time_point start) {
+    auto seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    spdlog::info("[generate_synthetic_data] {:<28} {:>10} rows {:>8.2f} s {:>12.0f} rows/min", table, rows, seconds, rows / seconds * 60);
+}
+
+static constexpr size_t stat_count = tuple_size_v<remove_cvref_t<decltype(stat_name_ids)>>;
+
+// stat values of a character, derived from its own stream so the row and packed tables agree without keeping them in memory
+static array<int64_t, stat_count> character_stat_values(uint64_t seed, uint64_t character_index, uint16_t level) {
+    auto rng = create_rng(seed, stream::character_stats, character_index);
+    array<int64_t, stat_count> values{};
+    for(auto &value : values) {
+        value = static_cast<int64_t>(level * (1 + rng(5)) + rng(10));
+    }
+    return values;
+}
+
+synthetic_data_counts ibh::generate_synthetic_data(PGconn *connection, synthetic_data_config const &config) {
+    static constexpr array<string_view, 5> races = {"Human", "Dwarf", "Gnome", "Elf", "High Elf"};
+    static constexpr array<string_view, 3> classes = {"Warrior", "Mage", "Thief"};
+    synthetic_data_counts counts{};
+
+    if(config.max_characters_per_user == 0 || config.max_characters_per_user > 5) {
+        throw runtime_error("max characters per user has to be between 1 and 5");
+    }
+
+    if(config.password.size() < 8) {
+        throw runtime_error("password needs to be at least 8 characters");
+    }
+
+    // hashed once the same way handle_register does, argon2 is far too slow to hash per user
+    char hashed_password[crypto_pwhash_STRBYTES];
+    if(crypto_pwhash_str(hashed_password, config.password.c_str(), config.password.length(), crypto_pwhash_argon2id_OPSLIMIT_SENSITIVE,
+                         crypto_pwhash_argon2id_MEMLIMIT_INTERACTIVE) != 0) {
+        throw runtime_error("could not hash password, out of memory?");
+    }
+
+    execute(connection, "BEGIN");
+
+    auto first_user = next_id(connection, "users");
+    auto first_character = next_id(connection, "characters");
+    auto first_character_stat = next_id(connection, "character_stats");
+    auto first_item = next_id(connection, "items");
+    auto first_item_stat = next_id(connection, "item_stats");
+    auto first_company = next_id(connection, "companies");
+    auto first_company_stat = next_id(connection, "company_stats");
+
+    auto start = chrono::steady_clock::now();
+    {
+        binary_copy copy(connection, "users", {"id", "username", "password", "email", "login_attempts", "max_characters", "subscription_tier", "is_tester", "is_game_master"});
+        for(uint64_t i = 0; i < config.users; i++) {
+            auto id = first_user + i;
+            copy.start_row();
+            copy.add_int64(static_cast<int64_t>(id));
+            copy.add_text(fmt::format("generated_user_{}", id));
+            copy.add_text(hashed_password);
+            copy.add_text(fmt::format("generated_user_{}@example.com", id));
+            copy.add_int16(0);
+            copy.add_int16(static_cast<int16_t>(config.max_characters_per_user));
+            copy.add_int16(0);
+            copy.add_int16(0);
+            copy.add_int16(0);
+        }
+        counts.users = copy.complete();
+        log_table("users", counts.users, start);
+    }
+
+    // most players have a single character, few fill every slot
+    vector<uint16_t> levels;
+    levels.reserve(config.users * config.max_characters_per_user);
+    start = chrono::steady_clock::now();
+    {
+        power_law characters_per_user(config.max_characters_per_user, 2.0);
+        auto rng = create_rng(config.seed, stream::characters);
+        binary_copy copy(connection, "characters", {"id", "user_id", "slot", "level", "gold", "xp", "skill_points", "character_name", "race", "class", "x", "y", "map"});
+        for(uint64_t i = 0; i < config.users; i++) {
+            auto characters = characters_per_user(rng) + 1;
+            for(uint64_t slot = 0; slot < characters; slot++) {
+                auto id = first_character + levels.size();
+                // levels fall off exponentially, gold is log-normal like most in-game currencies
+                auto level = static_cast<uint16_t>(1 + min(99.0, floor(-log(1.0 - unit(rng)) * 12.0)));
+                auto gold = static_cast<int64_t>(exp(7.0 + 1.5 * normal(rng)));
+                levels.push_back(level);
+
+                copy.start_row();
+                copy.add_int64(static_cast<int64_t>(id));
+                copy.add_int64(static_cast<int64_t>(first_user + i));
+                copy.add_int32(static_cast<int32_t>(slot));
+                copy.add_int64(level);
+                copy.add_int64(gold);
+                copy.add_int64(static_cast<int64_t>(level * level * 100 + rng(level * 100)));
+                copy.add_int64(static_cast<int64_t>(rng(level)));
+                copy.add_text(fmt::format("generated_character_{}", id));
+                copy.add_text(races[rng(races.size())]);
+                copy.add_text(classes[rng(classes.size())]);
+                copy.add_int32(0);
+                copy.add_int32(0);
+                copy.add_text("");
+            }
+        }
+        counts.characters = copy.complete();
+        log_table("characters", counts.characters, start);
+    }
+
+    start = chrono::steady_clock::now();
+    {
+        binary_copy copy(connection, "character_stats", {"id", "character_id", "stat_id", "value"});
+        auto id = first_character_stat;
+        for(uint64_t i = 0; i < levels.size(); i++) {
+            auto values = character_stat_values(config.seed, i, levels[i]);
+            for(uint32_t stat = 0; stat < stat_name_ids.size(); stat++) {
+                copy.start_row();
+                copy.add_int64(static_cast<int64_t>(id++));
+                copy.add_int64(static_cast<int64_t>(first_character + i));
+                copy.add_int64(stat_name_ids[stat]);
+                copy.add_int64(values[stat]);
+            }
+        }
+        counts.character_stats = copy.complete();
+        log_table("character_stats", counts.character_stats, start);
+    }
+
+    if(config.packed_stats) {
+        start = chrono::steady_clock::now();
+        binary_copy copy(connection, "character_stats_packed", {"character_id", "stats"});
+        array<int64_t, stat_count * 2> packed{};
+        for(uint64_t i = 0; i < levels.size(); i++) {
+            auto values = character_stat_values(config.seed, i, levels[i]);
+            for(uint32_t stat = 0; stat < stat_name_ids.size(); stat++) {
+                packed[stat * 2] = stat_name_ids[stat];
+                packed[stat * 2 + 1] = values[stat];
+            }
+            copy.start_row();
+            copy.add_int64(static_cast<int64_t>(first_character + i));
+            copy.add_int64_array(packed);
+        }
+        counts.packed_character_stats = copy.complete();
+        log_table("character_stats_packed", counts.packed_character_stats, start);
+    }
+
+    // higher level characters carry more items
+    vector<uint8_t> item_stat_counts;
+    start = chrono::steady_clock::now();
+    {
+        auto rng = create_rng(config.seed, stream::items);
+        binary_copy copy(connection, "items", {"id", "character_id", "item_name", "item_slot", "equip_slot"});
+        for(uint64_t i = 0; i < levels.size(); i++) {
+            auto max_items = max<uint64_t>(1, config.max_items_per_character * levels[i] / 100);
+            auto items = config.max_items_per_character == 0 ? 0 : rng(max_items + 1);
+            for(uint64_t item = 0; item < items; item++) {
+                auto id = first_item + item_stat_counts.size();
+                auto const &slot = slot_names[rng(slot_names.size())];
+                item_stat_counts.push_back(static_cast<uint8_t>(1 + rng(4)));
+
+                copy.start_row();
+                copy.add_int64(static_cast<int64_t>(id));
+                copy.add_int64(static_cast<int64_t>(first_character + i));
+                copy.add_text(fmt::format("generated_{}_{}", slot, id));
+                copy.add_text(slot);
+                copy.add_text(rng(2) == 0 ? slot : "");
+            }
+        }
+        counts.items = copy.complete();
+        log_table("items", counts.items, start);
+    }
+
+    start = chrono::steady_clock::now();
+    {
+        auto rng = create_rng(config.seed, stream::item_stats);
+        binary_copy copy(connection, "item_stats", {"id", "item_id", "stat_id", "value"});
+        auto id = first_item_stat;
+        for(uint64_t i = 0; i < item_stat_counts.size(); i++) {
+            auto first_stat = rng(stat_name_ids.size());
+            for(uint64_t stat = 0; stat < item_stat_counts[i]; stat++) {
+                copy.start_row();
+                copy.add_int64(static_cast<int64_t>(id++));
+                copy.add_int64(static_cast<int64_t>(first_item + i));
+                copy.add_int64(stat_name_ids[(first_stat + stat) % stat_name_ids.size()]);
+                copy.add_int64(static_cast<int64_t>(1 + rng(20)));
+            }
+        }
+        counts.item_stats = copy.complete();
+        log_table("item_stats", counts.item_stats, start);
+    }
+
+    if(config.companies > 0) {
+        start = chrono::steady_clock::now();
+        {
+            auto rng = create_rng(config.seed, stream::companies);
+            binary_copy copy(connection, "companies", {"id", "name", "no_of_shares", "company_type"});
+            for(uint64_t i = 0; i < config.companies; i++) {
+                auto id = first_company + i;
+                copy.start_row();
+                copy.add_int64(static_cast<int64_t>(id));
+                copy.add_text(fmt::format("generated_company_{}", id));
+                copy.add_int64(static_cast<int64_t>(1'000 * (1 + rng(100))));
+                copy.add_int16(static_cast<int16_t>(rng(2)));
+            }
+            counts.companies = copy.complete();
+        }
+        {
+            auto rng = create_rng(config.seed, stream::companies, 1);
+            binary_copy copy(connection, "company_stats", {"id", "company_id", "stat_id", "value"});
+            auto id = first_company_stat;
+            for(uint64_t i = 0; i < config.companies; i++) {
+                for(auto stat_id : company_stat_name_ids) {
+                    copy.start_row();
+                    copy.add_int64(static_cast<int64_t>(id++));
+                    copy.add_int64(static_cast<int64_t>(first_company + i));
+                    copy.add_int64(stat_id);
+                    copy.add_int64(static_cast<int64_t>(rng(50)));
+                }
+            }
+            counts.company_stats = copy.complete();
+        }
+        log_table("companies", counts.companies + counts.company_stats, start);
+
+        // company sizes follow Zipf's law, a handful of big companies and a long tail of small ones. The first member
+        // of a company becomes its admin.
+        power_law company_rank(config.companies, 1.1);
+        vector<bool> has_admin(config.companies);
+        vector<bool> is_member(levels.size());
+        start = chrono::steady_clock::now();
+        {
+            auto rng = create_rng(config.seed, stream::members);
+            binary_copy copy(connection, "company_members", {"company_id", "character_id", "member_level", "wage"});
+            for(uint64_t i = 0; i < levels.size(); i++) {
+                if(unit(rng) >= config.member_ratio) {
+                    continue;
+                }
+
+                auto company = company_rank(rng);
+                auto level = company_member_level::COMPANY_MEMBER;
+                if(!has_admin[company]) {
+                    has_admin[company] = true;
+                    level = company_member_level::COMPANY_ADMIN;
+                } else if(rng(20) == 0) {
+                    level = company_member_level::COMPANY_SAGE;
+                }
+                is_member[i] = true;
+
+                copy.start_row();
+                copy.add_int64(static_cast<int64_t>(first_company + company));
+                copy.add_int64(static_cast<int64_t>(first_character + i));
+                copy.add_int16(static_cast<int16_t>(level));
+                copy.add_int64(static_cast<int64_t>(rng(100)));
+            }
+            counts.company_members = copy.complete();
+            log_table("company_members", counts.company_members, start);
+        }
+
+        start = chrono::steady_clock::now();
+        {
+            auto rng = create_rng(config.seed, stream::members, 1);
+            binary_copy copy(connection, "company_member_applications", {"company_id", "character_id"});
+            for(uint64_t i = 0; i < levels.size(); i++) {
+                if(is_member[i] || unit(rng) >= config.applicant_ratio) {
+                    continue;
+                }
+
+                array<uint64_t, 3> applied_to{};
+                auto applications = 1 + rng(applied_to.size());
+                for(uint64_t application = 0; application < applications; application++) {
+                    applied_to[application] = company_rank(rng);
+                    if(find(begin(applied_to), begin(applied_to) + application, applied_to[application]) != begin(applied_to) + application) {
+                        continue;
+                    }
+
+                    copy.start_row();
+                    copy.add_int64(static_cast<int64_t>(first_company + applied_to[application]));
+                    copy.add_int64(static_cast<int64_t>(first_character + i));
+                }
+            }
+            counts.company_member_applications = copy.complete();
+            log_table("company_member_applications", counts.company_member_applications, start);
+        }
+    }
+
+    // the server inserts through the sequences, move them past the generated ids
+    for(auto const &table : {"users", "characters", "character_stats", "items", "item_stats", "companies", "company_stats"}) {
+        execute(connection, fmt::format("SELECT setval(pg_get_serial_sequence('{0}', 'id'), (SELECT MAX(id) FROM {0}))", table));
+    }
+
+    execute(connection, "COMMIT");
+
+    for(auto const &table : {"users", "characters", "character_stats", "character_stats_packed", "items", "item_stats", "companies", "company_stats", "company_members", "company_member_applications"}) {
+        execute(connection, fmt::format("ANALYZE {}", table));
+    }
+
+    return counts;
+}
@@ -0,0 +1,64 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <libpq-fe.h>
+
+using namespace std;
+
+namespace ibh {
+    struct synthetic_data_config {
+        uint64_t seed;
+        uint64_t users;
+        uint32_t max_characters_per_user;
+        uint32_t max_items_per_character;
+        uint64_t companies;
+        double member_ratio;
+        double applicant_ratio;
+        bool packed_stats;
+        // every generated user can log in with this password
+        string password;
+    };
+
+    struct synthetic_data_counts {
+        uint64_t users;
+        uint64_t characters;
+        uint64_t character_stats;
+        uint64_t packed_character_stats;
+        uint64_t items;
+        uint64_t item_stats;
+        uint64_t companies;
+        uint64_t company_stats;
+        uint64_t company_members;
+        uint64_t company_member_applications;
+
+        [[nodiscard]] uint64_t total() const noexcept {
+            return users + characters + character_stats + packed_character_stats + items + item_stats + companies + company_stats + company_members + company_member_applications;
+        }
+    };
+
+    // Generates users, characters with stats and items, companies with stats, members and applications in one transaction.
+    // Ids continue after the highest existing id, so it can be run against a database that is in use. Against an empty schema
+    // the same seed and config always produce the same rows independent of the platform, apart from the random salt of the
+    // password hash. Otherwise the rows only match up to their ids.
+    synthetic_data_counts generate_synthetic_data(PGconn *connection, synthetic_data_config const &config);
+}
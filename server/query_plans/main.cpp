@@ -0,0 +1,587 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <spdlog/spdlog.h>
+#include <fstream>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <map>
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "../src/config.h"
+#include "../src/config_parsers.h"
+#include "../src/working_directory_manipulation.h"
+#include "../src/database/database_pool.h"
+#include "../src/database/database_transaction.h"
+#include <repositories/users_repository.h>
+#include <repositories/banned_users_repository.h>
+#include <repositories/characters_repository.h>
+#include <repositories/character_stats_repository.h>
+#include <repositories/packed_character_stats_repository.h>
+#include <repositories/items_repository.h>
+#include <repositories/item_stats_repository.h>
+#include <repositories/companies_repository.h>
+#include <repositories/company_stats_repository.h>
+#include <repositories/company_members_repository.h>
+#include <repositories/company_member_applications_repository.h>
+#include <common_components.h>
+#include <macros.h>
+#include <on_leaving_scope.h>
+
+// Seeds a production sized data set inside a transaction that is never committed, runs the repository read and update paths
+// against it and fails when EXPLAIN shows a sequential scan over a large table or when a query touches considerably more
+// buffers than in the stored baseline. Buffers are compared instead of timings, as they barely vary between machines and runs.
+
+using namespace std;
+using namespace ibh;
+
+struct seed_sizes {
+    uint64_t users;
+    uint64_t characters_per_user;
+    uint64_t items_per_character;
+    uint64_t item_stats_per_item;
+    uint64_t companies;
+    uint64_t banned_users;
+};
+
+struct seed_ids {
+    uint64_t first_user;
+    uint64_t first_character;
+    uint64_t first_item;
+    uint64_t first_company;
+    uint64_t characters;
+    uint64_t items;
+};
+
+struct plan_check {
+    string name;
+    bool allow_seq_scan;
+    function<void(unique_ptr<database_transaction> const &)> run;
+};
+
+struct plan_result {
+    string key;
+    string query;
+    bool allow_seq_scan;
+    uint64_t seq_scanned_rows;
+    string seq_scanned_relation;
+    uint64_t buffers;
+    double execution_ms;
+};
+
+uint64_t next_id(unique_ptr<database_transaction> const &transaction, string const &table) {
+    auto result = transaction->execute(fmt::format("SELECT COALESCE(MAX(id), 0) + 1 AS id FROM {}", table));
+    return result[0]["id"].as(uint64_t{});
+}
+
+seed_ids seed(unique_ptr<database_transaction> const &transaction, seed_sizes const &sizes) {
+    MEASURE_TIME(info, "seed");
+    auto seed_start = chrono::steady_clock::now();
+    mt19937_64 rng(1234);
+    uniform_int_distribution<int64_t> value_dist(0, 1'000);
+    uint64_t rows = 0;
+
+    seed_ids ids{};
+    ids.first_user = next_id(transaction, "users");
+    ids.first_character = next_id(transaction, "characters");
+    ids.first_item = next_id(transaction, "items");
+    ids.first_company = next_id(transaction, "companies");
+    ids.characters = sizes.users * sizes.characters_per_user;
+    ids.items = ids.characters * sizes.items_per_character;
+    auto first_character_stat = next_id(transaction, "character_stats");
+    auto first_item_stat = next_id(transaction, "item_stats");
+    auto first_company_stat = next_id(transaction, "company_stats");
+    auto first_banned_user = next_id(transaction, "banned_users");
+
+    {
+        auto stream = transaction->create_copy_stream("users", {"id", "username", "password", "email", "login_attempts", "max_characters", "subscription_tier", "is_tester", "is_game_master"});
+        for(uint64_t i = 0; i < sizes.users; i++) {
+            auto id = ids.first_user + i;
+            *stream << make_tuple(id, fmt::format("qp_user_{}", id), "not_a_hash"s, fmt::format("qp_user_{}@example.com", id), 0, 4, 0, 0, 0);
+        }
+        stream->complete();
+        rows += sizes.users;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("banned_users", {"id", "ip", "user_id", "until"});
+        // until is stored in system_clock ticks, see banned_users_repository
+        auto until = (chrono::system_clock::now() + chrono::hours(1)).time_since_epoch().count();
+        for(uint64_t i = 0; i < sizes.banned_users; i++) {
+            *stream << make_tuple(first_banned_user + i, fmt::format("10.0.{}.{}", i / 256 % 256, i % 256), ids.first_user + i * 97 % sizes.users, until);
+        }
+        stream->complete();
+        rows += sizes.banned_users;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("characters", {"id", "user_id", "slot", "level", "gold", "xp", "skill_points", "character_name", "race", "class", "x", "y", "map"});
+        for(uint64_t i = 0; i < ids.characters; i++) {
+            auto id = ids.first_character + i;
+            *stream << make_tuple(id, ids.first_user + i / sizes.characters_per_user, i % sizes.characters_per_user, 1 + value_dist(rng) % 50, value_dist(rng), value_dist(rng), 0,
+                                  fmt::format("qp_character_{}", id), "human"s, "warrior"s, 0, 0, "test"s);
+        }
+        stream->complete();
+        rows += ids.characters;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("character_stats", {"id", "character_id", "stat_id", "value"});
+        auto packed_stream_rows = vector<string>();
+        packed_stream_rows.reserve(ids.characters);
+        uint64_t id = first_character_stat;
+        for(uint64_t i = 0; i < ids.characters; i++) {
+            string packed = "{";
+            for(auto stat_id : stat_name_ids) {
+                auto value = value_dist(rng);
+                *stream << make_tuple(id++, ids.first_character + i, stat_id, value);
+                packed += fmt::format("{}{},{}", packed.size() > 1 ? "," : "", stat_id, value);
+            }
+            packed += "}";
+            packed_stream_rows.push_back(move(packed));
+        }
+        stream->complete();
+        rows += id - first_character_stat;
+
+        auto packed_stream = transaction->create_copy_stream("character_stats_packed", {"character_id", "stats"});
+        for(uint64_t i = 0; i < ids.characters; i++) {
+            *packed_stream << make_tuple(ids.first_character + i, packed_stream_rows[i]);
+        }
+        packed_stream->complete();
+        rows += ids.characters;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("items", {"id", "character_id", "item_name", "item_slot", "equip_slot"});
+        for(uint64_t i = 0; i < ids.items; i++) {
+            auto id = ids.first_item + i;
+            *stream << make_tuple(id, ids.first_character + i / sizes.items_per_character, fmt::format("qp_item_{}", id), "inventory"s, ""s);
+        }
+        stream->complete();
+        rows += ids.items;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("item_stats", {"id", "item_id", "stat_id", "value"});
+        uint64_t id = first_item_stat;
+        for(uint64_t i = 0; i < ids.items; i++) {
+            for(uint64_t j = 0; j < sizes.item_stats_per_item; j++) {
+                *stream << make_tuple(id++, ids.first_item + i, stat_name_ids[(i + j) % stat_name_ids.size()], value_dist(rng));
+            }
+        }
+        stream->complete();
+        rows += id - first_item_stat;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("companies", {"id", "name", "no_of_shares", "company_type"});
+        for(uint64_t i = 0; i < sizes.companies; i++) {
+            auto id = ids.first_company + i;
+            *stream << make_tuple(id, fmt::format("qp_company_{}", id), 1'000, i % 3);
+        }
+        stream->complete();
+        rows += sizes.companies;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("company_stats", {"id", "company_id", "stat_id", "value"});
+        uint64_t id = first_company_stat;
+        for(uint64_t i = 0; i < sizes.companies; i++) {
+            for(auto stat_id : company_stat_name_ids) {
+                *stream << make_tuple(id++, ids.first_company + i, stat_id, value_dist(rng));
+            }
+        }
+        stream->complete();
+        rows += id - first_company_stat;
+    }
+
+    // every even character is a member of a company, every odd character applied to one
+    {
+        auto stream = transaction->create_copy_stream("company_members", {"company_id", "character_id", "member_level", "wage"});
+        for(uint64_t i = 0; i < ids.characters; i += 2) {
+            *stream << make_tuple(ids.first_company + i / 2 % sizes.companies, ids.first_character + i, i / 2 < sizes.companies ? 2 : 0, 0);
+        }
+        stream->complete();
+        rows += ids.characters / 2;
+    }
+
+    {
+        auto stream = transaction->create_copy_stream("company_member_applications", {"company_id", "character_id"});
+        for(uint64_t i = 1; i < ids.characters; i += 2) {
+            *stream << make_tuple(ids.first_company + i * 7'919 % sizes.companies, ids.first_character + i);
+        }
+        stream->complete();
+        rows += ids.characters / 2;
+    }
+
+    for(auto const &table : {"users", "banned_users", "characters", "character_stats", "character_stats_packed", "items", "item_stats", "companies", "company_stats", "company_members", "company_member_applications"}) {
+        transaction->execute(fmt::format("ANALYZE {}", table));
+    }
+
+    auto seconds = chrono::duration<double>(chrono::steady_clock::now() - seed_start).count();
+    spdlog::info("[{}] seeded {} rows, {:.0f} rows/s", __FUNCTION__, rows, rows / seconds);
+
+    return ids;
+}
+
+vector<plan_check> create_checks(seed_ids const &ids) {
+    vector<plan_check> checks;
+    auto user_id = ids.first_user + (ids.characters / 4);
+    auto character_id = ids.first_character + ids.characters / 2;
+    auto item_id = ids.first_item + ids.items / 2;
+    auto company_id = ids.first_company + 1;
+    vector<uint64_t> character_ids(500);
+    iota(begin(character_ids), end(character_ids), character_id);
+    vector<uint64_t> item_ids(500);
+    iota(begin(item_ids), end(item_ids), item_id);
+
+    checks.push_back({"users_get_by_id", false, [=](auto const &transaction) {
+        users_repository<database_transaction> repo{};
+        (void)repo.get(static_cast<int>(user_id), transaction);
+    }});
+    checks.push_back({"users_get_by_username", false, [=](auto const &transaction) {
+        users_repository<database_transaction> repo{};
+        (void)repo.get(fmt::format("qp_user_{}", user_id), transaction);
+    }});
+    // banned_users stays small enough that scanning it is cheaper than keeping an index up to date
+    checks.push_back({"banned_users_is_banned", true, [=](auto const &transaction) {
+        banned_users_repository<database_transaction> repo{};
+        (void)repo.is_username_or_ip_banned(fmt::format("qp_user_{}", user_id), "10.0.0.1"s, transaction);
+    }});
+    checks.push_back({"characters_get_by_id", false, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_character(character_id, transaction);
+    }});
+    checks.push_back({"characters_get_by_name", false, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_character(fmt::format("qp_character_{}", character_id), user_id, transaction);
+    }});
+    checks.push_back({"characters_get_by_slot", false, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_character_by_slot(0, user_id, transaction);
+    }});
+    checks.push_back({"characters_get_by_ids", false, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_characters(character_ids, transaction);
+    }});
+    checks.push_back({"characters_get_by_user_id", false, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_by_user_id(user_id, transaction);
+    }});
+    checks.push_back({"characters_get_summaries_by_user_id", false, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_summaries_by_user_id(user_id, transaction);
+    }});
+    checks.push_back({"character_stats_get_by_character_id", false, [=](auto const &transaction) {
+        character_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_character_id(character_id, transaction);
+    }});
+    checks.push_back({"character_stats_get_by_character_ids", false, [=](auto const &transaction) {
+        character_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_character_ids(character_ids, transaction);
+    }});
+    checks.push_back({"character_stats_update_by_stat_id", false, [=](auto const &transaction) {
+        character_stats_repository<database_transaction> repo{};
+        repo.update_by_stat_id(db_character_stat{0, character_id, stat_name_ids[0], 5}, transaction);
+    }});
+    checks.push_back({"packed_character_stats_get_by_character_ids", false, [=](auto const &transaction) {
+        packed_character_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_character_ids(character_ids, transaction);
+    }});
+    checks.push_back({"items_get_by_character_id", false, [=](auto const &transaction) {
+        items_repository<database_transaction> repo{};
+        (void)repo.get_by_character_id(character_id, transaction);
+    }});
+    checks.push_back({"items_get_by_character_ids", false, [=](auto const &transaction) {
+        items_repository<database_transaction> repo{};
+        (void)repo.get_by_character_ids(character_ids, transaction);
+    }});
+    checks.push_back({"item_stats_get_by_item_id", false, [=](auto const &transaction) {
+        item_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_item_id(item_id, transaction);
+    }});
+    checks.push_back({"item_stats_get_by_item_ids", false, [=](auto const &transaction) {
+        item_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_item_ids(item_ids, transaction);
+    }});
+    checks.push_back({"companies_get_by_id", false, [=](auto const &transaction) {
+        companies_repository<database_transaction> repo{};
+        (void)repo.get(static_cast<int>(company_id), transaction);
+    }});
+    checks.push_back({"companies_get_by_name", false, [=](auto const &transaction) {
+        companies_repository<database_transaction> repo{};
+        (void)repo.get(fmt::format("qp_company_{}", company_id), transaction);
+    }});
+    // loading everything is expected to scan, these only run at startup
+    checks.push_back({"companies_get_listing", true, [=](auto const &transaction) {
+        companies_repository<database_transaction> repo{};
+        (void)repo.get_listing(transaction);
+    }});
+    checks.push_back({"characters_get_all_ids", true, [=](auto const &transaction) {
+        characters_repository<database_transaction> repo{};
+        (void)repo.get_all_ids(transaction);
+    }});
+    checks.push_back({"company_stats_get_by_company_id", false, [=](auto const &transaction) {
+        company_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_company_id(company_id, transaction);
+    }});
+    checks.push_back({"company_stats_get_by_stat", false, [=](auto const &transaction) {
+        company_stats_repository<database_transaction> repo{};
+        (void)repo.get_by_stat(company_id, company_stat_name_ids[0], transaction);
+    }});
+    checks.push_back({"company_stats_update_by_stat_id", false, [=](auto const &transaction) {
+        company_stats_repository<database_transaction> repo{};
+        repo.update_by_stat_id(db_company_stat{0, company_id, company_stat_name_ids[0], 5}, transaction);
+    }});
+    checks.push_back({"company_members_get", false, [=](auto const &transaction) {
+        company_members_repository<database_transaction> repo{};
+        (void)repo.get(company_id, character_id, transaction);
+    }});
+    checks.push_back({"company_members_get_by_company_id", false, [=](auto const &transaction) {
+        company_members_repository<database_transaction> repo{};
+        (void)repo.get_by_company_id(company_id, transaction);
+    }});
+    checks.push_back({"company_members_get_by_character_id", false, [=](auto const &transaction) {
+        company_members_repository<database_transaction> repo{};
+        (void)repo.get_by_character_id(character_id, transaction);
+    }});
+    checks.push_back({"company_member_applications_get", false, [=](auto const &transaction) {
+        company_member_applications_repository<database_transaction> repo{};
+        (void)repo.get(company_id, character_id + 1, transaction);
+    }});
+    checks.push_back({"company_member_applications_get_by_company_id", false, [=](auto const &transaction) {
+        company_member_applications_repository<database_transaction> repo{};
+        (void)repo.get_by_company_id(company_id, transaction);
+    }});
+    checks.push_back({"company_member_applications_get_by_character_id", false, [=](auto const &transaction) {
+        company_member_applications_repository<database_transaction> repo{};
+        (void)repo.get_by_character_id(character_id + 1, transaction);
+    }});
+
+    return checks;
+}
+
+void walk_plan(rapidjson::Value const &plan, plan_result &result) {
+    if(string_view(plan["Node Type"].GetString()) == "Seq Scan") {
+        auto rows = plan["Actual Rows"].GetDouble();
+        if(plan.HasMember("Rows Removed by Filter")) {
+            rows += plan["Rows Removed by Filter"].GetDouble();
+        }
+        auto scanned = static_cast<uint64_t>(rows * plan["Actual Loops"].GetDouble());
+        if(scanned >= result.seq_scanned_rows) {
+            result.seq_scanned_rows = scanned;
+            result.seq_scanned_relation = plan["Relation Name"].GetString();
+        }
+    }
+
+    if(plan.HasMember("Plans")) {
+        for(auto const &child : plan["Plans"].GetArray()) {
+            walk_plan(child, result);
+        }
+    }
+}
+
+// checks that throw, queries that can't be explained and plans that can't be parsed end up in failures instead of results
+vector<plan_result> explain_checks(unique_ptr<database_transaction> const &transaction, vector<plan_check> const &checks, vector<string> &failures) {
+    vector<plan_result> results;
+
+    for(auto const &check : checks) {
+        vector<string> queries;
+        transaction->set_query_log(&queries);
+        try {
+            check.run(transaction);
+        } catch (exception const &e) {
+            failures.push_back(fmt::format("check {} threw {}", check.name, e.what()));
+        }
+        transaction->set_query_log(nullptr);
+
+        if(queries.empty()) {
+            failures.push_back(fmt::format("check {} ran no queries", check.name));
+            continue;
+        }
+
+        for(uint32_t i = 0; i < queries.size(); i++) {
+            plan_result result{fmt::format("{}#{}", check.name, i), queries[i], check.allow_seq_scan, 0, {}, 0, 0.0};
+
+            // ANALYZE executes the query, so updates are run in a subtransaction that gets rolled back
+            auto subtransaction = transaction->create_subtransaction();
+            pqxx::result explain_result;
+            try {
+                explain_result = subtransaction->execute(fmt::format("EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) {}", queries[i]));
+            } catch (exception const &e) {
+                failures.push_back(fmt::format("could not explain {}: {}", result.key, e.what()));
+                continue;
+            }
+
+            auto json = explain_result[0][0].as(string{});
+            rapidjson::Document d;
+            d.Parse(json.c_str(), json.size());
+            if(d.HasParseError() || !d.IsArray() || d.Size() == 0 || !d[0u].IsObject() || !d[0u].HasMember("Plan") || !d[0u].HasMember("Execution Time")) {
+                failures.push_back(fmt::format("could not parse plan of {}", result.key));
+                continue;
+            }
+
+            auto const &explain = d[0u];
+            auto const &plan = explain["Plan"];
+            walk_plan(plan, result);
+            result.buffers = plan["Shared Hit Blocks"].GetUint64() + plan["Shared Read Blocks"].GetUint64();
+            result.execution_ms = explain["Execution Time"].GetDouble();
+            results.push_back(move(result));
+        }
+    }
+
+    return results;
+}
+
+map<string, uint64_t> load_baseline(string const &path) {
+    map<string, uint64_t> baseline;
+    ifstream file(path);
+    if(!file) {
+        spdlog::info("[{}] no baseline at {}, only checking for sequential scans", __FUNCTION__, path);
+        return baseline;
+    }
+
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    rapidjson::Document d;
+    d.Parse(contents.c_str(), contents.size());
+    if(d.HasParseError() || !d.IsObject()) {
+        spdlog::error("[{}] baseline {} is malformed json", __FUNCTION__, path);
+        return baseline;
+    }
+
+    for(auto it = d.MemberBegin(); it != d.MemberEnd(); ++it) {
+        baseline.emplace(it->name.GetString(), it->value.GetUint64());
+    }
+
+    return baseline;
+}
+
+void write_baseline(string const &path, vector<plan_result> const &results) {
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+    writer.StartObject();
+    for(auto const &result : results) {
+        writer.Key(result.key.c_str(), result.key.size());
+        writer.Uint64(result.buffers);
+    }
+    writer.EndObject();
+
+    ofstream file(path, ios::trunc);
+    file << sb.GetString();
+    spdlog::info("[{}] wrote baseline of {} queries to {}", __FUNCTION__, results.size(), path);
+}
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+    spdlog::set_pattern("[%C-%m-%d %H:%M:%S.%e] [%L] %v");
+    set_cwd(get_selfpath());
+
+    double scale = 1.0;
+    string baseline_path = "query_plans_baseline.json";
+    bool update_baseline = false;
+    double max_buffer_ratio = 1.5;
+    uint64_t max_seq_scan_rows = 1'000;
+
+    for(int i = 1; i < argc; i++) {
+        string_view arg = argv[i];
+        if(arg == "--write-baseline") {
+            update_baseline = true;
+        } else if(i + 1 < argc && arg == "--scale") {
+            scale = stod(argv[++i]);
+        } else if(i + 1 < argc && arg == "--baseline") {
+            baseline_path = argv[++i];
+        } else if(i + 1 < argc && arg == "--max-buffer-ratio") {
+            max_buffer_ratio = stod(argv[++i]);
+        } else if(i + 1 < argc && arg == "--max-seq-scan-rows") {
+            max_seq_scan_rows = stoull(argv[++i]);
+        } else {
+            spdlog::error("[{}] usage: {} [--scale 1.0] [--baseline file] [--write-baseline] [--max-buffer-ratio 1.5] [--max-seq-scan-rows 1000]", __FUNCTION__, argv[0]);
+            return 1;
+        }
+    }
+
+    config config;
+    try {
+        auto config_opt = parse_env_file();
+        if(!config_opt) {
+            return 1;
+        }
+        config = config_opt.value();
+    } catch (const exception& e) {
+        spdlog::error("[{}] config.json file is malformed json.", __FUNCTION__);
+        return 1;
+    }
+    auto db_pool = make_shared<database_pool>();
+    db_pool->create_connections(config.connection_string, 1);
+    fill_mappers();
+
+    seed_sizes sizes{static_cast<uint64_t>(100'000 * scale), 2, 2, 3, max(static_cast<uint64_t>(10'000 * scale), uint64_t{1}), static_cast<uint64_t>(1'000 * scale)};
+    if(sizes.users == 0) {
+        spdlog::error("[{}] scale {} is too small", __FUNCTION__, scale);
+        return 1;
+    }
+
+    // never committed, the seeded rows disappear when the transaction goes out of scope
+    auto transaction = db_pool->create_transaction();
+    auto ids = seed(transaction, sizes);
+    vector<string> failures;
+    auto results = explain_checks(transaction, create_checks(ids), failures);
+
+    // a baseline missing queries would let them regress unnoticed, so none is written when anything went unchecked
+    for(auto const &failure : failures) {
+        spdlog::error("[{}] {}", __FUNCTION__, failure);
+    }
+    if(!failures.empty()) {
+        spdlog::error("[{}] {} failures while explaining queries", __FUNCTION__, failures.size());
+        return 1;
+    }
+
+    if(update_baseline) {
+        write_baseline(baseline_path, results);
+        return 0;
+    }
+
+    auto baseline = load_baseline(baseline_path);
+    bool failed = false;
+    for(auto const &result : results) {
+        string problem;
+
+        if(!result.allow_seq_scan && result.seq_scanned_rows > max_seq_scan_rows) {
+            problem = fmt::format("seq scan over {} rows of {}", result.seq_scanned_rows, result.seq_scanned_relation);
+        }
+
+        auto baseline_it = baseline.find(result.key);
+        if(baseline_it != end(baseline) && result.buffers > baseline_it->second * max_buffer_ratio && result.buffers > baseline_it->second + 8) {
+            problem += fmt::format("{}buffers went from {} to {}", problem.empty() ? "" : ", ", baseline_it->second, result.buffers);
+        }
+
+        if(problem.empty()) {
+            spdlog::info("[{}] {:<55} {:>8} buffers {:>9.3f} ms", __FUNCTION__, result.key, result.buffers, result.execution_ms);
+        } else {
+            failed = true;
+            spdlog::error("[{}] {:<55} {} in query {}", __FUNCTION__, result.key, problem, result.query);
+        }
+    }
+
+    return failed ? 1 : 0;
+}
@@ -52,6 +52,12 @@ CREATE TABLE character_stats (
     value BIGINT NOT NULL
 );
 
+-- stat_id, value pairs, see packed_character_stats_repository
+CREATE TABLE character_stats_packed (
+    character_id BIGINT PRIMARY KEY,
+    stats BIGINT[] NOT NULL
+);
+
 CREATE TABLE character_skills (
     id BIGSERIAL PRIMARY KEY,
     character_id BIGINT NOT NULL,
@@ -104,7 +110,8 @@ CREATE TABLE company_stats (
 CREATE TABLE company_members (
     company_id BIGINT NOT NULL,
     character_id BIGINT NOT NULL,
-    member_level SMALLINT NOT NULL
+    member_level SMALLINT NOT NULL,
+    wage BIGINT NOT NULL DEFAULT 0
 );
 
 CREATE TABLE company_member_applications (
@@ -164,6 +171,7 @@ ALTER TABLE banned_users ADD CONSTRAINT "banned_users_user_id_fkey" FOREIGN KEY
 ALTER TABLE boss_stats ADD CONSTRAINT "boss_stats_bosses_id_fkey" FOREIGN KEY (boss_id) REFERENCES bosses(id);
 ALTER TABLE characters ADD CONSTRAINT "characters_users_id_fkey" FOREIGN KEY (user_id) REFERENCES users(id);
 ALTER TABLE character_stats ADD CONSTRAINT "character_stats_characters_id_fkey" FOREIGN KEY (character_id) REFERENCES characters(id);
+ALTER TABLE character_stats_packed ADD CONSTRAINT "character_stats_packed_characters_id_fkey" FOREIGN KEY (character_id) REFERENCES characters(id) ON DELETE CASCADE;
 ALTER TABLE company_members ADD CONSTRAINT "company_members_company_id_fkey" FOREIGN KEY (company_id) REFERENCES companies(id);
 ALTER TABLE company_members ADD CONSTRAINT "company_members_character_id_fkey" FOREIGN KEY (character_id) REFERENCES characters(id);
 ALTER TABLE company_member_applications ADD CONSTRAINT "company_member_applications_company_id_fkey" FOREIGN KEY (company_id) REFERENCES companies(id);
@@ -188,6 +196,9 @@ CREATE INDEX boss_stats_idx ON boss_stats (boss_id, stat_id);
 CREATE INDEX character_stats_idx ON character_stats (character_id, stat_id);
 CREATE INDEX company_stats_idx ON company_stats (company_id, stat_id);
 CREATE INDEX item_stats_idx ON item_stats (item_id, stat_id);
+CREATE INDEX items_character_id_idx ON items (character_id);
+CREATE INDEX company_members_company_id_idx ON company_members (company_id);
+CREATE INDEX company_member_applications_company_id_idx ON company_member_applications (company_id);
 
 INSERT INTO schema_information(file_name, date) VALUES ('init.sql', CURRENT_TIMESTAMP);
 
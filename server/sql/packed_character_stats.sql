@@ -0,0 +1,23 @@
+START TRANSACTION;
+
+-- Migrates character stats from one row per stat in character_stats to one row per character in character_stats_packed.
+-- character_stats is left as is, so that switching back only requires pointing the server at it again.
+
+CREATE TABLE IF NOT EXISTS character_stats_packed (
+    character_id BIGINT PRIMARY KEY,
+    stats BIGINT[] NOT NULL
+);
+
+ALTER TABLE character_stats_packed DROP CONSTRAINT IF EXISTS "character_stats_packed_characters_id_fkey";
+ALTER TABLE character_stats_packed ADD CONSTRAINT "character_stats_packed_characters_id_fkey" FOREIGN KEY (character_id) REFERENCES characters(id) ON DELETE CASCADE;
+
+INSERT INTO character_stats_packed (character_id, stats)
+SELECT cs.character_id, array_agg(p.v ORDER BY cs.stat_id, p.ord)
+FROM character_stats cs
+CROSS JOIN LATERAL (VALUES (1, cs.stat_id), (2, cs.value)) AS p(ord, v)
+GROUP BY cs.character_id
+ON CONFLICT (character_id) DO NOTHING;
+
+INSERT INTO schema_information(file_name, date) VALUES ('packed_character_stats.sql', CURRENT_TIMESTAMP) ON CONFLICT DO NOTHING;
+
+COMMIT;
@@ -0,0 +1,14 @@
+START TRANSACTION;
+
+-- Indexes found missing by ibh_query_plans, and the wage column the company members repository already expects.
+-- characters (user_id) lookups are served by the characters_slot_unique index, which starts with user_id.
+
+ALTER TABLE company_members ADD COLUMN IF NOT EXISTS wage BIGINT NOT NULL DEFAULT 0;
+
+CREATE INDEX IF NOT EXISTS items_character_id_idx ON items (character_id);
+CREATE INDEX IF NOT EXISTS company_members_company_id_idx ON company_members (company_id);
+CREATE INDEX IF NOT EXISTS company_member_applications_company_id_idx ON company_member_applications (company_id);
+
+INSERT INTO schema_information(file_name, date) VALUES ('query_plan_indexes.sql', CURRENT_TIMESTAMP) ON CONFLICT DO NOTHING;
+
+COMMIT;
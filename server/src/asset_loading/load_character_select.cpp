@@ -73,7 +73,7 @@ void read_classes(Value const &class_array, vector<character_class> &classes) {
 
     for(SizeType i = 0; i < class_array.Size(); i++) {
         auto &_class = class_array[i];
-        spdlog::trace("[{}] loading class {}", __FUNCTION__, _class["name"].GetString());
+        SPDLOG_TRACE("[{}] loading class {}", __FUNCTION__, _class["name"].GetString());
 
         vector<stat_component> stat_mods;
         vector<item_object> items;
@@ -103,7 +103,7 @@ void read_races(Value const &race_array, vector<character_race> &races) {
 
     for(SizeType i = 0; i < race_array.Size(); i++) {
         auto &race = race_array[i];
-        spdlog::trace("[{}] loading class {}", __FUNCTION__, race["name"].GetString());
+        SPDLOG_TRACE("[{}] loading class {}", __FUNCTION__, race["name"].GetString());
 
         vector<stat_component> stat_mods;
         for (auto const &stat : stat_names) {
@@ -124,7 +124,7 @@ optional<character_select_response> ibh::load_character_select(string const &fil
     auto env_contents = read_whole_file(file);
 
     if(!env_contents) {
-        spdlog::trace("[{}] couldn't load character select!", __FUNCTION__);
+        SPDLOG_TRACE("[{}] couldn't load character select!", __FUNCTION__);
         return {};
     }
 
@@ -132,7 +132,7 @@ optional<character_select_response> ibh::load_character_select(string const &fil
     d.Parse(env_contents->c_str(), env_contents->size());
 
     if(!d.IsObject() || !d.HasMember("classes") || !d.HasMember("races")) {
-        spdlog::trace("[{}] couldn't load character select!", __FUNCTION__);
+        SPDLOG_TRACE("[{}] couldn't load character select!", __FUNCTION__);
         return {};
     }
 
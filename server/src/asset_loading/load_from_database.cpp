@@ -19,76 +19,116 @@
 #include "load_from_database.h"
 #include "spdlog/spdlog.h"
 
-#include <repositories/item_stats_repository.h>
 #include <repositories/items_repository.h>
 #include <repositories/item_stats_repository.h>
-#include <repositories/users_repository.h>
 #include <repositories/characters_repository.h>
 #include <repositories/character_stats_repository.h>
-#include <repositories/companies_repository.h>
-#include <repositories/company_buildings_repository.h>
-#include <repositories/company_stats_repository.h>
-#include <iterator>
+#include <span>
 #include <ecs/components.h>
 
 using namespace std;
 using namespace ibh;
 
-void ibh::load_from_database(entt::registry &registry, const shared_ptr<database_pool> &db_pool, atomic<bool> const &quit) {
-    item_stats_repository<database_transaction> stat_repo{};
-    items_repository<database_transaction> items_repo{};
-    item_stats_repository<database_transaction> item_stats_repo{};
-    users_repository<database_transaction> user_repo{};
+static void emplace_character(entt::registry &registry, db_character &character) {
+    ibh_flat_map<uint32_t , int64_t> stats;
+    vector<item_component> items;
+
+    for(auto &stat : character.stats) {
+        stats.emplace(stat.stat_id, stat.value);
+    }
+
+    for(auto &item : character.items) {
+        vector<stat_component> item_stats;
+        item_stats.reserve(item.stats.size());
+        for(auto &stat : item.stats) {
+            item_stats.emplace_back(stat.stat_id, stat.value);
+        }
+        items.emplace_back(item.name, "", item.slot, 0, 0, 0, 0, 0, false, false, move(item_stats));
+    }
+
+    SPDLOG_TRACE("[{}] loaded character id {} name {} no. of items {} no. of stats {}", __FUNCTION__, character.id, character.name, items.size(), stats.size());
+    auto new_entity = registry.create();
+    registry.emplace<pc_component>(new_entity, pc_component{character.id, 0, character.name, character.race, "",
+                                                           character._class, "", character.level,
+                                                           character.skill_points, stats,
+                                                           ibh_flat_map<uint32_t, item_component>{}, (items),
+                                                           ibh_flat_map<string, skill_component>{}});
+}
+
+// loads a batch of characters with their stats, items and item stats in four queries, regardless of batch size
+static void load_character_batch(entt::registry &registry, span<uint64_t const> character_ids, unique_ptr<database_transaction> const &transaction) {
     characters_repository<database_transaction> char_repo{};
     character_stats_repository<database_transaction> char_stats_repo{};
-    auto loading_start = chrono::system_clock::now();
+    items_repository<database_transaction> items_repo{};
+    item_stats_repository<database_transaction> item_stats_repo{};
 
-    auto transaction = db_pool->create_transaction();
-    auto users = user_repo.get_all(transaction);
-    vector<db_character> all_characters;
-
-    for(auto &user : users) {
-        auto characters = char_repo.get_by_user_id(user.id, transaction);
-        all_characters.reserve(all_characters.size() + characters.size());
-
-        for(auto &character : characters) {
-            character.stats = char_stats_repo.get_by_character_id(character.id, transaction);
-            character.items = items_repo.get_by_character_id(character.id, transaction);
-            for(auto &item : character.items) {
-                item.stats = item_stats_repo.get_by_item_id(item.id, transaction);
-            }
-        }
+    auto characters = char_repo.get_characters(character_ids, transaction);
+    if(characters.size() != character_ids.size()) {
+        spdlog::warn("[{}] {} characters disappeared while loading", __FUNCTION__, character_ids.size() - characters.size());
+    }
 
-        all_characters.insert(end(all_characters), make_move_iterator(begin(characters)), make_move_iterator(end(characters)));
+    ibh_flat_map<uint64_t, size_t> character_index;
+    character_index.reserve(characters.size());
+    for(size_t i = 0; i < characters.size(); i++) {
+        character_index.emplace(characters[i].id, i);
     }
 
-    for(auto &character : all_characters) {
-        ibh_flat_map<uint32_t , int64_t> stats;
-        vector<item_component> items;
+    for(auto &stat : char_stats_repo.get_by_character_ids(character_ids, transaction)) {
+        auto it = character_index.find(stat.character_id);
+        if(it != end(character_index)) {
+            characters[it->second].stats.push_back(move(stat));
+        }
+    }
 
-        for(auto &stat : character.stats) {
-            stats.emplace(stat.stat_id, stat.value);
+    auto items = items_repo.get_by_character_ids(character_ids, transaction);
+    vector<uint64_t> item_ids;
+    ibh_flat_map<uint64_t, size_t> item_index;
+    item_ids.reserve(items.size());
+    item_index.reserve(items.size());
+    for(size_t i = 0; i < items.size(); i++) {
+        item_ids.push_back(items[i].id);
+        item_index.emplace(items[i].id, i);
+    }
+
+    for(auto &stat : item_stats_repo.get_by_item_ids(item_ids, transaction)) {
+        auto it = item_index.find(stat.item_id);
+        if(it != end(item_index)) {
+            items[it->second].stats.push_back(move(stat));
         }
+    }
 
-        for(auto &item : character.items) {
-            vector<stat_component> item_stats;
-            item_stats.reserve(item.stats.size());
-            for(auto &stat : item.stats) {
-                item_stats.emplace_back(stat.stat_id, stat.value);
-            }
-            items.emplace_back(item.name, "", item.slot, 0, 0, 0, 0, 0, false, false, move(item_stats));
+    for(auto &item : items) {
+        auto it = character_index.find(item.character_id);
+        if(it != end(character_index)) {
+            characters[it->second].items.push_back(move(item));
         }
+    }
 
-        spdlog::trace("[{}] loaded character id {} name {} no. of items {} no. of stats {}", __FUNCTION__, character.id, character.name, items.size(), stats.size());
-        auto new_entity = registry.create();
-        registry.emplace<pc_component>(new_entity, pc_component{character.id, 0, character.name, character.race, "",
-                                                               character._class, "", character.level,
-                                                               character.skill_points, stats,
-                                                               ibh_flat_map<uint32_t, item_component>{}, (items),
-                                                               ibh_flat_map<string, skill_component>{}});
+    for(auto &character : characters) {
+        emplace_character(registry, character);
+    }
+}
+
+void ibh::load_from_database(entt::registry &registry, const shared_ptr<database_pool> &db_pool, atomic<bool> const &quit) {
+    characters_repository<database_transaction> char_repo{};
+    auto loading_start = chrono::system_clock::now();
+
+    auto transaction = db_pool->create_transaction();
+    auto character_ids = char_repo.get_all_ids(transaction);
+    span<uint64_t const> ids(character_ids);
+
+    for(size_t i = 0; i < ids.size() && !quit.load(memory_order_acquire); i += load_batch_size) {
+        load_character_batch(registry, ids.subspan(i, min(load_batch_size, ids.size() - i)), transaction);
     }
 
     auto loading_end = chrono::system_clock::now();
-    spdlog::info("[{}] database to game loaded in {:n} µs", __FUNCTION__, chrono::duration_cast<chrono::microseconds>(loading_end - loading_start).count());
+    spdlog::info("[{}] database to game loaded {} characters in {:n} µs using {} queries", __FUNCTION__, character_ids.size(), chrono::duration_cast<chrono::microseconds>(loading_end - loading_start).count(),
+                 transaction->executed_queries());
 }
 
+void ibh::load_characters_from_database(entt::registry &registry, vector<uint64_t> const &character_ids, unique_ptr<database_transaction> const &transaction) {
+    span<uint64_t const> ids(character_ids);
+    for(size_t i = 0; i < ids.size(); i += load_batch_size) {
+        load_character_batch(registry, ids.subspan(i, min(load_batch_size, ids.size() - i)), transaction);
+    }
+}
@@ -24,5 +24,11 @@
 using namespace std;
 
 namespace ibh {
+    // characters are loaded in batches of this size, each batch takes a fixed number of queries
+    static constexpr size_t load_batch_size = 1'000;
+
     void load_from_database(entt::registry &registry, const shared_ptr<database_pool> &db_pool, atomic<bool> const &quit);
+
+    // loads only the given characters, used to fill in characters missing from a registry snapshot
+    void load_characters_from_database(entt::registry &registry, vector<uint64_t> const &character_ids, unique_ptr<database_transaction> const &transaction);
 }
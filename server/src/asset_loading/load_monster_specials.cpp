@@ -30,7 +30,7 @@ optional<monster_special_definition_component> ibh::load_monster_specials(string
     auto env_contents = read_whole_file(file);
 
     if(!env_contents) {
-        spdlog::trace("[{}] couldn't load file {}", __FUNCTION__, file);
+        SPDLOG_TRACE("[{}] couldn't load file {}", __FUNCTION__, file);
         return {};
     }
 
@@ -38,7 +38,7 @@ optional<monster_special_definition_component> ibh::load_monster_specials(string
     d.Parse(env_contents->c_str(), env_contents->size());
 
     if(!d.IsObject() || !d.HasMember("name") || !d.HasMember("multipliers") || !d.HasMember("teleport_when_beat")) {
-        spdlog::trace("[{}] couldn't load, missing members file {}", __FUNCTION__, file);
+        SPDLOG_TRACE("[{}] couldn't load, missing members file {}", __FUNCTION__, file);
         return {};
     }
 
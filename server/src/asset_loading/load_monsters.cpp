@@ -30,7 +30,7 @@ optional<monster_definition_component> ibh::load_monsters(string const &file) {
     auto env_contents = read_whole_file(file);
 
     if(!env_contents) {
-        spdlog::trace("[{}] couldn't load monster file {}!", __FUNCTION__, file);
+        SPDLOG_TRACE("[{}] couldn't load monster file {}!", __FUNCTION__, file);
         return {};
     }
 
@@ -39,7 +39,7 @@ optional<monster_definition_component> ibh::load_monsters(string const &file) {
 
     if(!d.IsObject() || !d.HasMember("name") ||
             !d.HasMember("stats") || !d["stats"].IsObject()) {
-        spdlog::trace("[{}] couldn't load monster due to missing members {}!", __FUNCTION__, file);
+        SPDLOG_TRACE("[{}] couldn't load monster due to missing members {}!", __FUNCTION__, file);
         return {};
     }
 
@@ -55,9 +55,9 @@ optional<monster_definition_component> ibh::load_monsters(string const &file) {
                 continue;
             }
             stats.emplace(mapper_it->second, d["stats"][stat.c_str()].GetInt64());
-            spdlog::trace("[{}] monster {} found stat {}", __FUNCTION__, name, stat);
+            SPDLOG_TRACE("[{}] monster {} found stat {}", __FUNCTION__, name, stat);
         } else {
-            spdlog::trace("[{}] monster {} missing stat {}", __FUNCTION__, name, stat);
+            SPDLOG_TRACE("[{}] monster {} missing stat {}", __FUNCTION__, name, stat);
         }
     }
 
@@ -0,0 +1,188 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "monster_definitions.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <optional>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <spdlog/spdlog.h>
+#include "load_monsters.h"
+#include "load_monster_specials.h"
+
+using namespace std;
+using namespace ibh;
+
+namespace {
+    vector<string> regular_files(string const &directory) {
+        vector<string> files;
+        error_code ec;
+        for(filesystem::recursive_directory_iterator it(directory, ec), end_it; !ec && it != end_it; it.increment(ec)) {
+            if(it->is_regular_file(ec)) {
+                files.push_back(it->path().string());
+            }
+        }
+
+        if(ec) {
+            spdlog::error("[{}] error reading directory {}: {}", __FUNCTION__, directory, ec.message());
+        }
+
+        // keep the table order stable between reloads
+        sort(begin(files), end(files));
+        return files;
+    }
+
+    template <typename T, typename Parser>
+    vector<T> parse_all(vector<string> const &files, Parser parser, atomic<bool> const &quit) {
+        vector<optional<T>> parsed(files.size());
+        transform(execution::par, begin(files), end(files), begin(parsed), [&parser, &quit](string const &file) -> optional<T> {
+            if(quit.load(memory_order_acquire)) {
+                return {};
+            }
+            return parser(file);
+        });
+
+        vector<T> definitions;
+        definitions.reserve(parsed.size());
+        for(auto &definition : parsed) {
+            if(definition) {
+                definitions.push_back(move(definition.value()));
+            }
+        }
+        return definitions;
+    }
+}
+
+shared_ptr<monster_definition_table const> ibh::load_monster_definitions(string const &monsters_directory, string const &specials_directory, atomic<bool> const &quit) {
+    auto loading_start = chrono::system_clock::now();
+    auto table = make_shared<monster_definition_table>();
+    table->monsters = parse_all<monster_definition_component>(regular_files(monsters_directory), load_monsters, quit);
+
+    auto specials_loading_start = chrono::system_clock::now();
+    table->specials = parse_all<monster_special_definition_component>(regular_files(specials_directory), load_monster_specials, quit);
+
+    auto loading_end = chrono::system_clock::now();
+    spdlog::info("[{}] {:n} monsters loaded in {:n} µs", __FUNCTION__, table->monsters.size(), chrono::duration_cast<chrono::microseconds>(specials_loading_start - loading_start).count());
+    spdlog::info("[{}] {:n} monster specials loaded in {:n} µs", __FUNCTION__, table->specials.size(), chrono::duration_cast<chrono::microseconds>(loading_end - specials_loading_start).count());
+    return table;
+}
+
+monster_definitions_watcher::monster_definitions_watcher(string monsters_directory, string specials_directory)
+    : _monsters_directory(move(monsters_directory)), _specials_directory(move(specials_directory)), _mutex(), _reloaded(), _stop(false), _thread() {
+    _thread = thread([this] { run(); });
+}
+
+monster_definitions_watcher::~monster_definitions_watcher() {
+    stop();
+}
+
+void monster_definitions_watcher::stop() {
+    _stop.store(true, memory_order_release);
+    if(_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+shared_ptr<monster_definition_table const> monster_definitions_watcher::take_reloaded() {
+    lock_guard lock(_mutex);
+    return move(_reloaded);
+}
+
+void monster_definitions_watcher::run() {
+    auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(fd < 0) {
+        spdlog::error("[{}] inotify_init1 failed, monster definitions won't be reloaded: {}", __FUNCTION__, strerror(errno));
+        return;
+    }
+
+    // inotify doesn't watch subdirectories, so every directory gets its own watch
+    ibh_flat_map<int, string> watched_directories;
+    auto add_watches = [fd, &watched_directories](string const &directory) {
+        vector<string> directories{directory};
+        error_code ec;
+        for(filesystem::recursive_directory_iterator it(directory, ec), end_it; !ec && it != end_it; it.increment(ec)) {
+            if(it->is_directory(ec)) {
+                directories.push_back(it->path().string());
+            }
+        }
+
+        for(auto &dir : directories) {
+            auto wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE);
+            if(wd < 0) {
+                spdlog::error("[{}] could not watch {}: {}", __FUNCTION__, dir, strerror(errno));
+                continue;
+            }
+            watched_directories[wd] = dir;
+        }
+    };
+    add_watches(_monsters_directory);
+    add_watches(_specials_directory);
+
+    alignas(inotify_event) char buffer[4096];
+    pollfd poll_fd{fd, POLLIN, 0};
+    bool changed = false;
+    auto last_change = chrono::steady_clock::now();
+
+    while(!_stop.load(memory_order_acquire)) {
+        if(poll(&poll_fd, 1, settle_time.count()) > 0) {
+            ssize_t len;
+            while((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                for(char *ptr = buffer; ptr < buffer + len;) {
+                    auto const *event = reinterpret_cast<inotify_event const *>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+
+                    if((event->mask & IN_ISDIR) != 0 && (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+                        auto dir_it = watched_directories.find(event->wd);
+                        if(dir_it != end(watched_directories)) {
+                            add_watches((filesystem::path(dir_it->second) / event->name).string());
+                        }
+                    }
+                }
+                changed = true;
+                last_change = chrono::steady_clock::now();
+            }
+        }
+
+        // editors and deploys touch many files in a row, wait for them to finish before re-parsing everything
+        if(!changed || chrono::steady_clock::now() - last_change < settle_time) {
+            continue;
+        }
+        changed = false;
+
+        auto table = load_monster_definitions(_monsters_directory, _specials_directory, _stop);
+        if(_stop.load(memory_order_acquire)) {
+            break;
+        }
+
+        if(table->monsters.empty() || table->specials.empty()) {
+            spdlog::error("[{}] reload found no monsters or no specials, keeping the previous definitions", __FUNCTION__);
+            continue;
+        }
+
+        lock_guard lock(_mutex);
+        _reloaded = move(table);
+    }
+
+    close(fd);
+}
@@ -0,0 +1,63 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <ecs/components.h>
+
+using namespace std;
+
+namespace ibh {
+    // Parses all monster and special files in parallel. Files that fail to parse are skipped.
+    [[nodiscard]] shared_ptr<monster_definition_table const> load_monster_definitions(string const &monsters_directory, string const &specials_directory, atomic<bool> const &quit);
+
+    // Watches the monster and special directories with inotify and re-parses them on a background thread
+    // once changes have settled, so adding or tuning monsters needs no restart and never stalls a tick.
+    class monster_definitions_watcher {
+    public:
+        static constexpr chrono::milliseconds settle_time{250};
+
+        monster_definitions_watcher(string monsters_directory, string specials_directory);
+        ~monster_definitions_watcher();
+
+        monster_definitions_watcher(monster_definitions_watcher const &) = delete;
+        monster_definitions_watcher& operator=(monster_definitions_watcher const &) = delete;
+
+        // The table from the latest reload, nullptr when nothing was reloaded since the previous call.
+        [[nodiscard]] shared_ptr<monster_definition_table const> take_reloaded();
+
+        // stops watching and waits for a reload in progress, also done by the destructor
+        void stop();
+
+    private:
+        void run();
+
+        string _monsters_directory;
+        string _specials_directory;
+        mutex _mutex;
+        shared_ptr<monster_definition_table const> _reloaded;
+        atomic<bool> _stop;
+        thread _thread;
+    };
+}
@@ -33,10 +33,32 @@ namespace ibh {
         string certificate_password;
         uint32_t tick_length;
         uint32_t battle_system_each_n_ticks;
+        string battle_engine;
         uint32_t npc_system_each_n_ticks;
         uint32_t resource_gathering_system_each_n_ticks;
         uint32_t machine_production_system_each_n_ticks;
         bool log_tick_times;
+        bool log_async;
+        uint32_t log_queue_size;
+        string log_overflow_policy;
+        uint64_t log_rotate_bytes;
+        uint32_t log_rotate_files;
+        string tick_overrun_policy;
+        uint32_t max_catch_up_ticks;
+        uint32_t max_system_stretch;
+        string game_queue_commit_mode;
+        uint16_t metrics_port;
+        string snapshot_file;
+        uint32_t snapshot_interval_ticks;
+        uint32_t compression_threshold;
+        bool compression_shared_context;
+        uint64_t outbound_queue_byte_budget;
+        uint64_t slow_consumer_buffered_bytes;
+        string slow_consumer_policy;
+        uint32_t ban_refresh_seconds;
+        uint32_t user_cache_capacity;
+        uint32_t user_cache_ttl_seconds;
+        uint32_t user_cache_negative_ttl_seconds;
         string discord_token;
         string discord_channel_id;
     };
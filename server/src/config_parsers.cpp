@@ -39,7 +39,7 @@ optional<config> ibh::parse_env_file() {
         return {};
     }
 
-    spdlog::trace(R"([{}] config.json file contents: {})", __FUNCTION__, env_contents.value());
+    SPDLOG_TRACE(R"([{}] config.json file contents: {})", __FUNCTION__, env_contents.value());
 
     config config;
     Document d;
@@ -56,10 +56,32 @@ optional<config> ibh::parse_env_file() {
     PARSE_MEMBER("CONNECTION_STRING", connection_string, GetString());
     PARSE_MEMBER("TICK_LENGTH", tick_length, GetUint());
     PARSE_MEMBER("BATTLE_SYSTEM_EACH_N_TICKS", battle_system_each_n_ticks, GetUint());
+    PARSE_MEMBER("BATTLE_ENGINE", battle_engine, GetString());
     PARSE_MEMBER("NPC_SYSTEM_EACH_N_TICKS", npc_system_each_n_ticks, GetUint());
     PARSE_MEMBER("RESOURCE_GATHERING_SYSTEM_EACH_N_TICKS", resource_gathering_system_each_n_ticks, GetUint());
     PARSE_MEMBER("MACHINE_PRODUCTION_SYSTEM_EACH_N_TICKS", machine_production_system_each_n_ticks, GetUint());
     PARSE_MEMBER("LOG_TICK_TIMES", log_tick_times, GetBool());
+    PARSE_MEMBER("LOG_ASYNC", log_async, GetBool());
+    PARSE_MEMBER("LOG_QUEUE_SIZE", log_queue_size, GetUint());
+    PARSE_MEMBER("LOG_OVERFLOW_POLICY", log_overflow_policy, GetString());
+    PARSE_MEMBER("LOG_ROTATE_BYTES", log_rotate_bytes, GetUint64());
+    PARSE_MEMBER("LOG_ROTATE_FILES", log_rotate_files, GetUint());
+    PARSE_MEMBER("TICK_OVERRUN_POLICY", tick_overrun_policy, GetString());
+    PARSE_MEMBER("MAX_CATCH_UP_TICKS", max_catch_up_ticks, GetUint());
+    PARSE_MEMBER("MAX_SYSTEM_STRETCH", max_system_stretch, GetUint());
+    PARSE_MEMBER("GAME_QUEUE_COMMIT_MODE", game_queue_commit_mode, GetString());
+    PARSE_MEMBER("METRICS_PORT", metrics_port, GetUint());
+    PARSE_MEMBER("SNAPSHOT_FILE", snapshot_file, GetString());
+    PARSE_MEMBER("SNAPSHOT_INTERVAL_TICKS", snapshot_interval_ticks, GetUint());
+    PARSE_MEMBER("COMPRESSION_THRESHOLD", compression_threshold, GetUint());
+    PARSE_MEMBER("COMPRESSION_SHARED_CONTEXT", compression_shared_context, GetBool());
+    PARSE_MEMBER("OUTBOUND_QUEUE_BYTE_BUDGET", outbound_queue_byte_budget, GetUint64());
+    PARSE_MEMBER("SLOW_CONSUMER_BUFFERED_BYTES", slow_consumer_buffered_bytes, GetUint64());
+    PARSE_MEMBER("SLOW_CONSUMER_POLICY", slow_consumer_policy, GetString());
+    PARSE_MEMBER("BAN_REFRESH_SECONDS", ban_refresh_seconds, GetUint());
+    PARSE_MEMBER("USER_CACHE_CAPACITY", user_cache_capacity, GetUint());
+    PARSE_MEMBER("USER_CACHE_TTL_SECONDS", user_cache_ttl_seconds, GetUint());
+    PARSE_MEMBER("USER_CACHE_NEGATIVE_TTL_SECONDS", user_cache_negative_ttl_seconds, GetUint());
     PARSE_MEMBER("CERTIFICATE_PASSWORD", certificate_password, GetString());
     PARSE_MEMBER("CERTIFICATE_FILE", certificate_file, GetString());
     PARSE_MEMBER("PRIVATE_KEY_FILE", private_key_file, GetString());
@@ -0,0 +1,241 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "per_socket_data.h"
+
+using namespace std;
+
+namespace ibh {
+    // Slot array of per_socket_data, indexed by connection id (generation << 32 | slot).
+    //
+    // Adding and removing connections is serialized by a mutex, finding and iterating is lock-free.
+    // Chunks are never freed or moved, so a reader only ever has to check whether a slot is occupied.
+    // Removed slots are reused only after every reader thread has passed a quiescent state since the removal,
+    // which means the data of a removed connection stays valid for readers that were still looking at it.
+    // Readers other than the websocket thread have to call quiescent_state() whenever they hold no references into the registry,
+    // at the moment this is only the game loop, once per tick.
+    template <class WebSocket>
+    class connection_registry {
+        static constexpr uint32_t chunk_size = 1024;
+        static constexpr uint32_t max_chunks = 4096;
+
+        struct slot {
+            atomic<uint64_t> connection_id{0};
+            uint32_t generation{0};
+            per_socket_data<WebSocket> data{};
+        };
+
+        struct retired_slot {
+            uint32_t index;
+            uint64_t epoch;
+        };
+
+    public:
+        class iterator {
+        public:
+            using iterator_category = forward_iterator_tag;
+            using value_type = per_socket_data<WebSocket>;
+            using difference_type = ptrdiff_t;
+            using pointer = per_socket_data<WebSocket>*;
+            using reference = per_socket_data<WebSocket>&;
+
+            iterator(connection_registry const *registry, uint32_t index, uint32_t end_index) noexcept : _registry(registry), _index(index), _end_index(end_index) {
+                skip_free();
+            }
+
+            per_socket_data<WebSocket>& operator*() const noexcept {
+                return _registry->get_slot(_index).data;
+            }
+
+            per_socket_data<WebSocket>* operator->() const noexcept {
+                return &_registry->get_slot(_index).data;
+            }
+
+            iterator& operator++() noexcept {
+                _index++;
+                skip_free();
+                return *this;
+            }
+
+            // begin() and end() may have seen a different amount of slots when a connection was added in between
+            bool operator==(iterator const &other) const noexcept {
+                return (at_end() && other.at_end()) || _index == other._index;
+            }
+
+            bool operator!=(iterator const &other) const noexcept {
+                return !(*this == other);
+            }
+
+        private:
+            void skip_free() noexcept {
+                while(_index < _end_index && _registry->get_slot(_index).connection_id.load(memory_order_acquire) == 0) {
+                    _index++;
+                }
+            }
+
+            [[nodiscard]] bool at_end() const noexcept {
+                return _index >= _end_index;
+            }
+
+            connection_registry const *_registry;
+            uint32_t _index;
+            uint32_t _end_index;
+        };
+
+        connection_registry() noexcept : _chunks(), _slot_count(0), _size(0), _epoch(1), _write_mutex(), _free_slots(), _retired_slots() {}
+        connection_registry(connection_registry const &) = delete;
+        connection_registry(connection_registry &&) = delete;
+        connection_registry& operator=(connection_registry const &) = delete;
+        connection_registry& operator=(connection_registry &&) = delete;
+
+        ~connection_registry() noexcept {
+            for(auto &chunk : _chunks) {
+                delete[] chunk.load(memory_order_relaxed);
+            }
+        }
+
+        per_socket_data<WebSocket>* add(WebSocket ws) {
+            unique_lock lock(_write_mutex);
+
+            auto index = get_free_slot();
+            auto &s = get_slot(index);
+            s.generation++;
+            auto connection_id = (static_cast<uint64_t>(s.generation) << 32U) | index;
+
+            s.data = per_socket_data<WebSocket>{};
+            s.data.connection_id = connection_id;
+            s.data.playing_character_slot = -1;
+            s.data.ws = move(ws);
+            s.connection_id.store(connection_id, memory_order_release);
+            _size.fetch_add(1, memory_order_relaxed);
+
+            return &s.data;
+        }
+
+        bool remove(uint64_t connection_id) {
+            unique_lock lock(_write_mutex);
+
+            auto index = static_cast<uint32_t>(connection_id);
+            if(index >= _slot_count.load(memory_order_relaxed)) {
+                return false;
+            }
+
+            auto &s = get_slot(index);
+            if(s.connection_id.load(memory_order_relaxed) != connection_id) {
+                return false;
+            }
+
+            s.connection_id.store(0, memory_order_release);
+            _retired_slots.push_back(retired_slot{index, _epoch.load(memory_order_acquire)});
+            _size.fetch_sub(1, memory_order_relaxed);
+
+            return true;
+        }
+
+        [[nodiscard]] per_socket_data<WebSocket>* find(uint64_t connection_id) const noexcept {
+            auto index = static_cast<uint32_t>(connection_id);
+            if(connection_id == 0 || index >= _slot_count.load(memory_order_acquire)) {
+                return nullptr;
+            }
+
+            auto &s = get_slot(index);
+            if(s.connection_id.load(memory_order_acquire) != connection_id) {
+                return nullptr;
+            }
+
+            return &s.data;
+        }
+
+        void quiescent_state() noexcept {
+            _epoch.fetch_add(1, memory_order_acq_rel);
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _size.load(memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        [[nodiscard]] iterator begin() const noexcept {
+            auto end_index = _slot_count.load(memory_order_acquire);
+            return iterator(this, 0, end_index);
+        }
+
+        [[nodiscard]] iterator end() const noexcept {
+            auto end_index = _slot_count.load(memory_order_acquire);
+            return iterator(this, end_index, end_index);
+        }
+
+    private:
+        slot& get_slot(uint32_t index) const noexcept {
+            return _chunks[index / chunk_size].load(memory_order_acquire)[index % chunk_size];
+        }
+
+        uint32_t get_free_slot() {
+            if(_free_slots.empty()) {
+                auto epoch = _epoch.load(memory_order_acquire);
+                auto retired_end = remove_if(std::begin(_retired_slots), std::end(_retired_slots), [this, epoch](retired_slot const &retired) {
+                    if(retired.epoch < epoch) {
+                        _free_slots.push_back(retired.index);
+                        return true;
+                    }
+                    return false;
+                });
+                _retired_slots.erase(retired_end, std::end(_retired_slots));
+            }
+
+            if(!_free_slots.empty()) {
+                auto index = _free_slots.back();
+                _free_slots.pop_back();
+                return index;
+            }
+
+            auto index = _slot_count.load(memory_order_relaxed);
+            if(index / chunk_size >= max_chunks) {
+                throw runtime_error("connection_registry is full");
+            }
+
+            if(index % chunk_size == 0) {
+                _chunks[index / chunk_size].store(new slot[chunk_size], memory_order_release);
+            }
+            _slot_count.store(index + 1, memory_order_release);
+
+            return index;
+        }
+
+        array<atomic<slot*>, max_chunks> _chunks;
+        atomic<uint32_t> _slot_count;
+        atomic<size_t> _size;
+        atomic<uint64_t> _epoch;
+        mutex _write_mutex;
+        vector<uint32_t> _free_slots;
+        vector<retired_slot> _retired_slots;
+    };
+}
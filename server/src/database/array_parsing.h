@@ -0,0 +1,73 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <pqxx/pqxx>
+
+using namespace std;
+
+namespace ibh {
+    // BIGINT[] literal for use with = ANY(...), so that a batch of ids is fetched in a single query
+    [[nodiscard]] inline string to_bigint_array(span<uint64_t const> ids) {
+        return fmt::format("'{{{}}}'::BIGINT[]", fmt::join(ids, ","));
+    }
+
+    [[nodiscard]] inline string to_bigint_array(span<int64_t const> values) {
+        return fmt::format("'{{{}}}'::BIGINT[]", fmt::join(values, ","));
+    }
+
+    // Parsers for one dimensional arrays as returned by array_agg, NULL elements are skipped.
+
+    [[nodiscard]] inline vector<int64_t> parse_bigint_array(pqxx::field const &field) {
+        vector<int64_t> values;
+        auto parser = field.as_array();
+        while(true) {
+            auto [juncture, value] = parser.get_next();
+            if(juncture == pqxx::array_parser::juncture::done) {
+                break;
+            }
+
+            if(juncture == pqxx::array_parser::juncture::string_value) {
+                values.push_back(stoll(value));
+            }
+        }
+        return values;
+    }
+
+    [[nodiscard]] inline vector<string> parse_text_array(pqxx::field const &field) {
+        vector<string> values;
+        auto parser = field.as_array();
+        while(true) {
+            auto [juncture, value] = parser.get_next();
+            if(juncture == pqxx::array_parser::juncture::done) {
+                break;
+            }
+
+            if(juncture == pqxx::array_parser::juncture::string_value) {
+                values.push_back(move(value));
+            }
+        }
+        return values;
+    }
+}
@@ -0,0 +1,59 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "database_pipeline.h"
+#include <spdlog/spdlog.h>
+#include <metrics/metrics.h>
+#include <tracing.h>
+
+using namespace std;
+using namespace ibh;
+
+database_pipeline::database_pipeline(pqxx::transaction_base &transaction, uint64_t *executed_queries, vector<string> *query_log)
+        : _transaction(transaction), _pipeline(transaction), _inserted_queries(), _executed_queries(executed_queries), _query_log(query_log) {
+    // send queries as soon as they're inserted, the server can work on them while the next ones are built
+    _pipeline.retain(0);
+}
+
+pqxx::pipeline::query_id database_pipeline::insert(string const &query) {
+    SPDLOG_TRACE("[database_pipeline] inserting query {}", query);
+    _inserted_queries++;
+    if(_executed_queries != nullptr) {
+        (*_executed_queries)++;
+    }
+    if(_query_log != nullptr) {
+        _query_log->push_back(query);
+    }
+    return _pipeline.insert(query);
+}
+
+void database_pipeline::insert_statement(string const &statement) {
+    SPDLOG_TRACE("[database_pipeline] inserting statement {}", statement);
+    (void)_pipeline.insert(statement);
+}
+
+pqxx::result database_pipeline::retrieve(pqxx::pipeline::query_id id) {
+    scoped_histogram_timer timer(&metrics.db_query_us);
+    IBH_TRACE_SCOPE(database, "pipeline_retrieve");
+    return _pipeline.retrieve(id);
+}
+
+string database_pipeline::escape(string const &element) {
+    return _transaction.esc(element);
+}
@@ -0,0 +1,96 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+
+using namespace std;
+
+namespace ibh {
+    // Sends queries to the server without waiting for the results of the queries before it, so that independent
+    // queries share a network round trip instead of paying one each.
+    //
+    // While a pipeline exists no other queries can be run on its transaction, so keep it in a scope that ends
+    // before the transaction is used directly again.
+    class database_pipeline {
+    public:
+        // inserted queries are counted into executed_queries and appended to query_log when those are given
+        explicit database_pipeline(pqxx::transaction_base &transaction, uint64_t *executed_queries = nullptr, vector<string> *query_log = nullptr);
+
+        database_pipeline(database_pipeline const &o) = delete;
+        database_pipeline(database_pipeline &&o) = delete;
+        database_pipeline& operator=(database_pipeline const &o) = delete;
+
+        [[nodiscard]] pqxx::pipeline::query_id insert(string const &query);
+        // runs statement in order with the inserted queries, for bookkeeping statements whose result is never retrieved,
+        // not counted as a query
+        void insert_statement(string const &statement);
+        // blocks until the result of the given query has arrived
+        [[nodiscard]] pqxx::result retrieve(pqxx::pipeline::query_id id);
+        [[nodiscard]] string escape(string const &element);
+
+        [[nodiscard]] uint64_t inserted_queries() const noexcept {
+            return _inserted_queries;
+        }
+
+    private:
+        pqxx::transaction_base &_transaction;
+        pqxx::pipeline _pipeline;
+        uint64_t _inserted_queries;
+        uint64_t *_executed_queries;
+        vector<string> *_query_log;
+    };
+
+    // Result of a query inserted into a database_pipeline, parsed on get().
+    template<typename T>
+    class pipelined {
+    public:
+        pipelined(database_pipeline *pipeline, pqxx::pipeline::query_id id, function<T(pqxx::result const &)> parse)
+            : _pipeline(pipeline), _id(id), _parse(move(parse)), _value(), _retrieved(false) {}
+
+        // for calls that are answered without querying the database
+        explicit pipelined(T value) : _pipeline(nullptr), _id(), _parse(), _value(move(value)), _retrieved(false) {}
+
+        // retrieves the result, throws when called a second time as the pipeline hands out each result only once
+        [[nodiscard]] T get() {
+            if(_retrieved) {
+                throw runtime_error("pipelined result already retrieved");
+            }
+            _retrieved = true;
+
+            if(_pipeline == nullptr) {
+                return move(_value);
+            }
+
+            return _parse(_pipeline->retrieve(_id));
+        }
+
+    private:
+        database_pipeline *_pipeline;
+        pqxx::pipeline::query_id _id;
+        function<T(pqxx::result const &)> _parse;
+        T _value;
+        bool _retrieved;
+    };
+}
@@ -18,33 +18,53 @@
 
 #include "database_transaction.h"
 #include "database_pool.h"
+#include "database_pipeline.h"
 #include <spdlog/spdlog.h>
+#include <metrics/metrics.h>
+#include <tracing.h>
 
 using namespace std;
 using namespace ibh;
 
 
 
-database_subtransaction::database_subtransaction(pqxx::work &transaction, string const &name) noexcept : _subtransaction(transaction, name) {
+database_subtransaction::database_subtransaction(database_transaction *parent, pqxx::work &transaction, string const &name) noexcept
+        : _parent(parent), _on_commit(), _subtransaction(transaction, name) {
 
 }
 
 pqxx::result database_subtransaction::execute(string const &query) {
-    spdlog::trace("[database_transaction] executing query {}", query);
+    SPDLOG_TRACE("[database_transaction] executing query {}", query);
+    scoped_histogram_timer timer(&metrics.db_query_us);
+    IBH_TRACE_SCOPE(database, "query");
+    _parent->record_query(query);
     return _subtransaction.exec(query);
 }
 
+unique_ptr<database_pipeline> database_subtransaction::create_pipeline() {
+    return make_unique<database_pipeline>(_subtransaction, &_parent->_executed_queries, _parent->_query_log);
+}
+
 string database_subtransaction::escape(string const &element) {
     return _subtransaction.esc(element);
 }
 
 void database_subtransaction::commit() {
     _subtransaction.commit();
+    for(auto &callback : _on_commit) {
+        _parent->on_commit(move(callback));
+    }
+    _on_commit.clear();
+}
+
+void database_subtransaction::on_commit(function<void()> callback) {
+    _on_commit.push_back(move(callback));
 }
 
 
 database_transaction::database_transaction(database_pool *pool, uint32_t connection_id, shared_ptr<pqxx::connection> connection) noexcept
-        : _pool(pool), _connection_id(connection_id), _transaction(*connection) {
+        : _pool(pool), _connection_id(connection_id), _executed_queries(), _query_log(), _on_commit(), _pending_savepoint(), _savepoint(), _release_savepoint(false),
+          _transaction(*connection) {
 
 }
 
@@ -53,12 +73,43 @@ database_transaction::~database_transaction() {
 }
 
 unique_ptr<database_subtransaction> database_transaction::create_subtransaction(string const &name) {
-    return make_unique<database_subtransaction>(_transaction, name);
+    send_savepoint_statements();
+    return make_unique<database_subtransaction>(this, _transaction, name);
 }
 
 pqxx::result database_transaction::execute(string const &query) {
-    spdlog::trace("[database_transaction] executing query {}", query);
-    return _transaction.exec(query);
+    SPDLOG_TRACE("[database_transaction] executing query {}", query);
+    scoped_histogram_timer timer(&metrics.db_query_us);
+    IBH_TRACE_SCOPE(database, "query");
+    record_query(query);
+
+    auto statements = take_savepoint_statements();
+    if(statements.empty()) {
+        return _transaction.exec(query);
+    }
+
+    // sent as one multi statement query, the result is the one of the last statement
+    string statements_and_query;
+    for(auto const &statement : statements) {
+        statements_and_query += statement;
+        statements_and_query += "; ";
+    }
+    return _transaction.exec(statements_and_query + query);
+}
+
+unique_ptr<database_pipeline> database_transaction::create_pipeline() {
+    auto pipeline = make_unique<database_pipeline>(_transaction, &_executed_queries, _query_log);
+    for(auto const &statement : take_savepoint_statements()) {
+        // runs before the queries inserted after it
+        pipeline->insert_statement(statement);
+    }
+    return pipeline;
+}
+
+unique_ptr<pqxx::stream_to> database_transaction::create_copy_stream(string const &table, vector<string> const &columns) {
+    SPDLOG_TRACE("[database_transaction] copying into {}", table);
+    send_savepoint_statements();
+    return make_unique<pqxx::stream_to>(_transaction, table, columns);
 }
 
 string database_transaction::escape(string const &element) {
@@ -67,4 +118,71 @@ string database_transaction::escape(string const &element) {
 
 void database_transaction::commit() {
     _transaction.commit();
+    for(auto &callback : exchange(_on_commit, {})) {
+        callback();
+    }
+}
+
+void database_transaction::on_commit(function<void()> callback) {
+    _on_commit.push_back(move(callback));
+}
+
+void database_transaction::record_query(string const &query) {
+    _executed_queries++;
+    if(_query_log != nullptr) {
+        _query_log->push_back(query);
+    }
+}
+
+void database_transaction::savepoint(string const &name) {
+    _pending_savepoint = name;
+}
+
+void database_transaction::rollback_to_savepoint() {
+    if(!_pending_savepoint.empty()) {
+        // nothing was sent since the savepoint was asked for, so there is nothing to roll back
+        _pending_savepoint.clear();
+        return;
+    }
+
+    if(_savepoint.empty() || _release_savepoint) {
+        spdlog::error("[{}] no savepoint to roll back to", __FUNCTION__);
+        return;
+    }
+
+    _transaction.exec(fmt::format("ROLLBACK TO SAVEPOINT {}", _transaction.quote_name(_savepoint)));
+    _release_savepoint = true;
+}
+
+void database_transaction::release_savepoint() {
+    if(!_pending_savepoint.empty()) {
+        _pending_savepoint.clear();
+        return;
+    }
+
+    // committing ends it as well, so it is only released when another statement goes out anyway
+    _release_savepoint = !_savepoint.empty();
+}
+
+vector<string> database_transaction::take_savepoint_statements() {
+    vector<string> statements;
+    if(_release_savepoint) {
+        // a savepoint that isn't released stays around until the commit and makes every following query slower
+        statements.push_back(fmt::format("RELEASE SAVEPOINT {}", _transaction.quote_name(_savepoint)));
+        _savepoint.clear();
+        _release_savepoint = false;
+    }
+
+    if(!_pending_savepoint.empty()) {
+        statements.push_back(fmt::format("SAVEPOINT {}", _transaction.quote_name(_pending_savepoint)));
+        _savepoint = exchange(_pending_savepoint, {});
+    }
+
+    return statements;
+}
+
+void database_transaction::send_savepoint_statements() {
+    for(auto const &statement : take_savepoint_statements()) {
+        _transaction.exec(statement);
+    }
 }
@@ -18,10 +18,12 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <pqxx/pqxx>
 #include <type_traits>
+#include <vector>
 
 using namespace std;
 
@@ -41,16 +43,22 @@ namespace ibh {
 
     class database_pool;
     class database_transaction;
+    class database_pipeline;
 
     class database_subtransaction {
     public:
-        explicit database_subtransaction(pqxx::work &transaction, string const &name) noexcept;
+        explicit database_subtransaction(database_transaction *parent, pqxx::work &transaction, string const &name) noexcept;
 
         pqxx::result execute(string const & query);
+        [[nodiscard]] unique_ptr<database_pipeline> create_pipeline();
         [[nodiscard]] string escape(string const & element);
         void commit();
+        // handed to the parent transaction on commit, dropped when the subtransaction is rolled back
+        void on_commit(function<void()> callback);
     private:
 
+        database_transaction *_parent;
+        vector<function<void()>> _on_commit;
         pqxx::subtransaction _subtransaction;
     };
 
@@ -65,12 +73,49 @@ namespace ibh {
 
         [[nodiscard]] unique_ptr<database_subtransaction> create_subtransaction(string const &name = string{});
         pqxx::result execute(string const & query);
+        [[nodiscard]] unique_ptr<database_pipeline> create_pipeline();
+        // bulk loads rows with COPY ... FROM STDIN, the stream has to be completed before running other queries
+        [[nodiscard]] unique_ptr<pqxx::stream_to> create_copy_stream(string const &table, vector<string> const &columns);
         [[nodiscard]] string escape(string const & element);
         void commit();
+        // runs callback once the transaction committed, for caches that mustn't see changes that could still be rolled back
+        void on_commit(function<void()> callback);
+
+        // Lets group commit undo a single game queue message without aborting the rest of the tick's transaction.
+        // The savepoint is only sent along with the next query, so messages that don't touch the database don't pay for it,
+        // and releasing it waits for the next savepoint or query instead of taking a round trip of its own.
+        void savepoint(string const &name);
+        void rollback_to_savepoint();
+        void release_savepoint();
+
+        // number of queries run through execute() or inserted into a pipeline, including those of subtransactions, lets tests assert that
+        // batch loading doesn't regress into N+1. Savepoint statements ride along with those queries and are neither counted nor logged.
+        [[nodiscard]] uint64_t executed_queries() const noexcept {
+            return _executed_queries;
+        }
+
+        // when set, every counted query is appended to query_log, used to explain the queries repositories run
+        void set_query_log(vector<string> *query_log) noexcept {
+            _query_log = query_log;
+        }
 
     private:
+        friend class database_subtransaction;
+
+        // counts query and appends it to the query log if there is one
+        void record_query(string const &query);
+        // the savepoint statements owed to the server, empty when there are none
+        [[nodiscard]] vector<string> take_savepoint_statements();
+        void send_savepoint_statements();
+
         database_pool *_pool;
         uint32_t _connection_id;
+        uint64_t _executed_queries;
+        vector<string> *_query_log;
+        vector<function<void()>> _on_commit;
+        string _pending_savepoint;
+        string _savepoint;
+        bool _release_savepoint;
         pqxx::work _transaction;
     };
 }
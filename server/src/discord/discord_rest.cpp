@@ -113,7 +113,7 @@ namespace ibh {
         }
 
         string result = response_content.str();
-        spdlog::trace("[{}] discord response {}", __FUNCTION__, result);
+        SPDLOG_TRACE("[{}] discord response {}", __FUNCTION__, result);
 
 
         istringstream istrm(result);
@@ -57,7 +57,7 @@ namespace ibh {
             return;
         }
 
-        spdlog::trace("[{}] sending {}", __FUNCTION__, msg);
+        SPDLOG_TRACE("[{}] sending {}", __FUNCTION__, msg);
         try {
             c->send(discord_hdl, msg, websocketpp::frame::opcode::text);
         } catch (const exception &e) {
@@ -145,7 +145,7 @@ namespace ibh {
     void discord_on_message(client *c, outward_queues *outward_queue, websocketpp::connection_hdl hdl, message_ptr msg) {
         try {
             string const &message = msg->get_payload();
-            spdlog::trace("[{}] got message {}", __FUNCTION__, message);
+            SPDLOG_TRACE("[{}] got message {}", __FUNCTION__, message);
 
             rapidjson::Document d{};
             d.Parse(&message[0], message.size());
@@ -160,12 +160,12 @@ namespace ibh {
             }
 
             if(d["op"].GetUint() == 0) {
-                spdlog::trace("[{}] got op 0 Dispatch", __FUNCTION__);
+                SPDLOG_TRACE("[{}] got op 0 Dispatch", __FUNCTION__);
                 if(d["t"].GetString() == string{"MESSAGE_CREATE"} && d["d"]["channel_id"].GetString() == discord_channel_id) {
                     auto discord_msg = d["d"]["content"].GetString();
                     auto discord_user = d["d"]["author"]["username"].GetString();
                     auto now = chrono::system_clock::now();
-                    auto new_chat_msg = make_unique<message_response>(discord_user, discord_msg, "discord", duration_cast<chrono::milliseconds>(now.time_since_epoch()).count());
+                    message_response new_chat_msg(discord_user, discord_msg, "discord", duration_cast<chrono::milliseconds>(now.time_since_epoch()).count());
                     outward_queue->enqueue(outward_message{0ul, move(new_chat_msg)});
                     return;
                 }
@@ -180,13 +180,13 @@ namespace ibh {
             }
 
             if (d["op"].GetUint() == 1) {
-                spdlog::trace("[{}] got op 1 Heartbeat", __FUNCTION__);
+                SPDLOG_TRACE("[{}] got op 1 Heartbeat", __FUNCTION__);
                 send_to_discord(c, create_heartbeat_message());
                 return;
             }
 
             if (d["op"].GetUint() == 9) {
-                spdlog::trace("[{}] got op 9 Invalid Session", __FUNCTION__);
+                SPDLOG_TRACE("[{}] got op 9 Invalid Session", __FUNCTION__);
                 discord_ready_to_send_messages.store(false, memory_order_release);
                 discord_heartbeat_enabled.store(false, memory_order_release);
                 discord_init_done.store(false, memory_order_release);
@@ -202,7 +202,7 @@ namespace ibh {
             }
 
             if (d["op"].GetUint() == 10) {
-                spdlog::trace("[{}] got op 10 Hello", __FUNCTION__);
+                SPDLOG_TRACE("[{}] got op 10 Hello", __FUNCTION__);
                 heartbeat_interval = d["d"]["heartbeat_interval"].GetUint();
                 discord_heartbeat_enabled.store(true, memory_order_release);
                 spdlog::info("[{}] enabled heartbeat", __FUNCTION__);
@@ -210,7 +210,7 @@ namespace ibh {
             }
 
             if (d["op"].GetUint() == 11) {
-                spdlog::trace("[{}] got op 11 Heartbeat ACK", __FUNCTION__);
+                SPDLOG_TRACE("[{}] got op 11 Heartbeat ACK", __FUNCTION__);
                 if (!discord_first_ack_received) {
                     if(!discord_session_id.empty() && last_s_received.has_value()) {
                         send_to_discord(c, create_resume_message());
@@ -235,7 +235,7 @@ namespace ibh {
 
     void discord_on_open(client *c, atomic<bool> const &quit, websocketpp::connection_hdl hdl) {
         if (quit) {
-            spdlog::debug("[{}] new connection in closing state", __FUNCTION__);
+            SPDLOG_DEBUG("[{}] new connection in closing state", __FUNCTION__);
             return;
         }
 
@@ -243,7 +243,7 @@ namespace ibh {
     }
 
     void discord_on_close(client *c, websocketpp::connection_hdl hdl) {
-        spdlog::trace("[{}] conn close connection", __FUNCTION__);
+        SPDLOG_TRACE("[{}] conn close connection", __FUNCTION__);
         discord_heartbeat_enabled.store(false, memory_order_release);
     }
 
@@ -0,0 +1,256 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "batch_battle_resolver.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random_helper.h>
+
+using namespace std;
+using namespace ibh;
+
+namespace {
+    constexpr size_t lanes = batch_battle_resolver::lanes;
+    // doubles represent integers exactly up to 2^53, keep stats well below that so hp can't lose precision
+    constexpr int64_t max_exact_value = int64_t{1} << 50;
+    // damage and hit rolls go up to 1.1 * str and agi, floor_non_negative needs those to fit in an int32
+    constexpr int64_t max_lane_stat = int64_t{1} << 30;
+
+    using lane_doubles = array<double, lanes>;
+
+    // xoshiro256+ with one stream per lane, only shifts, xors and adds so the lanes vectorize
+    class lane_random {
+    public:
+        lane_random() : _s() {
+            for(auto &state : _s) {
+                for(auto &lane : state) {
+                    lane = ibh::random.generate_single<uint64_t>();
+                }
+            }
+            // an all zero state would only ever produce zeroes
+            for(size_t l = 0; l < lanes; l++) {
+                _s[0][l] |= 1;
+            }
+        }
+
+        // uniform in [0, 1), from the top 52 bits
+        void next(lane_doubles &out) noexcept {
+            for(size_t l = 0; l < lanes; l++) {
+                uint64_t result = _s[0][l] + _s[3][l];
+                uint64_t t = _s[1][l] << 17u;
+                _s[2][l] ^= _s[0][l];
+                _s[3][l] ^= _s[1][l];
+                _s[1][l] ^= _s[2][l];
+                _s[0][l] ^= _s[3][l];
+                _s[2][l] ^= t;
+                _s[3][l] = (_s[3][l] << 45u) | (_s[3][l] >> 19u);
+
+                uint64_t bits = (result >> 12u) | 0x3FF0000000000000ULL;
+                double one_to_two;
+                memcpy(&one_to_two, &bits, sizeof(one_to_two));
+                out[l] = one_to_two - 1.;
+            }
+        }
+
+    private:
+        array<array<uint64_t, lanes>, 4> _s;
+    };
+
+    thread_local lane_random lane_rng;
+
+    struct lane_side {
+        lane_doubles str;
+        lane_doubles agi;
+        lane_doubles hp;
+        lane_doubles turns;
+        lane_doubles hits;
+        lane_doubles dmg;
+        lane_doubles dead;
+    };
+
+    // floor() of a value in [0, 2^31). Unlike std::floor this vectorizes without -fno-trapping-math,
+    // which is why str and agi are limited to max_lane_stat.
+    [[nodiscard]] double floor_non_negative(double value) noexcept {
+        return static_cast<double>(static_cast<int32_t>(value));
+    }
+
+    // One attack in every lane where active is 1, the same draws and formula as battle_turn.
+    // Booleans are 0. or 1. so they can be multiplied in instead of branched on. The isgreater family are quiet
+    // comparisons, and nothing that could raise a floating point exception is conditional, otherwise gcc won't if-convert.
+    void attack(lane_side &__restrict attacker, lane_side &__restrict defender, lane_doubles const &__restrict active) noexcept {
+        lane_doubles attacker_roll;
+        lane_doubles defender_roll;
+        lane_doubles attacker_hit_roll;
+        lane_doubles defender_hit_roll;
+        lane_rng.next(attacker_roll);
+        lane_rng.next(defender_roll);
+        lane_rng.next(attacker_hit_roll);
+        lane_rng.next(defender_hit_roll);
+
+        for(size_t l = 0; l < lanes; l++) {
+            double attacker_dmg = attacker.str[l] * 0.9 + attacker_roll[l] * (attacker.str[l] * 0.2);
+            double defender_def = defender.str[l] * 0.9 + defender_roll[l] * (defender.str[l] * 0.2);
+            // str is never negative here, so adding the smallest double only avoids dividing 0 by 0 without a branch
+            double total = attacker_dmg + defender_def + numeric_limits<double>::min();
+            // round() of a non-negative value, but vectorizable
+            double dmg = floor_non_negative(attacker_dmg * attacker_dmg / total + 0.5);
+            double attacker_hit = floor_non_negative(attacker_hit_roll[l] * (attacker.agi[l] + 1.));
+            double defender_hit = floor_non_negative(defender_hit_roll[l] * (defender.agi[l] + 1.));
+            double hit = isgreaterequal(attacker_hit, defender_hit) ? active[l] : 0.;
+
+            defender.hp[l] -= hit * dmg;
+            double died = islessequal(defender.hp[l], 0.) ? active[l] : 0.;
+            defender.dead[l] = isgreater(died, defender.dead[l]) ? died : defender.dead[l];
+            attacker.turns[l] += active[l];
+            attacker.hits[l] += hit;
+            attacker.dmg[l] += hit * dmg;
+        }
+    }
+
+    [[nodiscard]] bool exact(int64_t value) noexcept {
+        return value > -max_exact_value && value < max_exact_value;
+    }
+}
+
+bool batch_battle_resolver::add(battle_component &bc) {
+    auto player_str = bc.total_player_stats.find(stat_str_id);
+    auto player_agi = bc.total_player_stats.find(stat_agi_id);
+    auto player_hp = bc.total_player_stats.find(stat_hp_id);
+    auto player_spd = bc.total_player_stats.find(stat_spd_id);
+    auto mob_str = bc.monster_stats.find(stat_str_id);
+    auto mob_agi = bc.monster_stats.find(stat_agi_id);
+    auto mob_hp = bc.monster_stats.find(stat_hp_id);
+    auto mob_spd = bc.monster_stats.find(stat_spd_id);
+
+    if(player_str == end(bc.total_player_stats) || player_agi == end(bc.total_player_stats) || player_hp == end(bc.total_player_stats) || player_spd == end(bc.total_player_stats) ||
+       mob_str == end(bc.monster_stats) || mob_agi == end(bc.monster_stats) || mob_hp == end(bc.monster_stats) || mob_spd == end(bc.monster_stats)) {
+        return false;
+    }
+
+    if(player_spd->second <= 0 || mob_spd->second <= 0 || player_str->second < 0 || player_agi->second < 0 || mob_str->second < 0 || mob_agi->second < 0) {
+        return false;
+    }
+
+    if(player_str->second >= max_lane_stat || player_agi->second >= max_lane_stat || mob_str->second >= max_lane_stat || mob_agi->second >= max_lane_stat) {
+        return false;
+    }
+
+    if(!exact(player_str->second) || !exact(player_agi->second) || !exact(player_hp->second) || !exact(player_spd->second) ||
+       !exact(mob_str->second) || !exact(mob_agi->second) || !exact(mob_hp->second) || !exact(mob_spd->second)) {
+        return false;
+    }
+
+    // the faster side attacks (faster - 1) / slower times, then the other side once, see resolve_battle_turns
+    bool player_first = player_spd->second >= mob_spd->second;
+    auto first_turns = player_first ? (player_spd->second - 1) / mob_spd->second : (mob_spd->second - 1) / player_spd->second;
+    if(first_turns > max_batched_turns) {
+        return false;
+    }
+
+    auto &first_str = player_first ? player_str->second : mob_str->second;
+    auto &first_agi = player_first ? player_agi->second : mob_agi->second;
+    auto &first_hp = player_first ? player_hp->second : mob_hp->second;
+    auto &second_str = player_first ? mob_str->second : player_str->second;
+    auto &second_agi = player_first ? mob_agi->second : player_agi->second;
+    auto &second_hp = player_first ? mob_hp->second : player_hp->second;
+
+    _first_str.push_back(first_str);
+    _first_agi.push_back(first_agi);
+    _first_hp.push_back(first_hp);
+    _second_str.push_back(second_str);
+    _second_agi.push_back(second_agi);
+    _second_hp.push_back(second_hp);
+    _first_turns_left.push_back(first_turns);
+    _player_first.push_back(player_first);
+    _player_hp.push_back(&player_hp->second);
+    _mob_hp.push_back(&mob_hp->second);
+
+    return true;
+}
+
+vector<battle_turn_result> const & batch_battle_resolver::resolve() {
+    auto count = size();
+    _results.resize(count);
+
+    for(size_t offset = 0; offset < count; offset += lanes) {
+        auto used_lanes = min(lanes, count - offset);
+        lane_side first{};
+        lane_side second{};
+        lane_doubles turns_left{};
+        double max_turns_left = 0.;
+
+        for(size_t l = 0; l < used_lanes; l++) {
+            first.str[l] = _first_str[offset + l];
+            first.agi[l] = _first_agi[offset + l];
+            first.hp[l] = _first_hp[offset + l];
+            second.str[l] = _second_str[offset + l];
+            second.agi[l] = _second_agi[offset + l];
+            second.hp[l] = _second_hp[offset + l];
+            turns_left[l] = _first_turns_left[offset + l];
+            max_turns_left = max(max_turns_left, turns_left[l]);
+        }
+        // padding lanes start out dead so they never attack
+        for(size_t l = used_lanes; l < lanes; l++) {
+            first.dead[l] = 1.;
+        }
+
+        lane_doubles active;
+        for(double turn = 0.; turn < max_turns_left; turn++) {
+            for(size_t l = 0; l < lanes; l++) {
+                active[l] = turn < turns_left[l] && first.dead[l] == 0. && second.dead[l] == 0. ? 1. : 0.;
+            }
+            attack(first, second, active);
+        }
+
+        for(size_t l = 0; l < lanes; l++) {
+            active[l] = first.dead[l] == 0. && second.dead[l] == 0. ? 1. : 0.;
+        }
+        attack(second, first, active);
+
+        for(size_t l = 0; l < used_lanes; l++) {
+            auto i = offset + l;
+            auto &player = _player_first[i] ? first : second;
+            auto &mob = _player_first[i] ? second : first;
+            *_player_hp[i] = static_cast<int64_t>(player.hp[l]);
+            *_mob_hp[i] = static_cast<int64_t>(mob.hp[l]);
+            _results[i] = battle_turn_result{static_cast<uint64_t>(player.turns[l]), static_cast<uint64_t>(mob.turns[l]),
+                                             static_cast<uint64_t>(player.dmg[l]), static_cast<uint64_t>(mob.dmg[l]),
+                                             static_cast<uint64_t>(player.hits[l]), static_cast<uint64_t>(mob.hits[l]),
+                                             mob.dead[l] != 0., player.dead[l] != 0.};
+        }
+    }
+
+    return _results;
+}
+
+void batch_battle_resolver::clear() noexcept {
+    _first_str.clear();
+    _first_agi.clear();
+    _first_hp.clear();
+    _second_str.clear();
+    _second_agi.clear();
+    _second_hp.clear();
+    _first_turns_left.clear();
+    _player_first.clear();
+    _player_hp.clear();
+    _mob_hp.clear();
+    _results.clear();
+}
@@ -0,0 +1,71 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include "components.h"
+
+using namespace std;
+
+namespace ibh {
+    struct battle_turn_result {
+        uint64_t player_turns;
+        uint64_t mob_turns;
+        uint64_t player_dmg_to_mob;
+        uint64_t mob_dmg_to_player;
+        uint64_t player_hits;
+        uint64_t mob_hits;
+        bool mob_dead;
+        bool plyr_dead;
+    };
+
+    // Resolves one tick of turns for many battles at once. Battles are packed into structure of arrays lanes of doubles,
+    // ordered by which side attacks first, so every turn is the same branch free loop over all lanes which the compiler
+    // vectorizes. Each lane draws from its own xoshiro256+ stream, giving the same distributions as battle_turn.
+    class batch_battle_resolver {
+    public:
+        static constexpr size_t lanes = 8;
+        // sides attacking more often than this in one tick would idle most lanes, those use the scalar path
+        static constexpr int64_t max_batched_turns = 32;
+
+        // Returns false without adding the battle when the lanes can't represent it exactly: missing stats,
+        // non-positive speed, negative or very large str or agi, values beyond double precision or too many turns.
+        [[nodiscard]] bool add(battle_component &bc);
+
+        // Resolves all added battles, writes hp back into their battle components and returns results in add order.
+        vector<battle_turn_result> const & resolve();
+
+        void clear() noexcept;
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _first_hp.size();
+        }
+
+    private:
+        // one column per value, first is the side that attacks first this tick
+        vector<double> _first_str, _first_agi, _first_hp;
+        vector<double> _second_str, _second_agi, _second_hp;
+        vector<double> _first_turns_left;
+        vector<bool> _player_first;
+        vector<int64_t*> _player_hp;
+        vector<int64_t*> _mob_hp;
+        vector<battle_turn_result> _results;
+    };
+}
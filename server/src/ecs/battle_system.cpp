@@ -17,6 +17,7 @@
 */
 
 #include <execution>
+#include <numeric>
 #include <spdlog/spdlog.h>
 #include <magic_enum.hpp>
 #include <websocket_thread.h>
@@ -26,13 +27,25 @@
 #include <messages/battle/battle_update_response.h>
 #include <messages/battle/battle_finished_response.h>
 #include "battle_system.h"
+#include "batch_battle_resolver.h"
 #include "random_helper.h"
-#include "on_leaving_scope.h"
-#include "macros.h"
+#include "tracing.h"
 
 using namespace std;
 using namespace ibh;
 
+optional<battle_engine> ibh::parse_battle_engine(string const &engine) noexcept {
+    if(engine == "scalar") {
+        return battle_engine::scalar;
+    }
+
+    if(engine == "batched") {
+        return battle_engine::batched;
+    }
+
+    return {};
+}
+
 [[nodiscard]]
 int64_t battle_turn(pc_component &pc, ibh_flat_map<uint32_t, int64_t> &attacker, ibh_flat_map<uint32_t, int64_t> &defender, bool &attacker_dead, bool &defender_dead, string const &attacker_name, string const &defender_name) {
     auto &attacker_str = get_stat(attacker, stat_str_id);
@@ -53,14 +66,14 @@ int64_t battle_turn(pc_component &pc, ibh_flat_map<uint32_t, int64_t> &attacker,
 
     if(attacker_hit >= defender_hit) {
         defender_hp -= dmg;
-        spdlog::trace("[{}] {} attacked {} for {} dmg. {} has {} health left. {} {} {} {}", __FUNCTION__, attacker_name, defender_name, dmg, defender_name, defender_hp, attacker_dmg, defender_def, attacker_str, defender_str);
+        SPDLOG_TRACE("[{}] {} attacked {} for {} dmg. {} has {} health left. {} {} {} {}", __FUNCTION__, attacker_name, defender_name, dmg, defender_name, defender_hp, attacker_dmg, defender_def, attacker_str, defender_str);
     } else {
-        spdlog::trace("[{}] {} tried to attack {} but missed. {} has {} health left.", __FUNCTION__, attacker_name, defender_name, defender_name, defender_hp);
+        SPDLOG_TRACE("[{}] {} tried to attack {} but missed. {} has {} health left.", __FUNCTION__, attacker_name, defender_name, defender_name, defender_hp);
         dmg = -1;
     }
 
     if(defender_hp <= 0) {
-        spdlog::trace("[{}] {} died", __FUNCTION__, defender_name);
+        SPDLOG_TRACE("[{}] {} died", __FUNCTION__, defender_name);
         defender_dead = true;
     }
 
@@ -92,19 +105,61 @@ void set_hp_mp(pc_component &pc, ibh_flat_map<uint32_t, int64_t> &stats) {
     max_mp = mp;
 }
 
-void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es, outward_queues &outward_queue) {
+ibh_flat_map<uint32_t, int64_t> const & get_total_stats(pc_component &pc) {
+    if(!pc.total_stats_cache.empty()) {
+        return pc.total_stats_cache;
+    }
+
+    ibh_flat_map<uint32_t, int64_t> total_stats;
+    total_stats.reserve(stat_name_ids.size());
+    for(auto &stat_id : stat_name_ids) {
+        // change every won battle, caching them would invalidate the cache every battle
+        if(stat_id == stat_xp_id || stat_id == stat_gold_id) {
+            continue;
+        }
+
+        auto stat = pc.stats.find(stat_id);
+
+        if(stat == end(pc.stats)) {
+            continue;
+        }
+
+        total_stats.emplace(stat_id, stat->second);
+    }
+
+    for(auto &slot_id : slot_name_ids) {
+        auto item = pc.equipped_items.find(slot_id);
+
+        if(item == end(pc.equipped_items)) {
+            continue;
+        }
+
+        for(auto &stat : item->second.stats) {
+            auto &pc_stat = get_stat(total_stats, stat.stat_id);
+            pc_stat += stat.value;
+        }
+    }
+    set_hp_mp(pc, total_stats);
+
+    // only fill the cache once complete, get_stat throws on items with stats the pc doesn't have
+    pc.total_stats_cache = move(total_stats);
+    return pc.total_stats_cache;
+}
+
+// returns false when no monster could be found to battle
+bool setup_battle(pc_component &pc, battle_component &bc, monster_definition_table const &definitions, outward_queues &outward_queue) {
     if(bc.done) {
-        auto mob_view = es.view<monster_definition_component>();
-        auto mob_special_view = es.view<monster_special_definition_component>();
+        auto const &mobs = definitions.monsters;
+        auto const &mob_specials = definitions.specials;
 
-        if(mob_view.empty() || mob_special_view.empty()) {
+        if(mobs.empty() || mob_specials.empty()) {
             throw std::runtime_error("missing mobs/specials"); \
         }
 
-        auto definition = ibh::random.generate_single(0UL, mob_view.size()-1UL);
-        auto special = ibh::random.generate_single(-static_cast<int64_t>(mob_special_view.size()), static_cast<int64_t>(mob_special_view.size())-1L);
+        auto definition = ibh::random.generate_single(0UL, mobs.size()-1UL);
+        auto special = ibh::random.generate_single(-static_cast<int64_t>(mob_specials.size()), static_cast<int64_t>(mob_specials.size())-1L);
         auto level = ibh::random.generate_single(max(static_cast<int64_t>(pc.level)-2L, 0L), static_cast<int64_t>(pc.level)+2L);
-        monster_definition_component &mob_def = es.get<monster_definition_component>(*(mob_view.begin() + definition));
+        monster_definition_component const &mob_def = mobs[definition];
         ibh_flat_map<uint32_t, int64_t> mob_stats;
         mob_stats.reserve(stat_name_ids.size());
         string name = mob_def.name;
@@ -118,7 +173,7 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
 
             double value = level * 6 * stat_it->second / 100.;
             if(special >= 0) {
-                monster_special_definition_component &special_def = es.get<monster_special_definition_component>(*(mob_special_view.begin() + special));
+                monster_special_definition_component const &special_def = mob_specials[special];
                 auto special_stat_it = special_def.stats.find(mob_stat_id);
                 if(special_stat_it != end(special_def.stats)) {
                     value *= special_stat_it->second / 100.;
@@ -129,7 +184,7 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
             mob_stats.emplace(mob_stat_id, static_cast<int64_t>(round(value)));
         }
         if(special >= 0) {
-            monster_special_definition_component &special_def = es.get<monster_special_definition_component>(*(mob_special_view.begin() + special));
+            monster_special_definition_component const &special_def = mob_specials[special];
             name += " " + special_def.name;
         }
         bc = battle_component(name, level, move(mob_stats));
@@ -138,30 +193,7 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
         set_hp_mp(pc, bc.monster_stats);
 
         // pc setup
-        bc.total_player_stats.reserve(stat_name_ids.size());
-        for(auto &stat_id : stat_name_ids) {
-            auto stat = pc.stats.find(stat_id);
-
-            if(stat == end(pc.stats)) {
-                continue;
-            }
-
-            bc.total_player_stats.emplace(stat_id, stat->second);
-        }
-
-        for(auto &slot_id : slot_name_ids) {
-            auto item = pc.equipped_items.find(slot_id);
-
-            if(item == end(pc.equipped_items)) {
-                continue;
-            }
-
-            for(auto &stat : item->second.stats) {
-                auto &pc_stat = get_stat(bc.total_player_stats, stat.stat_id);
-                pc_stat += stat.value;
-            }
-        }
-        set_hp_mp(pc, bc.total_player_stats);
+        bc.total_player_stats = get_total_stats(pc);
         bc.done = false;
 
         if(pc.connection_id > 0) {
@@ -169,16 +201,20 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
             auto mob_max_hp = bc.monster_stats.find(stat_max_hp_id);
             auto player_hp = bc.total_player_stats.find(stat_hp_id);
             auto player_max_hp = bc.total_player_stats.find(stat_max_hp_id);
-            auto new_battle_msg = make_unique<new_battle_response>(name, level, mob_hp->second, mob_max_hp->second, player_hp->second, player_max_hp->second);
+            new_battle_response new_battle_msg(name, level, mob_hp->second, mob_max_hp->second, player_hp->second, player_max_hp->second);
             outward_queue.enqueue_tokenless(outward_message{pc.connection_id, move(new_battle_msg)});
         }
     }
 
     if(bc.done) {
         spdlog::warn("[{}] Couldn't find appropriate monster to battle for pc {} level {}", __FUNCTION__, pc.id, pc.level);
-        return;
+        return false;
     }
 
+    return true;
+}
+
+battle_turn_result resolve_battle_turns(pc_component &pc, battle_component &bc) {
 #ifdef BATTLE_EXTREME_LOGGING
         for(auto &mob_stat : bc.monster_stats) {
             spdlog::info("[{}] available stat for monster: {} - {} - {}", __FUNCTION__, mob_stat.first, mob_stat.second.name, mob_stat.second.value);
@@ -246,8 +282,14 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
         }
     }
 
+    return battle_turn_result{player_turns, mob_turns, player_dmg_to_mob, mob_dmg_to_player, player_hits, mob_hits, mob_dead, plyr_dead};
+}
+
+void finish_battle_turns(pc_component &pc, battle_component &bc, battle_turn_result const &result, outward_queues &outward_queue) {
+    auto [player_turns, mob_turns, player_dmg_to_mob, mob_dmg_to_player, player_hits, mob_hits, mob_dead, plyr_dead] = result;
+
     if(mob_dead) {
-        spdlog::trace("[{}] pc {} killed mob {}", __FUNCTION__, pc.name, bc.monster_name);
+        SPDLOG_TRACE("[{}] pc {} killed mob {}", __FUNCTION__, pc.name, bc.monster_name);
         auto &mob_xp = get_stat(bc.monster_stats, stat_xp_id);
         auto &mob_gold = get_stat(bc.monster_stats, stat_gold_id);
         auto &plyr_xp = get_stat(pc.stats, stat_xp_id);
@@ -260,6 +302,7 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
         if(plyr_xp >= level_threshold) {
             plyr_xp -= level_threshold;
             pc.level++;
+            invalidate_total_stats(pc);
             ibh_flat_map<uint64_t, stat_component> stats;
 
             for(auto &race : select_response.races) {
@@ -308,47 +351,104 @@ void simulate_battle(pc_component &pc, battle_component &bc, entt::registry &es,
                 break;
             }
             if(pc.connection_id > 0) {
-                auto level_up_msg = make_unique<level_up_response>(move(stats), level_calc(pc.level),
+                level_up_response level_up_msg(move(stats), level_calc(pc.level),
                                                                    level_calc(pc.level) - plyr_xp);
                 outward_queue.enqueue_tokenless(outward_message{pc.connection_id, move(level_up_msg)});
             }
-            spdlog::trace("[{}] pc {} level up", __FUNCTION__, pc.name);
+            SPDLOG_TRACE("[{}] pc {} level up", __FUNCTION__, pc.name);
         }
         if(pc.connection_id > 0) {
-            auto finished_msg = make_unique<battle_finished_response>(true, false, mob_xp, mob_gold);
+            battle_finished_response finished_msg(true, false, mob_xp, mob_gold);
             outward_queue.enqueue_tokenless(outward_message{pc.connection_id, move(finished_msg)});
         }
 
         bc.done = true;
     } else if (plyr_dead) {
-        spdlog::trace("[{}] pc {} died against mob {}", __FUNCTION__, pc.name, bc.monster_name);
+        SPDLOG_TRACE("[{}] pc {} died against mob {}", __FUNCTION__, pc.name, bc.monster_name);
         if(pc.connection_id > 0) {
-            auto finished_msg = make_unique<battle_finished_response>(false, true, 0, 0);
+            battle_finished_response finished_msg(false, true, 0, 0);
             outward_queue.enqueue_tokenless(outward_message{pc.connection_id, move(finished_msg)});
         }
         bc.done = true;
     } else {
-        spdlog::trace("[{}] pc {} fought against mob {}", __FUNCTION__, pc.name, bc.monster_name);
+        SPDLOG_TRACE("[{}] pc {} fought against mob {}", __FUNCTION__, pc.name, bc.monster_name);
         if(pc.connection_id > 0) {
-            auto update_msg = make_unique<battle_update_response>(mob_turns, player_turns, mob_hits, player_hits, mob_dmg_to_player, player_dmg_to_mob);
+            battle_update_response update_msg(mob_turns, player_turns, mob_hits, player_hits, mob_dmg_to_player, player_dmg_to_mob);
             outward_queue.enqueue_tokenless(outward_message{pc.connection_id, move(update_msg)});
         }
     }
 }
 
+void simulate_battle(pc_component &pc, battle_component &bc, monster_definition_table const &definitions, outward_queues &outward_queue) {
+    if(!setup_battle(pc, bc, definitions, outward_queue)) {
+        return;
+    }
+
+    finish_battle_turns(pc, bc, resolve_battle_turns(pc, bc), outward_queue);
+}
+
 void battle_system::do_tick(entt::registry &es) {
-    _tick_count++;
+    // Entities are spread over phase buckets by character id and each tick simulates one bucket.
+    // Every entity still runs once per _every_n_ticks * _stretch ticks, but the work is no longer done in one spike.
+    // A changed stretch only takes effect when the cycle wraps, otherwise the new bucket count would skip or repeat entities.
+    if(_tick_count == 0) {
+        _buckets = max(_every_n_ticks * _stretch, 1u);
+    }
+    auto buckets = _buckets;
+    auto phase = _tick_count;
+    _tick_count = (_tick_count + 1) % buckets;
 
-    if(_tick_count < _every_n_ticks) {
+    if(!_definitions) {
+        spdlog::error("[{}] no monster definitions set", __FUNCTION__);
         return;
     }
 
-    _tick_count = 0;
-
-    MEASURE_TIME(info, "battle_system::do_tick");
+    auto const &definitions = *_definitions;
     auto pc_group = es.group<battle_component>(entt::get<pc_component>);
-    for_each(execution::par_unseq, begin(pc_group), end(pc_group), [&es, &outward_queue = _outward_queue, &pc_group](auto entity){
+
+    // a cheap serial pass, so the parallel work below only touches this tick's bucket
+    _phase_entities.clear();
+    for(auto entity : pc_group) {
+        if(pc_group.get<pc_component>(entity).id % buckets == phase) {
+            _phase_entities.push_back(entity);
+        }
+    }
+
+    if(_engine == battle_engine::batched) {
+        _batch_indices.resize((_phase_entities.size() + batch_size - 1) / batch_size);
+        iota(begin(_batch_indices), end(_batch_indices), 0);
+        for_each(execution::par, begin(_batch_indices), end(_batch_indices), [&definitions, &outward_queue = _outward_queue, &pc_group, &phase_entities = _phase_entities](size_t batch){
+            IBH_TRACE_SCOPE(systems, "simulate_battle_batch");
+            thread_local batch_battle_resolver resolver;
+            thread_local vector<pair<pc_component*, battle_component*>> batched;
+            resolver.clear();
+            batched.clear();
+
+            auto last = min((batch + 1) * batch_size, phase_entities.size());
+            for(auto i = batch * batch_size; i < last; i++) {
+                auto [pc, bc] = pc_group.template get<pc_component, battle_component>(phase_entities[i]);
+                if(!setup_battle(pc, bc, definitions, outward_queue)) {
+                    continue;
+                }
+
+                if(resolver.add(bc)) {
+                    batched.emplace_back(&pc, &bc);
+                } else {
+                    finish_battle_turns(pc, bc, resolve_battle_turns(pc, bc), outward_queue);
+                }
+            }
+
+            auto const &results = resolver.resolve();
+            for(size_t i = 0; i < batched.size(); i++) {
+                finish_battle_turns(*batched[i].first, *batched[i].second, results[i], outward_queue);
+            }
+        });
+        return;
+    }
+
+    for_each(execution::par_unseq, begin(_phase_entities), end(_phase_entities), [&definitions, &outward_queue = _outward_queue, &pc_group](auto entity){
         auto [pc, bc] = pc_group.template get<pc_component, battle_component>(entity);
-        simulate_battle(pc, bc, es, outward_queue);
+        IBH_TRACE_SCOPE(systems, "simulate_battle");
+        simulate_battle(pc, bc, definitions, outward_queue);
     });
 }
@@ -18,20 +18,53 @@
 
 #pragma once
 
+#include <optional>
 #include <entt/entity/registry.hpp>
 #include "components.h"
 #include "game_queue_messages/messages.h"
 
 namespace ibh {
+    enum class battle_engine : uint32_t {
+        // battle_turn per entity
+        scalar,
+        // batch_battle_resolver per chunk of entities, scalar for battles it can't represent
+        batched
+    };
+
+    [[nodiscard]] optional<battle_engine> parse_battle_engine(string const &engine) noexcept;
+
     class battle_system {
     public:
-        battle_system(uint32_t every_n_ticks, moodycamel::ConcurrentQueue<outward_message> *outward_queue) :
-        _tick_count(0), _every_n_ticks(every_n_ticks), _outward_queue(outward_queue) {}
+        // entities handed to one batch_battle_resolver
+        static constexpr size_t batch_size = 512;
+
+        battle_system(uint32_t every_n_ticks, moodycamel::ConcurrentQueue<outward_message> *outward_queue, battle_engine engine = battle_engine::scalar) :
+        _tick_count(0), _buckets(1), _every_n_ticks(every_n_ticks), _stretch(1), _engine(engine), _definitions(), _outward_queue(outward_queue), _phase_entities(), _batch_indices() {}
         void do_tick(entt::registry &es);
 
+        // run every every_n_ticks * stretch ticks from the next cycle on, used by the tick scheduler to shed load
+        void set_stretch(uint32_t stretch) noexcept {
+            _stretch = stretch;
+        }
+
+        // only call between ticks, simulate_battle reads the table without locking
+        void set_definitions(shared_ptr<monster_definition_table const> definitions) noexcept {
+            _definitions = move(definitions);
+        }
+
     private:
+        // current phase bucket, see do_tick
         uint32_t _tick_count;
+        // bucket count of the current cycle
+        uint32_t _buckets;
         uint32_t _every_n_ticks;
+        uint32_t _stretch;
+        battle_engine _engine;
+        shared_ptr<monster_definition_table const> _definitions;
         outward_queues _outward_queue;
+        // entities of the current phase bucket, reused between ticks
+        vector<entt::entity> _phase_entities;
+        // reused between ticks by the batched engine
+        vector<size_t> _batch_indices;
     };
 }
\ No newline at end of file
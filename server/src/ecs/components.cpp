@@ -41,4 +41,8 @@ namespace ibh {
 
         return stat->second;
     }
-}
\ No newline at end of file
+
+    void invalidate_total_stats(pc_component &pc) noexcept {
+        pc.total_stats_cache.clear();
+    }
+}
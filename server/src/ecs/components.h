@@ -114,6 +114,12 @@ namespace ibh {
         monster_special_definition_component(string name, ibh_flat_map<uint32_t, int64_t> stats, bool teleport) : name(move(name)), stats(move(stats)), teleport_when_beat(teleport) {}
     };
 
+    // Immutable once published, a reload builds a new table which the game thread swaps in between ticks.
+    struct monster_definition_table {
+        vector<monster_definition_component> monsters;
+        vector<monster_special_definition_component> specials;
+    };
+
     struct monster_component {
         string name;
         string special_name;
@@ -163,11 +169,14 @@ namespace ibh {
         vector<item_component> inventory;
         ibh_flat_map<string, skill_component> skills;
 
+        // base plus equipment stats every battle starts from, empty when stale. Not kept in the database or snapshots.
+        ibh_flat_map<uint32_t, int64_t> total_stats_cache;
+
         pc_component() : id(), connection_id(), name(), race(), dir(), _class(), spawn_message(),
-                          level(), skill_points(), stats(), equipped_items(), inventory(), skills() {}
+                          level(), skill_points(), stats(), equipped_items(), inventory(), skills(), total_stats_cache() {}
         pc_component(uint64_t id, uint64_t connection_id, string name, string race, string dir, string _class, string spawn_message, uint64_t level, uint64_t skill_points, ibh_flat_map<uint32_t, int64_t> stats, ibh_flat_map<uint32_t, item_component> equipped_items, vector<item_component> inventory, ibh_flat_map<string, skill_component> skills)
         : id(id), connection_id(connection_id), name(move(name)), race(move(race)), dir(move(dir)), _class(move(_class)), spawn_message(move(spawn_message)),
-                          level(level), skill_points(skill_points), stats(move(stats)), equipped_items(move(equipped_items)), inventory(move(inventory)), skills(move(skills)) {}
+                          level(level), skill_points(skill_points), stats(move(stats)), equipped_items(move(equipped_items)), inventory(move(inventory)), skills(move(skills)), total_stats_cache() {}
     };
 
     struct user_component {
@@ -201,6 +210,9 @@ namespace ibh {
     [[nodiscard]]
     auto get_stat(decltype(pc_component::stats) &stats, decltype(pc_component::stats)::key_type stat_id) -> decltype(pc_component::stats)::mapped_type&;
 
+    // call after changing pc.stats (except xp and gold, which battles don't read) or pc.equipped_items
+    void invalidate_total_stats(pc_component &pc) noexcept;
+
     auto get_stat_or_initialize_default(decltype(pc_component::stats) &stats, decltype(pc_component::stats)::key_type stat_id, decltype(pc_component::stats)::mapped_type default_val) -> decltype(pc_component::stats)::mapped_type&;
 
     // constants
@@ -22,8 +22,7 @@
 #include <websocket_thread.h>
 #include "resource_system.h"
 #include "random_helper.h"
-#include "on_leaving_scope.h"
-#include "macros.h"
+#include "tracing.h"
 #include <messages/resources/resource_update_response.h>
 
 using namespace std;
@@ -61,39 +60,46 @@ void simulate_resource(uint32_t resource_id, pc_component &pc, outward_queues &o
         }
     }
 
-    auto update_msg = make_unique<resource_update_response>(vector<resource>{
+    resource_update_response update_msg(vector<resource>{
         {resource_id, static_cast<uint64_t>(resource_amt->second), static_cast<uint64_t>(resource_xp->second), static_cast<uint64_t>(resource_level->second)}
     });
     outward_queue.enqueue_tokenless(outward_message{pc.connection_id, move(update_msg)});
 }
 template <typename T>
-void tick_for(entt::registry &es, uint32_t resource_id, queue_abstraction<outward_message> &outward_queue) {
+void tick_for(entt::registry &es, uint32_t resource_id, queue_abstraction<outward_message> &outward_queue, vector<entt::entity> &phase_entities, uint32_t buckets, uint32_t phase) {
     auto pc_group = es.group<T>(entt::get<pc_component>);
-    for_each(execution::par_unseq, begin(pc_group), end(pc_group), [resource_id, &outward_queue, &pc_group](auto entity){
+    phase_entities.clear();
+    for(auto entity : pc_group) {
+        if(pc_group.template get<pc_component>(entity).id % buckets == phase) {
+            phase_entities.push_back(entity);
+        }
+    }
+
+    for_each(execution::par_unseq, begin(phase_entities), end(phase_entities), [resource_id, &outward_queue, &pc_group](auto entity){
         auto &pc = pc_group.template get<pc_component>(entity);
+        IBH_TRACE_SCOPE(systems, "simulate_resource");
         simulate_resource(resource_id, pc, outward_queue);
     });
 }
 
 void ibh::resource_system::do_tick(entt::registry &es) {
-    _tick_count++;
-
-    if(_tick_count < _every_n_ticks) {
-        return;
+    // same phase bucketing as battle_system::do_tick
+    if(_tick_count == 0) {
+        _buckets = max(_every_n_ticks * _stretch, 1u);
     }
+    auto buckets = _buckets;
+    auto phase = _tick_count;
+    _tick_count = (_tick_count + 1) % buckets;
 
-    _tick_count = 0;
-
-    MEASURE_TIME(info, "resource_system::do_tick");
-    tick_for<wood_gathering_component>(es, resource_wood_id, _outward_queue);
-    tick_for<ore_gathering_component>(es, resource_ore_id, _outward_queue);
-    tick_for<water_gathering_component>(es, resource_water_id, _outward_queue);
-    tick_for<plants_gathering_component>(es, resource_plants_id, _outward_queue);
-    tick_for<clay_gathering_component>(es, resource_clay_id, _outward_queue);
-    tick_for<paper_gathering_component>(es, resource_paper_id, _outward_queue);
-    tick_for<ink_gathering_component>(es, resource_ink_id, _outward_queue);
-    tick_for<metal_gathering_component>(es, resource_metal_id, _outward_queue);
-    tick_for<bricks_gathering_component>(es, resource_bricks_id, _outward_queue);
-    tick_for<gems_gathering_component>(es, resource_gems_id, _outward_queue);
-    tick_for<timber_gathering_component>(es, resource_timber_id, _outward_queue);
+    tick_for<wood_gathering_component>(es, resource_wood_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<ore_gathering_component>(es, resource_ore_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<water_gathering_component>(es, resource_water_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<plants_gathering_component>(es, resource_plants_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<clay_gathering_component>(es, resource_clay_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<paper_gathering_component>(es, resource_paper_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<ink_gathering_component>(es, resource_ink_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<metal_gathering_component>(es, resource_metal_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<bricks_gathering_component>(es, resource_bricks_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<gems_gathering_component>(es, resource_gems_id, _outward_queue, _phase_entities, buckets, phase);
+    tick_for<timber_gathering_component>(es, resource_timber_id, _outward_queue, _phase_entities, buckets, phase);
 }
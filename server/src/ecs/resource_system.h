@@ -26,12 +26,23 @@ namespace ibh {
     class resource_system {
     public:
         resource_system(uint32_t every_n_ticks, moodycamel::ConcurrentQueue<outward_message> *outward_queue) :
-                _tick_count(0), _every_n_ticks(every_n_ticks), _outward_queue(outward_queue) {}
+                _tick_count(0), _buckets(1), _every_n_ticks(every_n_ticks), _stretch(1), _outward_queue(outward_queue), _phase_entities() {}
         void do_tick(entt::registry &es);
 
+        // run every every_n_ticks * stretch ticks from the next cycle on, used by the tick scheduler to shed load
+        void set_stretch(uint32_t stretch) noexcept {
+            _stretch = stretch;
+        }
+
     private:
+        // current phase bucket, see do_tick
         uint32_t _tick_count;
+        // bucket count of the current cycle
+        uint32_t _buckets;
         uint32_t _every_n_ticks;
+        uint32_t _stretch;
         outward_queues _outward_queue;
+        // entities of the current phase bucket, reused between ticks and gathering components
+        vector<entt::entity> _phase_entities;
     };
 }
\ No newline at end of file
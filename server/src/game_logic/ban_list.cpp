@@ -0,0 +1,144 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ban_list.h"
+
+#include <algorithm>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <repositories/models.h>
+#include <repositories/banned_users_repository.h>
+#include <database/database_pool.h>
+
+using namespace std;
+using namespace ibh;
+
+ban_list ibh::bans{};
+
+namespace ibh {
+    static string to_ban_key(string_view username) {
+        string key(username);
+        transform(begin(key), end(key), begin(key), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return key;
+    }
+
+    void ban_list::load(vector<db_banned_user> const &bans) {
+        unique_lock lock(_mutex);
+        _usernames.clear();
+        _ips.clear();
+
+        for(auto const &ban : bans) {
+            add_unlocked(ban);
+        }
+
+        _size.store(_usernames.size() + _ips.size(), memory_order_release);
+        SPDLOG_DEBUG("[{}] loaded {} bans", __FUNCTION__, bans.size());
+    }
+
+    void ban_list::add(db_banned_user const &ban) {
+        unique_lock lock(_mutex);
+        add_unlocked(ban);
+        _size.store(_usernames.size() + _ips.size(), memory_order_release);
+    }
+
+    void ban_list::clear() {
+        unique_lock lock(_mutex);
+        _usernames.clear();
+        _ips.clear();
+        _size.store(0, memory_order_release);
+    }
+
+    bool ban_list::is_banned(optional<string_view> username, optional<string_view> ip, chrono::system_clock::time_point now) const {
+        if(_size.load(memory_order_acquire) == 0) {
+            return false;
+        }
+
+        shared_lock lock(_mutex);
+        if(username) {
+            auto it = _usernames.find(to_ban_key(*username));
+            if(it != end(_usernames) && it->second >= now) {
+                return true;
+            }
+        }
+
+        if(ip) {
+            auto it = _ips.find(string(*ip));
+            if(it != end(_ips) && it->second >= now) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    size_t ban_list::size() const {
+        return _size.load(memory_order_acquire);
+    }
+
+    void ban_list::add_unlocked(db_banned_user const &ban) {
+        // bans without an end are not enforced, same as the until >= now check in banned_users_repository
+        if(!ban.until) {
+            return;
+        }
+
+        // when someone is banned more than once, the ban ending last wins
+        auto keep_latest = [&ban](ban_map &map, string key) {
+            auto [it, inserted] = map.try_emplace(move(key), *ban.until);
+            if(!inserted) {
+                it->second = max(it->second, *ban.until);
+            }
+        };
+
+        if(ban._user && !ban._user->username.empty()) {
+            keep_latest(_usernames, to_ban_key(ban._user->username));
+        }
+
+        if(!ban.ip.empty()) {
+            keep_latest(_ips, ban.ip);
+        }
+    }
+
+    ban_list_refresher::ban_list_refresher(shared_ptr<database_pool> pool, ban_list &list, chrono::seconds interval)
+        : _pool(move(pool)), _list(list), _interval(interval), _mutex(), _cv(), _stop(false), _thread() {
+        _thread = thread([this] { run(); });
+    }
+
+    ban_list_refresher::~ban_list_refresher() {
+        {
+            lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    void ban_list_refresher::run() {
+        unique_lock lock(_mutex);
+        while(!_cv.wait_for(lock, _interval, [this] { return _stop; })) {
+            lock.unlock();
+            try {
+                auto transaction = _pool->create_transaction();
+                _list.load(banned_users_repository<database_transaction>{}.get_active(transaction));
+            } catch (const exception &e) {
+                spdlog::error("[{}] refreshing bans failed, keeping the old list: {}", __FUNCTION__, e.what());
+            }
+            lock.lock();
+        }
+    }
+}
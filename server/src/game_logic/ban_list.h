@@ -0,0 +1,92 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <ibh_containers.h>
+
+using namespace std;
+
+namespace ibh {
+    struct db_banned_user;
+    class database_pool;
+
+    // Active bans by username and by ip, kept in memory so that login and register don't query the database for every attempt.
+    //
+    // Loaded at boot and reloaded periodically by ban_list_refresher, bans created by the server itself should be added right away.
+    // Expired bans stop matching as soon as their until has passed and are dropped at the next reload.
+    // Usernames are matched case insensitively, just like the CITEXT column they come from.
+    class ban_list {
+    public:
+        void load(vector<db_banned_user> const &bans);
+        void add(db_banned_user const &ban);
+        void clear();
+
+        [[nodiscard]] bool is_banned(optional<string_view> username, optional<string_view> ip, chrono::system_clock::time_point now = chrono::system_clock::now()) const;
+        [[nodiscard]] size_t size() const;
+
+    private:
+        // until of the ban ending last, looked up from const member functions which ibh_flat_map<string, T> doesn't support
+        using ban_map = unordered_map<string, chrono::system_clock::time_point, custom_hash<string>, custom_equalto<string>>;
+
+        void add_unlocked(db_banned_user const &ban);
+
+        ban_map _usernames;
+        ban_map _ips;
+        // lets the common case of no bans at all skip the lock
+        atomic<size_t> _size{};
+        mutable shared_mutex _mutex;
+    };
+
+    extern ban_list bans;
+
+    // Reloads a ban list from the database every interval on a thread of its own, so database latency never lands in a tick.
+    // A failed reload keeps the old list.
+    class ban_list_refresher {
+    public:
+        ban_list_refresher(shared_ptr<database_pool> pool, ban_list &list, chrono::seconds interval);
+        ~ban_list_refresher();
+
+        ban_list_refresher(ban_list_refresher const &) = delete;
+        ban_list_refresher& operator=(ban_list_refresher const &) = delete;
+
+    private:
+        void run();
+
+        shared_ptr<database_pool> _pool;
+        ban_list &_list;
+        chrono::seconds _interval;
+        mutex _mutex;
+        condition_variable _cv;
+        bool _stop;
+        thread _thread;
+    };
+}
@@ -66,7 +66,7 @@ bool censor_sensor::is_profane(string phrase) {
     while ((next = phrase.find(' ', last)) != std::string::npos && !contains_profanity) {
         auto word = phrase_view.substr(last, next-last);
         last = next + 1;
-        spdlog::trace("[{}] testing word {} in phrase {}", __FUNCTION__, word, phrase);
+        SPDLOG_TRACE("[{}] testing word {} in phrase {}", __FUNCTION__, word, phrase);
         auto word_iter = _word_tiers.find(word);
 
         if (word_iter == _word_tiers.end()) {
@@ -84,7 +84,7 @@ bool censor_sensor::is_profane(string phrase) {
 
     if(!contains_profanity) {
         auto word = phrase_view.substr(last);
-        spdlog::trace("[{}] testing word {} in phrase {}", __FUNCTION__, word, phrase);
+        SPDLOG_TRACE("[{}] testing word {} in phrase {}", __FUNCTION__, word, phrase);
         auto word_iter = _word_tiers.find(word);
 
         if (word_iter == _word_tiers.end()) {
@@ -101,7 +101,7 @@ bool censor_sensor::is_profane(string phrase) {
     }
 
     end:
-    spdlog::trace("[{}] phrase {} profane: {}", __FUNCTION__, phrase, contains_profanity);
+    SPDLOG_TRACE("[{}] phrase {} profane: {}", __FUNCTION__, phrase, contains_profanity);
     return contains_profanity;
 }
 
@@ -112,13 +112,13 @@ bool censor_sensor::is_profane_ish(string phrase) {
             auto tier_iter = _enabled_tiers.find(tier);
 
             if(tier_iter != _enabled_tiers.end()) {
-                spdlog::trace("[{}] phrase {} profane ish", __FUNCTION__, phrase);
+                SPDLOG_TRACE("[{}] phrase {} profane ish", __FUNCTION__, phrase);
                 return true;
             }
         }
     }
 
-    spdlog::trace("[{}] phrase {} not profane ish", __FUNCTION__, phrase);
+    SPDLOG_TRACE("[{}] phrase {} not profane ish", __FUNCTION__, phrase);
     return false;
 }
 
@@ -151,7 +151,7 @@ string censor_sensor::clean_profanity(string phrase) {
     }
 
     auto word = phrase_view.substr(last);
-    spdlog::trace("[{}] testing word {} in phrase {}", __FUNCTION__, word, phrase);
+    SPDLOG_TRACE("[{}] testing word {} in phrase {}", __FUNCTION__, word, phrase);
     auto word_iter = _word_tiers.find(word);
 
     if (word_iter != _word_tiers.end()) {
@@ -166,7 +166,7 @@ string censor_sensor::clean_profanity(string phrase) {
         }
     }
 
-    spdlog::trace("[{}] phrase {}", __FUNCTION__, phrase);
+    SPDLOG_TRACE("[{}] phrase {}", __FUNCTION__, phrase);
     return phrase;
 }
 
@@ -187,20 +187,20 @@ string censor_sensor::clean_profanity_ish(string phrase) {
         }
     }
 
-    spdlog::trace("[{}] phrase {}", __FUNCTION__, phrase);
+    SPDLOG_TRACE("[{}] phrase {}", __FUNCTION__, phrase);
     return phrase;
 }
 
 void censor_sensor::enable_tier(uint32_t tier) {
     if(tier <= static_cast<uint32_t>(profanity_type::USER_ADDED)) {
         _enabled_tiers.insert(tier);
-        spdlog::trace("[{}] tier {} enabled", __FUNCTION__, tier);
+        SPDLOG_TRACE("[{}] tier {} enabled", __FUNCTION__, tier);
     }
 }
 
 void censor_sensor::disable_tier(uint32_t tier) {
     if(tier <= static_cast<uint32_t>(profanity_type::USER_ADDED)) {
         _enabled_tiers.erase(tier);
-        spdlog::trace("[{}] tier {} disabled", __FUNCTION__, tier);
+        SPDLOG_TRACE("[{}] tier {} disabled", __FUNCTION__, tier);
     }
 }
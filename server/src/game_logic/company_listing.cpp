@@ -0,0 +1,207 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "company_listing.h"
+
+#include <algorithm>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <repositories/models.h>
+#include <messages/company/get_company_listing_response.h>
+
+using namespace std;
+using namespace ibh;
+
+company_listing ibh::company_list{};
+
+namespace ibh {
+    string to_listing_key(string_view name) {
+        string key(name);
+        transform(begin(key), end(key), begin(key), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return key;
+    }
+
+    void company_listing::load(vector<db_company_listing> const &companies) {
+        unique_lock lock(_mutex);
+        _companies.clear();
+        _keys_by_id.clear();
+
+        for(auto const &c : companies) {
+            listing_entry entry{c.company.name, {}, {}};
+            entry.members.reserve(c.member_ids.size());
+            for(size_t i = 0; i < c.member_ids.size() && i < c.member_names.size(); i++) {
+                entry.members.push_back(listing_member{c.member_ids[i], c.member_names[i]});
+            }
+            entry.bonuses.reserve(c.stats.size());
+            for(auto const &stat : c.stats) {
+                entry.bonuses.emplace_back(stat.stat_id, stat.value);
+            }
+
+            auto key = to_listing_key(c.company.name);
+            _keys_by_id[c.company.id] = key;
+            _companies.insert_or_assign(move(key), move(entry));
+        }
+
+        changed();
+        spdlog::info("[{}] loaded {} companies", __FUNCTION__, _companies.size());
+    }
+
+    void company_listing::add_company(uint64_t company_id, string const &name, vector<stat_component> bonuses) {
+        unique_lock lock(_mutex);
+        auto key = to_listing_key(name);
+        _keys_by_id[company_id] = key;
+        _companies.insert_or_assign(move(key), listing_entry{name, {}, move(bonuses)});
+        changed();
+    }
+
+    void company_listing::add_member(uint64_t company_id, uint64_t character_id, string name) {
+        unique_lock lock(_mutex);
+        auto entry = find_entry(company_id);
+        if(entry == nullptr) {
+            spdlog::warn("[{}] company {} not in listing", __FUNCTION__, company_id);
+            return;
+        }
+
+        entry->members.push_back(listing_member{character_id, move(name)});
+        changed();
+    }
+
+    void company_listing::remove_member(uint64_t company_id, uint64_t character_id) {
+        unique_lock lock(_mutex);
+        auto entry = find_entry(company_id);
+        if(entry == nullptr) {
+            spdlog::warn("[{}] company {} not in listing", __FUNCTION__, company_id);
+            return;
+        }
+
+        erase_if(entry->members, [character_id](listing_member const &m) { return m.character_id == character_id; });
+        changed();
+    }
+
+    void company_listing::set_bonus(uint64_t company_id, uint64_t stat_id, int64_t value) {
+        unique_lock lock(_mutex);
+        auto entry = find_entry(company_id);
+        if(entry == nullptr) {
+            spdlog::warn("[{}] company {} not in listing", __FUNCTION__, company_id);
+            return;
+        }
+
+        auto bonus = find_if(begin(entry->bonuses), end(entry->bonuses), [stat_id](stat_component const &s) { return s.stat_id == stat_id; });
+        if(bonus != end(entry->bonuses)) {
+            bonus->value = value;
+        } else {
+            entry->bonuses.emplace_back(stat_id, value);
+        }
+        changed();
+    }
+
+    void company_listing::clear() {
+        unique_lock lock(_mutex);
+        _companies.clear();
+        _keys_by_id.clear();
+        changed();
+    }
+
+    uint64_t company_listing::version() const {
+        shared_lock lock(_mutex);
+        return _version;
+    }
+
+    size_t company_listing::size() const {
+        shared_lock lock(_mutex);
+        return _companies.size();
+    }
+
+    shared_ptr<string const> company_listing::get_page(uint32_t page, string_view name_prefix) {
+        shared_lock lock(_mutex);
+        if(!name_prefix.empty()) {
+            return make_shared<string const>(serialize_page(page, to_listing_key(name_prefix)));
+        }
+
+        {
+            lock_guard cache_lock(_cache_mutex);
+            auto cached = _page_cache.find(page);
+            if(cached != end(_page_cache)) {
+                return cached->second;
+            }
+        }
+
+        auto serialized = make_shared<string const>(serialize_page(page, name_prefix));
+        // pages past the end are all the same empty page, don't let them grow the cache
+        if(static_cast<uint64_t>(page) * page_size < _companies.size()) {
+            lock_guard cache_lock(_cache_mutex);
+            _page_cache.emplace(page, serialized);
+        }
+        return serialized;
+    }
+
+    company_listing::listing_entry* company_listing::find_entry(uint64_t company_id) {
+        auto key = _keys_by_id.find(company_id);
+        if(key == end(_keys_by_id)) {
+            return nullptr;
+        }
+
+        auto entry = _companies.find(key->second);
+        if(entry == end(_companies)) {
+            return nullptr;
+        }
+
+        return &entry->second;
+    }
+
+    // must be called while holding the unique lock
+    void company_listing::changed() {
+        _version++;
+        lock_guard cache_lock(_cache_mutex);
+        _page_cache.clear();
+    }
+
+    string company_listing::serialize_page(uint32_t page, string_view name_prefix) const {
+        auto first = _companies.lower_bound(name_prefix);
+        auto last = first;
+        size_t matches = 0;
+        if(name_prefix.empty()) {
+            last = end(_companies);
+            matches = _companies.size();
+        } else {
+            while(last != end(_companies) && last->first.starts_with(name_prefix)) {
+                ++last;
+                matches++;
+            }
+        }
+
+        auto page_count = static_cast<uint32_t>((matches + page_size - 1) / page_size);
+        auto skip = min(static_cast<size_t>(page) * page_size, matches);
+        advance(first, skip);
+
+        vector<company_object> companies;
+        companies.reserve(min(matches - skip, static_cast<size_t>(page_size)));
+        for(; first != last && companies.size() < page_size; ++first) {
+            auto const &entry = first->second;
+            vector<string> members;
+            members.reserve(entry.members.size());
+            for(auto const &m : entry.members) {
+                members.push_back(m.name);
+            }
+            companies.emplace_back(entry.name, move(members), entry.bonuses);
+        }
+
+        return get_company_listing_response("", move(companies), page, page_count, _version).serialize();
+    }
+}
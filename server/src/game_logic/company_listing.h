@@ -0,0 +1,87 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ibh_containers.h>
+#include <common_components.h>
+
+using namespace std;
+
+namespace ibh {
+    struct db_company_listing;
+
+    // All companies with their members and bonuses, kept in memory so that listing requests don't touch the database.
+    //
+    // Loaded once at boot and updated after each change to a company is committed, handlers defer their updates with after_commit()
+    // so the listing never shows a company change that could still be rolled back.
+    // Websocket threads only read, pages without a name filter are serialized once and cached until the next change.
+    // Names are matched case insensitively, just like the CITEXT column they come from.
+    class company_listing {
+    public:
+        static constexpr uint32_t page_size = 50;
+
+        void load(vector<db_company_listing> const &companies);
+        void add_company(uint64_t company_id, string const &name, vector<stat_component> bonuses);
+        void add_member(uint64_t company_id, uint64_t character_id, string name);
+        void remove_member(uint64_t company_id, uint64_t character_id);
+        void set_bonus(uint64_t company_id, uint64_t stat_id, int64_t value);
+        void clear();
+
+        [[nodiscard]] uint64_t version() const;
+        [[nodiscard]] size_t size() const;
+        // serialized get_company_listing_response
+        [[nodiscard]] shared_ptr<string const> get_page(uint32_t page, string_view name_prefix);
+
+    private:
+        struct listing_member {
+            uint64_t character_id;
+            string name;
+        };
+
+        struct listing_entry {
+            string name;
+            vector<listing_member> members;
+            vector<stat_component> bonuses;
+        };
+
+        listing_entry* find_entry(uint64_t company_id);
+        void changed();
+        [[nodiscard]] string serialize_page(uint32_t page, string_view name_prefix) const;
+
+        // keyed by lowercased name, so that a prefix search is a range starting at lower_bound
+        map<string, listing_entry, less<>> _companies;
+        ibh_flat_map<uint64_t, string> _keys_by_id;
+        uint64_t _version{};
+        mutable shared_mutex _mutex;
+
+        // only pages without a prefix are cached, those are what the overview shows
+        ibh_flat_map<uint32_t, shared_ptr<string const>> _page_cache;
+        mutex _cache_mutex;
+    };
+
+    extern company_listing company_list;
+}
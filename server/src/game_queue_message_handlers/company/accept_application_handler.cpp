@@ -24,6 +24,8 @@
 #include <repositories/companies_repository.h>
 #include <repositories/company_members_repository.h>
 #include <repositories/company_member_applications_repository.h>
+#include <repositories/characters_repository.h>
+#include <game_logic/company_listing.h>
 #include <game_queue_message_handlers/handler_helpers.h>
 #include <magic_enum.hpp>
 
@@ -31,14 +33,7 @@ using namespace std;
 
 namespace ibh {
 
-    bool handle_accept_application(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *accept_msg = dynamic_cast<accept_application_message*>(msg);
-
-        if(accept_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_accept_application(accept_application_message* accept_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_group = es.group<pc_component>(entt::get<company_component>);
         for(auto entity : pc_group) {
             auto [pc, cc] = pc_group.get<pc_component, company_component>(entity);
@@ -47,60 +42,89 @@ namespace ibh {
                 continue;
             }
 
-            company_members_repository<database_subtransaction> company_members_repo{};
-            company_member_applications_repository<database_subtransaction> company_member_applications_repo{};
-            auto subtransaction = transaction->create_subtransaction();
+            company_members_repository<database_transaction> company_members_repo{};
+            company_member_applications_repository<database_transaction> company_member_applications_repo{};
+
+            optional<db_company_member> company_member;
+            optional<db_company_member> company_application;
+            {
+                // the application is looked up by the company the player is in according to the game state, so both queries can go out together
+                auto pipeline = transaction->create_pipeline();
+                auto company_member_result = company_members_repo.get_by_character_id_async(pc.id, *pipeline);
+                auto company_application_result = company_member_applications_repo.get_async(cc.id, accept_msg->applicant_id, *pipeline);
+                company_member = company_member_result.get();
+                company_application = company_application_result.get();
+            }
 
-            auto company_member = company_members_repo.get_by_character_id(pc.id, subtransaction);
             if(!company_member) {
-                auto new_err_msg = make_unique<accept_application_response>("Not a member of a company");
+                accept_application_response new_err_msg("Not a member of a company");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             if(company_member->member_level == magic_enum::enum_integer(company_member_level::COMPANY_MEMBER)) {
-                auto new_err_msg = make_unique<accept_application_response>("Not an admin");
+                accept_application_response new_err_msg("Not an admin");
+                outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
+                return false;
+            }
+
+            if(company_member->company_id != cc.id) {
+                spdlog::error("[{}] pc {} is in company {} according to the database but {} in game", __FUNCTION__, pc.id, company_member->company_id, cc.id);
+                accept_application_response new_err_msg("Server error.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            auto company_application = company_member_applications_repo.get(company_member->company_id, accept_msg->applicant_id, subtransaction);
             if(!company_application) {
-                auto new_err_msg = make_unique<accept_application_response>("No applicant by that name.");
+                accept_application_response new_err_msg("No applicant by that name.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             company_application->member_level = magic_enum::enum_integer(company_member_level::COMPANY_MEMBER);
-            if(!company_members_repo.insert(*company_application, subtransaction)) {
-                auto new_err_msg = make_unique<accept_application_response>("Server error.");
+            if(!company_members_repo.insert(*company_application, transaction)) {
+                accept_application_response new_err_msg("Server error.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            company_member_applications_repo.remove(*company_application, subtransaction);
-            subtransaction->commit();
+            company_member_applications_repo.remove(*company_application, transaction);
 
-            auto new_err_msg = make_unique<accept_application_response>("");
+            accept_application_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
             auto accepted_player = get_player_entity(company_application->character_id, es);
             if(accepted_player.has_value()) {
                 es.emplace<company_component>(*accepted_player, cc);
+                record_undo(es, [accepted = *accepted_player](entt::registry &registry) {
+                    if(registry.valid(accepted)) {
+                        registry.remove_if_exists<company_component>(accepted);
+                    }
+                });
                 // can't use cc anymore as group has re-allocated underlying storage
                 auto cc2 = pc_group.get<company_component>(entity);
                 auto &pc =es.get<pc_component>(*accepted_player);
+                after_commit(es, [company_id = company_member->company_id, character_id = pc.id, name = pc.name] {
+                    company_list.add_member(company_id, character_id, name);
+                });
                 send_message_to_all_company_members(cc2, pc.name, fmt::format("{} got accepted into the company!", pc.name), "system-company", es, outward_queue);
             } else {
                 spdlog::error("[{}] Couldn't find recently accepted player {}", __FUNCTION__, company_application->character_id);
+                characters_repository<database_transaction> characters_repo{};
+                auto accepted_character = characters_repo.get_character(company_application->character_id, transaction);
+                if(accepted_character) {
+                    after_commit(es, [company_id = company_member->company_id, character_id = accepted_character->id, name = accepted_character->name] {
+                        company_list.add_member(company_id, character_id, name);
+                    });
+                }
             }
 
-            spdlog::trace("[{}] accepted applicant {} company {} by pc {} connection id {}", __FUNCTION__, accept_msg->applicant_id, company_member->company_id, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] accepted applicant {} company {} by pc {} connection id {}", __FUNCTION__, accept_msg->applicant_id, company_member->company_id, pc.name, pc.connection_id);
 
             return true;
         }
 
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, accept_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, accept_msg->connection_id);
 
         return false;
     }
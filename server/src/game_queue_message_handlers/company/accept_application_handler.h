@@ -25,5 +25,5 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_accept_application(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
+    bool handle_accept_application(accept_application_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
 }
@@ -25,19 +25,14 @@
 #include <repositories/companies_repository.h>
 #include <repositories/company_stats_repository.h>
 #include <repositories/company_members_repository.h>
+#include <game_logic/company_listing.h>
+#include <game_queue_message_handlers/game_state_changes.h>
 #include <magic_enum.hpp>
 
 using namespace std;
 
 namespace ibh {
-    bool handle_create_company(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *create_msg = dynamic_cast<create_company_message*>(msg);
-
-        if(create_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_create_company(create_company_message* create_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_view = es.view<pc_component>();
         for(auto entity : pc_view) {
             auto &pc = pc_view.get(entity);
@@ -49,55 +44,72 @@ namespace ibh {
             auto gold_it = pc.stats.find(stat_gold_id);
 
             if(gold_it == end(pc.stats)) {
-                spdlog::trace("[{}] pc {} not enough gold", __FUNCTION__, pc.id);
-                auto new_err_msg = make_unique<generic_error_response>("unknown error", "", "", false);
+                SPDLOG_TRACE("[{}] pc {} not enough gold", __FUNCTION__, pc.id);
+                generic_error_response new_err_msg("unknown error", "", "", false);
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             if(gold_it->second < 10'000) {
-                auto new_err_msg = make_unique<create_company_response>("Not enough gold, need 10,000 to create company.");
+                create_company_response new_err_msg("Not enough gold, need 10,000 to create company.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            companies_repository<database_subtransaction> company_repo{};
-            company_stats_repository<database_subtransaction> company_stats_repo{};
-            company_members_repository<database_subtransaction> company_members_repo{};
-            auto subtransaction = transaction->create_subtransaction();
+            companies_repository<database_transaction> company_repo{};
+            company_stats_repository<database_transaction> company_stats_repo{};
+            company_members_repository<database_transaction> company_members_repo{};
 
             db_company new_company{0, create_msg->company_name, 0, create_msg->company_type};
-            if(!company_repo.insert(new_company, subtransaction)) {
-                auto new_err_msg = make_unique<create_company_response>("Company name already exists");
+            if(!company_repo.insert(new_company, transaction)) {
+                create_company_response new_err_msg("Company name already exists");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             ibh_flat_map<uint32_t, int64_t> company_stats;
+            vector<stat_component> listing_bonuses;
+            listing_bonuses.reserve(stat_name_ids.size());
             for(auto &stat_id : stat_name_ids) {
                 db_company_stat stat{0, new_company.id, stat_id, stat_id == stat_xp_id || stat_id == stat_gold_id ? 5 : 0};
                 company_stats.emplace(stat_id, stat.value);
-                company_stats_repo.insert(stat, subtransaction);
+                listing_bonuses.emplace_back(stat_id, stat.value);
+                company_stats_repo.insert(stat, transaction);
             }
 
             db_company_member company_admin{new_company.id, pc.id, magic_enum::enum_integer(company_member_level::COMPANY_ADMIN), 0};
-            company_members_repo.insert(company_admin, subtransaction);
-            subtransaction->commit();
+            company_members_repo.insert(company_admin, transaction);
+
+            after_commit(es, [company_id = new_company.id, company_name = new_company.name, listing_bonuses = move(listing_bonuses), character_id = pc.id, name = pc.name]() mutable {
+                company_list.add_company(company_id, company_name, move(listing_bonuses));
+                company_list.add_member(company_id, character_id, name);
+            });
 
             es.emplace<company_component>(entity, new_company.id, magic_enum::enum_integer(company_member_level::COMPANY_ADMIN), create_msg->company_name, company_stats);
 
             gold_it->second -= 10'000;
-            auto new_err_msg = make_unique<create_company_response>("");
+            record_undo(es, [entity](entt::registry &registry) {
+                if(!registry.valid(entity)) {
+                    return;
+                }
+                registry.remove_if_exists<company_component>(entity);
+                auto &pc_to_refund = registry.get<pc_component>(entity);
+                auto gold = pc_to_refund.stats.find(stat_gold_id);
+                if(gold != end(pc_to_refund.stats)) {
+                    gold->second += 10'000;
+                }
+            });
+            create_company_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
-            spdlog::trace("[{}] created company {} for pc {} for connection id {}", __FUNCTION__, create_msg->company_name, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] created company {} for pc {} for connection id {}", __FUNCTION__, create_msg->company_name, pc.name, pc.connection_id);
 
             return true;
         }
 
-        auto new_err_msg = make_unique<create_company_response>("unknown error");
+        create_company_response new_err_msg("unknown error");
         outward_queue.enqueue(outward_message{create_msg->connection_id, move(new_err_msg)});
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, create_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, create_msg->connection_id);
 
         return false;
     }
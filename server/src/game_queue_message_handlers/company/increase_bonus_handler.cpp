@@ -23,6 +23,7 @@
 #include <messages/company/increase_bonus_response.h>
 #include <repositories/companies_repository.h>
 #include <repositories/company_stats_repository.h>
+#include <game_logic/company_listing.h>
 #include <game_queue_message_handlers/handler_helpers.h>
 #include <magic_enum.hpp>
 #include <messages/chat/message_response.h>
@@ -31,14 +32,7 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_increase_bonus(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *increase_bonus_msg = dynamic_cast<increase_bonus_message*>(msg);
-
-        if(increase_bonus_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_increase_bonus(increase_bonus_message* increase_bonus_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_group = es.group<pc_component>(entt::get<company_component>);
         for(auto entity : pc_group) {
             auto [pc, cc] = pc_group.get<pc_component, company_component>(entity);
@@ -48,51 +42,58 @@ namespace ibh {
             }
 
             if(cc.member_level == magic_enum::enum_integer(company_member_level::COMPANY_MEMBER)) {
-                auto new_err_msg = make_unique<increase_bonus_response>("Not an admin");
+                increase_bonus_response new_err_msg("Not an admin");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             if(increase_bonus_msg->bonus_type == company_stat_gold_id) {
-                auto new_err_msg = make_unique<increase_bonus_response>("Can't increase gold, silly");
+                increase_bonus_response new_err_msg("Can't increase gold, silly");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             auto current_stat = cc.stats.find(increase_bonus_msg->bonus_type);
             if(current_stat == end(cc.stats)) {
-                auto new_err_msg = make_unique<increase_bonus_response>("Couldn't find specified bonus type");
+                increase_bonus_response new_err_msg("Couldn't find specified bonus type");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             auto current_gold_stat = cc.stats.find(company_stat_gold_id);
             if(current_gold_stat == end(cc.stats)) {
-                auto new_err_msg = make_unique<increase_bonus_response>("Couldn't find company gold, please report this as a bug.");
+                increase_bonus_response new_err_msg("Couldn't find company gold, please report this as a bug.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             auto gold_requirement = pow(10l, current_stat->second + 2);
             if(current_gold_stat->second < gold_requirement) {
-                auto new_err_msg = make_unique<increase_bonus_response>(fmt::format("You need {} company gold to increase this stat.", gold_requirement));
+                increase_bonus_response new_err_msg(fmt::format("You need {} company gold to increase this stat.", gold_requirement));
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
+            record_undo(es, [entity, company_id = cc.id, bonus_type = increase_bonus_msg->bonus_type, bonus = current_stat->second, gold = current_gold_stat->second](entt::registry &registry) {
+                restore_company_stat(registry, entity, company_id, bonus_type, bonus);
+                restore_company_stat(registry, entity, company_id, company_stat_gold_id, gold);
+            });
             current_stat->second++;
             current_gold_stat->second -= gold_requirement;
 
 
-            company_stats_repository<database_subtransaction> company_stats_repo{};
-            auto subtransaction = transaction->create_subtransaction();
+            company_stats_repository<database_transaction> company_stats_repo{};
             db_company_stat db_current_stat{0, cc.id, increase_bonus_msg->bonus_type, current_stat->second};
             db_company_stat db_gold_stat{0, cc.id, company_stat_gold_id, current_gold_stat->second};
-            company_stats_repo.update_by_stat_id(db_current_stat, subtransaction);
-            company_stats_repo.update_by_stat_id(db_gold_stat, subtransaction);
-            subtransaction->commit();
+            company_stats_repo.update_by_stat_id(db_current_stat, transaction);
+            company_stats_repo.update_by_stat_id(db_gold_stat, transaction);
+
+            after_commit(es, [company_id = cc.id, bonus_type = increase_bonus_msg->bonus_type, bonus = current_stat->second, gold = current_gold_stat->second] {
+                company_list.set_bonus(company_id, bonus_type, bonus);
+                company_list.set_bonus(company_id, company_stat_gold_id, gold);
+            });
 
-            auto new_err_msg = make_unique<increase_bonus_response>("");
+            increase_bonus_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
             auto now = chrono::system_clock::now();
@@ -119,7 +120,7 @@ namespace ibh {
                     spdlog::error("[{}] missing bonus id {} for player {}", __FUNCTION__, increase_bonus_msg->bonus_type, pc.id);
                 } else {
                     bonus->second = current_stat->second;
-                    auto update_msg = make_unique<message_response>(pc.name, message, "system-company", timestamp);
+                    message_response update_msg(pc.name, message, "system-company", timestamp);
                     outward_queue.enqueue(outward_message{pc.connection_id, move(update_msg)});
                 }
             }
@@ -127,9 +128,9 @@ namespace ibh {
             return true;
         }
         
-        auto new_err_msg = make_unique<increase_bonus_response>("Not a member of a company");
+        increase_bonus_response new_err_msg("Not a member of a company");
         outward_queue.enqueue(outward_message{increase_bonus_msg->connection_id, move(new_err_msg)});
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, increase_bonus_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, increase_bonus_msg->connection_id);
 
         return false;
     }
@@ -25,5 +25,5 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_increase_bonus(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
+    bool handle_increase_bonus(increase_bonus_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
 }
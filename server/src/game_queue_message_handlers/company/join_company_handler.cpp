@@ -30,14 +30,7 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_join_company(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *join_msg = dynamic_cast<join_company_message*>(msg);
-
-        if(join_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_join_company(join_company_message* join_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_view = es.view<pc_component>();
         for(auto entity : pc_view) {
             auto &pc = pc_view.get(entity);
@@ -46,51 +39,49 @@ namespace ibh {
                 continue;
             }
 
-            companies_repository<database_subtransaction> companies_repo{};
-            company_members_repository<database_subtransaction> company_members_repo{};
-            company_member_applications_repository<database_subtransaction> company_member_applications_repo{};
-            auto subtransaction = transaction->create_subtransaction();
+            companies_repository<database_transaction> companies_repo{};
+            company_members_repository<database_transaction> company_members_repo{};
+            company_member_applications_repository<database_transaction> company_member_applications_repo{};
 
-            auto db_company = companies_repo.get(join_msg->company_name, subtransaction);
+            auto db_company = companies_repo.get(join_msg->company_name, transaction);
             if(!db_company) {
-                auto new_err_msg = make_unique<join_company_response>("No company by that name.");
+                join_company_response new_err_msg("No company by that name.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            auto company_member = company_members_repo.get_by_character_id(pc.id, subtransaction);
+            auto company_member = company_members_repo.get_by_character_id(pc.id, transaction);
             if(company_member) {
-                auto new_err_msg = make_unique<join_company_response>("Already a member of a company, leave that company first.");
+                join_company_response new_err_msg("Already a member of a company, leave that company first.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            auto company_application = company_member_applications_repo.get(db_company->id, pc.id, subtransaction);
+            auto company_application = company_member_applications_repo.get(db_company->id, pc.id, transaction);
             if(company_application) {
-                auto new_err_msg = make_unique<join_company_response>("Already applied to company, please be patient.");
+                join_company_response new_err_msg("Already applied to company, please be patient.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             db_company_member new_member{db_company->id, pc.id, magic_enum::enum_integer(company_member_level::COMPANY_MEMBER), 0};
-            if(!company_member_applications_repo.insert(new_member, subtransaction)) {
-                auto new_err_msg = make_unique<join_company_response>("Server error.");
+            if(!company_member_applications_repo.insert(new_member, transaction)) {
+                join_company_response new_err_msg("Server error.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             send_message_to_all_company_admins(db_company->id, pc.name, "has applied for the company.", "system-company", es, outward_queue, transaction);
-            subtransaction->commit();
 
-            auto new_err_msg = make_unique<join_company_response>("");
+            join_company_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
-            spdlog::trace("[{}] left company {} for pc {} for connection id {}", __FUNCTION__, company_member->company_id, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] left company {} for pc {} for connection id {}", __FUNCTION__, company_member->company_id, pc.name, pc.connection_id);
 
             return true;
         }
 
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, join_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, join_msg->connection_id);
 
         return false;
     }
@@ -23,19 +23,13 @@
 #include <messages/company/leave_company_response.h>
 #include <repositories/companies_repository.h>
 #include <repositories/company_members_repository.h>
+#include <game_logic/company_listing.h>
 #include <game_queue_message_handlers/handler_helpers.h>
 
 using namespace std;
 
 namespace ibh {
-    bool handle_leave_company(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *leave_msg = dynamic_cast<leave_company_message*>(msg);
-
-        if(leave_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_leave_company(leave_company_message* leave_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_group = es.group<pc_component>(entt::get<company_component>);
         for(auto entity : pc_group) {
             auto [pc, cc] = pc_group.get<pc_component, company_component>(entity);
@@ -44,33 +38,39 @@ namespace ibh {
                 continue;
             }
 
-            company_members_repository<database_subtransaction> company_members_repo{};
-            auto subtransaction = transaction->create_subtransaction();
-            auto company_member = company_members_repo.get_by_character_id(pc.id, subtransaction);
+            company_members_repository<database_transaction> company_members_repo{};
+            auto company_member = company_members_repo.get_by_character_id(pc.id, transaction);
             if(!company_member) {
-                auto new_err_msg = make_unique<leave_company_response>("Not a member of a company");
+                leave_company_response new_err_msg("Not a member of a company");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            company_members_repo.remove(*company_member, subtransaction);
+            company_members_repo.remove(*company_member, transaction);
 
             send_message_to_all_company_members(company_member->company_id, pc.name, "has left the company.", "system-company", es, outward_queue, transaction);
 
-            auto new_err_msg = make_unique<leave_company_response>("");
+            leave_company_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
-            subtransaction->commit();
 
+            after_commit(es, [company_id = company_member->company_id, character_id = pc.id] {
+                company_list.remove_member(company_id, character_id);
+            });
+            record_undo(es, [entity, left_company = cc](entt::registry &registry) {
+                if(registry.valid(entity)) {
+                    registry.emplace_or_replace<company_component>(entity, left_company);
+                }
+            });
             es.remove<company_component>(entity);
 
-            spdlog::trace("[{}] left company {} for pc {} for connection id {}", __FUNCTION__, company_member->company_id, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] left company {} for pc {} for connection id {}", __FUNCTION__, company_member->company_id, pc.name, pc.connection_id);
 
             return true;
         }
 
-        auto new_err_msg = make_unique<leave_company_response>("Not a member of a company");
+        leave_company_response new_err_msg("Not a member of a company");
         outward_queue.enqueue(outward_message{leave_msg->connection_id, move(new_err_msg)});
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, leave_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, leave_msg->connection_id);
 
         return false;
     }
@@ -29,14 +29,7 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_reject_application(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *reject_msg = dynamic_cast<reject_application_message*>(msg);
-
-        if(reject_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_reject_application(reject_application_message* reject_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_view = es.view<pc_component>();
         for(auto entity : pc_view) {
             auto &pc = pc_view.get(entity);
@@ -45,42 +38,40 @@ namespace ibh {
                 continue;
             }
 
-            company_members_repository<database_subtransaction> company_members_repo{};
-            company_member_applications_repository<database_subtransaction> company_member_applications_repo{};
-            auto subtransaction = transaction->create_subtransaction();
+            company_members_repository<database_transaction> company_members_repo{};
+            company_member_applications_repository<database_transaction> company_member_applications_repo{};
 
-            auto company_member = company_members_repo.get_by_character_id(pc.id, subtransaction);
+            auto company_member = company_members_repo.get_by_character_id(pc.id, transaction);
             if(!company_member) {
-                auto new_err_msg = make_unique<reject_application_response>("Not a member of a company");
+                reject_application_response new_err_msg("Not a member of a company");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             if(company_member->member_level == magic_enum::enum_integer(company_member_level::COMPANY_MEMBER)) {
-                auto new_err_msg = make_unique<reject_application_response>("Not an admin");
+                reject_application_response new_err_msg("Not an admin");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            auto company_application = company_member_applications_repo.get(company_member->company_id, reject_msg->applicant_id, subtransaction);
+            auto company_application = company_member_applications_repo.get(company_member->company_id, reject_msg->applicant_id, transaction);
             if(!company_application) {
-                auto new_err_msg = make_unique<reject_application_response>("No applicant by that name.");
+                reject_application_response new_err_msg("No applicant by that name.");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            company_member_applications_repo.remove(*company_application, subtransaction);
-            subtransaction->commit();
+            company_member_applications_repo.remove(*company_application, transaction);
 
-            auto new_err_msg = make_unique<reject_application_response>("");
+            reject_application_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
-            spdlog::trace("[{}] rejected applicant {} company {} by pc {} connection id {}", __FUNCTION__, reject_msg->applicant_id, company_member->company_id, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] rejected applicant {} company {} by pc {} connection id {}", __FUNCTION__, reject_msg->applicant_id, company_member->company_id, pc.name, pc.connection_id);
 
             return true;
         }
 
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, reject_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, reject_msg->connection_id);
 
         return false;
     }
@@ -25,5 +25,5 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_reject_application(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
+    bool handle_reject_application(reject_application_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
 }
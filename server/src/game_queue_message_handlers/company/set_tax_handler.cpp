@@ -24,20 +24,14 @@
 #include <messages/chat/message_response.h>
 #include <repositories/companies_repository.h>
 #include <repositories/company_stats_repository.h>
+#include <game_logic/company_listing.h>
 #include <game_queue_message_handlers/handler_helpers.h>
 #include <magic_enum.hpp>
 
 using namespace std;
 
 namespace ibh {
-    bool handle_set_tax(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *set_tax_msg = dynamic_cast<set_tax_message*>(msg);
-
-        if(set_tax_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_set_tax(set_tax_message* set_tax_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_group = es.group<pc_component>(entt::get<company_component>);
         for(auto entity : pc_group) {
             auto [pc, cc] = pc_group.get<pc_component, company_component>(entity);
@@ -47,26 +41,31 @@ namespace ibh {
             }
 
             if(cc.member_level == magic_enum::enum_integer(company_member_level::COMPANY_MEMBER)) {
-                auto new_err_msg = make_unique<set_tax_response>("Not an admin");
+                set_tax_response new_err_msg("Not an admin");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
             auto current_stat = cc.stats.find(company_stat_tax_id);
             if(current_stat == end(cc.stats)) {
-                auto new_err_msg = make_unique<set_tax_response>("Couldn't find tax stat, please file a bug report");
+                set_tax_response new_err_msg("Couldn't find tax stat, please file a bug report");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
 
-            company_stats_repository<database_subtransaction> company_stats_repo{};
-            auto subtransaction = transaction->create_subtransaction();
+            company_stats_repository<database_transaction> company_stats_repo{};
+            record_undo(es, [entity, company_id = cc.id, tax = current_stat->second](entt::registry &registry) {
+                restore_company_stat(registry, entity, company_id, company_stat_tax_id, tax);
+            });
             current_stat->second = min(set_tax_msg->tax_percentage, 100u);
             db_company_stat db_tax_stat{0, cc.id, company_stat_tax_id, current_stat->second};
-            company_stats_repo.update_by_stat_id(db_tax_stat, subtransaction);
-            subtransaction->commit();
+            company_stats_repo.update_by_stat_id(db_tax_stat, transaction);
+
+            after_commit(es, [company_id = cc.id, tax = current_stat->second] {
+                company_list.set_bonus(company_id, company_stat_tax_id, tax);
+            });
 
-            auto new_err_msg = make_unique<set_tax_response>("");
+            set_tax_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
 
@@ -85,7 +84,7 @@ namespace ibh {
                     spdlog::error("[{}] missing stat tax id for player {}", __FUNCTION__, pc.id);
                 } else {
                     tax->second = current_stat->second;
-                    auto update_msg = make_unique<message_response>(pc.name, message, "system-company", timestamp);
+                    message_response update_msg(pc.name, message, "system-company", timestamp);
                     outward_queue.enqueue(outward_message{pc.connection_id, move(update_msg)});
                 }
             }
@@ -93,9 +92,9 @@ namespace ibh {
             return true;
         }
 
-        auto new_err_msg = make_unique<set_tax_response>("Not a member of a company");
+        set_tax_response new_err_msg("Not a member of a company");
         outward_queue.enqueue(outward_message{set_tax_msg->connection_id, move(new_err_msg)});
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, set_tax_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, set_tax_msg->connection_id);
 
         return false;
     }
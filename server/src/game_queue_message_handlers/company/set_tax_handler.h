@@ -25,5 +25,5 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_set_tax(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
+    bool handle_set_tax(set_tax_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
 }
@@ -0,0 +1,83 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <variant>
+#include <spdlog/spdlog.h>
+#include <game_queue_message_handlers/player_enter_handler.h>
+#include <game_queue_message_handlers/player_leave_handler.h>
+#include <game_queue_message_handlers/company/accept_application_handler.h>
+#include <game_queue_message_handlers/company/create_company_handler.h>
+#include <game_queue_message_handlers/company/increase_bonus_handler.h>
+#include <game_queue_message_handlers/company/join_company_handler.h>
+#include <game_queue_message_handlers/company/leave_company_handler.h>
+#include <game_queue_message_handlers/company/reject_application_handler.h>
+#include <game_queue_message_handlers/company/set_tax_handler.h>
+#include <game_queue_message_handlers/resources/set_action_handler.h>
+
+using namespace std;
+
+namespace ibh {
+    // std::visit picks the handler from the alternative the variant holds, so there is no lookup and no downcast.
+    struct game_queue_visitor {
+        entt::registry &es;
+        outward_queues &outward_queue;
+        unique_ptr<database_transaction> const &transaction;
+
+        bool operator()(player_enter_message &msg) const { return handle_player_enter_message(&msg, es, outward_queue, transaction); }
+        bool operator()(player_leave_message &msg) const { return handle_player_leave_message(&msg, es, outward_queue, transaction); }
+
+        // companies
+        bool operator()(accept_application_message &msg) const { return handle_accept_application(&msg, es, outward_queue, transaction); }
+        bool operator()(create_company_message &msg) const { return handle_create_company(&msg, es, outward_queue, transaction); }
+        bool operator()(increase_bonus_message &msg) const { return handle_increase_bonus(&msg, es, outward_queue, transaction); }
+        bool operator()(join_company_message &msg) const { return handle_join_company(&msg, es, outward_queue, transaction); }
+        bool operator()(leave_company_message &msg) const { return handle_leave_company(&msg, es, outward_queue, transaction); }
+        bool operator()(reject_application_message &msg) const { return handle_reject_application(&msg, es, outward_queue, transaction); }
+        bool operator()(set_tax_message &msg) const { return handle_set_tax(&msg, es, outward_queue, transaction); }
+
+        // resources
+        bool operator()(set_action_message &msg) const { return handle_set_action(&msg, es, outward_queue, transaction); }
+
+        bool operator()(player_move_message &msg) const {
+            spdlog::error("[{}] missing game queue handler for type {}", __FUNCTION__, msg.type);
+            return false;
+        }
+
+        bool operator()(monostate) const {
+            spdlog::error("[{}] empty game queue message", __FUNCTION__);
+            return false;
+        }
+    };
+
+    // the generate_type<T>() of the held message, 0 when empty
+    [[nodiscard]] inline uint64_t get_queue_message_type(queue_message const &msg) noexcept {
+        return visit([](auto const &m) -> uint64_t {
+            if constexpr (is_same_v<decay_t<decltype(m)>, monostate>) {
+                return 0;
+            } else {
+                return m.type;
+            }
+        }, msg);
+    }
+
+    inline bool handle_game_queue_message(queue_message &msg, entt::registry &es, outward_queues &outward_queue, unique_ptr<database_transaction> const &transaction) {
+        return visit(game_queue_visitor{es, outward_queue, transaction}, msg);
+    }
+}
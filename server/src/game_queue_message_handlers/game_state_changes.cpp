@@ -0,0 +1,65 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "game_state_changes.h"
+#include <iterator>
+
+using namespace std;
+
+namespace ibh {
+    void game_state_changes::undo(entt::registry &es) {
+        for(auto it = rbegin(undo_steps); it != rend(undo_steps); ++it) {
+            (*it)(es);
+        }
+        clear();
+    }
+
+    void game_state_changes::committed() {
+        for(auto &step : commit_steps) {
+            step();
+        }
+        clear();
+    }
+
+    void game_state_changes::append(game_state_changes &&other) {
+        undo_steps.insert(end(undo_steps), make_move_iterator(begin(other.undo_steps)), make_move_iterator(end(other.undo_steps)));
+        commit_steps.insert(end(commit_steps), make_move_iterator(begin(other.commit_steps)), make_move_iterator(end(other.commit_steps)));
+        other.clear();
+    }
+
+    void game_state_changes::clear() noexcept {
+        undo_steps.clear();
+        commit_steps.clear();
+    }
+
+    void record_undo(entt::registry &es, function<void(entt::registry&)> step) {
+        auto *changes = es.try_ctx<game_state_changes>();
+        if(changes != nullptr) {
+            changes->undo_steps.push_back(move(step));
+        }
+    }
+
+    void after_commit(entt::registry &es, function<void()> step) {
+        auto *changes = es.try_ctx<game_state_changes>();
+        if(changes == nullptr) {
+            step();
+            return;
+        }
+        changes->commit_steps.push_back(move(step));
+    }
+}
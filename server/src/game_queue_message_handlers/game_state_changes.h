@@ -0,0 +1,50 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <entt/entity/registry.hpp>
+
+using namespace std;
+
+namespace ibh {
+    // In-memory changes made by game queue handlers whose database writes are not committed yet.
+    //
+    // The game loop keeps one in the registry context for the message being handled. Handlers record how to undo every change
+    // to the registry, which the game loop runs when the message's savepoint or the tick's commit is rolled back.
+    // Changes other threads can see, such as the company listing, are deferred with after_commit(). In group commit mode those
+    // steps run on the commit thread, so they must not touch the registry.
+    struct game_state_changes {
+        vector<function<void(entt::registry&)>> undo_steps;
+        vector<function<void()>> commit_steps;
+
+        // runs the undo steps newest first and forgets about the commit steps
+        void undo(entt::registry &es);
+        // runs the commit steps in the order they were recorded and forgets about the undo steps
+        void committed();
+        void append(game_state_changes &&other);
+        void clear() noexcept;
+    };
+
+    // records how to undo a change to the registry, dropped when nothing tracks changes such as in the handler tests
+    void record_undo(entt::registry &es, function<void(entt::registry&)> step);
+    // runs step once the message's transaction committed, right away when nothing tracks changes
+    void after_commit(entt::registry &es, function<void()> step);
+}
@@ -40,7 +40,7 @@ namespace ibh {
                 continue;
             }
 
-            auto new_applicant_msg = make_unique<message_response>(playername, message, source, timestamp);
+            message_response new_applicant_msg(playername, message, source, timestamp);
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_applicant_msg)});
         }
     }
@@ -49,7 +49,8 @@ namespace ibh {
     void send_message(vector<db_company_member> const &data, string const &playername, string const &message, string const &source, entt::registry &es, outward_queues &outward_queue) {
         auto now = chrono::system_clock::now();
         auto timestamp = duration_cast<chrono::milliseconds>(now.time_since_epoch()).count();
-        auto pc_view = es.view<pc_component>();
+        ibh_unordered_set<uint64_t> recipient_ids;
+        recipient_ids.reserve(data.size());
         for (auto const &member : data) {
             if constexpr(AdminOnly) {
                 if (member.member_level == magic_enum::enum_integer(company_member_level::COMPANY_MEMBER)) {
@@ -57,16 +58,20 @@ namespace ibh {
                 }
             }
 
-            for (auto company_entity : pc_view) {
-                auto &pc = pc_view.template get<pc_component>(company_entity);
+            recipient_ids.insert(member.character_id);
+        }
 
-                if (member.character_id != pc.id) {
-                    continue;
-                }
+        // single pass over the players instead of one per member
+        auto pc_view = es.view<pc_component>();
+        for (auto company_entity : pc_view) {
+            auto &pc = pc_view.template get<pc_component>(company_entity);
 
-                auto new_applicant_msg = make_unique<message_response>(playername, message, source, timestamp);
-                outward_queue.enqueue(outward_message{pc.connection_id, move(new_applicant_msg)});
+            if (!recipient_ids.contains(pc.id)) {
+                continue;
             }
+
+            message_response new_applicant_msg(playername, message, source, timestamp);
+            outward_queue.enqueue(outward_message{pc.connection_id, move(new_applicant_msg)});
         }
     }
 
@@ -145,4 +150,15 @@ namespace ibh {
 
         return nullptr;
     }
+
+    void restore_company_stat(entt::registry &es, entt::entity entity, uint64_t company_id, uint32_t stat_id, int64_t value) {
+        if(!es.valid(entity) || !es.has<company_component>(entity)) {
+            return;
+        }
+
+        auto &cc = es.get<company_component>(entity);
+        if(cc.id == company_id) {
+            cc.stats[stat_id] = value;
+        }
+    }
 }
\ No newline at end of file
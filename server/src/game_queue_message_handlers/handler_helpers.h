@@ -21,6 +21,7 @@
 #include <database/database_transaction.h>
 #include <game_queue_messages/messages.h>
 #include <ecs/components.h>
+#include "game_state_changes.h"
 
 using namespace std;
 
@@ -33,4 +34,6 @@ namespace ibh {
     pc_component* get_player_component_for_connection(uint64_t connection_id, entt::registry &es);
     optional<entt::entity> get_player_entity(uint64_t player_id, entt::registry &es);
     pc_component* get_player_component(uint64_t player_id, entt::registry &es);
+    // puts back a stat of the player's company when a change to it didn't commit
+    void restore_company_stat(entt::registry &es, entt::entity entity, uint64_t company_id, uint32_t stat_id, int64_t value);
 }
\ No newline at end of file
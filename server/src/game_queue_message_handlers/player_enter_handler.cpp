@@ -25,14 +25,7 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_player_enter_message(queue_message* msg, entt::registry& registry, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *enter_msg = dynamic_cast<player_enter_message*>(msg);
-
-        if(enter_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_player_enter_message(player_enter_message* enter_msg, entt::registry& registry, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_bc_group = registry.view<pc_component>();
         for(auto entity : pc_bc_group) {
             auto &pc = pc_bc_group.get<pc_component>(entity);
@@ -42,7 +35,7 @@ namespace ibh {
             }
 
             pc.connection_id = enter_msg->connection_id;
-            spdlog::trace("[{}] found pc {} for connection id {}", __FUNCTION__, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] found pc {} for connection id {}", __FUNCTION__, pc.name, pc.connection_id);
 
             if(registry.has<battle_component>(entity)) {
                 auto &bc = registry.get<battle_component>(entity);
@@ -50,7 +43,7 @@ namespace ibh {
                 auto mob_max_hp = bc.monster_stats.find(stat_max_hp_id);
                 auto player_hp = bc.total_player_stats.find(stat_hp_id);
                 auto player_max_hp = bc.total_player_stats.find(stat_max_hp_id);
-                auto new_battle_msg = make_unique<new_battle_response>(bc.monster_name, bc.monster_level, mob_hp->second, mob_max_hp->second, player_hp->second,
+                new_battle_response new_battle_msg(bc.monster_name, bc.monster_level, mob_hp->second, mob_max_hp->second, player_hp->second,
                                                                        player_max_hp->second);
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_battle_msg)});
             }
@@ -58,7 +51,7 @@ namespace ibh {
             return true;
         }
 
-        spdlog::trace("[{}] could not find pc {} conn id {}", __FUNCTION__, enter_msg->character_id, enter_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find pc {} conn id {}", __FUNCTION__, enter_msg->character_id, enter_msg->connection_id);
         return false;
     }
 }
@@ -25,5 +25,5 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_player_enter_message(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
+    bool handle_player_enter_message(player_enter_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
 }
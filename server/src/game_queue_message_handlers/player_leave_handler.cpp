@@ -24,14 +24,7 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_player_leave_message(queue_message* msg, entt::registry& registry, outward_queues&, unique_ptr<database_transaction> const &transaction) {
-        auto *leave_message = dynamic_cast<player_leave_message*>(msg);
-
-        if(leave_message == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_player_leave_message(player_leave_message* leave_message, entt::registry& registry, outward_queues&, unique_ptr<database_transaction> const &transaction) {
         auto pc_view = registry.view<pc_component>();
         for(auto entity : pc_view) {
             auto &pc = pc_view.get(entity);
@@ -40,13 +33,13 @@ namespace ibh {
                 continue;
             }
 
-            spdlog::trace("[{}] found pc {} for connection id {}", __FUNCTION__, pc.name, pc.connection_id);
+            SPDLOG_TRACE("[{}] found pc {} for connection id {}", __FUNCTION__, pc.name, pc.connection_id);
             pc.connection_id = 0;
 
             return true;
         }
 
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, leave_message->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, leave_message->connection_id);
         return false;
     }
 }
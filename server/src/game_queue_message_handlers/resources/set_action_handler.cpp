@@ -27,14 +27,7 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_set_action(queue_message* msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
-        auto *set_action_msg = dynamic_cast<set_action_message*>(msg);
-
-        if(set_action_msg == nullptr) {
-            spdlog::error("[{}] nullptr", __FUNCTION__);
-            return false;
-        }
-
+    bool handle_set_action(set_action_message* set_action_msg, entt::registry& es, outward_queues& outward_queue, unique_ptr<database_transaction> const &transaction) {
         auto pc_group = es.view<pc_component>();
         for(auto entity : pc_group) {
             auto &pc = pc_group.get<pc_component>(entity);
@@ -45,7 +38,7 @@ namespace ibh {
 
 
             if(!magic_enum::enum_contains<selectable_actions>(set_action_msg->action_id)) {
-                auto new_err_msg = make_unique<set_action_response>("Wrong action id");
+                set_action_response new_err_msg("Wrong action id");
                 outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                 return false;
             }
@@ -98,20 +91,20 @@ namespace ibh {
                     es.emplace<working_component>(entity);
                     break;
                 default:
-                    auto new_err_msg = make_unique<set_action_response>("Wrong action id");
+                    set_action_response new_err_msg("Wrong action id");
                     outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
                     return false;
             }
 
-            auto new_err_msg = make_unique<set_action_response>("");
+            set_action_response new_err_msg("");
             outward_queue.enqueue(outward_message{pc.connection_id, move(new_err_msg)});
 
             return true;
         }
 
-        auto new_err_msg = make_unique<set_action_response>("Couldn't find you");
+        set_action_response new_err_msg("Couldn't find you");
         outward_queue.enqueue(outward_message{set_action_msg->connection_id, move(new_err_msg)});
-        spdlog::trace("[{}] could not find conn id {}", __FUNCTION__, set_action_msg->connection_id);
+        SPDLOG_TRACE("[{}] could not find conn id {}", __FUNCTION__, set_action_msg->connection_id);
 
         return false;
     }
@@ -25,5 +25,5 @@
 using namespace std;
 
 namespace ibh {
-    bool handle_set_action(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
+    bool handle_set_action(set_action_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &transaction);
 }
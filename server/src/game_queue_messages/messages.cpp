@@ -21,37 +21,47 @@
 
 namespace ibh {
     player_enter_message::player_enter_message(uint64_t character_id, string character_name, string race, string baseclass, vector <stat_component> player_stats, uint64_t connection_id, uint64_t level, uint64_t gold, uint64_t xp, uint64_t skill_points) noexcept
-            : queue_message(_type, connection_id), character_id(character_id), character_name(move(character_name)), race(move(race)), baseclass(move(baseclass)),
+            : queue_message_base(_type, connection_id), character_id(character_id), character_name(move(character_name)), race(move(race)), baseclass(move(baseclass)),
             player_stats(move(player_stats)), level(level), gold(gold), xp(xp), skill_points(skill_points) {}
 
     player_leave_message::player_leave_message(uint64_t connection_id) noexcept
-            : queue_message(_type, connection_id) {}
+            : queue_message_base(_type, connection_id) {}
 
     player_move_message::player_move_message(uint64_t connection_id, uint32_t x, uint32_t y) noexcept
-            : queue_message(_type, connection_id), x(x), y(y) {}
+            : queue_message_base(_type, connection_id), x(x), y(y) {}
 
     accept_application_message::accept_application_message(uint64_t connection_id, uint64_t applicant_id) noexcept
-            : queue_message(_type, connection_id), applicant_id(applicant_id) {}
+            : queue_message_base(_type, connection_id), applicant_id(applicant_id) {}
 
     create_company_message::create_company_message(uint64_t connection_id, string company_name, uint16_t company_type) noexcept
-            : queue_message(_type, connection_id), company_name(move(company_name)), company_type(company_type) {}
+            : queue_message_base(_type, connection_id), company_name(move(company_name)), company_type(company_type) {}
 
     increase_bonus_message::increase_bonus_message(uint64_t connection_id, uint32_t bonus_type) noexcept
-            : queue_message(_type, connection_id), bonus_type(bonus_type) {}
+            : queue_message_base(_type, connection_id), bonus_type(bonus_type) {}
 
     join_company_message::join_company_message(uint64_t connection_id, string company_name) noexcept
-            : queue_message(_type, connection_id), company_name(move(company_name)) {}
+            : queue_message_base(_type, connection_id), company_name(move(company_name)) {}
 
     leave_company_message::leave_company_message(uint64_t connection_id) noexcept
-            : queue_message(_type, connection_id) {}
+            : queue_message_base(_type, connection_id) {}
 
     reject_application_message::reject_application_message(uint64_t connection_id, uint64_t applicant_id) noexcept
-            : queue_message(_type, connection_id), applicant_id(applicant_id) {}
+            : queue_message_base(_type, connection_id), applicant_id(applicant_id) {}
 
     set_tax_message::set_tax_message(uint64_t connection_id, uint32_t tax_percentage) noexcept
-            : queue_message(_type, connection_id), tax_percentage(tax_percentage) {}
+            : queue_message_base(_type, connection_id), tax_percentage(tax_percentage) {}
 
-    set_action_message::set_action_message(uint64_t connection_id, uint32_t action_id) noexcept : queue_message(_type, connection_id), action_id(action_id) {
+    set_action_message::set_action_message(uint64_t connection_id, uint32_t action_id) noexcept : queue_message_base(_type, connection_id), action_id(action_id) {
 
     }
+
+    string serialize_response(outward_response const &response) {
+        return visit([](auto const &resp) -> string {
+            if constexpr (is_same_v<decay_t<decltype(resp)>, monostate>) {
+                return {};
+            } else {
+                return resp.serialize();
+            }
+        }, response);
+    }
 }
@@ -19,118 +19,92 @@
 #pragma once
 
 #include <string>
+#include <variant>
 #include <vector>
 #include <ibh_containers.h>
+#include <common_components.h>
 #include <messages/message.h>
+#include <messages/generic_error_response.h>
+#include <messages/battle/battle_finished_response.h>
+#include <messages/battle/battle_update_response.h>
+#include <messages/battle/level_up_response.h>
+#include <messages/battle/new_battle_response.h>
+#include <messages/chat/message_response.h>
+#include <messages/company/accept_application_response.h>
+#include <messages/company/create_company_response.h>
+#include <messages/company/increase_bonus_response.h>
+#include <messages/company/join_company_response.h>
+#include <messages/company/leave_company_response.h>
+#include <messages/company/reject_application_response.h>
+#include <messages/company/set_tax_response.h>
+#include <messages/resources/resource_update_response.h>
+#include <messages/resources/set_action_response.h>
 #include "queue_abstraction.h"
 
 using namespace std;
 
 namespace ibh {
-    struct stat_component;
-    using outward_queues = queue_abstraction<outward_message>;
-
-    struct queue_message {
+    struct queue_message_base {
         uint64_t type;
         uint64_t connection_id;
 
-        queue_message(uint64_t type, uint64_t connection_id) noexcept : type(type), connection_id(connection_id) {}
-        virtual ~queue_message() = default;
-        queue_message(const queue_message&) noexcept = default;
-        queue_message(queue_message&&) noexcept = default;
-        queue_message& operator=(const queue_message &) noexcept = default;
-        queue_message& operator=(queue_message&&) noexcept = default;
+        queue_message_base(uint64_t type, uint64_t connection_id) noexcept : type(type), connection_id(connection_id) {}
     };
 
     // company
 
-    struct accept_application_message : queue_message {
+    struct accept_application_message : queue_message_base {
         uint64_t applicant_id;
         static constexpr uint64_t _type = generate_type<accept_application_message>();
 
         accept_application_message(uint64_t connection_id, uint64_t applicant_id) noexcept;
-        ~accept_application_message() override = default;
-        accept_application_message(const accept_application_message&) noexcept = default;
-        accept_application_message(accept_application_message&&) noexcept = default;
-        accept_application_message& operator=(const accept_application_message &) noexcept = default;
-        accept_application_message& operator=(accept_application_message&&) noexcept = default;
     };
 
-    struct create_company_message : queue_message {
+    struct create_company_message : queue_message_base {
         string company_name;
         uint16_t company_type;
         static constexpr uint64_t _type = generate_type<create_company_message>();
 
         create_company_message(uint64_t connection_id, string company_name, uint16_t company_type) noexcept;
-        ~create_company_message() override = default;
-        create_company_message(const create_company_message&) = default;
-        create_company_message(create_company_message&&) noexcept = default;
-        create_company_message& operator=(const create_company_message &) = default;
-        create_company_message& operator=(create_company_message&&) noexcept = default;
     };
 
-    struct increase_bonus_message : queue_message {
+    struct increase_bonus_message : queue_message_base {
         uint32_t bonus_type;
         static constexpr uint64_t _type = generate_type<increase_bonus_message>();
 
         increase_bonus_message(uint64_t connection_id, uint32_t bonus_type) noexcept;
-        ~increase_bonus_message() override = default;
-        increase_bonus_message(const increase_bonus_message&) noexcept = default;
-        increase_bonus_message(increase_bonus_message&&) noexcept = default;
-        increase_bonus_message& operator=(const increase_bonus_message &) noexcept = default;
-        increase_bonus_message& operator=(increase_bonus_message&&) noexcept = default;
     };
 
-    struct join_company_message : queue_message {
+    struct join_company_message : queue_message_base {
         string company_name;
         static constexpr uint64_t _type = generate_type<join_company_message>();
 
         join_company_message(uint64_t connection_id, string company_name) noexcept;
-        ~join_company_message() override = default;
-        join_company_message(const join_company_message&) = default;
-        join_company_message(join_company_message&&) noexcept = default;
-        join_company_message& operator=(const join_company_message &) = default;
-        join_company_message& operator=(join_company_message&&) noexcept = default;
     };
 
-    struct leave_company_message : queue_message {
+    struct leave_company_message : queue_message_base {
         static constexpr uint64_t _type = generate_type<leave_company_message>();
 
         explicit leave_company_message(uint64_t connection_id) noexcept;
-        ~leave_company_message() override = default;
-        leave_company_message(const leave_company_message&) noexcept = default;
-        leave_company_message(leave_company_message&&) noexcept = default;
-        leave_company_message& operator=(const leave_company_message &) noexcept = default;
-        leave_company_message& operator=(leave_company_message&&) noexcept = default;
     };
 
-    struct reject_application_message : queue_message {
+    struct reject_application_message : queue_message_base {
         uint64_t applicant_id;
         static constexpr uint64_t _type = generate_type<reject_application_message>();
 
         reject_application_message(uint64_t connection_id, uint64_t applicant_id) noexcept;
-        ~reject_application_message() override = default;
-        reject_application_message(const reject_application_message&) noexcept = default;
-        reject_application_message(reject_application_message&&) noexcept = default;
-        reject_application_message& operator=(const reject_application_message &) noexcept = default;
-        reject_application_message& operator=(reject_application_message&&) noexcept = default;
     };
 
-    struct set_tax_message : queue_message {
+    struct set_tax_message : queue_message_base {
         uint32_t tax_percentage;
         static constexpr uint64_t _type = generate_type<set_tax_message>();
 
         set_tax_message(uint64_t connection_id, uint32_t tax_percentage) noexcept;
-        ~set_tax_message() override = default;
-        set_tax_message(const set_tax_message&) noexcept = default;
-        set_tax_message(set_tax_message&&) noexcept = default;
-        set_tax_message& operator=(const set_tax_message &) noexcept = default;
-        set_tax_message& operator=(set_tax_message&&) noexcept = default;
     };
 
     // resources
 
-    struct set_action_message : queue_message {
+    struct set_action_message : queue_message_base {
         uint32_t action_id;
         static constexpr uint64_t _type = generate_type<set_action_message>();
 
@@ -139,7 +113,7 @@ namespace ibh {
 
     // uac
 
-    struct player_enter_message : queue_message {
+    struct player_enter_message : queue_message_base {
         uint64_t character_id;
         string character_name;
         string race;
@@ -154,17 +128,35 @@ namespace ibh {
         player_enter_message(uint64_t character_id, string character_name, string race, string baseclass, vector<stat_component> player_stats, uint64_t connection_id, uint64_t level, uint64_t gold, uint64_t xp, uint64_t skill_points) noexcept;
     };
 
-    struct player_leave_message : queue_message {
+    struct player_leave_message : queue_message_base {
         static constexpr uint64_t _type = generate_type<player_leave_message>();
 
         explicit player_leave_message(uint64_t connection_id) noexcept;
     };
 
-    struct player_move_message : queue_message {
+    struct player_move_message : queue_message_base {
         static constexpr uint64_t _type = generate_type<player_move_message>();
         uint32_t x;
         uint32_t y;
 
         player_move_message(uint64_t connection_id, uint32_t x, uint32_t y) noexcept;
     };
+
+    // Messages are passed by value through the queues, so that enqueueing doesn't need a heap allocation per message.
+    // monostate is only there to give try_dequeue something to default construct, it is never enqueued.
+    using queue_message = variant<monostate, player_enter_message, player_leave_message, player_move_message, accept_application_message, create_company_message,
+                                  increase_bonus_message, join_company_message, leave_company_message, reject_application_message, set_tax_message, set_action_message>;
+
+    using outward_response = variant<monostate, generic_error_response, battle_finished_response, battle_update_response, level_up_response, new_battle_response,
+                                     message_response, accept_application_response, create_company_response, increase_bonus_response, join_company_response,
+                                     leave_company_response, reject_application_response, set_tax_response, resource_update_response, set_action_response>;
+
+    struct outward_message {
+        uint64_t conn_id;
+        outward_response msg;
+    };
+
+    using outward_queues = queue_abstraction<outward_message>;
+
+    string serialize_response(outward_response const &response);
 }
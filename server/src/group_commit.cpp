@@ -0,0 +1,159 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "group_commit.h"
+#include <spdlog/spdlog.h>
+#include <ibh_containers.h>
+#include <messages/generic_error_response.h>
+#include <game_queue_message_handlers/game_queue_router.h>
+#include <metrics/metrics.h>
+#include <tracing.h>
+
+using namespace std;
+using namespace ibh;
+
+group_commit_counters ibh::commit_stats{};
+
+optional<game_queue_commit_mode> ibh::parse_game_queue_commit_mode(string const &mode) noexcept {
+    if(mode == "per_message") {
+        return game_queue_commit_mode::per_message;
+    }
+
+    if(mode == "group") {
+        return game_queue_commit_mode::group;
+    }
+
+    return {};
+}
+
+bool ibh::handle_grouped_game_queue_message(queue_message &msg, entt::registry &es, outward_queues &outward_queue, unique_ptr<database_transaction> const &transaction,
+                                             game_state_changes &tick_changes) {
+    auto *changes = es.try_ctx<game_state_changes>();
+    if(changes == nullptr) {
+        changes = &es.set<game_state_changes>();
+    }
+
+    transaction->savepoint("game_queue_message");
+    bool handled = false;
+    try {
+        handled = handle_game_queue_message(msg, es, outward_queue, transaction);
+    } catch (exception const &e) {
+        spdlog::error("[{}] game queue message {} failed: {}", __FUNCTION__, get_queue_message_type(msg), e.what());
+    }
+
+    if(!handled) {
+        transaction->rollback_to_savepoint();
+        changes->undo(es);
+        return false;
+    }
+
+    transaction->release_savepoint();
+    tick_changes.append(move(*changes));
+    return true;
+}
+
+group_committer::group_committer(moodycamel::ConcurrentQueue<outward_message> *outward_queue)
+    : _outward_queue(outward_queue), _transaction(), _responses(), _messages(), _changes(), _rolled_back(), _mutex(), _cv(), _pending(false), _stop(false), _thread() {
+    _thread = thread([this] { run(); });
+}
+
+group_committer::~group_committer() {
+    {
+        lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+void group_committer::wait_idle() {
+    unique_lock lock(_mutex);
+    _cv.wait(lock, [this] { return !_pending; });
+}
+
+void group_committer::commit_async(unique_ptr<database_transaction> transaction, vector<outward_message> responses, uint64_t messages, game_state_changes changes) {
+    wait_idle();
+    {
+        lock_guard lock(_mutex);
+        _transaction = move(transaction);
+        _responses = move(responses);
+        _messages = messages;
+        _changes = move(changes);
+        _pending = true;
+    }
+    _cv.notify_all();
+}
+
+vector<game_state_changes> group_committer::take_rolled_back() {
+    lock_guard lock(_mutex);
+    return exchange(_rolled_back, {});
+}
+
+void group_committer::run() {
+    unique_lock lock(_mutex);
+    while(true) {
+        // a batch handed over right before stopping is still committed
+        _cv.wait(lock, [this] { return _pending || _stop; });
+        if(!_pending) {
+            return;
+        }
+        lock.unlock();
+
+        bool committed = true;
+        {
+            scoped_histogram_timer timer(&metrics.db_commit_us);
+            IBH_TRACE_SCOPE(database, "group_commit");
+            try {
+                _transaction->commit();
+            } catch (exception const &e) {
+                spdlog::error("[{}] commit of {} game queue messages failed: {}", __FUNCTION__, _messages, e.what());
+                committed = false;
+            }
+        }
+        // releases the connection back to the pool
+        _transaction.reset();
+
+        if(committed) {
+            commit_stats.commits.fetch_add(1, memory_order_relaxed);
+            commit_stats.committed_messages.fetch_add(_messages, memory_order_relaxed);
+            _changes.committed();
+            for(auto &response : _responses) {
+                _outward_queue.enqueue(move(response));
+            }
+        } else {
+            commit_stats.failed_commits.fetch_add(1, memory_order_relaxed);
+            // the game state already moved on, at least let the players involved know something went wrong
+            ibh_unordered_set<uint64_t> notified;
+            for(auto const &response : _responses) {
+                if(response.conn_id != 0 && notified.insert(response.conn_id).second) {
+                    _outward_queue.enqueue(outward_message{response.conn_id, generic_error_response("Server error", "", "", false)});
+                }
+            }
+        }
+        _responses.clear();
+
+        lock.lock();
+        if(!committed) {
+            _rolled_back.push_back(move(_changes));
+        }
+        _changes.clear();
+        _pending = false;
+        _cv.notify_all();
+    }
+}
@@ -0,0 +1,97 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <database/database_transaction.h>
+#include <game_queue_messages/messages.h>
+#include <game_queue_message_handlers/game_state_changes.h>
+
+using namespace std;
+
+namespace ibh {
+    enum class game_queue_commit_mode : uint32_t {
+        // every game queue message gets its own transaction and commit
+        per_message,
+        // all messages drained in a tick share one transaction, committed by group_committer
+        group
+    };
+
+    [[nodiscard]] optional<game_queue_commit_mode> parse_game_queue_commit_mode(string const &mode) noexcept;
+
+    struct group_commit_counters {
+        atomic<uint64_t> commits;
+        atomic<uint64_t> failed_commits;
+        atomic<uint64_t> committed_messages;
+    };
+
+    extern group_commit_counters commit_stats;
+
+    // Handles a game queue message as part of the transaction shared by the tick. When its handler fails or throws, the message's
+    // database writes are rolled back to a savepoint taken before it and its in-memory changes are undone, so the other messages
+    // of the tick still commit. The changes of a handled message are appended to tick_changes.
+    bool handle_grouped_game_queue_message(queue_message &msg, entt::registry &es, outward_queues &outward_queue, unique_ptr<database_transaction> const &transaction,
+                                           game_state_changes &tick_changes);
+
+    // Commits the transaction shared by a tick's game queue messages on a background thread.
+    //
+    // Responses produced while handling those messages are held back and only enqueued on the outward queue once
+    // the commit succeeded, so clients never see results that could still be rolled back. The after commit steps of the
+    // tick's game state changes run on the commit thread right before that, the undo steps of a failed commit are handed
+    // back to the game loop through take_rolled_back().
+    // At most one commit is in flight. wait_idle() blocks until it's done, which the game loop calls before opening
+    // the next tick's transaction so that it always reads the previous tick's writes.
+    class group_committer {
+    public:
+        explicit group_committer(moodycamel::ConcurrentQueue<outward_message> *outward_queue);
+        ~group_committer();
+
+        group_committer(group_committer const &) = delete;
+        group_committer& operator=(group_committer const &) = delete;
+
+        void wait_idle();
+        // messages is the number of game queue messages handled in the transaction
+        void commit_async(unique_ptr<database_transaction> transaction, vector<outward_message> responses, uint64_t messages, game_state_changes changes);
+        // changes of failed commits, oldest first, the game loop has to undo them before handling new messages
+        [[nodiscard]] vector<game_state_changes> take_rolled_back();
+
+    private:
+        void run();
+
+        outward_queues _outward_queue;
+        unique_ptr<database_transaction> _transaction;
+        vector<outward_message> _responses;
+        uint64_t _messages;
+        game_state_changes _changes;
+        vector<game_state_changes> _rolled_back;
+        mutex _mutex;
+        condition_variable _cv;
+        bool _pending;
+        bool _stop;
+        thread _thread;
+    };
+}
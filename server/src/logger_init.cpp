@@ -20,15 +20,33 @@
 
 #include <spdlog/spdlog.h>
 #include "spdlog/sinks/stdout_color_sinks.h"
-#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+#include "spdlog/async.h"
 
-void ibh::reconfigure_logger(config const& config) noexcept {
+bool ibh::reconfigure_logger(config const& config) noexcept {
     auto console_sink = make_shared<spdlog::sinks::stdout_color_sink_mt>();
 
     auto time_since_epoch = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch());
-    auto file_sink = make_shared<spdlog::sinks::basic_file_sink_mt>(fmt::format("logs/log-{}.txt", time_since_epoch.count()), true);
+    auto file_sink = make_shared<spdlog::sinks::rotating_file_sink_mt>(fmt::format("logs/log-{}.txt", time_since_epoch.count()), config.log_rotate_bytes, config.log_rotate_files);
 
-    auto logger = make_shared<spdlog::logger>("multi_sink"s, spdlog::sinks_init_list{console_sink, file_sink});
+    shared_ptr<spdlog::logger> logger;
+    if(config.log_async) {
+        spdlog::async_overflow_policy overflow_policy;
+        if(config.log_overflow_policy == "block") {
+            overflow_policy = spdlog::async_overflow_policy::block;
+        } else if(config.log_overflow_policy == "overrun_oldest") {
+            overflow_policy = spdlog::async_overflow_policy::overrun_oldest;
+        } else {
+            spdlog::error(R"([{}] LOG_OVERFLOW_POLICY has to be either "block" or "overrun_oldest")", __FUNCTION__);
+            return false;
+        }
+
+        // formatting and writing happen on the single logging thread, callers only enqueue
+        spdlog::init_thread_pool(config.log_queue_size, 1);
+        logger = make_shared<spdlog::async_logger>("multi_sink"s, spdlog::sinks_init_list{console_sink, file_sink}, spdlog::thread_pool(), overflow_policy);
+    } else {
+        logger = make_shared<spdlog::logger>("multi_sink"s, spdlog::sinks_init_list{console_sink, file_sink});
+    }
 
     auto test = spdlog::get("test");
 
@@ -48,8 +66,11 @@ void ibh::reconfigure_logger(config const& config) noexcept {
         }
     }
 
+    // errors should make it to disk even if the process dies right after
+    logger->flush_on(spdlog::level::err);
     spdlog::set_default_logger(logger);
     spdlog::set_pattern("[%C-%m-%d %H:%M:%S.%e] [%L] %v");
 
-    spdlog::info("[{}] debug level: {}", __FUNCTION__, config.debug_level);
+    spdlog::info("[{}] debug level: {} async: {}", __FUNCTION__, config.debug_level, config.log_async);
+    return true;
 }
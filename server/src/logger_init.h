@@ -21,5 +21,6 @@
 #include "config.h"
 
 namespace ibh {
-    void reconfigure_logger(config const &config) noexcept;
+    // returns false on invalid logging configuration
+    [[nodiscard]] bool reconfigure_logger(config const &config) noexcept;
 }
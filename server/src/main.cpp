@@ -26,22 +26,18 @@
 #include <filesystem>
 
 #include <entt/entt.hpp>
-#include <asset_loading/load_assets.h>
+#include <asset_loading/monster_definitions.h>
 #include <asset_loading/load_from_database.h>
 #include <game_logic/logic_helpers.h>
 #include <game_logic/censor_sensor.h>
+#include <game_logic/company_listing.h>
+#include <game_logic/ban_list.h>
+#include <repositories/companies_repository.h>
+#include <repositories/banned_users_repository.h>
+#include <repositories/user_cache.h>
 #include <sodium.h>
 #include <messages/update_response.h>
-#include <game_queue_message_handlers/player_enter_handler.h>
-#include <game_queue_message_handlers/player_leave_handler.h>
-#include <game_queue_message_handlers/company/accept_application_handler.h>
-#include <game_queue_message_handlers/company/create_company_handler.h>
-#include <game_queue_message_handlers/company/increase_bonus_handler.h>
-#include <game_queue_message_handlers/company/join_company_handler.h>
-#include <game_queue_message_handlers/company/leave_company_handler.h>
-#include <game_queue_message_handlers/company/reject_application_handler.h>
-#include <game_queue_message_handlers/company/set_tax_handler.h>
-#include <game_queue_message_handlers/resources/set_action_handler.h>
+#include <game_queue_message_handlers/game_queue_router.h>
 #include <tbb/task_scheduler_init.h>
 #include <asset_loading/load_character_select.h>
 
@@ -55,6 +51,13 @@
 #include "ecs/resource_system.h"
 
 #include "websocket_thread.h"
+#include "outbound_queue.h"
+#include "tick_scheduler.h"
+#include "group_commit.h"
+#include "metrics/metrics.h"
+#include "metrics/metrics_thread.h"
+#include "tracing.h"
+#include "snapshot/registry_snapshot.h"
 #include "discord/discord_thread.h"
 #include "discord/discord_rest.h"
 
@@ -68,6 +71,10 @@ void on_sigint([[maybe_unused]] int sig) {
     spdlog::info("received sigint");
 }
 
+void on_sigusr1([[maybe_unused]] int sig) {
+    trace_dump_requested.store(true, memory_order_release);
+}
+
 void setup_es_groups(entt::registry &es) {
     es.group<battle_component>(entt::get<pc_component>);
     es.group<wood_gathering_component>(entt::get<pc_component>);
@@ -86,6 +93,7 @@ void setup_es_groups(entt::registry &es) {
 int main() {
     set_cwd(get_selfpath());
     ::signal(SIGINT, on_sigint);
+    ::signal(SIGUSR1, on_sigusr1);
     locale::global(locale("en_US.UTF-8"));
 
     sensor.add_dictionary("assets/profanity_locales/en.json");
@@ -108,13 +116,40 @@ int main() {
         return 1;
     }
 
-    reconfigure_logger(config);
+    if(!reconfigure_logger(config)) {
+        return 1;
+    }
 
     if(sodium_init() != 0) {
         spdlog::error("[{}] sodium init failure", __FUNCTION__);
         return 1;
     }
 
+    auto policy = parse_slow_consumer_policy(config.slow_consumer_policy);
+    if(!policy) {
+        spdlog::error("[{}] SLOW_CONSUMER_POLICY has to be either \"drop\" or \"disconnect\"", __FUNCTION__);
+        return 1;
+    }
+    max_buffered_bytes.store(config.slow_consumer_buffered_bytes, memory_order_relaxed);
+
+    auto overrun_policy = parse_tick_overrun_policy(config.tick_overrun_policy);
+    if(!overrun_policy) {
+        spdlog::error("[{}] TICK_OVERRUN_POLICY has to be either \"catch_up\" or \"skip\"", __FUNCTION__);
+        return 1;
+    }
+
+    auto commit_mode = parse_game_queue_commit_mode(config.game_queue_commit_mode);
+    if(!commit_mode) {
+        spdlog::error("[{}] GAME_QUEUE_COMMIT_MODE has to be either \"per_message\" or \"group\"", __FUNCTION__);
+        return 1;
+    }
+
+    auto engine = parse_battle_engine(config.battle_engine);
+    if(!engine) {
+        spdlog::error("[{}] BATTLE_ENGINE has to be either \"scalar\" or \"batched\"", __FUNCTION__);
+        return 1;
+    }
+
     auto pool = make_shared<database_pool>();
     pool->create_connections(config.connection_string, 1);
 
@@ -123,9 +158,28 @@ int main() {
 
     entt::registry es;
     setup_es_groups(es);
+    // in-memory changes of the game queue message being handled, undone when its transaction doesn't commit
+    auto &message_changes = es.set<game_state_changes>();
+
+    auto monster_definitions = load_monster_definitions("assets/monsters", "assets/monster_specials", quit);
+    optional<uint64_t> snapshot_characters;
+    if(!config.snapshot_file.empty()) {
+        snapshot_characters = load_registry_snapshot(config.snapshot_file, es);
+    }
+    if(snapshot_characters) {
+        auto transaction = pool->create_transaction();
+        reconcile_registry_snapshot(es, transaction);
+    } else {
+        load_from_database(es, pool, quit);
+    }
+
+    {
+        auto transaction = pool->create_transaction();
+        company_list.load(companies_repository<database_transaction>{}.get_listing(transaction));
+        bans.load(banned_users_repository<database_transaction>{}.get_active(transaction));
+    }
+    cached_users.configure(config.user_cache_capacity, chrono::seconds(config.user_cache_ttl_seconds), chrono::seconds(config.user_cache_negative_ttl_seconds));
 
-    load_assets(es, quit);
-    load_from_database(es, pool, quit);
     auto char_sel = load_character_select("assets/charselect.json");
 
     if(!char_sel) {
@@ -134,10 +188,7 @@ int main() {
 
     select_response = char_sel.value();
 
-    auto mob_def_view = es.view<monster_definition_component>();
-    auto special_def_view = es.view<monster_special_definition_component>();
-
-    if(mob_def_view.empty() || special_def_view.empty()) {
+    if(monster_definitions->monsters.empty() || monster_definitions->specials.empty()) {
         spdlog::error("[{}] monster init failure", __FUNCTION__);
         return 1;
     }
@@ -148,7 +199,15 @@ int main() {
     moodycamel::ConsumerToken outward_ctok(outward_queue);
     moodycamel::ProducerToken game_loop_ptok(game_loop_queue);
     moodycamel::ConsumerToken game_loop_ctok(game_loop_queue);
-    battle_system bs{config.battle_system_each_n_ticks, &outward_queue};
+    // in group commit mode, responses wait here until the tick's transaction is committed
+    moodycamel::ConcurrentQueue<outward_message> staged_outward_queue;
+    outward_queues staged_outward_queue_abstraction(&staged_outward_queue);
+    optional<group_committer> committer;
+    if(*commit_mode == game_queue_commit_mode::group) {
+        committer.emplace(&outward_queue);
+    }
+    battle_system bs{config.battle_system_each_n_ticks, &outward_queue, *engine};
+    bs.set_definitions(move(monster_definitions));
     resource_system rs{config.resource_gathering_system_each_n_ticks, &outward_queue};
 
     if(quit.load(memory_order_acquire)) {
@@ -156,6 +215,17 @@ int main() {
         return 0;
     }
 
+    // the metrics thread reads the label lists without locking, so they're all added before it starts
+    variant_labels<queue_message>::add(metrics.game_queue_handler_us);
+    add_request_handler_labels();
+    metrics_handle m_handle{};
+    thread metrics_thread;
+    if(config.metrics_port != 0) {
+        metrics_thread = run_metrics(config, m_handle);
+    } else {
+        spdlog::warn("[{}] not starting metrics endpoint due to METRICS_PORT being 0", __FUNCTION__);
+    }
+
     auto websocket_thread = run_websocket(config, pool, s_handle, quit);
     vector<thread> discord_threads;
     if(!config.discord_channel_id.empty() && !config.discord_token.empty()) {
@@ -168,114 +238,225 @@ int main() {
     }
 
     vector<uint64_t> frame_times;
-    auto next_tick = chrono::system_clock::now() + chrono::milliseconds(config.tick_length);
-    auto next_log_tick_times = chrono::system_clock::now() + chrono::seconds(1);
-    uint32_t tick_counter = 0;
-
-    ibh_flat_map<uint64_t, function<bool(queue_message*, entt::registry&, outward_queues&, unique_ptr<database_transaction> const &)>> game_queue_message_router;
-    game_queue_message_router.emplace(player_enter_message::_type, handle_player_enter_message);
-    game_queue_message_router.emplace(player_leave_message::_type, handle_player_leave_message);
-
-    // companies
-    game_queue_message_router.emplace(accept_application_message::_type, handle_accept_application);
-    game_queue_message_router.emplace(create_company_message::_type, handle_create_company);
-    game_queue_message_router.emplace(increase_bonus_message::_type, handle_increase_bonus);
-    game_queue_message_router.emplace(join_company_message::_type, handle_join_company);
-    game_queue_message_router.emplace(leave_company_message::_type, handle_leave_company);
-    game_queue_message_router.emplace(reject_application_message::_type, handle_reject_application);
-    game_queue_message_router.emplace(set_tax_message::_type, handle_set_tax);
-
-    // resources
-    game_queue_message_router.emplace(set_action_message::_type, handle_set_action);
+    ibh_flat_map<uint64_t, outbound_queue> connection_queues;
+    auto queue_for = [&connection_queues, &config, &policy](uint64_t conn_id) -> outbound_queue& {
+        auto queue_it = connection_queues.find(conn_id);
+        if(queue_it == end(connection_queues)) {
+            queue_it = connection_queues.emplace(conn_id, outbound_queue{config.outbound_queue_byte_budget, config.slow_consumer_buffered_bytes, *policy}).first;
+        }
+        return queue_it->second;
+    };
+    tick_scheduler scheduler{chrono::milliseconds(config.tick_length), *overrun_policy, config.max_catch_up_ticks, config.max_system_stretch, tick_scheduler::clock::now()};
+    auto next_log_tick_times = tick_scheduler::clock::now() + chrono::seconds(1);
+
+    optional<registry_snapshot_writer> snapshot_writer;
+    uint32_t ticks_since_snapshot = 0;
+    if(!config.snapshot_file.empty() && config.snapshot_interval_ticks != 0) {
+        snapshot_writer.emplace(config.snapshot_file);
+    } else {
+        spdlog::warn("[{}] not writing registry snapshots due to SNAPSHOT_FILE being empty or SNAPSHOT_INTERVAL_TICKS being 0", __FUNCTION__);
+    }
+
+    // picks up bans made outside of the server, a single small query every few minutes
+    optional<ban_list_refresher> ban_refresher;
+    if(config.ban_refresh_seconds > 0) {
+        ban_refresher.emplace(pool, bans, chrono::seconds(config.ban_refresh_seconds));
+    }
+
+    monster_definitions_watcher definitions_watcher{"assets/monsters", "assets/monster_specials"};
 
     tbb::task_scheduler_init anonymous;
 
     while (!quit.load(memory_order_acquire)) {
-        auto now = chrono::system_clock::now();
-        if(now < next_tick) {
-            this_thread::sleep_until(next_tick);
+        if(tick_scheduler::clock::now() < scheduler.next_tick()) {
+            this_thread::sleep_until(scheduler.next_tick());
+        }
+        auto tick_start = tick_scheduler::clock::now();
+        scheduler.start_tick(tick_start);
+
+        if(auto reloaded_definitions = definitions_watcher.take_reloaded()) {
+            bs.set_definitions(move(reloaded_definitions));
+            spdlog::info("[{}] swapped in reloaded monster definitions", __FUNCTION__);
         }
-        auto tick_start = chrono::system_clock::now();
+
+        metrics.game_loop_queue_depth.store(game_loop_queue.size_approx(), memory_order_relaxed);
+        metrics.connected_users.store(user_connections.size(), memory_order_relaxed);
 
         {
-            unique_ptr<queue_message> msg(nullptr);
-            while (game_loop_queue.try_dequeue(game_loop_ctok, msg)) {
-                spdlog::trace("[{}] got game loop msg with type {}", __FUNCTION__, msg->type);
-                auto transaction = pool->create_transaction();
-                auto handler = game_queue_message_router.find(msg->type);
-                if(handler == end(game_queue_message_router)) {
-                    spdlog::error("[[}] missing game_queue_message_router handler for type {}", __FUNCTION__, msg->type);
-                    continue;
+            scoped_histogram_timer phase_timer(&metrics.phase(tick_phase::queue_drain));
+            IBH_TRACE_SCOPE(tick, "queue_drain");
+            queue_message msg;
+            if(committer) {
+                auto undo_rolled_back = [&es, &committer] {
+                    auto rolled_back = committer->take_rolled_back();
+                    for(auto it = rbegin(rolled_back); it != rend(rolled_back); ++it) {
+                        it->undo(es);
+                    }
+                };
+                undo_rolled_back();
+
+                unique_ptr<database_transaction> transaction;
+                game_state_changes tick_changes;
+                uint64_t handled_messages = 0;
+                while (game_loop_queue.try_dequeue(game_loop_ctok, msg)) {
+                    SPDLOG_TRACE("[{}] got game loop msg with index {}", __FUNCTION__, msg.index());
+                    if(!transaction) {
+                        // the previous tick's commit has to land first, otherwise this transaction won't see its writes
+                        committer->wait_idle();
+                        undo_rolled_back();
+                        transaction = pool->create_transaction();
+                    }
+                    scoped_histogram_timer handler_timer(metrics.game_queue_handler_us.find(get_queue_message_type(msg)));
+                    IBH_TRACE_SCOPE(handlers, "game_queue_handler");
+                    if(handle_grouped_game_queue_message(msg, es, staged_outward_queue_abstraction, transaction, tick_changes)) {
+                        handled_messages++;
+                    }
                 }
-                if(handler->second(msg.get(), es, outward_queue_abstraction, transaction)) {
-                    transaction->commit();
+
+                if(transaction) {
+                    vector<outward_message> responses;
+                    outward_message response{};
+                    while (staged_outward_queue.try_dequeue(response)) {
+                        responses.push_back(move(response));
+                    }
+                    committer->commit_async(move(transaction), move(responses), handled_messages, move(tick_changes));
+                }
+            } else {
+                while (game_loop_queue.try_dequeue(game_loop_ctok, msg)) {
+                    SPDLOG_TRACE("[{}] got game loop msg with index {}", __FUNCTION__, msg.index());
+                    scoped_histogram_timer handler_timer(metrics.game_queue_handler_us.find(get_queue_message_type(msg)));
+                    IBH_TRACE_SCOPE(handlers, "game_queue_handler");
+                    auto transaction = pool->create_transaction();
+                    if(handle_game_queue_message(msg, es, outward_queue_abstraction, transaction)) {
+                        scoped_histogram_timer commit_timer(&metrics.db_commit_us);
+                        transaction->commit();
+                        commit_stats.commits.fetch_add(1, memory_order_relaxed);
+                        commit_stats.committed_messages.fetch_add(1, memory_order_relaxed);
+                        message_changes.committed();
+                    } else {
+                        message_changes.undo(es);
+                    }
                 }
             }
         }
 
-        bs.do_tick(es);
-        rs.do_tick(es);
+        bs.set_stretch(scheduler.system_stretch());
+        rs.set_stretch(scheduler.system_stretch());
+        {
+            scoped_histogram_timer phase_timer(&metrics.phase(tick_phase::battle));
+            IBH_TRACE_SCOPE(tick, "battle_system");
+            bs.do_tick(es);
+        }
+        {
+            scoped_histogram_timer phase_timer(&metrics.phase(tick_phase::resource));
+            IBH_TRACE_SCOPE(tick, "resource_system");
+            rs.do_tick(es);
+        }
 
-        auto tick_end = chrono::system_clock::now();
+        auto tick_end = tick_scheduler::clock::now();
         frame_times.push_back(chrono::duration_cast<chrono::microseconds>(tick_end - tick_start).count());
-        next_tick += chrono::milliseconds(config.tick_length);
-        tick_counter++;
+        metrics.phase(tick_phase::total).record(frame_times.back());
 
         {
-            outward_message msg{{}, nullptr};
+            metrics.outward_queue_depth.store(outward_queue.size_approx(), memory_order_relaxed);
+            scoped_histogram_timer phase_timer(&metrics.phase(tick_phase::outward_drain));
+            IBH_TRACE_SCOPE(tick, "outward_drain");
+            outward_message msg{};
             while (outward_queue.try_dequeue(outward_ctok, msg)) {
-                shared_lock lock(user_connections_mutex);
+                auto serialized_msg = make_shared<string const>(serialize_response(msg.msg));
 
                 if(msg.conn_id == 0) {
-                    auto serializedMsg = msg.msg->serialize();
                     for(auto &conn : user_connections) {
-                        try {
-                            s_handle.s->send(conn.second.ws, serializedMsg, websocketpp::frame::opcode::value::TEXT);
-                        } catch (...) {
-                            spdlog::warn("[{}] socket expired, wanted to send outward message to all", __FUNCTION__, msg.conn_id);
-                            continue;
-                        }
+                        queue_for(conn.connection_id).push(msg.msg, serialized_msg);
                     }
                     continue;
                 }
 
-                auto user_data = user_connections.find(msg.conn_id);
-                if (user_data != end(user_connections) && !user_data->second.ws.expired()) {
-                    try {
-                        s_handle.s->send(user_data->second.ws, msg.msg->serialize(), websocketpp::frame::opcode::value::TEXT);
-                    } catch (...) {
-                        spdlog::warn("[{}] socket expired, wanted to send outward message", __FUNCTION__, msg.conn_id);
-                        continue;
-                    }
+                auto *user_data = user_connections.find(msg.conn_id);
+                if (user_data != nullptr && !user_data->ws.expired()) {
+                    queue_for(msg.conn_id).push(msg.msg, move(serialized_msg));
                 } else {
                     spdlog::warn("[{}] couldn't find connection id {}, wanted to send outward message", __FUNCTION__, msg.conn_id);
-                    game_loop_queue.enqueue(game_loop_ptok, make_unique<player_leave_message>(msg.conn_id));
+                    game_loop_queue.enqueue(game_loop_ptok, player_leave_message(msg.conn_id));
+                }
+            }
+
+            for(auto it = begin(connection_queues); it != end(connection_queues);) {
+                auto *user_data = user_connections.find(it->first);
+                if(user_data == nullptr) {
+                    it = connection_queues.erase(it);
+                    continue;
                 }
+                IBH_TRACE_SCOPE(network, "outbound_flush");
+                it->second.flush(s_handle.s, user_data->ws);
+                ++it;
             }
+
+            user_connections.quiescent_state();
+        }
+
+        // when the writer is still busy with the previous snapshot, try again next tick rather than block
+        if(snapshot_writer && ++ticks_since_snapshot >= config.snapshot_interval_ticks && snapshot_writer->try_snapshot(es)) {
+            ticks_since_snapshot = 0;
         }
 
+        if(trace_dump_requested.exchange(false, memory_order_acq_rel)) {
+            auto time_since_epoch = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch());
+            dump_chrome_trace(fmt::format("logs/trace-{}.json", time_since_epoch.count()));
+        }
+
+        // everything the tick did counts towards overruns and stretching, not only the systems
+        scheduler.end_tick(tick_scheduler::clock::now());
+
         if(config.log_tick_times && tick_end > next_log_tick_times) {
-            spdlog::info("[{}] ticks {} - frame times max/avg/min: {} / {} / {} µs", __FUNCTION__, tick_counter,
+            auto const &tick_stats = scheduler.stats();
+            spdlog::info("[{}] ticks {} - frame times max/avg/min: {} / {} / {} µs", __FUNCTION__, tick_stats.ticks,
                          *max_element(begin(frame_times), end(frame_times)), accumulate(begin(frame_times), end(frame_times), 0UL) / frame_times.size(),
                          *min_element(begin(frame_times), end(frame_times)));
+            spdlog::info("[{}] tick overruns {} skipped {} system stretch {}", __FUNCTION__, tick_stats.overruns, tick_stats.skipped_ticks, scheduler.system_stretch());
+            spdlog::info("[{}] outbound queued bytes {} sent {} dropped {} coalesced {} slow consumer disconnects {}", __FUNCTION__, outbound_stats.queued_bytes.load(memory_order_relaxed),
+                         outbound_stats.sent_messages.load(memory_order_relaxed), outbound_stats.dropped_messages.load(memory_order_relaxed),
+                         outbound_stats.coalesced_messages.load(memory_order_relaxed), outbound_stats.slow_consumer_disconnects.load(memory_order_relaxed));
+            spdlog::info("[{}] game queue commits {} failed {} messages committed {}", __FUNCTION__, commit_stats.commits.load(memory_order_relaxed),
+                         commit_stats.failed_commits.load(memory_order_relaxed), commit_stats.committed_messages.load(memory_order_relaxed));
             frame_times.clear();
             next_log_tick_times += chrono::seconds(1);
-            tick_counter = 0;
+            scheduler.reset_stats();
         }
     }
 
     spdlog::warn("[{}] quitting program", __FUNCTION__);
+    definitions_watcher.stop();
+    ban_refresher.reset();
+    if(committer) {
+        committer.reset();
+        spdlog::warn("[{}] last game queue commit done", __FUNCTION__);
+    }
+    if(snapshot_writer) {
+        snapshot_writer->snapshot(es);
+        snapshot_writer.reset();
+        spdlog::warn("[{}] registry snapshot written", __FUNCTION__);
+    }
     s_handle.s->stop();
     if(!config.discord_channel_id.empty() && !config.discord_token.empty()) {
         c_handle.c->stop();
     }
     websocket_thread.join();
     spdlog::warn("[{}] websocket_thread stopped", __FUNCTION__);
+    if(m_handle.s != nullptr) {
+        m_handle.s->stop();
+    }
+    if(metrics_thread.joinable()) {
+        metrics_thread.join();
+        spdlog::warn("[{}] metrics_thread stopped", __FUNCTION__);
+    }
     for(auto &t : discord_threads) {
         t.join();
         spdlog::warn("[{}] discord_thread stopped", __FUNCTION__);
     }
     spdlog::warn("[{}] all discord_threads stopped", __FUNCTION__);
 
+    // flushes the async logger queue
+    spdlog::shutdown();
     return 0;
 }
@@ -39,18 +39,17 @@ using namespace chrono;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_public_chat(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data,
-                            queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                            queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
-        DESERIALIZE_WITH_PLAYING_CHECK(message_request);
+        DESERIALIZE_WITH_PLAYING_CHECK(message_request_view);
 
         auto now = system_clock::now();
-        auto chat_msg = message_response(user_data->username, sensor.clean_profanity_ish(msg->content), "game", duration_cast<milliseconds>(now.time_since_epoch()).count());
+        auto chat_msg = message_response(user_data->username, sensor.clean_profanity_ish(string(msg->content)), "game", duration_cast<milliseconds>(now.time_since_epoch()).count());
         auto serialized_msg = chat_msg.serialize();
         send_discord_message(fmt::format("<{}> {}", user_data->username, chat_msg.content));
 
         {
-            shared_lock lock(user_connections_mutex);
-            for (auto &[conn_id, other_user_data] : user_connections) {
+            for (auto &other_user_data : user_connections) {
                 try {
                     if (other_user_data.ws.expired()) {
                         continue;
@@ -64,10 +63,10 @@ namespace ibh {
     }
 
     template void handle_public_chat<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                          per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                          per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_public_chat<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
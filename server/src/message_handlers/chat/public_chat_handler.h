@@ -20,7 +20,7 @@
 
 #include <rapidjson/document.h>
 #include <database/database_pool.h>
-#include <per_socket_data.h>
+#include <connection_registry.h>
 #include <concurrentqueue.h>
 #include <game_queue_messages/messages.h>
 
@@ -29,5 +29,5 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_public_chat(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data,
-                            queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections);
+                            queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections);
 }
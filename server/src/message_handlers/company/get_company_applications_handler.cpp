@@ -43,7 +43,7 @@ using namespace chrono;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_get_company_applications(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data,
-                                   queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                                   queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_PLAYING_CHECK(get_company_applications_request);
 
@@ -67,15 +67,35 @@ namespace ibh {
             return;
         }
 
-        auto company = companies_repo.get(company_member->company_id, transaction);
-        auto applications = applications_repo.get_by_company_id(company->id, transaction);
+        optional<db_company> company;
+        vector<db_company_member> applications;
+        {
+            auto pipeline = transaction->create_pipeline();
+            auto company_result = companies_repo.get_async(company_member->company_id, *pipeline);
+            auto applications_result = applications_repo.get_by_company_id_async(company_member->company_id, *pipeline);
+            company = company_result.get();
+            applications = applications_result.get();
+        }
 
-        vector<member> members;
-        members.reserve(applications.size());
+        if(!company) {
+            get_company_applications_response response{"Company doesn't exist", {}};
+            auto response_msg = response.serialize();
+            s->send(user_data->ws, response_msg, websocketpp::frame::opcode::value::TEXT);
+            return;
+        }
 
+        vector<uint64_t> applicant_ids;
+        applicant_ids.reserve(applications.size());
         for(auto const &application : applications) {
-            auto character = chars_repo.get_character(application.character_id, transaction);
-            members.emplace_back(character->id, character->level, move(character->name));
+            applicant_ids.push_back(application.character_id);
+        }
+
+        auto applicants = chars_repo.get_characters(applicant_ids, transaction);
+        vector<member> members;
+        members.reserve(applicants.size());
+
+        for(auto &character : applicants) {
+            members.emplace_back(character.id, character.level, move(character.name));
         }
 
         get_company_applications_response response{"", move(members)};
@@ -84,10 +104,10 @@ namespace ibh {
     }
 
     template void handle_get_company_applications<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                                 per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                                 per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_get_company_applications<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                     per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                                     per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
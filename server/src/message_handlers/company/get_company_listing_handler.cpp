@@ -25,12 +25,8 @@
 #include <messages/company/get_company_listing_response.h>
 #include "message_handlers/handler_macros.h"
 #include <websocket_thread.h>
-#include <repositories/companies_repository.h>
-#include <repositories/company_members_repository.h>
-#include <repositories/company_stats_repository.h>
-#include <repositories/characters_repository.h>
+#include <game_logic/company_listing.h>
 #include "macros.h"
-#include <common_components.h>
 
 #ifdef TEST_CODE
 #include "../../../test/custom_server.h"
@@ -42,46 +38,20 @@ using namespace chrono;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_get_company_listing(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data,
-                                 queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                                 queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_PLAYING_CHECK(get_company_listing_request);
 
-        companies_repository<database_transaction> company_repo{};
-        company_members_repository<database_transaction> company_member_repo{};
-        company_stats_repository<database_transaction> company_stat_repo{};
-        characters_repository<database_transaction> char_repo{};
-
-        auto companies = company_repo.get_all(transaction);
-        vector<company_object> msg_companies;
-        msg_companies.reserve(companies.size());
-        for(auto &c : companies) {
-            vector<string> msg_members;
-            vector<stat_component> msg_bonuses;
-
-            auto members = company_member_repo.get_by_company_id(c.id, transaction);
-            msg_members.reserve(members.size());
-            for(auto &member : members) {
-                auto player = char_repo.get_character(member.character_id, transaction);
-                msg_members.emplace_back(player->name);
-            }
-
-            auto bonuses = company_stat_repo.get_by_company_id(c.id, transaction);
-            for(auto &bonus : bonuses) {
-                msg_bonuses.emplace_back(bonus.stat_id, bonus.value);
-            }
-
-            msg_companies.emplace_back(c.name, msg_members, msg_bonuses);
-        }
-
-        get_company_listing_response resp{"", msg_companies};
-        s->send(user_data->ws, resp.serialize(), websocketpp::frame::opcode::value::TEXT);
+        // served from memory, the game thread keeps the listing up to date
+        auto page = company_list.get_page(msg->page, msg->name_prefix);
+        s->send(user_data->ws, *page, websocketpp::frame::opcode::value::TEXT);
     }
 
     template void handle_get_company_listing<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_get_company_listing<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
@@ -36,7 +36,7 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_set_motd(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data,
-                          queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                          queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         if(!user_data->is_game_master) {
             spdlog::warn("[{}] user {} tried to set motd but is not a game master!", __FUNCTION__, user_data->username);
             return;
@@ -51,8 +51,7 @@ namespace ibh {
         update_motd_response motd_msg(motd);
         auto motd_msg_str = motd_msg.serialize();
         {
-            shared_lock lock(user_connections_mutex);
-            for (auto &[conn_id, other_user_data] : user_connections) {
+            for (auto &other_user_data : user_connections) {
                 try {
                     if (other_user_data.ws.expired()) {
                         continue;
@@ -67,10 +66,10 @@ namespace ibh {
 
     template void handle_set_motd<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
                                                                         per_socket_data<websocketpp::connection_hdl> *user_data,
-                                                                        queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                        queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_set_motd<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
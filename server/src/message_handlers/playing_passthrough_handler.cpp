@@ -43,63 +43,63 @@ using namespace chrono;
 namespace ibh {
 
     template <class WebSocketMsgT>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<WebSocketMsgT> &msg);
+    queue_message convert_msg(uint64_t connection_id, WebSocketMsgT const &msg);
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<set_action_request> &msg) {
-        return make_unique<set_action_message>(connection_id, msg->resource_id);
+    queue_message convert_msg(uint64_t connection_id, set_action_request_view const &msg) {
+        return set_action_message(connection_id, msg.resource_id);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<accept_application_request> &msg) {
-        return make_unique<accept_application_message>(connection_id, msg->applicant_id);
+    queue_message convert_msg(uint64_t connection_id, accept_application_request const &msg) {
+        return accept_application_message(connection_id, msg.applicant_id);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<create_company_request> &msg) {
-        return make_unique<create_company_message>(connection_id, msg->name, msg->company_type);
+    queue_message convert_msg(uint64_t connection_id, create_company_request const &msg) {
+        return create_company_message(connection_id, msg.name, msg.company_type);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<increase_bonus_request> &msg) {
-        return make_unique<increase_bonus_message>(connection_id, msg->bonus_type);
+    queue_message convert_msg(uint64_t connection_id, increase_bonus_request const &msg) {
+        return increase_bonus_message(connection_id, msg.bonus_type);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<join_company_request> &msg) {
-        return make_unique<join_company_message>(connection_id, msg->company_name);
+    queue_message convert_msg(uint64_t connection_id, join_company_request const &msg) {
+        return join_company_message(connection_id, msg.company_name);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<leave_company_request> &msg) {
-        return make_unique<leave_company_message>(connection_id);
+    queue_message convert_msg(uint64_t connection_id, leave_company_request const &msg) {
+        return leave_company_message(connection_id);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<reject_application_request> &msg) {
-        return make_unique<reject_application_message>(connection_id, msg->applicant_id);
+    queue_message convert_msg(uint64_t connection_id, reject_application_request const &msg) {
+        return reject_application_message(connection_id, msg.applicant_id);
     }
 
     template <>
-    auto convert_msg(uint64_t connection_id, const unique_ptr<set_tax_request> &msg) {
-        return make_unique<set_tax_message>(connection_id, msg->rate);
+    queue_message convert_msg(uint64_t connection_id, set_tax_request const &msg) {
+        return set_tax_message(connection_id, msg.rate);
     }
 
     // accept_application_request
 
     template <class Server, class WebSocket, class WebSocketMsgT>
     void playing_passthrough_handler(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data,
-                              queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                              queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_PLAYING_CHECK(WebSocketMsgT);
 
-        q->enqueue(convert_msg<WebSocketMsgT>(user_data->connection_id, msg));
+        q->enqueue(convert_msg<WebSocketMsgT>(user_data->connection_id, *msg));
     }
 
 #define TEMPLATE_SPECIALIZE(server, hdl, type) template void playing_passthrough_handler<server, hdl, type>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction, \
-    per_socket_data<hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<hdl>> &user_connections);
+    per_socket_data<hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<hdl> &user_connections);
 
-    TEMPLATE_SPECIALIZE(server, websocketpp::connection_hdl, set_action_request)
+    TEMPLATE_SPECIALIZE(server, websocketpp::connection_hdl, set_action_request_view)
     TEMPLATE_SPECIALIZE(server, websocketpp::connection_hdl, accept_application_request)
     TEMPLATE_SPECIALIZE(server, websocketpp::connection_hdl, create_company_request)
     TEMPLATE_SPECIALIZE(server, websocketpp::connection_hdl, increase_bonus_request)
@@ -109,7 +109,7 @@ namespace ibh {
     TEMPLATE_SPECIALIZE(server, websocketpp::connection_hdl, set_tax_request)
 
 #ifdef TEST_CODE
-    TEMPLATE_SPECIALIZE(custom_server, custom_hdl, set_action_request)
+    TEMPLATE_SPECIALIZE(custom_server, custom_hdl, set_action_request_view)
     TEMPLATE_SPECIALIZE(custom_server, custom_hdl, accept_application_request)
     TEMPLATE_SPECIALIZE(custom_server, custom_hdl, create_company_request)
     TEMPLATE_SPECIALIZE(custom_server, custom_hdl, increase_bonus_request)
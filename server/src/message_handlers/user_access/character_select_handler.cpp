@@ -37,7 +37,7 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_character_select(Server *s, rapidjson::Document const &d,
-                                 unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                                 unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_NOT_PLAYING_CHECK(character_select_request);
 
@@ -46,10 +46,10 @@ namespace ibh {
     }
 
     template void handle_character_select<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_character_select<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
@@ -42,7 +42,7 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_create_character(Server *s, rapidjson::Document const &d,
-                                 unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                                 unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_NOT_PLAYING_CHECK(create_character_request);
 
@@ -144,11 +144,12 @@ namespace ibh {
             player_stats.emplace_back(stat, value);
         }
 
+        vector<db_character_stat> db_stats;
+        db_stats.reserve(player_stats.size());
         for(auto const &stat : player_stats) {
-            db_character_stat char_stat{0, new_player.id, stat.stat_id, stat.value};
-            stats_repo.insert(char_stat, subtransaction);
-            player_stats.emplace_back(stat.stat_id, stat.value);
+            db_stats.emplace_back(0, new_player.id, stat.stat_id, stat.value);
         }
+        stats_repo.insert_many(db_stats, subtransaction);
 
         subtransaction->commit();
 
@@ -160,10 +161,10 @@ namespace ibh {
     }
 
     template void handle_create_character<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_create_character<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
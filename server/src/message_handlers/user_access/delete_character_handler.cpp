@@ -37,13 +37,12 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_delete_character(Server *s, rapidjson::Document const &d,
-                                 unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                                 unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_NOT_PLAYING_CHECK(delete_character_request);
 
         {
-            shared_lock lock(user_connections_mutex);
-            for (auto &[conn_id, other_user_data] : user_connections) {
+            for (auto &other_user_data : user_connections) {
                 if (other_user_data.user_id == user_data->user_id && other_user_data.playing_character_slot >= 0 &&
                     other_user_data.playing_character_slot == static_cast<int32_t>(msg->slot)) {
                     SEND_ERROR("Already playing that slot on another connection", "", "", true);
@@ -63,10 +62,10 @@ namespace ibh {
     }
 
     template void handle_delete_character<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                               per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_delete_character<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
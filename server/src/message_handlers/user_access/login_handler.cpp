@@ -25,11 +25,9 @@
 #include <messages/user_access/login_request.h>
 #include <messages/user_access/login_response.h>
 #include <repositories/users_repository.h>
-#include <repositories/banned_users_repository.h>
+#include <repositories/user_cache.h>
+#include <game_logic/ban_list.h>
 #include <repositories/characters_repository.h>
-#include <repositories/character_stats_repository.h>
-#include <repositories/company_members_repository.h>
-#include <repositories/companies_repository.h>
 #include <on_leaving_scope.h>
 #include <messages/user_access/user_entered_game_response.h>
 #include <websocket_thread.h>
@@ -45,39 +43,38 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_login(Server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                      per_socket_data<WebSocket> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                      per_socket_data<WebSocket> *user_data, queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
-        DESERIALIZE_WITH_NOT_LOGIN_CHECK(login_request);
+        DESERIALIZE_WITH_NOT_LOGIN_CHECK(login_request_view);
 
-        users_repository<database_subtransaction> user_repo{};
-        banned_users_repository<database_subtransaction> banned_user_repo{};
+        users_repository<database_transaction> user_repo{};
         characters_repository<database_subtransaction> character_repo{};
-        character_stats_repository<database_subtransaction> stats_repo{};
-        company_members_repository<database_subtransaction> company_members_repo{};
-        companies_repository<database_subtransaction> companies_repo{};
 
-        auto subtransaction = transaction->create_subtransaction();
-        auto banned_usr = banned_user_repo.is_username_or_ip_banned(msg->username, {}, subtransaction);
-
-        if (banned_usr) {
+        // checked before touching the database, so that banned clients retrying in a loop cost next to nothing
+        if (bans.is_banned(msg->username, {})) {
             s->close(user_data->ws, 0, "You are banned");
             return;
         }
 
-        auto usr = user_repo.get(msg->username, subtransaction);
+        // a read only, no savepoint needed. Unknown usernames are cached as well.
+        auto usr = cached_users.get_or_load(msg->username, [&] { return user_repo.get(string(msg->username), transaction); });
 
         if (!usr) {
             SEND_ERROR("User doesn't exist", "", "", true);
             return;
         }
 
+        auto subtransaction = transaction->create_subtransaction();
+
         {
-            sodium_mlock(reinterpret_cast<unsigned char *>(&msg->password[0]), msg->password.size());
+            // password points into the mutable, in-situ parsed payload
+            auto *password = const_cast<char *>(msg->password.data());
+            sodium_mlock(password, msg->password.size());
             auto scope_guard = on_leaving_scope([&] {
-                sodium_munlock(reinterpret_cast<unsigned char *>(&msg->password[0]), msg->password.size());
+                sodium_munlock(password, msg->password.size());
             });
 
-            if (crypto_pwhash_str_verify(usr->password.c_str(), msg->password.c_str(), msg->password.length()) != 0) {
+            if (crypto_pwhash_str_verify(usr->password.c_str(), password, msg->password.length()) != 0) {
                 SEND_ERROR("Password incorrect", "", "", true);
                 return;
             }
@@ -88,29 +85,21 @@ namespace ibh {
         user_data->is_game_master = usr->is_game_master;
 
         vector<character_object> message_characters;
-        auto characters = character_repo.get_by_user_id(usr->id, subtransaction);
-        message_characters.reserve(characters.size());
+        // one query regardless of the number of characters
+        auto summaries = character_repo.get_summaries_by_user_id(usr->id, subtransaction);
+        message_characters.reserve(summaries.size());
 
-        for (auto &character : characters) {
-            auto db_stats = stats_repo.get_by_character_id(character.id, subtransaction);
+        for (auto &summary : summaries) {
+            auto &character = summary.character;
             vector<stat_component> stats;
-            stats.reserve(db_stats.size());
-            for(auto const &stat : db_stats) {
+            stats.reserve(character.stats.size());
+            for(auto const &stat : character.stats) {
                 stats.emplace_back(stat.stat_id, stat.value);
             }
             vector<item_object> items;
             vector<skill_object> skills;
 
-            auto company_membership = company_members_repo.get_by_character_id(character.id, subtransaction);
-            string company_name;
-            if(company_membership) {
-                auto company = companies_repo.get(company_membership->character_id, subtransaction);
-                if(company) {
-                    company_name = company->name;
-                }
-            }
-
-            message_characters.emplace_back(character.name, character.race, character._class, company_name, character.level, character.slot, character.gold, character.xp, character.skill_points, move(stats), move(items), move(skills));
+            message_characters.emplace_back(character.name, character.race, character._class, move(summary.company_name), character.level, character.slot, character.gold, character.xp, character.skill_points, move(stats), move(items), move(skills));
         }
 
         vector<account_object> online_users;
@@ -118,9 +107,8 @@ namespace ibh {
         user_entered_game_response join_msg(account_object(usr->is_game_master, false, false, 0, 0, usr->username));
         auto join_msg_str = join_msg.serialize();
         {
-            shared_lock lock(user_connections_mutex);
             online_users.reserve(user_connections.size());
-            for (auto &[conn_id, other_user_data] : user_connections) {
+            for (auto &other_user_data : user_connections) {
                 try {
                     if(other_user_data.ws.expired()) {
                         continue;
@@ -154,10 +142,10 @@ namespace ibh {
     }
 
     template void handle_login<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                    per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                    per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_login<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
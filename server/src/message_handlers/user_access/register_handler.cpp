@@ -24,11 +24,9 @@
 
 #include <messages/user_access/register_request.h>
 #include <repositories/users_repository.h>
-#include <repositories/banned_users_repository.h>
+#include <repositories/user_cache.h>
+#include <game_logic/ban_list.h>
 #include <repositories/characters_repository.h>
-#include <repositories/character_stats_repository.h>
-#include <repositories/company_members_repository.h>
-#include <repositories/companies_repository.h>
 #include <on_leaving_scope.h>
 #include <messages/user_access/login_response.h>
 #include <game_logic/censor_sensor.h>
@@ -49,16 +47,12 @@ using namespace std;
 namespace ibh {
     template <class Server, class WebSocket>
     void handle_register(Server *s, rapidjson::Document const &d,
-                         unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                         unique_ptr<database_transaction> const &transaction, per_socket_data<WebSocket> *user_data, queue_abstraction<queue_message> *q, connection_registry<WebSocket> &user_connections) {
         MEASURE_TIME_OF_FUNCTION(trace);
         DESERIALIZE_WITH_NOT_LOGIN_CHECK(register_request);
 
         users_repository<database_subtransaction> user_repo{};
-        banned_users_repository<database_subtransaction> banned_user_repo{};
         characters_repository<database_subtransaction> character_repo{};
-        character_stats_repository<database_subtransaction> stats_repo{};
-        company_members_repository<database_subtransaction> company_members_repo{};
-        companies_repository<database_subtransaction> companies_repo{};
 
         if(sensor.is_profane_ish(msg->username)) {
             SEND_ERROR("Usernames cannot contain profanities", "", "", true);
@@ -85,22 +79,21 @@ namespace ibh {
             return;
         }
 
-        auto subtransaction = transaction->create_subtransaction();
         // TODO modify uwebsockets to include ip address
-        auto banned_usr = banned_user_repo.is_username_or_ip_banned(msg->username, {}, subtransaction);
-
-        if (banned_usr) {
+        if (bans.is_banned(msg->username, {})) {
             s->close(user_data->ws, 0, "You are banned");
             return;
         }
 
-        auto usr = user_repo.get(msg->username, subtransaction);
+        auto usr = cached_users.get_or_load(msg->username, [&] { return users_repository<database_transaction>{}.get(msg->username, transaction); });
 
         if (usr) {
             SEND_ERROR("User already exists", "", "", true);
             return;
         }
 
+        auto subtransaction = transaction->create_subtransaction();
+
         {
             sodium_mlock(reinterpret_cast<unsigned char *>(&msg->password[0]), msg->password.size());
             auto scope_guard = on_leaving_scope([&] {
@@ -131,37 +124,28 @@ namespace ibh {
             user_data->username = new_usr.username;
 
             vector<character_object> message_characters;
-            auto characters = character_repo.get_by_user_id(usr->id, subtransaction);
+            auto summaries = character_repo.get_summaries_by_user_id(new_usr.id, subtransaction);
+            message_characters.reserve(summaries.size());
 
-            for (auto &character : characters) {
-                auto db_stats = stats_repo.get_by_character_id(character.id, subtransaction);
+            for (auto &summary : summaries) {
+                auto &character = summary.character;
                 vector<stat_component> stats;
-                stats.reserve(db_stats.size());
-                for(auto const &stat : db_stats) {
+                stats.reserve(character.stats.size());
+                for(auto const &stat : character.stats) {
                     stats.emplace_back(stat.stat_id, stat.value);
                 }
                 vector<item_object> items;
                 vector<skill_object> skills;
 
-                auto company_membership = company_members_repo.get_by_character_id(character.id, subtransaction);
-                string company_name;
-                if(company_membership) {
-                    auto company = companies_repo.get(company_membership->character_id, subtransaction);
-                    if(company) {
-                        company_name = company->name;
-                    }
-                }
-
-                message_characters.emplace_back(character.name, character.race, character._class, company_name, character.level, character.slot, character.gold, character.xp, character.skill_points, move(stats), move(items), move(skills));
+                message_characters.emplace_back(character.name, character.race, character._class, move(summary.company_name), character.level, character.slot, character.gold, character.xp, character.skill_points, move(stats), move(items), move(skills));
             }
 
             vector<account_object> online_users;
             user_entered_game_response join_msg(account_object(new_usr.is_game_master, false, false, 0, 0, new_usr.username));
             auto join_msg_str = join_msg.serialize();
             {
-                shared_lock lock(user_connections_mutex);
                 online_users.reserve(user_connections.size());
-                for (auto &[conn_id, other_user_data] : user_connections) {
+                for (auto &other_user_data : user_connections) {
                     try {
                         if constexpr(is_same_v<WebSocket, websocketpp::connection_hdl>) {
                             if (other_user_data.ws.expired()) {
@@ -197,10 +181,10 @@ namespace ibh {
     }
 
     template void handle_register<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                                       per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+                                                                       per_socket_data<websocketpp::connection_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<websocketpp::connection_hdl> &user_connections);
 
 #ifdef TEST_CODE
     template void handle_register<custom_server, custom_hdl>(custom_server *s, rapidjson::Document const &d, unique_ptr<database_transaction> const &transaction,
-                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<unique_ptr<queue_message>> *q, ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> &user_connections);
+                                                           per_socket_data<custom_hdl> *user_data, queue_abstraction<queue_message> *q, connection_registry<custom_hdl> &user_connections);
 #endif
 }
@@ -0,0 +1,179 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <string_view>
+
+using namespace std;
+
+namespace ibh {
+    // Log-linear histogram in the style of HdrHistogram. Every power of two range is split into sub_buckets linear buckets,
+    // so any uint64_t is recorded with at most 1/sub_buckets relative error in a fixed array of counters.
+    // Recording is a relaxed atomic increment: it never allocates and can be called from any thread, TBB workers included.
+    class histogram {
+    public:
+        static constexpr uint32_t sub_bucket_bits = 3;
+        static constexpr uint32_t sub_buckets = 1u << sub_bucket_bits;
+        static constexpr uint32_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+        histogram() noexcept : _buckets(), _sum(0) {}
+
+        histogram(histogram const &) = delete;
+        histogram& operator=(histogram const &) = delete;
+
+        [[nodiscard]] static constexpr uint32_t bucket_index(uint64_t value) noexcept {
+            if(value < sub_buckets) {
+                return static_cast<uint32_t>(value);
+            }
+
+            uint32_t shift = 63 - countl_zero(value) - sub_bucket_bits;
+            return (shift + 1) * sub_buckets + static_cast<uint32_t>((value >> shift) & (sub_buckets - 1));
+        }
+
+        // highest value that ends up in the bucket with the given index
+        [[nodiscard]] static constexpr uint64_t bucket_upper_bound(uint32_t index) noexcept {
+            if(index < sub_buckets) {
+                return index;
+            }
+
+            uint32_t shift = index / sub_buckets - 1;
+            uint64_t lower = (uint64_t{sub_buckets} + index % sub_buckets) << shift;
+            return lower + ((uint64_t{1} << shift) - 1);
+        }
+
+        void record(uint64_t value) noexcept {
+            _buckets[bucket_index(value)].fetch_add(1, memory_order_relaxed);
+            _sum.fetch_add(value, memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t bucket(uint32_t index) const noexcept {
+            return _buckets[index].load(memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t sum() const noexcept {
+            return _sum.load(memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t count() const noexcept {
+            uint64_t total = 0;
+            for(auto const &b : _buckets) {
+                total += b.load(memory_order_relaxed);
+            }
+            return total;
+        }
+
+        // upper bound of the bucket containing the given percentile (0-100), 0 when empty
+        [[nodiscard]] uint64_t value_at_percentile(double percentile) const noexcept {
+            auto total = count();
+            if(total == 0) {
+                return 0;
+            }
+
+            auto target = static_cast<uint64_t>(percentile / 100. * static_cast<double>(total) + 0.5);
+            target = max(target, uint64_t{1});
+            uint64_t seen = 0;
+            for(uint32_t i = 0; i < bucket_count; i++) {
+                seen += bucket(i);
+                if(seen >= target) {
+                    return bucket_upper_bound(i);
+                }
+            }
+            return bucket_upper_bound(bucket_count - 1);
+        }
+
+    private:
+        array<atomic<uint64_t>, bucket_count> _buckets;
+        atomic<uint64_t> _sum;
+    };
+
+    // Histograms with one label, such as latency per message type. Labels are added before recording starts,
+    // after which find() is a lock free scan over a fixed array.
+    template <size_t Capacity>
+    class histogram_family {
+    public:
+        histogram_family() noexcept : _keys(), _labels(), _histograms(), _size(0) {}
+
+        // returns false when the family is full, adding an existing key is a no-op
+        bool add(uint64_t key, string_view label) noexcept {
+            if(find(key) != nullptr) {
+                return true;
+            }
+
+            if(_size == Capacity) {
+                return false;
+            }
+
+            _keys[_size] = key;
+            _labels[_size] = label;
+            _size++;
+            return true;
+        }
+
+        [[nodiscard]] histogram* find(uint64_t key) noexcept {
+            for(size_t i = 0; i < _size; i++) {
+                if(_keys[i] == key) {
+                    return &_histograms[i];
+                }
+            }
+            return nullptr;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] string_view label(size_t index) const noexcept {
+            return _labels[index];
+        }
+
+        [[nodiscard]] histogram const & at(size_t index) const noexcept {
+            return _histograms[index];
+        }
+
+    private:
+        array<uint64_t, Capacity> _keys;
+        array<string_view, Capacity> _labels;
+        array<histogram, Capacity> _histograms;
+        size_t _size;
+    };
+
+    // records the elapsed microseconds into the histogram when leaving scope, does nothing for nullptr
+    class scoped_histogram_timer {
+    public:
+        explicit scoped_histogram_timer(histogram *h) noexcept : _histogram(h), _start(chrono::steady_clock::now()) {}
+
+        ~scoped_histogram_timer() {
+            if(_histogram != nullptr) {
+                _histogram->record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - _start).count());
+            }
+        }
+
+        scoped_histogram_timer(scoped_histogram_timer const &) = delete;
+        scoped_histogram_timer& operator=(scoped_histogram_timer const &) = delete;
+
+    private:
+        histogram *_histogram;
+        chrono::steady_clock::time_point _start;
+    };
+}
@@ -0,0 +1,98 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "metrics.h"
+#include <magic_enum.hpp>
+#include <outbound_queue.h>
+#include <group_commit.h>
+#include <repositories/user_cache.h>
+
+using namespace std;
+
+namespace ibh {
+    server_metrics metrics;
+
+    // Cumulative buckets are written per power of two range rather than per sub bucket, which is plenty for histogram_quantile.
+    // Ranges above 2^32 µs (over an hour) only show up in +Inf.
+    static constexpr uint32_t max_exposed_bucket = histogram::bucket_index(uint64_t{1} << 32);
+
+    void write_histogram(string &out, string_view name, string_view labels, histogram const &h) {
+        auto bucket_labels = labels.empty() ? string{} : fmt::format("{},", labels);
+        auto series_labels = labels.empty() ? string{} : fmt::format("{{{}}}", labels);
+        uint64_t cumulative = 0;
+        for(uint32_t i = 0; i < histogram::bucket_count; i++) {
+            cumulative += h.bucket(i);
+            if(i % histogram::sub_buckets == histogram::sub_buckets - 1 && i < max_exposed_bucket) {
+                out += fmt::format("{}_bucket{{{}le=\"{}\"}} {}\n", name, bucket_labels, histogram::bucket_upper_bound(i), cumulative);
+            }
+        }
+        out += fmt::format("{}_bucket{{{}le=\"+Inf\"}} {}\n", name, bucket_labels, cumulative);
+        out += fmt::format("{}_sum{} {}\n", name, series_labels, h.sum());
+        out += fmt::format("{}_count{} {}\n", name, series_labels, cumulative);
+    }
+
+    template <size_t Capacity>
+    void write_family(string &out, string_view name, string_view help, histogram_family<Capacity> const &family) {
+        out += fmt::format("# HELP {} {}\n# TYPE {} histogram\n", name, help, name);
+        for(size_t i = 0; i < family.size(); i++) {
+            write_histogram(out, name, fmt::format("message_type=\"{}\"", family.label(i)), family.at(i));
+        }
+    }
+
+    void write_value(string &out, string_view name, string_view type, string_view help, uint64_t value) {
+        out += fmt::format("# HELP {} {}\n# TYPE {} {}\n{} {}\n", name, help, name, type, name, value);
+    }
+
+    string render_prometheus_metrics(server_metrics const &m) {
+        string out;
+        out.reserve(64 * 1024);
+
+        out += "# HELP ibh_tick_phase_microseconds Time spent per game loop tick phase\n# TYPE ibh_tick_phase_microseconds histogram\n";
+        for(size_t i = 0; i < tick_phase_count; i++) {
+            auto phase_name = magic_enum::enum_name(static_cast<tick_phase>(i));
+            write_histogram(out, "ibh_tick_phase_microseconds", fmt::format("phase=\"{}\"", phase_name), m.tick_phase_us[i]);
+        }
+
+        write_family(out, "ibh_request_handler_microseconds", "Time spent handling a client request, by message type", m.request_handler_us);
+        write_family(out, "ibh_game_queue_handler_microseconds", "Time spent handling a game queue message, by message type", m.game_queue_handler_us);
+
+        out += "# HELP ibh_db_query_microseconds Time spent executing a database query\n# TYPE ibh_db_query_microseconds histogram\n";
+        write_histogram(out, "ibh_db_query_microseconds", "", m.db_query_us);
+        out += "# HELP ibh_db_commit_microseconds Time spent committing game queue transactions\n# TYPE ibh_db_commit_microseconds histogram\n";
+        write_histogram(out, "ibh_db_commit_microseconds", "", m.db_commit_us);
+
+        write_value(out, "ibh_game_loop_queue_depth", "gauge", "Messages waiting for the game loop", m.game_loop_queue_depth.load(memory_order_relaxed));
+        write_value(out, "ibh_outward_queue_depth", "gauge", "Messages waiting to be sent to clients", m.outward_queue_depth.load(memory_order_relaxed));
+        write_value(out, "ibh_connected_users", "gauge", "Open websocket connections", m.connected_users.load(memory_order_relaxed));
+        write_value(out, "ibh_outbound_queued_bytes", "gauge", "Bytes queued in per connection outbound queues", outbound_stats.queued_bytes.load(memory_order_relaxed));
+        write_value(out, "ibh_outbound_sent_messages_total", "counter", "Messages handed to websocketpp", outbound_stats.sent_messages.load(memory_order_relaxed));
+        write_value(out, "ibh_outbound_dropped_messages_total", "counter", "Messages dropped for slow consumers", outbound_stats.dropped_messages.load(memory_order_relaxed));
+        write_value(out, "ibh_outbound_coalesced_messages_total", "counter", "Battle updates merged into a pending one", outbound_stats.coalesced_messages.load(memory_order_relaxed));
+        write_value(out, "ibh_slow_consumer_disconnects_total", "counter", "Connections closed for not keeping up", outbound_stats.slow_consumer_disconnects.load(memory_order_relaxed));
+        write_value(out, "ibh_game_queue_commits_total", "counter", "Commits of game queue transactions", commit_stats.commits.load(memory_order_relaxed));
+        write_value(out, "ibh_game_queue_failed_commits_total", "counter", "Game queue transactions that failed to commit", commit_stats.failed_commits.load(memory_order_relaxed));
+        write_value(out, "ibh_game_queue_committed_messages_total", "counter", "Game queue messages whose changes were committed", commit_stats.committed_messages.load(memory_order_relaxed));
+        auto const &user_cache_stats = cached_users.counters();
+        write_value(out, "ibh_user_cache_hits_total", "counter", "User lookups served from the cache", user_cache_stats.hits.load(memory_order_relaxed));
+        write_value(out, "ibh_user_cache_negative_hits_total", "counter", "Lookups of users that don't exist served from the cache", user_cache_stats.negative_hits.load(memory_order_relaxed));
+        write_value(out, "ibh_user_cache_misses_total", "counter", "User lookups that went to the database", user_cache_stats.misses.load(memory_order_relaxed));
+        write_value(out, "ibh_user_cache_evictions_total", "counter", "Least recently used users evicted from a full cache", user_cache_stats.evictions.load(memory_order_relaxed));
+
+        return out;
+    }
+}
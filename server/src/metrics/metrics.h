@@ -0,0 +1,91 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <variant>
+#include <spdlog/spdlog.h>
+#include <constexpr_wyhash.h>
+#include "histogram.h"
+
+using namespace std;
+
+namespace ibh {
+    enum class tick_phase : uint32_t {
+        queue_drain,
+        battle,
+        resource,
+        outward_drain,
+        total
+    };
+
+    inline constexpr size_t tick_phase_count = static_cast<size_t>(tick_phase::total) + 1;
+    inline constexpr size_t max_labelled_message_types = 32;
+
+    // Process wide metrics, served in Prometheus text format by the metrics thread.
+    // Latencies are in microseconds, gauges are refreshed once per tick by the game loop.
+    struct server_metrics {
+        array<histogram, tick_phase_count> tick_phase_us;
+        histogram_family<max_labelled_message_types> request_handler_us;
+        histogram_family<max_labelled_message_types> game_queue_handler_us;
+        histogram db_query_us;
+        histogram db_commit_us;
+        atomic<uint64_t> game_loop_queue_depth;
+        atomic<uint64_t> outward_queue_depth;
+        atomic<uint64_t> connected_users;
+
+        [[nodiscard]] histogram& phase(tick_phase p) noexcept {
+            return tick_phase_us[static_cast<size_t>(p)];
+        }
+    };
+
+    extern server_metrics metrics;
+
+    [[nodiscard]] string render_prometheus_metrics(server_metrics const &m = metrics);
+
+    // "ibh::login_request" -> "login_request"
+    [[nodiscard]] constexpr string_view message_label(string_view name) noexcept {
+        auto pos = name.rfind(':');
+        return pos == string_view::npos ? name : name.substr(pos + 1);
+    }
+
+    // adds a histogram per message type, keyed by generate_type<T>() which is what the message's type member holds
+    template <typename... Msgs, size_t Capacity>
+    void add_message_labels(histogram_family<Capacity> &family) {
+        ([&family] {
+            if constexpr (!is_same_v<Msgs, monostate>) {
+                if(!family.add(generate_type<Msgs>(), message_label(type_name<Msgs>()))) {
+                    spdlog::error("[{}] no room left for {}", __FUNCTION__, type_name<Msgs>());
+                }
+            }
+        }(), ...);
+    }
+
+    // variant_labels<queue_message>::add(metrics.game_queue_handler_us)
+    template <typename Variant>
+    struct variant_labels;
+
+    template <typename... Msgs>
+    struct variant_labels<variant<Msgs...>> {
+        template <size_t Capacity>
+        static void add(histogram_family<Capacity> &family) {
+            add_message_labels<Msgs...>(family);
+        }
+    };
+}
@@ -0,0 +1,78 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "metrics_thread.h"
+#include <future>
+#include <spdlog/spdlog.h>
+#include "metrics.h"
+
+using namespace std;
+
+namespace ibh {
+    void on_metrics_http(metrics_server *s, websocketpp::connection_hdl hdl) {
+        auto con = s->get_con_from_hdl(hdl);
+        if(con->get_request().get_method() != "GET" || con->get_resource() != "/metrics") {
+            con->set_status(websocketpp::http::status_code::not_found);
+            return;
+        }
+
+        con->append_header("Content-Type", "text/plain; version=0.0.4");
+        con->set_body(render_prometheus_metrics());
+        con->set_status(websocketpp::http::status_code::ok);
+    }
+
+    thread run_metrics(config const &config, metrics_handle &m_handle) {
+        promise<void> listening;
+        auto listening_future = listening.get_future();
+
+        auto t = thread([port = config.metrics_port, &m_handle, listening = move(listening)]() mutable {
+            metrics_server metrics_srv;
+            m_handle.s = &metrics_srv;
+
+            try {
+                metrics_srv.clear_access_channels(websocketpp::log::alevel::all);
+                metrics_srv.clear_error_channels(websocketpp::log::elevel::all);
+                metrics_srv.init_asio();
+                metrics_srv.set_reuse_addr(true);
+                metrics_srv.set_http_handler([&metrics_srv](websocketpp::connection_hdl hdl) {
+                    on_metrics_http(&metrics_srv, move(hdl));
+                });
+                metrics_srv.listen(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port));
+                metrics_srv.start_accept();
+            } catch (websocketpp::exception const &e) {
+                spdlog::error("[{}] could not start metrics endpoint on port {}: {}", __FUNCTION__, port, e.what());
+                m_handle.s = nullptr;
+                listening.set_value();
+                return;
+            }
+
+            spdlog::info("[{}] serving metrics on 127.0.0.1:{}/metrics", __FUNCTION__, port);
+            listening.set_value();
+
+            try {
+                metrics_srv.run();
+            } catch (std::exception const &e) {
+                spdlog::error("[{}] exception {}", __FUNCTION__, e.what());
+            }
+            spdlog::warn("[{}] done", __FUNCTION__);
+        });
+
+        listening_future.wait();
+        return t;
+    }
+}
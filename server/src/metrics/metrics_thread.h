@@ -0,0 +1,41 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <config.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wduplicated-branches"
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+#include <websocketpp/server.hpp>
+#include <websocketpp/config/asio_no_tls.hpp>
+#pragma GCC diagnostic pop
+
+namespace ibh {
+    using metrics_server = websocketpp::server<websocketpp::config::asio>;
+
+    struct metrics_handle {
+        metrics_server* s;
+    };
+
+    // Serves GET /metrics in Prometheus text format on localhost:METRICS_PORT. s is nullptr when the endpoint couldn't be started.
+    thread run_metrics(config const &config, metrics_handle &m_handle);
+}
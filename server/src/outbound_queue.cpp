@@ -0,0 +1,139 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "outbound_queue.h"
+#include <algorithm>
+
+using namespace std;
+using namespace ibh;
+
+namespace ibh {
+    outbound_counters outbound_stats{};
+
+    uint64_t get_battle_message_type(outward_response const &msg) noexcept {
+        if(holds_alternative<battle_update_response>(msg)) {
+            return battle_update_response::type;
+        }
+
+        if(holds_alternative<battle_finished_response>(msg)) {
+            return battle_finished_response::type;
+        }
+
+        if(holds_alternative<new_battle_response>(msg)) {
+            return new_battle_response::type;
+        }
+
+        return 0;
+    }
+
+    optional<slow_consumer_policy> parse_slow_consumer_policy(string const &policy) noexcept {
+        if(policy == "drop") {
+            return slow_consumer_policy::drop;
+        }
+
+        if(policy == "disconnect") {
+            return slow_consumer_policy::disconnect;
+        }
+
+        return {};
+    }
+
+    outbound_queue::outbound_queue(outbound_queue &&other) noexcept
+        : _byte_budget(other._byte_budget), _slow_consumer_bytes(other._slow_consumer_bytes), _policy(other._policy), _queued_bytes(exchange(other._queued_bytes, 0)),
+          _should_disconnect(other._should_disconnect), _pending(move(other._pending)) {
+        other._pending.clear();
+    }
+
+    outbound_queue& outbound_queue::operator=(outbound_queue &&other) noexcept {
+        if(this != &other) {
+            outbound_stats.queued_bytes.fetch_sub(_queued_bytes, memory_order_relaxed);
+            _byte_budget = other._byte_budget;
+            _slow_consumer_bytes = other._slow_consumer_bytes;
+            _policy = other._policy;
+            _queued_bytes = exchange(other._queued_bytes, 0);
+            _should_disconnect = other._should_disconnect;
+            _pending = move(other._pending);
+            other._pending.clear();
+        }
+        return *this;
+    }
+
+    outbound_queue::~outbound_queue() noexcept {
+        outbound_stats.queued_bytes.fetch_sub(_queued_bytes, memory_order_relaxed);
+    }
+
+    void outbound_queue::push(outward_response const &msg, shared_ptr<string const> payload) {
+        auto battle_message_type = get_battle_message_type(msg);
+        if(battle_message_type == battle_update_response::type) {
+            // updates are deltas the client subtracts from hp, so they are summed up rather than replaced,
+            // but only while the pending one still belongs to the same battle
+            auto pending_it = find_if(rbegin(_pending), rend(_pending), [](pending_outbound_message const &pending) noexcept { return pending.battle_message_type != 0; });
+            if(pending_it != rend(_pending) && pending_it->battle_update) {
+                merge(*pending_it, get<battle_update_response>(msg));
+                return;
+            }
+        }
+
+        if(_queued_bytes + payload->size() > _byte_budget) {
+            outbound_stats.dropped_messages.fetch_add(1, memory_order_relaxed);
+            if(_policy == slow_consumer_policy::disconnect) {
+                _should_disconnect = true;
+            }
+            return;
+        }
+
+        _queued_bytes += payload->size();
+        outbound_stats.queued_bytes.fetch_add(payload->size(), memory_order_relaxed);
+        optional<battle_update_response> battle_update;
+        if(battle_message_type == battle_update_response::type) {
+            battle_update = get<battle_update_response>(msg);
+        }
+        _pending.push_back(pending_outbound_message{battle_message_type, move(battle_update), move(payload)});
+    }
+
+    // the sums only add a few digits, so the merged update is kept even when that crosses the byte budget
+    void outbound_queue::merge(pending_outbound_message &pending, battle_update_response const &update) {
+        auto &merged = *pending.battle_update;
+        merged.mob_turns += update.mob_turns;
+        merged.player_turns += update.player_turns;
+        merged.mob_hits += update.mob_hits;
+        merged.player_hits += update.player_hits;
+        merged.mob_damage += update.mob_damage;
+        merged.player_damage += update.player_damage;
+
+        auto payload = make_shared<string const>(merged.serialize());
+        _queued_bytes = _queued_bytes - pending.payload->size() + payload->size();
+        outbound_stats.queued_bytes.fetch_sub(pending.payload->size(), memory_order_relaxed);
+        outbound_stats.queued_bytes.fetch_add(payload->size(), memory_order_relaxed);
+        outbound_stats.coalesced_messages.fetch_add(1, memory_order_relaxed);
+        pending.payload = move(payload);
+    }
+
+    void outbound_queue::pop_front() noexcept {
+        _queued_bytes -= _pending.front().payload->size();
+        outbound_stats.queued_bytes.fetch_sub(_pending.front().payload->size(), memory_order_relaxed);
+        _pending.pop_front();
+    }
+
+    void outbound_queue::clear(atomic<uint64_t> &counter) noexcept {
+        counter.fetch_add(_pending.size(), memory_order_relaxed);
+        outbound_stats.queued_bytes.fetch_sub(_queued_bytes, memory_order_relaxed);
+        _queued_bytes = 0;
+        _pending.clear();
+    }
+}
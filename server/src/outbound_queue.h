@@ -0,0 +1,147 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <spdlog/spdlog.h>
+#include <game_queue_messages/messages.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wduplicated-branches"
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+#include <websocketpp/frame.hpp>
+#include <websocketpp/close.hpp>
+#pragma GCC diagnostic pop
+
+using namespace std;
+
+namespace ibh {
+    enum class slow_consumer_policy : uint32_t {
+        drop,
+        disconnect
+    };
+
+    struct outbound_counters {
+        atomic<uint64_t> queued_bytes;
+        atomic<uint64_t> sent_messages;
+        atomic<uint64_t> dropped_messages;
+        atomic<uint64_t> coalesced_messages;
+        atomic<uint64_t> slow_consumer_disconnects;
+    };
+
+    extern outbound_counters outbound_stats;
+
+    // returns the message type of responses the battle log has to see in order, 0 for all others
+    [[nodiscard]] uint64_t get_battle_message_type(outward_response const &msg) noexcept;
+    [[nodiscard]] optional<slow_consumer_policy> parse_slow_consumer_policy(string const &policy) noexcept;
+
+    struct pending_outbound_message {
+        uint64_t battle_message_type;
+        // kept for battle updates so newer ones can be merged into it
+        optional<battle_update_response> battle_update;
+        shared_ptr<string const> payload;
+    };
+
+    // Owned by the game loop thread, one per connection. Buffers outward messages so that a slow client
+    // cannot make websocketpp buffer unboundedly.
+    class outbound_queue {
+    public:
+        outbound_queue(uint64_t byte_budget, uint64_t slow_consumer_bytes, slow_consumer_policy policy) noexcept
+            : _byte_budget(byte_budget), _slow_consumer_bytes(slow_consumer_bytes), _policy(policy), _queued_bytes(0), _should_disconnect(false), _pending() {}
+        outbound_queue(outbound_queue &&other) noexcept;
+        outbound_queue& operator=(outbound_queue &&other) noexcept;
+        ~outbound_queue() noexcept;
+
+        // payload has to be msg serialized, pending battle updates absorb newer ones instead of queueing them
+        void push(outward_response const &msg, shared_ptr<string const> payload);
+
+        template <class Server, class WebSocket>
+        void flush(Server *s, WebSocket const &ws) {
+            if(_should_disconnect) {
+                disconnect(s, ws);
+                return;
+            }
+
+            uint64_t buffered = s->get_buffered_amount(ws);
+            if(buffered > _slow_consumer_bytes) {
+                SPDLOG_DEBUG("[{}] slow consumer with {} bytes buffered and {} bytes queued", __FUNCTION__, buffered, _queued_bytes);
+                if(_policy == slow_consumer_policy::disconnect) {
+                    disconnect(s, ws);
+                }
+                return;
+            }
+
+            // a message bigger than the limit is still sent once nothing is buffered, otherwise it would block the queue forever
+            while(!_pending.empty() && (buffered == 0 || buffered + _pending.front().payload->size() <= _slow_consumer_bytes)) {
+                auto &front = _pending.front();
+                try {
+                    s->send(ws, *front.payload, websocketpp::frame::opcode::value::TEXT);
+                } catch (...) {
+                    spdlog::warn("[{}] socket expired, wanted to send outward message", __FUNCTION__);
+                    clear(outbound_stats.dropped_messages);
+                    return;
+                }
+                buffered += front.payload->size();
+                pop_front();
+                outbound_stats.sent_messages.fetch_add(1, memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] uint64_t queued_bytes() const noexcept {
+            return _queued_bytes;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _pending.size();
+        }
+
+        [[nodiscard]] bool should_disconnect() const noexcept {
+            return _should_disconnect;
+        }
+
+    private:
+        template <class Server, class WebSocket>
+        void disconnect(Server *s, WebSocket const &ws) {
+            spdlog::warn("[{}] disconnecting slow consumer with {} bytes queued", __FUNCTION__, _queued_bytes);
+            outbound_stats.slow_consumer_disconnects.fetch_add(1, memory_order_relaxed);
+            clear(outbound_stats.dropped_messages);
+            try {
+                s->close(ws, websocketpp::close::status::policy_violation, "slow consumer");
+            } catch (...) {
+                spdlog::warn("[{}] socket expired, wanted to close slow consumer", __FUNCTION__);
+            }
+            _should_disconnect = false;
+        }
+
+        void merge(pending_outbound_message &pending, battle_update_response const &update);
+        void pop_front() noexcept;
+        void clear(atomic<uint64_t> &counter) noexcept;
+
+        uint64_t _byte_budget;
+        uint64_t _slow_consumer_bytes;
+        slow_consumer_policy _policy;
+        uint64_t _queued_bytes;
+        bool _should_disconnect;
+        deque<pending_outbound_message> _pending;
+    };
+}
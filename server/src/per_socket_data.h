@@ -25,9 +25,10 @@
 #include <websocketpp/client.hpp>
 #include <websocketpp/config/asio.hpp>
 #pragma GCC diagnostic pop
+#include "websocket_compression.h"
 
 namespace ibh {
-    using server = websocketpp::server<websocketpp::config::asio_tls>;
+    using server = compressing_server<asio_tls_deflate>;
     using client = websocketpp::client<websocketpp::config::asio_tls>;
 
     template <class WebSocket>
@@ -33,7 +33,7 @@ bool banned_users_repository<transaction_T>::insert_if_not_exists(db_banned_user
 
     auto result = transaction->execute(fmt::format("INSERT INTO banned_users (ip, user_id, until) VALUES ({}, {}, {}) RETURNING id", ip, user_id, until));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     if(result.empty()) {
         //already exists
@@ -53,14 +53,14 @@ void banned_users_repository<transaction_T>::update(db_banned_user const &usr, u
 
     auto result = transaction->execute(fmt::format("UPDATE banned_users SET ip = {}, user_id = {}, until = {}", ip, user_id, until));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_banned_user> banned_users_repository<transaction_T>::get(int id, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("SELECT id, ip, user_id, until FROM banned_users WHERE id = {}", id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     if(result.empty()) {
         return {};
@@ -92,72 +92,68 @@ optional<db_banned_user> banned_users_repository<transaction_T>::is_username_or_
         return {};
     }
 
-    uint64_t usr_id;
-    string ip_ret;
-    optional<system_clock::time_point> until;
     auto now = system_clock::now().time_since_epoch().count();
+    string query;
 
     if(username && ip) {
-        auto result = transaction->execute(fmt::format("SELECT bu.id as id, bu.ip, until FROM banned_users bu "
-                                           "LEFT JOIN users u ON bu.user_id = u.id AND u.username = '{}' "
-                                           "WHERE bu.until >= {} AND (u.id IS NOT NULL OR bu.ip = '{}')",
-                                           transaction->escape(username.value()), now, transaction->escape(ip.value())));
-
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-        if(result.empty()) {
-            return {};
-        }
+        query = fmt::format("SELECT bu.id as id, bu.ip, until FROM banned_users bu "
+                            "LEFT JOIN users u ON bu.user_id = u.id AND u.username = '{}' "
+                            "WHERE bu.until >= {} AND (u.id IS NOT NULL OR bu.ip = '{}')",
+                            transaction->escape(username.value()), now, transaction->escape(ip.value()));
+    } else if(username) {
+        query = fmt::format("SELECT bu.id as id, bu.ip, until FROM banned_users bu "
+                            "LEFT JOIN users u ON bu.user_id = u.id AND u.username = '{}' "
+                            "WHERE bu.until >= {} AND u.id IS NOT NULL", transaction->escape(username.value()), now);
+    } else {
+        query = fmt::format("SELECT bu.id as id, bu.ip, until FROM banned_users bu "
+                            "WHERE bu.until >= {} AND bu.ip = '{}'", now, transaction->escape(ip.value()));
+    }
 
-        if(!result[0]["ip"].is_null()) {
-            ip_ret = result[0]["ip"].as(string{});
-        }
+    auto result = transaction->execute(query);
 
-        if(!result[0]["until"].is_null()) {
-            until = system_clock::time_point(nanoseconds(result[0]["until"].as(int64_t{})));
-        }
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
-        usr_id = result[0]["id"].as(uint64_t{});
-    } else if(username) {
-        auto result = transaction->execute(fmt::format("SELECT bu.id as id, bu.ip, until FROM banned_users bu "
-                                           "LEFT JOIN users u ON bu.user_id = u.id AND u.username = '{}' "
-                                           "WHERE bu.until >= {} AND u.id IS NOT NULL", transaction->escape(username.value()), now));
+    if(result.empty()) {
+        return {};
+    }
 
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    string ip_ret;
+    optional<system_clock::time_point> until;
 
-        if(result.empty()) {
-            return {};
-        }
+    if(!result[0]["ip"].is_null()) {
+        ip_ret = result[0]["ip"].as(string{});
+    }
 
-        if(!result[0]["ip"].is_null()) {
-            ip_ret = result[0]["ip"].as(string{});
-        }
+    if(!result[0]["until"].is_null()) {
+        until = system_clock::time_point(nanoseconds(result[0]["until"].as(int64_t{})));
+    }
 
-        if(!result[0]["until"].is_null()) {
-            until = system_clock::time_point(nanoseconds(result[0]["until"].as(int64_t{})));
-        }
+    return make_optional<db_banned_user>(result[0]["id"].as(uint64_t{}), ip_ret, db_user{}, until);
+}
 
-        usr_id = result[0]["id"].as(uint64_t{});
-    } else {
-        auto result = transaction->execute(fmt::format("SELECT bu.id as id, bu.ip, until FROM banned_users bu "
-                                           "WHERE bu.until >= {} AND bu.ip = '{}'", now, transaction->escape(ip.value())));
+template<DatabaseTransaction transaction_T>
+vector<db_banned_user> banned_users_repository<transaction_T>::get_active(unique_ptr<transaction_T> const &transaction) const {
+    auto result = transaction->execute(fmt::format("SELECT bu.id, bu.ip, bu.user_id, bu.until, u.username FROM banned_users bu "
+                                                   "LEFT JOIN users u ON bu.user_id = u.id WHERE bu.until >= {}", system_clock::now().time_since_epoch().count()));
 
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
-        if(result.empty()) {
-            return {};
-        }
+    vector<db_banned_user> bans;
+    bans.reserve(result.size());
+    for(auto const &r : result) {
+        string ip;
+        optional<db_user> _user;
 
-        if(!result[0]["ip"].is_null()) {
-            ip_ret = result[0]["ip"].as(string{});
+        if(!r["ip"].is_null()) {
+            ip = r["ip"].as(string{});
         }
 
-        if(!result[0]["until"].is_null()) {
-            until = system_clock::time_point(nanoseconds(result[0]["until"].as(int64_t{})));
+        if(!r["user_id"].is_null() && !r["username"].is_null()) {
+            _user = make_optional<db_user>({r["user_id"].as(uint64_t{}), r["username"].as(string{}), {}, {}, 0, {}, 0, 0});
         }
 
-        usr_id = result[0]["id"].as(uint64_t{});
+        bans.emplace_back(r["id"].as(uint64_t{}), move(ip), move(_user), system_clock::time_point(nanoseconds(r["until"].as(int64_t{}))));
     }
 
-    return make_optional<db_banned_user>(usr_id, ip_ret, db_user{}, until);
+    return bans;
 }
@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <optional>
+#include <vector>
 #include <database/database_transaction.h>
 #include "models.h"
 
@@ -34,5 +35,7 @@ namespace ibh {
         void update(db_banned_user const &usr, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_banned_user> get(int id, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_banned_user> is_username_or_ip_banned(optional<string> username, optional<string> ip, unique_ptr<transaction_T> const &transaction) const;
+        // bans that haven't expired yet, with the username of banned users filled in
+        [[nodiscard]] vector<db_banned_user> get_active(unique_ptr<transaction_T> const &transaction) const;
     };
 }
@@ -29,27 +29,27 @@ void boss_stats_repository<transaction_T>::insert(db_boss_stat &stat, unique_ptr
     auto result = transaction->execute(fmt::format("INSERT INTO boss_stats (boss_id, stat_id, value) VALUES ({}, '{}', {}) RETURNING id", stat.boss_id, stat.stat_id, stat.value));
 
     if(result.empty()) {
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+        SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
         return;
     }
 
     stat.id = result[0][0].as(uint32_t{});
 
-    spdlog::trace("[{}] inserted stat {}", __FUNCTION__, stat.id);
+    SPDLOG_TRACE("[{}] inserted stat {}", __FUNCTION__, stat.id);
 }
 
 template<DatabaseTransaction transaction_T>
 void boss_stats_repository<transaction_T>::update(db_boss_stat const &stat, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("UPDATE boss_stats SET value = {} WHERE id = {}", stat.value, stat.id));
 
-    spdlog::trace("[{}] updated stat {}", __FUNCTION__, stat.id);
+    SPDLOG_TRACE("[{}] updated stat {}", __FUNCTION__, stat.id);
 }
 
 template<DatabaseTransaction transaction_T>
 void boss_stats_repository<transaction_T>::update_by_stat_id(db_boss_stat const &stat, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("UPDATE boss_stats SET value = {} WHERE boss_id = {} AND stat_id = {}", stat.value, stat.boss_id, stat.stat_id));
 
-    spdlog::trace("[{}] updated stat {}", __FUNCTION__, stat.id);
+    SPDLOG_TRACE("[{}] updated stat {}", __FUNCTION__, stat.id);
 }
 
 template<DatabaseTransaction transaction_T>
@@ -57,14 +57,14 @@ optional<db_boss_stat> boss_stats_repository<transaction_T>::get(uint64_t id, un
     auto result = transaction->execute(fmt::format("SELECT s.id, s.boss_id, s.stat_id, s.value FROM boss_stats s WHERE s.id = {}" , id));
 
     if(result.empty()) {
-        spdlog::trace("[{}] found no stat by id {}", __FUNCTION__, id);
+        SPDLOG_TRACE("[{}] found no stat by id {}", __FUNCTION__, id);
         return {};
     }
 
     auto ret = make_optional<db_boss_stat>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}),
                                           result[0][2].as(uint64_t{}), result[0][3].as(int64_t{}));
 
-    spdlog::trace("[{}] found stat by id {}", __FUNCTION__, id);
+    SPDLOG_TRACE("[{}] found stat by id {}", __FUNCTION__, id);
 
     return ret;
 }
@@ -73,7 +73,7 @@ template<DatabaseTransaction transaction_T>
 vector<db_boss_stat> boss_stats_repository<transaction_T>::get_by_boss_id(uint64_t boss_id, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("SELECT s.id, s.boss_id, s.stat_id, s.value FROM boss_stats s WHERE s.boss_id = {}", boss_id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     vector<db_boss_stat> stats;
     stats.reserve(result.size());
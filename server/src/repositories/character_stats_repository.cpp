@@ -18,6 +18,7 @@
 
 #include "character_stats_repository.h"
 #include <spdlog/spdlog.h>
+#include <database/array_parsing.h>
 
 using namespace ibh;
 
@@ -29,27 +30,47 @@ void character_stats_repository<transaction_T>::insert(db_character_stat &stat,
     auto result = transaction->execute(fmt::format("INSERT INTO character_stats (character_id, stat_id, value) VALUES ({}, '{}', {}) RETURNING id", stat.character_id, stat.stat_id, stat.value));
 
     if(result.empty()) {
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+        SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
         return;
     }
 
     stat.id = result[0][0].as(uint32_t{});
 
-    spdlog::trace("[{}] inserted stat {}", __FUNCTION__, stat.id);
+    SPDLOG_TRACE("[{}] inserted stat {}", __FUNCTION__, stat.id);
+}
+
+template<DatabaseTransaction transaction_T>
+void character_stats_repository<transaction_T>::insert_many(span<db_character_stat const> stats, unique_ptr<transaction_T> const &transaction) const {
+    if(stats.empty()) {
+        return;
+    }
+
+    string values;
+    values.reserve(stats.size() * 24);
+    for(auto const &stat : stats) {
+        if(!values.empty()) {
+            values += ',';
+        }
+        fmt::format_to(back_inserter(values), "({}, {}, {})", stat.character_id, stat.stat_id, stat.value);
+    }
+
+    transaction->execute(fmt::format("INSERT INTO character_stats (character_id, stat_id, value) VALUES {}", values));
+
+    SPDLOG_TRACE("[{}] inserted {} stats", __FUNCTION__, stats.size());
 }
 
 template<DatabaseTransaction transaction_T>
 void character_stats_repository<transaction_T>::update(db_character_stat const &stat, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("UPDATE character_stats SET value = {} WHERE id = {}", stat.value, stat.id));
 
-    spdlog::trace("[{}] updated stat {}", __FUNCTION__, stat.id);
+    SPDLOG_TRACE("[{}] updated stat {}", __FUNCTION__, stat.id);
 }
 
 template<DatabaseTransaction transaction_T>
 void character_stats_repository<transaction_T>::update_by_stat_id(db_character_stat const &stat, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("UPDATE character_stats SET value = {} WHERE character_id = {} AND stat_id = {}", stat.value, stat.character_id, stat.stat_id));
 
-    spdlog::trace("[{}] updated stat {}", __FUNCTION__, stat.id);
+    SPDLOG_TRACE("[{}] updated stat {}", __FUNCTION__, stat.id);
 }
 
 template<DatabaseTransaction transaction_T>
@@ -57,14 +78,14 @@ optional<db_character_stat> character_stats_repository<transaction_T>::get(uint6
     auto result = transaction->execute(fmt::format("SELECT s.id, s.character_id, s.stat_id, s.value FROM character_stats s WHERE s.id = {}" , id));
 
     if(result.empty()) {
-        spdlog::trace("[{}] found no stat by id {}", __FUNCTION__, id);
+        SPDLOG_TRACE("[{}] found no stat by id {}", __FUNCTION__, id);
         return {};
     }
 
     auto ret = make_optional<db_character_stat>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}),
                                                 result[0][2].as(uint64_t{}), result[0][3].as(int64_t{}));
 
-    spdlog::trace("[{}] found stat by id {}", __FUNCTION__, id);
+    SPDLOG_TRACE("[{}] found stat by id {}", __FUNCTION__, id);
 
     return ret;
 }
@@ -73,7 +94,28 @@ template<DatabaseTransaction transaction_T>
 vector<db_character_stat> character_stats_repository<transaction_T>::get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("SELECT s.id, s.character_id, s.stat_id, s.value FROM character_stats s WHERE s.character_id = {}", character_id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_character_stat> stats;
+    stats.reserve(result.size());
+
+    for(auto const & res : result) {
+        stats.emplace_back(res[0].as(uint64_t{}), res[1].as(uint64_t{}),
+                           res[2].as(uint64_t{}), res[3].as(int64_t{}));
+    }
+
+    return stats;
+}
+
+template<DatabaseTransaction transaction_T>
+vector<db_character_stat> character_stats_repository<transaction_T>::get_by_character_ids(span<uint64_t const> character_ids, unique_ptr<transaction_T> const &transaction) const {
+    if(character_ids.empty()) {
+        return {};
+    }
+
+    auto result = transaction->execute(fmt::format("SELECT s.id, s.character_id, s.stat_id, s.value FROM character_stats s WHERE s.character_id = ANY({}) ORDER BY s.character_id", to_bigint_array(character_ids)));
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     vector<db_character_stat> stats;
     stats.reserve(result.size());
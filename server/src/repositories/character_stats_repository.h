@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <optional>
+#include <span>
 #include <database/database_transaction.h>
 #include "models.h"
 
@@ -29,9 +30,13 @@ namespace ibh {
     class character_stats_repository  {
     public:
         void insert(db_character_stat &stat, unique_ptr<transaction_T> const &transaction) const;
+        // single statement, ids are not returned
+        void insert_many(span<db_character_stat const> stats, unique_ptr<transaction_T> const &transaction) const;
         void update(db_character_stat const &stat, unique_ptr<transaction_T> const &transaction) const;
         void update_by_stat_id(db_character_stat const &stat, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_character_stat> get(uint64_t id, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] vector<db_character_stat> get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const;
+        // ordered by character_id
+        [[nodiscard]] vector<db_character_stat> get_by_character_ids(span<uint64_t const> character_ids, unique_ptr<transaction_T> const &transaction) const;
     };
 }
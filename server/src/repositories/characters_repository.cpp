@@ -18,6 +18,7 @@
 
 #include "characters_repository.h"
 #include <spdlog/spdlog.h>
+#include <database/array_parsing.h>
 
 using namespace ibh;
 
@@ -34,18 +35,18 @@ bool characters_repository<transaction_T>::insert(db_character &character, uniqu
             transaction->escape(character._class), transaction->escape(character.map)));
 
     if(result.empty()) {
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+        SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
         return false;
     }
 
     character.id = result[0][1].as(uint64_t{});
 
     if(result[0][0].as(uint64_t{}) == 0) {
-        spdlog::trace("[{}] inserted db_character {}", __FUNCTION__, character.id);
+        SPDLOG_TRACE("[{}] inserted db_character {}", __FUNCTION__, character.id);
         return true;
     }
 
-    spdlog::trace("[{}] could not insert db_character {} {}", __FUNCTION__, character.id, character.name);
+    SPDLOG_TRACE("[{}] could not insert db_character {} {}", __FUNCTION__, character.id, character.name);
     return false;
 }
 
@@ -61,18 +62,18 @@ bool characters_repository<transaction_T>::insert_or_update_character(db_charact
             transaction->escape(character.race), transaction->escape(character._class), transaction->escape(character.map)));
 
     if(result.empty()) {
-        spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+        SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
         return false;
     }
 
     character.id = result[0][1].as(uint64_t{});
 
     if(result[0][0].as(uint64_t{}) == 0) {
-        spdlog::trace("[{}] inserted db_character {}", __FUNCTION__, character.id);
+        SPDLOG_TRACE("[{}] inserted db_character {}", __FUNCTION__, character.id);
         return true;
     }
 
-    spdlog::trace("[{}] updated db_character {}", __FUNCTION__, character.id);
+    SPDLOG_TRACE("[{}] updated db_character {}", __FUNCTION__, character.id);
     return false;
 }
 
@@ -82,7 +83,7 @@ void characters_repository<transaction_T>::update_character(db_character const &
             character.user_id, character.level, character.gold, character.xp, character.skill_points, character.x, character.y,
             transaction->escape(character.race), transaction->escape(character._class), transaction->escape(character.map), character.id));
 
-    spdlog::trace("[{}] updated db_character {}", __FUNCTION__, character.id);
+    SPDLOG_TRACE("[{}] updated db_character {}", __FUNCTION__, character.id);
 }
 
 template<DatabaseTransaction transaction_T>
@@ -90,7 +91,7 @@ void characters_repository<transaction_T>::delete_character_by_slot(uint32_t slo
     transaction->execute(fmt::format("DELETE FROM character_stats s USING characters c WHERE s.character_id = c.id AND c.slot = {} AND c.user_id = {}", slot, user_id));
     transaction->execute(fmt::format("DELETE FROM characters WHERE slot = {} AND user_id = {}", slot, user_id));
 
-    spdlog::trace("[{}] deleted db_character {} for user {}", __FUNCTION__, slot, user_id);
+    SPDLOG_TRACE("[{}] deleted db_character {} for user {}", __FUNCTION__, slot, user_id);
 }
 
 template<DatabaseTransaction transaction_T>
@@ -99,7 +100,7 @@ optional<db_character> characters_repository<transaction_T>::get_character(strin
     pqxx::result result = transaction->execute(fmt::format("SELECT p.id, p.user_id, p.slot, p.level, p.gold, p.xp, p.skill_points, p.x, p.y, p.character_name, p.race, p.class, p.map FROM characters p WHERE character_name = '{}' and p.user_id = {}", transaction->escape(name), user_id));
 
     if(result.empty()) {
-        spdlog::trace("[{}] found no db_character by name {}", __FUNCTION__, name);
+        SPDLOG_TRACE("[{}] found no db_character by name {}", __FUNCTION__, name);
         return {};
     }
 
@@ -112,7 +113,7 @@ optional<db_character> characters_repository<transaction_T>::get_character(strin
                                            result[0][11].as(string{}),
                                            result[0][12].as(string{}), vector<db_character_stat>{}, vector<db_item>{});
 
-    spdlog::trace("[{}] found db_character by name {} with id {}", __FUNCTION__, name, ret->id);
+    SPDLOG_TRACE("[{}] found db_character by name {} with id {}", __FUNCTION__, name, ret->id);
 
     return ret;
 }
@@ -122,7 +123,7 @@ optional<db_character> characters_repository<transaction_T>::get_character(uint6
     auto result = transaction->execute(fmt::format("SELECT p.id, p.user_id, p.slot, p.level, p.gold, p.xp, p.skill_points, p.x, p.y, p.character_name, p.race, p.class, p.map FROM characters p WHERE id = {}", id));
 
     if(result.empty()) {
-        spdlog::trace("[{}] found no db_character by id {}", __FUNCTION__, id);
+        SPDLOG_TRACE("[{}] found no db_character by id {}", __FUNCTION__, id);
         return {};
     }
 
@@ -135,7 +136,7 @@ optional<db_character> characters_repository<transaction_T>::get_character(uint6
                                            result[0][11].as(string{}),
                                            result[0][12].as(string{}), vector<db_character_stat>{}, vector<db_item>{});
 
-    spdlog::trace("[{}] found db_character by id {}", __FUNCTION__, id);
+    SPDLOG_TRACE("[{}] found db_character by id {}", __FUNCTION__, id);
 
     return ret;
 }
@@ -147,7 +148,7 @@ optional<db_character> characters_repository<transaction_T>::get_character_by_sl
 
 
     if(result.empty()) {
-        spdlog::trace("[{}] found no db_character by slot {}", __FUNCTION__, slot);
+        SPDLOG_TRACE("[{}] found no db_character by slot {}", __FUNCTION__, slot);
         return {};
     }
 
@@ -160,17 +161,40 @@ optional<db_character> characters_repository<transaction_T>::get_character_by_sl
                                            result[0][11].as(string{}),
                                            result[0][12].as(string{}), vector<db_character_stat>{}, vector<db_item>{});
 
-    spdlog::trace("[{}] found db_character by slot {} for user {}", __FUNCTION__, slot, user_id);
+    SPDLOG_TRACE("[{}] found db_character by slot {} for user {}", __FUNCTION__, slot, user_id);
 
     return ret;
 }
 
+template<DatabaseTransaction transaction_T>
+vector<db_character> characters_repository<transaction_T>::get_characters(span<uint64_t const> ids, unique_ptr<transaction_T> const &transaction) const {
+    if(ids.empty()) {
+        return {};
+    }
+
+    pqxx::result result = transaction->execute(fmt::format("SELECT p.id, p.user_id, p.slot, p.level, p.gold, p.xp, p.skill_points, p.x, p.y, p.character_name, p.race, p.class, p.map FROM characters p WHERE p.id = ANY({})", to_bigint_array(ids)));
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_character> characters;
+    characters.reserve(result.size());
+
+    for(auto const & res : result) {
+        characters.emplace_back(res[0].as(uint64_t{}), res[1].as(uint64_t{}), res[2].as(uint32_t{}), res[3].as(uint64_t{}),
+                                res[4].as(uint64_t{}),res[5].as(uint64_t{}), res[6].as(uint64_t{}), res[7].as(uint32_t{}),
+                                res[8].as(uint32_t{}), res[9].as(string{}), res[10].as(string{}), res[11].as(string{}),
+                                res[12].as(string{}), vector<db_character_stat>{}, vector<db_item>{});
+    }
+
+    return characters;
+}
+
 template<DatabaseTransaction transaction_T>
 vector<db_character> characters_repository<transaction_T>::get_by_user_id(uint64_t user_id,
                                                                                   unique_ptr<transaction_T> const &transaction) const {
     pqxx::result result = transaction->execute(fmt::format("SELECT p.id, p.user_id, p.slot, p.level, p.gold, p.xp, p.skill_points, p.x, p.y, p.character_name, p.race, p.class, p.map FROM characters p WHERE user_id = {}", user_id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     vector<db_character> characters;
     characters.reserve(result.size());
@@ -184,3 +208,59 @@ vector<db_character> characters_repository<transaction_T>::get_by_user_id(uint64
 
     return characters;
 }
+
+template<DatabaseTransaction transaction_T>
+vector<db_character_summary> characters_repository<transaction_T>::get_summaries_by_user_id(uint64_t user_id,
+                                                                                         unique_ptr<transaction_T> const &transaction) const {
+    pqxx::result result = transaction->execute(fmt::format("SELECT p.id, p.user_id, p.slot, p.level, p.gold, p.xp, p.skill_points, p.x, p.y, p.character_name, p.race, p.class, p.map, "
+                                                           "COALESCE(c.name, ''), COALESCE(s.stat_ids, '{{}}'), COALESCE(s.stat_values, '{{}}') FROM characters p "
+                                                           "LEFT JOIN LATERAL (SELECT array_agg(cs.stat_id ORDER BY cs.stat_id) AS stat_ids, array_agg(cs.value ORDER BY cs.stat_id) AS stat_values "
+                                                           "FROM character_stats cs WHERE cs.character_id = p.id) s ON true "
+                                                           "LEFT JOIN company_members m ON m.character_id = p.id "
+                                                           "LEFT JOIN companies c ON c.id = m.company_id "
+                                                           "WHERE p.user_id = {}", user_id));
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_character_summary> summaries;
+    summaries.reserve(result.size());
+
+    for(auto const & res : result) {
+        auto character_id = res[0].as(uint64_t{});
+        auto stat_ids = parse_bigint_array(res[14]);
+        auto stat_values = parse_bigint_array(res[15]);
+        if(stat_ids.size() != stat_values.size()) {
+            spdlog::error("[{}] character {} has {} stat ids but {} values", __FUNCTION__, character_id, stat_ids.size(), stat_values.size());
+            continue;
+        }
+
+        vector<db_character_stat> stats;
+        stats.reserve(stat_ids.size());
+        for(size_t i = 0; i < stat_ids.size(); i++) {
+            stats.emplace_back(0, character_id, stat_ids[i], stat_values[i]);
+        }
+
+        summaries.emplace_back(db_character{character_id, res[1].as(uint64_t{}), res[2].as(uint32_t{}), res[3].as(uint64_t{}),
+                                            res[4].as(uint64_t{}), res[5].as(uint64_t{}), res[6].as(uint64_t{}), res[7].as(uint32_t{}),
+                                            res[8].as(uint32_t{}), res[9].as(string{}), res[10].as(string{}), res[11].as(string{}),
+                                            res[12].as(string{}), move(stats), vector<db_item>{}}, res[13].as(string{}));
+    }
+
+    return summaries;
+}
+
+template<DatabaseTransaction transaction_T>
+vector<uint64_t> characters_repository<transaction_T>::get_all_ids(unique_ptr<transaction_T> const &transaction) const {
+    pqxx::result result = transaction->execute("SELECT p.id FROM characters p");
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<uint64_t> ids;
+    ids.reserve(result.size());
+
+    for(auto const & res : result) {
+        ids.push_back(res[0].as(uint64_t{}));
+    }
+
+    return ids;
+}
@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <optional>
+#include <span>
 #include <database/database_transaction.h>
 #include "models.h"
 
@@ -37,6 +38,10 @@ namespace ibh {
         [[nodiscard]] optional<db_character> get_character(string const &name, uint64_t user_id, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_character> get_character(uint64_t id, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_character> get_character_by_slot(uint32_t slot, uint64_t user_id, unique_ptr<transaction_T> const &transaction) const;
+        [[nodiscard]] vector<db_character> get_characters(span<uint64_t const> ids, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] vector<db_character> get_by_user_id(uint64_t user_id, unique_ptr<transaction_T> const &transaction) const;
+        // characters of a user including stats and company name, in a single query
+        [[nodiscard]] vector<db_character_summary> get_summaries_by_user_id(uint64_t user_id, unique_ptr<transaction_T> const &transaction) const;
+        [[nodiscard]] vector<uint64_t> get_all_ids(unique_ptr<transaction_T> const &transaction) const;
     };
 }
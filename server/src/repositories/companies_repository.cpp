@@ -18,6 +18,7 @@
 
 #include "companies_repository.h"
 #include <spdlog/spdlog.h>
+#include <database/array_parsing.h>
 
 using namespace ibh;
 using namespace chrono;
@@ -25,11 +26,21 @@ using namespace chrono;
 template class ibh::companies_repository<database_transaction>;
 template class ibh::companies_repository<database_subtransaction>;
 
+static optional<db_company> parse_company(pqxx::result const &result) {
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    if(result.empty()) {
+        return {};
+    }
+
+    return make_optional<db_company>(result[0]["id"].as(uint64_t{}), result[0]["name"].as(string{}), result[0]["no_of_shares"].as(uint64_t{}), result[0]["company_type"].as(uint16_t{}));
+}
+
 template<DatabaseTransaction transaction_T>
 bool companies_repository<transaction_T>::insert(db_company &company, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("INSERT INTO companies (name, no_of_shares, company_type) VALUES ('{}', {}, {}) ON CONFLICT DO NOTHING RETURNING id", transaction->escape(company.name), company.no_of_shares, company.company_type));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     if(result.empty()) {
         //already exists
@@ -45,47 +56,37 @@ template<DatabaseTransaction transaction_T>
 void companies_repository<transaction_T>::update(db_company const &company, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("UPDATE companies SET name = '{}', no_of_shares = {} WHERE id = {}", transaction->escape(company.name), company.no_of_shares, company.id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 }
 
 template<DatabaseTransaction transaction_T>
 void companies_repository<transaction_T>::remove(db_company const &company, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("DELETE FROM companies WHERE id = {}", company.id));
 
-    spdlog::trace("[{}] removed {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] removed {} entries", __FUNCTION__, result.size());
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_company> companies_repository<transaction_T>::get(int id, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT id, name, no_of_shares, company_type FROM companies WHERE id = {}", id));
-
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-    if(result.empty()) {
-        return {};
-    }
+    return parse_company(transaction->execute(fmt::format("SELECT id, name, no_of_shares, company_type FROM companies WHERE id = {}", id)));
+}
 
-    return make_optional<db_company>(result[0]["id"].as(uint64_t{}), result[0]["name"].as(string{}), result[0]["no_of_shares"].as(uint64_t{}), result[0]["company_type"].as(uint16_t{}));
+template<DatabaseTransaction transaction_T>
+pipelined<optional<db_company>> companies_repository<transaction_T>::get_async(int id, database_pipeline &pipeline) const {
+    auto query_id = pipeline.insert(fmt::format("SELECT id, name, no_of_shares, company_type FROM companies WHERE id = {}", id));
+    return pipelined<optional<db_company>>(&pipeline, query_id, parse_company);
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_company> companies_repository<transaction_T>::get(string const &name, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT id, name, no_of_shares, company_type FROM companies WHERE name = '{}'", transaction->escape(name)));
-
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-    if(result.empty()) {
-        return {};
-    }
-
-    return make_optional<db_company>(result[0]["id"].as(uint64_t{}), result[0]["name"].as(string{}), result[0]["no_of_shares"].as(uint64_t{}), result[0]["company_type"].as(uint16_t{}));
+    return parse_company(transaction->execute(fmt::format("SELECT id, name, no_of_shares, company_type FROM companies WHERE name = '{}'", transaction->escape(name))));
 }
 
 template<DatabaseTransaction transaction_T>
 vector<db_company> companies_repository<transaction_T>::get_all(const unique_ptr<transaction_T> &transaction) const {
     auto result = transaction->execute("SELECT id, name, no_of_shares, company_type FROM companies");
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     vector<db_company> companies;
     companies.reserve(result.size());
@@ -96,3 +97,41 @@ vector<db_company> companies_repository<transaction_T>::get_all(const unique_ptr
 
     return companies;
 }
+
+template<DatabaseTransaction transaction_T>
+vector<db_company_listing> companies_repository<transaction_T>::get_listing(const unique_ptr<transaction_T> &transaction) const {
+    auto result = transaction->execute("SELECT c.id, c.name, c.no_of_shares, c.company_type, COALESCE(m.member_ids, '{}'), COALESCE(m.member_names, '{}'), "
+                                       "COALESCE(s.stat_ids, '{}'), COALESCE(s.stat_values, '{}') FROM companies c "
+                                       "LEFT JOIN LATERAL (SELECT array_agg(cm.character_id ORDER BY cm.character_id) AS member_ids, array_agg(p.character_name ORDER BY cm.character_id) AS member_names "
+                                       "FROM company_members cm JOIN characters p ON p.id = cm.character_id WHERE cm.company_id = c.id) m ON true "
+                                       "LEFT JOIN LATERAL (SELECT array_agg(cs.stat_id ORDER BY cs.stat_id) AS stat_ids, array_agg(cs.value ORDER BY cs.stat_id) AS stat_values "
+                                       "FROM company_stats cs WHERE cs.company_id = c.id) s ON true");
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_company_listing> companies;
+    companies.reserve(result.size());
+
+    for(auto const & res : result) {
+        auto company_id = res[0].as(uint64_t{});
+        auto member_ids = parse_bigint_array(res[4]);
+        auto member_names = parse_text_array(res[5]);
+        auto stat_ids = parse_bigint_array(res[6]);
+        auto stat_values = parse_bigint_array(res[7]);
+        if(member_ids.size() != member_names.size() || stat_ids.size() != stat_values.size()) {
+            spdlog::error("[{}] company {} has mismatched member or stat arrays", __FUNCTION__, company_id);
+            continue;
+        }
+
+        vector<db_company_stat> stats;
+        stats.reserve(stat_ids.size());
+        for(size_t i = 0; i < stat_ids.size(); i++) {
+            stats.emplace_back(0, company_id, stat_ids[i], stat_values[i]);
+        }
+
+        companies.emplace_back(db_company{company_id, res[1].as(string{}), res[2].as(uint64_t{}), res[3].as(uint16_t{})},
+                               vector<uint64_t>(begin(member_ids), end(member_ids)), move(member_names), move(stats));
+    }
+
+    return companies;
+}
@@ -22,6 +22,7 @@
 #include <memory>
 #include <optional>
 #include <database/database_transaction.h>
+#include <database/database_pipeline.h>
 #include "models.h"
 
 using namespace std;
@@ -34,7 +35,10 @@ namespace ibh {
         void update(db_company const &company, unique_ptr<transaction_T> const &transaction) const;
         void remove(db_company const &company, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_company> get(int id, unique_ptr<transaction_T> const &transaction) const;
+        [[nodiscard]] pipelined<optional<db_company>> get_async(int id, database_pipeline &pipeline) const;
         [[nodiscard]] optional<db_company> get(string const &name, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] vector<db_company> get_all(unique_ptr<transaction_T> const &transaction) const;
+        // all companies including members and stats, in a single query
+        [[nodiscard]] vector<db_company_listing> get_listing(unique_ptr<transaction_T> const &transaction) const;
     };
 }
@@ -29,7 +29,7 @@ template<DatabaseTransaction transaction_T>
 bool company_buildings_repository<transaction_T>::insert(db_company_building &company, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("INSERT INTO company_buildings (name, company_id) VALUES ('{}', {}) ON CONFLICT DO NOTHING RETURNING id", transaction->escape(company.name), company.company_id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     if(result.empty()) {
         //already exists
@@ -45,14 +45,14 @@ template<DatabaseTransaction transaction_T>
 void company_buildings_repository<transaction_T>::update(db_company_building const &company, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("UPDATE company_buildings SET name = '{}' WHERE id = {}", transaction->escape(company.name), company.id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_company_building> company_buildings_repository<transaction_T>::get(int id, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("SELECT id, company_id, name FROM company_buildings WHERE id = {}", id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     if(result.empty()) {
         return {};
@@ -24,6 +24,28 @@ using namespace ibh;
 template class ibh::company_member_applications_repository<database_transaction>;
 template class ibh::company_member_applications_repository<database_subtransaction>;
 
+static optional<db_company_member> parse_application(pqxx::result const &result) {
+    if(result.empty()) {
+        SPDLOG_TRACE("[{}] found no application", __FUNCTION__);
+        return {};
+    }
+
+    return make_optional<db_company_member>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}), 0, 0);
+}
+
+static vector<db_company_member> parse_applications(pqxx::result const &result) {
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_company_member> members;
+    members.reserve(result.size());
+
+    for(auto const & res : result) {
+        members.emplace_back(res[0].as(uint64_t{}), res[1].as(uint64_t{}), 0, 0);
+    }
+
+    return members;
+}
+
 template<DatabaseTransaction transaction_T>
 bool company_member_applications_repository<transaction_T>::insert(db_company_member &member, unique_ptr<transaction_T> const &transaction) const {
     try {
@@ -32,7 +54,7 @@ bool company_member_applications_repository<transaction_T>::insert(db_company_me
         return false;
     }
 
-    spdlog::trace("[{}] inserted member {}-{}", __FUNCTION__, member.company_id, member.character_id);
+    SPDLOG_TRACE("[{}] inserted member {}-{}", __FUNCTION__, member.company_id, member.character_id);
     return true;
 }
 
@@ -40,53 +62,33 @@ template<DatabaseTransaction transaction_T>
 void company_member_applications_repository<transaction_T>::remove(db_company_member const &member, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("DELETE FROM company_member_applications WHERE company_id = {} AND character_id = {}", member.company_id, member.character_id));
 
-    spdlog::trace("[{}] updated member {}-{}", __FUNCTION__, member.company_id, member.character_id);
+    SPDLOG_TRACE("[{}] updated member {}-{}", __FUNCTION__, member.company_id, member.character_id);
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_company_member> company_member_applications_repository<transaction_T>::get(uint64_t company_id, uint64_t character_id, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.company_id = {} AND m.character_id = {}" , company_id, character_id));
-
-    if(result.empty()) {
-        spdlog::trace("[{}] found no member by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
-        return {};
-    }
-
-    auto ret = make_optional<db_company_member>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}), 0, 0);
-
-    spdlog::trace("[{}] found member by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
+    SPDLOG_TRACE("[{}] getting application by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
+    return parse_application(transaction->execute(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.company_id = {} AND m.character_id = {}" , company_id, character_id)));
+}
 
-    return ret;
+template<DatabaseTransaction transaction_T>
+pipelined<optional<db_company_member>> company_member_applications_repository<transaction_T>::get_async(uint64_t company_id, uint64_t character_id, database_pipeline &pipeline) const {
+    auto id = pipeline.insert(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.company_id = {} AND m.character_id = {}" , company_id, character_id));
+    return pipelined<optional<db_company_member>>(&pipeline, id, parse_application);
 }
 
 template<DatabaseTransaction transaction_T>
 vector<db_company_member> company_member_applications_repository<transaction_T>::get_by_company_id(uint64_t company_id, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.company_id = {}", company_id));
-
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-    vector<db_company_member> members;
-    members.reserve(result.size());
-
-    for(auto const & res : result) {
-        members.emplace_back(res[0].as(uint64_t{}), res[1].as(uint64_t{}), 0, 0);
-    }
+    return parse_applications(transaction->execute(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.company_id = {}", company_id)));
+}
 
-    return members;
+template<DatabaseTransaction transaction_T>
+pipelined<vector<db_company_member>> company_member_applications_repository<transaction_T>::get_by_company_id_async(uint64_t company_id, database_pipeline &pipeline) const {
+    auto id = pipeline.insert(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.company_id = {}", company_id));
+    return pipelined<vector<db_company_member>>(&pipeline, id, parse_applications);
 }
 
 template<DatabaseTransaction transaction_T>
 vector<db_company_member> company_member_applications_repository<transaction_T>::get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.character_id = {}", character_id));
-
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-    vector<db_company_member> members;
-    members.reserve(result.size());
-
-    for(auto const & res : result) {
-        members.emplace_back(res[0].as(uint64_t{}), res[1].as(uint64_t{}), 0, 0);
-    }
-
-    return members;
+    return parse_applications(transaction->execute(fmt::format("SELECT m.company_id, m.character_id FROM company_member_applications m WHERE m.character_id = {}", character_id)));
 }
@@ -22,6 +22,7 @@
 #include <memory>
 #include <optional>
 #include <database/database_transaction.h>
+#include <database/database_pipeline.h>
 #include "models.h"
 
 namespace ibh {
@@ -31,7 +32,9 @@ namespace ibh {
         bool insert(db_company_member &member, unique_ptr<transaction_T> const &transaction) const;
         void remove(db_company_member const &member, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_company_member> get(uint64_t id, uint64_t character_id, unique_ptr<transaction_T> const &transaction) const;
+        [[nodiscard]] pipelined<optional<db_company_member>> get_async(uint64_t id, uint64_t character_id, database_pipeline &pipeline) const;
         [[nodiscard]] vector<db_company_member> get_by_company_id(uint64_t company_id, unique_ptr<transaction_T> const &transaction) const;
+        [[nodiscard]] pipelined<vector<db_company_member>> get_by_company_id_async(uint64_t company_id, database_pipeline &pipeline) const;
         [[nodiscard]] vector<db_company_member> get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const;
     };
 }
@@ -24,6 +24,15 @@ using namespace ibh;
 template class ibh::company_members_repository<database_transaction>;
 template class ibh::company_members_repository<database_subtransaction>;
 
+static optional<db_company_member> parse_member(pqxx::result const &result) {
+    if(result.empty()) {
+        SPDLOG_TRACE("[{}] found no member", __FUNCTION__);
+        return {};
+    }
+
+    return make_optional<db_company_member>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}), result[0][2].as(uint16_t{}), result[0][3].as(uint64_t{}));
+}
+
 template<DatabaseTransaction transaction_T>
 bool company_members_repository<transaction_T>::insert(db_company_member const &member, unique_ptr<transaction_T> const &transaction) const {
     try {
@@ -33,7 +42,7 @@ bool company_members_repository<transaction_T>::insert(db_company_member const &
         return false;
     }
 
-    spdlog::trace("[{}] inserted member {}-{}", __FUNCTION__, member.company_id, member.character_id);
+    SPDLOG_TRACE("[{}] inserted member {}-{}", __FUNCTION__, member.company_id, member.character_id);
     return true;
 }
 
@@ -41,14 +50,14 @@ template<DatabaseTransaction transaction_T>
 void company_members_repository<transaction_T>::update(db_company_member const &member, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("UPDATE company_members SET member_level = {}, wage = {} WHERE company_id = {} AND character_id = {}", member.member_level, member.wage, member.company_id, member.character_id));
 
-    spdlog::trace("[{}] updated member {}-{}", __FUNCTION__, member.company_id, member.character_id);
+    SPDLOG_TRACE("[{}] updated member {}-{}", __FUNCTION__, member.company_id, member.character_id);
 }
 
 template<DatabaseTransaction transaction_T>
 void company_members_repository<transaction_T>::remove(db_company_member const &member, unique_ptr<transaction_T> const &transaction) const {
     transaction->execute(fmt::format("DELETE FROM company_members WHERE company_id = {} AND character_id = {}", member.company_id, member.character_id));
 
-    spdlog::trace("[{}] deleted member {}-{}", __FUNCTION__, member.company_id, member.character_id);
+    SPDLOG_TRACE("[{}] deleted member {}-{}", __FUNCTION__, member.company_id, member.character_id);
 }
 
 template<DatabaseTransaction transaction_T>
@@ -56,13 +65,13 @@ optional<db_company_member> company_members_repository<transaction_T>::get(uint6
     auto result = transaction->execute(fmt::format("SELECT m.company_id, m.character_id, m.member_level, m.wage FROM company_members m WHERE m.company_id = {} AND m.character_id = {}" , company_id, character_id));
 
     if(result.empty()) {
-        spdlog::trace("[{}] found no member by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
+        SPDLOG_TRACE("[{}] found no member by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
         return {};
     }
 
     auto ret = make_optional<db_company_member>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}), result[0][2].as(uint16_t{}), result[0][3].as(uint64_t{}));
 
-    spdlog::trace("[{}] found member by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
+    SPDLOG_TRACE("[{}] found member by company_id {} character_id {}", __FUNCTION__, company_id, character_id);
 
     return ret;
 }
@@ -71,7 +80,7 @@ template<DatabaseTransaction transaction_T>
 vector<db_company_member> company_members_repository<transaction_T>::get_by_company_id(uint64_t company_id, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format("SELECT m.company_id, m.character_id, m.member_level, m.wage FROM company_members m WHERE m.company_id = {}", company_id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     vector<db_company_member> members;
     members.reserve(result.size());
@@ -85,16 +94,28 @@ vector<db_company_member> company_members_repository<transaction_T>::get_by_comp
 
 template<DatabaseTransaction transaction_T>
 optional<db_company_member> company_members_repository<transaction_T>::get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT m.company_id, m.character_id, m.member_level, m.wage FROM company_members m WHERE m.character_id = {} LIMIT 1", character_id));
+    SPDLOG_TRACE("[{}] getting member character_id {}", __FUNCTION__, character_id);
+    return parse_member(transaction->execute(fmt::format("SELECT m.company_id, m.character_id, m.member_level, m.wage FROM company_members m WHERE m.character_id = {} LIMIT 1", character_id)));
+}
 
-    if(result.empty()) {
-        spdlog::trace("[{}] found no member character_id {}", __FUNCTION__, character_id);
-        return {};
-    }
+template<DatabaseTransaction transaction_T>
+pipelined<optional<db_company_member>> company_members_repository<transaction_T>::get_by_character_id_async(uint64_t character_id, database_pipeline &pipeline) const {
+    auto id = pipeline.insert(fmt::format("SELECT m.company_id, m.character_id, m.member_level, m.wage FROM company_members m WHERE m.character_id = {} LIMIT 1", character_id));
+    return pipelined<optional<db_company_member>>(&pipeline, id, parse_member);
+}
 
-    auto ret = make_optional<db_company_member>(result[0][0].as(uint64_t{}), result[0][1].as(uint64_t{}), result[0][2].as(uint16_t{}), result[0][3].as(uint64_t{}));
+template<DatabaseTransaction transaction_T>
+vector<db_company_member> company_members_repository<transaction_T>::get_all(unique_ptr<transaction_T> const &transaction) const {
+    auto result = transaction->execute("SELECT m.company_id, m.character_id, m.member_level, m.wage FROM company_members m");
 
-    spdlog::trace("[{}] found member character_id {}", __FUNCTION__, character_id);
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
-    return ret;
+    vector<db_company_member> members;
+    members.reserve(result.size());
+
+    for(auto const & res : result) {
+        members.emplace_back(res[0].as(uint64_t{}), res[1].as(uint64_t{}), res[2].as(uint16_t{}), res[3].as(uint64_t{}));
+    }
+
+    return members;
 }
@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <optional>
+#include <span>
 #include <database/database_transaction.h>
 #include "models.h"
 
@@ -33,5 +34,7 @@ namespace ibh {
         void update_by_stat_id(db_item_stat const &stat, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_item_stat> get(uint64_t id, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] vector<db_item_stat> get_by_item_id(uint64_t item_id, unique_ptr<transaction_T> const &transaction) const;
+        // ordered by item_id
+        [[nodiscard]] vector<db_item_stat> get_by_item_ids(span<uint64_t const> item_ids, unique_ptr<transaction_T> const &transaction) const;
     };
 }
@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <optional>
+#include <span>
 #include <database/database_transaction.h>
 #include "models.h"
 
@@ -35,5 +36,7 @@ namespace ibh {
         void delete_item(db_item const &item, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] optional<db_item> get_item(uint64_t id, unique_ptr<transaction_T> const &transaction) const;
         [[nodiscard]] vector<db_item> get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const;
+        // ordered by character_id
+        [[nodiscard]] vector<db_item> get_by_character_ids(span<uint64_t const> character_ids, unique_ptr<transaction_T> const &transaction) const;
     };
 }
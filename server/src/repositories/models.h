@@ -102,6 +102,15 @@ namespace ibh {
         _class(move(_class)), map(move(map)), stats(move(stats)), items(move(items)) {}
     };
 
+    // a character with its stats and the name of its company, empty when not in one
+    struct db_character_summary {
+        db_character character;
+        string company_name;
+
+        db_character_summary() : character(), company_name() {}
+        db_character_summary(db_character character, string company_name) : character(move(character)), company_name(move(company_name)) {}
+    };
+
     struct db_boss_stat {
         uint64_t id;
         uint64_t boss_id;
@@ -159,5 +168,17 @@ namespace ibh {
         db_company() : id(), name(), no_of_shares(), company_type() {}
         db_company(uint64_t id, string name, uint64_t no_of_shares, uint16_t company_type) : id(id), name(move(name)), no_of_shares(no_of_shares), company_type(company_type) {}
     };
+
+    // a company with the ids and names of its members and its stats, member_ids and member_names are in the same order
+    struct db_company_listing {
+        db_company company;
+        vector<uint64_t> member_ids;
+        vector<string> member_names;
+        vector<db_company_stat> stats;
+
+        db_company_listing() : company(), member_ids(), member_names(), stats() {}
+        db_company_listing(db_company company, vector<uint64_t> member_ids, vector<string> member_names, vector<db_company_stat> stats)
+        : company(move(company)), member_ids(move(member_ids)), member_names(move(member_names)), stats(move(stats)) {}
+    };
 }
 
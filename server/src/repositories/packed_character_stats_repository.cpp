@@ -0,0 +1,105 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "packed_character_stats_repository.h"
+#include <map>
+#include <spdlog/spdlog.h>
+#include <database/array_parsing.h>
+#include <common_components.h>
+
+using namespace ibh;
+
+template class ibh::packed_character_stats_repository<database_transaction>;
+template class ibh::packed_character_stats_repository<database_subtransaction>;
+
+static void unpack_stats(pqxx::result const &result, vector<db_character_stat> &stats) {
+    for(auto const & res : result) {
+        auto character_id = res[0].as(uint64_t{});
+        auto packed = parse_bigint_array(res[1]);
+        if(packed.size() % 2 != 0) {
+            spdlog::error("[{}] character {} has an odd number of packed stat values", __FUNCTION__, character_id);
+            continue;
+        }
+
+        for(size_t i = 0; i < packed.size(); i += 2) {
+            stats.emplace_back(0, character_id, static_cast<uint64_t>(packed[i]), packed[i + 1]);
+        }
+    }
+}
+
+template<DatabaseTransaction transaction_T>
+void packed_character_stats_repository<transaction_T>::save(span<db_character_stat const> stats, unique_ptr<transaction_T> const &transaction) const {
+    if(stats.empty()) {
+        return;
+    }
+
+    map<uint64_t, vector<int64_t>> packed_by_character;
+    for(auto const &stat : stats) {
+        auto &packed = packed_by_character[stat.character_id];
+        packed.push_back(static_cast<int64_t>(stat.stat_id));
+        packed.push_back(stat.value);
+    }
+
+    string values;
+    for(auto const &[character_id, packed] : packed_by_character) {
+        if(!values.empty()) {
+            values += ',';
+        }
+        fmt::format_to(back_inserter(values), "({}, {})", character_id, to_bigint_array(packed));
+    }
+
+    transaction->execute(fmt::format("INSERT INTO character_stats_packed (character_id, stats) VALUES {} "
+                                     "ON CONFLICT (character_id) DO UPDATE SET stats = EXCLUDED.stats", values));
+
+    SPDLOG_TRACE("[{}] saved {} stats of {} characters", __FUNCTION__, stats.size(), packed_by_character.size());
+}
+
+template<DatabaseTransaction transaction_T>
+void packed_character_stats_repository<transaction_T>::remove(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const {
+    transaction->execute(fmt::format("DELETE FROM character_stats_packed WHERE character_id = {}", character_id));
+
+    SPDLOG_TRACE("[{}] removed stats of character {}", __FUNCTION__, character_id);
+}
+
+template<DatabaseTransaction transaction_T>
+vector<db_character_stat> packed_character_stats_repository<transaction_T>::get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const {
+    auto result = transaction->execute(fmt::format("SELECT s.character_id, s.stats FROM character_stats_packed s WHERE s.character_id = {}", character_id));
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_character_stat> stats;
+    unpack_stats(result, stats);
+    return stats;
+}
+
+template<DatabaseTransaction transaction_T>
+vector<db_character_stat> packed_character_stats_repository<transaction_T>::get_by_character_ids(span<uint64_t const> character_ids, unique_ptr<transaction_T> const &transaction) const {
+    if(character_ids.empty()) {
+        return {};
+    }
+
+    auto result = transaction->execute(fmt::format("SELECT s.character_id, s.stats FROM character_stats_packed s WHERE s.character_id = ANY({}) ORDER BY s.character_id", to_bigint_array(character_ids)));
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    vector<db_character_stat> stats;
+    stats.reserve(result.size() * stat_name_ids.size());
+    unpack_stats(result, stats);
+    return stats;
+}
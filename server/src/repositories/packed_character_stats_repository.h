@@ -0,0 +1,43 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <optional>
+#include <span>
+#include <database/database_transaction.h>
+#include "models.h"
+
+namespace ibh {
+    // Alternative to character_stats_repository that keeps one row per character, with all stats packed in a single
+    // BIGINT[] column as stat_id, value pairs. Reading or writing all stats of a character is a single row,
+    // instead of one row per stat. Ids of the returned stats are always 0.
+    template<DatabaseTransaction transaction_T>
+    class packed_character_stats_repository  {
+    public:
+        // replaces all stats of every character that has a stat in stats, in a single statement
+        void save(span<db_character_stat const> stats, unique_ptr<transaction_T> const &transaction) const;
+        void remove(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const;
+        [[nodiscard]] vector<db_character_stat> get_by_character_id(uint64_t character_id, unique_ptr<transaction_T> const &transaction) const;
+        // ordered by character_id
+        [[nodiscard]] vector<db_character_stat> get_by_character_ids(span<uint64_t const> character_ids, unique_ptr<transaction_T> const &transaction) const;
+    };
+}
@@ -0,0 +1,142 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "user_cache.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+using namespace std;
+using namespace ibh;
+
+user_cache ibh::cached_users{};
+
+namespace ibh {
+    static string to_user_key(string_view username) {
+        string key(username);
+        transform(begin(key), end(key), begin(key), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return key;
+    }
+
+    user_cache::user_cache(size_t capacity, chrono::seconds ttl, chrono::seconds negative_ttl) : _shards(), _capacity_per_shard(), _ttl(), _negative_ttl() {
+        configure(capacity, ttl, negative_ttl);
+    }
+
+    void user_cache::configure(size_t capacity, chrono::seconds ttl, chrono::seconds negative_ttl) {
+        clear();
+        _capacity_per_shard = capacity == 0 ? 0 : max<size_t>(1, capacity / shard_count);
+        _ttl = ttl;
+        _negative_ttl = negative_ttl;
+    }
+
+    optional<db_user> user_cache::get_or_load(string_view username, function<optional<db_user>()> const &load, chrono::steady_clock::time_point now) {
+        if(_capacity_per_shard == 0) {
+            return load();
+        }
+
+        auto key = to_user_key(username);
+        auto &s = shard_for(key);
+        uint64_t generation;
+        {
+            lock_guard lock(s.m);
+            auto it = s.index.find(key);
+            if(it != end(s.index)) {
+                if(it->second->expires > now) {
+                    s.lru.splice(begin(s.lru), s.lru, it->second);
+                    (it->second->user ? _counters.hits : _counters.negative_hits).fetch_add(1, memory_order_relaxed);
+                    return it->second->user;
+                }
+
+                s.lru.erase(it->second);
+                s.index.erase(it);
+            }
+            generation = s.generation;
+        }
+
+        _counters.misses.fetch_add(1, memory_order_relaxed);
+        auto user = load();
+
+        lock_guard lock(s.m);
+        if(s.generation != generation) {
+            SPDLOG_TRACE("[{}] {} invalidated while loading, not caching", __FUNCTION__, key);
+            return user;
+        }
+
+        auto expires = now + (user ? _ttl : _negative_ttl);
+        auto it = s.index.find(key);
+        if(it != end(s.index)) {
+            // loaded by another thread in the meantime
+            it->second->user = user;
+            it->second->expires = expires;
+            s.lru.splice(begin(s.lru), s.lru, it->second);
+            return user;
+        }
+
+        s.lru.push_front(entry{key, user, expires});
+        s.index.emplace(move(key), begin(s.lru));
+        while(s.lru.size() > _capacity_per_shard) {
+            s.index.erase(s.lru.back().key);
+            s.lru.pop_back();
+            _counters.evictions.fetch_add(1, memory_order_relaxed);
+        }
+
+        return user;
+    }
+
+    void user_cache::invalidate(string_view username) {
+        // other spellings of a non-ascii name fold to different keys, rare enough to drop everything instead of tracking them
+        if(any_of(begin(username), end(username), [](unsigned char c) { return c >= 0x80; })) {
+            clear();
+            return;
+        }
+
+        auto key = to_user_key(username);
+        auto &s = shard_for(key);
+        lock_guard lock(s.m);
+        s.generation++;
+        auto it = s.index.find(key);
+        if(it != end(s.index)) {
+            s.lru.erase(it->second);
+            s.index.erase(it);
+        }
+    }
+
+    void user_cache::clear() {
+        for(auto &s : _shards) {
+            lock_guard lock(s.m);
+            s.generation++;
+            s.index.clear();
+            s.lru.clear();
+        }
+    }
+
+    size_t user_cache::size() const {
+        size_t size = 0;
+        for(auto const &s : _shards) {
+            lock_guard lock(s.m);
+            size += s.lru.size();
+        }
+        return size;
+    }
+
+    user_cache::shard& user_cache::shard_for(string const &key) {
+        // the upper bits, the lower ones pick the bucket inside the shard
+        return _shards[(custom_hash<string>{}(key) >> 32) % shard_count];
+    }
+}
@@ -0,0 +1,93 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <ibh_containers.h>
+#include "models.h"
+
+using namespace std;
+
+namespace ibh {
+    struct user_cache_counters {
+        atomic<uint64_t> hits;
+        atomic<uint64_t> negative_hits;
+        atomic<uint64_t> misses;
+        atomic<uint64_t> evictions;
+    };
+
+    // Read-through cache in front of users_repository::get, keyed by the lowercased username just like the CITEXT column.
+    //
+    // Users that don't exist are cached as well, for a shorter time, so that logins with random usernames don't reach the database.
+    // Entries are spread over shards with their own lock and LRU list, the least recently used entry of a full shard is evicted.
+    // users_repository invalidates once an insert or update is committed, a load racing with an invalidation isn't cached.
+    class user_cache {
+    public:
+        static constexpr size_t shard_count = 16;
+
+        user_cache(size_t capacity = 100'000, chrono::seconds ttl = 5min, chrono::seconds negative_ttl = 10s);
+
+        // not thread safe, meant to be called at startup. A capacity of 0 disables caching.
+        void configure(size_t capacity, chrono::seconds ttl, chrono::seconds negative_ttl);
+
+        [[nodiscard]] optional<db_user> get_or_load(string_view username, function<optional<db_user>()> const &load, chrono::steady_clock::time_point now = chrono::steady_clock::now());
+        void invalidate(string_view username);
+        void clear();
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] user_cache_counters const & counters() const noexcept {
+            return _counters;
+        }
+
+    private:
+        struct entry {
+            string key;
+            optional<db_user> user;
+            chrono::steady_clock::time_point expires;
+        };
+
+        struct shard {
+            // most recently used at the front
+            list<entry> lru;
+            unordered_map<string, list<entry>::iterator, custom_hash<string>, custom_equalto<string>> index;
+            uint64_t generation{};
+            mutable mutex m;
+        };
+
+        [[nodiscard]] shard& shard_for(string const &key);
+
+        array<shard, shard_count> _shards;
+        size_t _capacity_per_shard;
+        chrono::seconds _ttl;
+        chrono::seconds _negative_ttl;
+        user_cache_counters _counters{};
+    };
+
+    extern user_cache cached_users;
+}
@@ -17,6 +17,7 @@
 */
 
 #include "users_repository.h"
+#include "user_cache.h"
 #include <spdlog/spdlog.h>
 
 using namespace ibh;
@@ -24,13 +25,30 @@ using namespace ibh;
 template class ibh::users_repository<database_transaction>;
 template class ibh::users_repository<database_subtransaction>;
 
+static optional<db_user> parse_user(pqxx::result const &result) {
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    if(result.empty()) {
+        return {};
+    }
+
+    return make_optional<db_user>(result[0]["id"].as(uint64_t{}), result[0]["username"].as(string{}),
+                                  result[0]["password"].as(string{}), result[0]["email"].as(string{}),
+                                  result[0]["login_attempts"].as(uint16_t{}), result[0]["verification_code"].as(string{}),
+                                  result[0]["max_characters"].as(uint16_t{}), result[0]["is_game_master"].as(uint16_t{}));
+}
+
 template<DatabaseTransaction transaction_T>
 bool users_repository<transaction_T>::insert_if_not_exists(db_user &usr, unique_ptr<transaction_T> const &transaction) const {
     auto result = transaction->execute(fmt::format(
             "INSERT INTO users (username, password, email, login_attempts, verification_code, is_game_master, max_characters) VALUES ('{}', '{}', '{}', {}, '{}', {}, {}) ON CONFLICT DO NOTHING RETURNING id",
             transaction->escape(usr.username), transaction->escape(usr.password), transaction->escape(usr.email), usr.login_attempts, transaction->escape(usr.verification_code), usr.is_game_master, usr.max_characters));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
+
+    // also drops a cached "doesn't exist". Only once committed, a login racing with the registration could otherwise
+    // cache "doesn't exist" again under the new generation.
+    transaction->on_commit([username = usr.username] { cached_users.invalidate(username); });
 
     if(result.empty()) {
         //already exists
@@ -47,46 +65,27 @@ void users_repository<transaction_T>::update(db_user const &usr, unique_ptr<tran
     auto result = transaction->execute(fmt::format("UPDATE users SET username = '{}', password = '{}', email = '{}', login_attempts = {}, verification_code = '{}', is_game_master = {}, max_characters = {} WHERE id = {}",
                                                    transaction->escape(usr.username), transaction->escape(usr.password), transaction->escape(usr.email), usr.login_attempts, transaction->escape(usr.verification_code), usr.is_game_master, usr.max_characters, usr.id));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    // the username itself may have changed and the old one is unknown here, updates are rare enough to drop everything
+    transaction->on_commit([] { cached_users.clear(); });
+
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_user> users_repository<transaction_T>::get(int id, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT * FROM users WHERE id = {}", id));
-
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-    if(result.empty()) {
-        return {};
-    }
-
-    return make_optional<db_user>(result[0]["id"].as(uint64_t{}), result[0]["username"].as(string{}),
-                                  result[0]["password"].as(string{}), result[0]["email"].as(string{}),
-                                  result[0]["login_attempts"].as(uint16_t{}), result[0]["verification_code"].as(string{}),
-                                  result[0]["max_characters"].as(uint16_t{}), result[0]["is_game_master"].as(uint16_t{}));
+    return parse_user(transaction->execute(fmt::format("SELECT * FROM users WHERE id = {}", id)));
 }
 
 template<DatabaseTransaction transaction_T>
 optional<db_user> users_repository<transaction_T>::get(string const &username, unique_ptr<transaction_T> const &transaction) const {
-    auto result = transaction->execute(fmt::format("SELECT * FROM users WHERE username = '{}'", transaction->escape(username)));
-
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
-
-    if(result.empty()) {
-        return {};
-    }
-
-    return make_optional<db_user>(result[0]["id"].as(uint64_t{}), result[0]["username"].as(string{}),
-                                  result[0]["password"].as(string{}), result[0]["email"].as(string{}),
-                                  result[0]["login_attempts"].as(uint16_t{}), result[0]["verification_code"].as(string{}),
-                                  result[0]["max_characters"].as(uint16_t{}), result[0]["is_game_master"].as(uint16_t{}));
+    return parse_user(transaction->execute(fmt::format("SELECT * FROM users WHERE username = '{}'", transaction->escape(username))));
 }
 
 template<DatabaseTransaction transaction_T>
 vector<db_user> users_repository<transaction_T>::get_all(const unique_ptr<transaction_T> &transaction) const {
     pqxx::result result = transaction->execute(fmt::format("SELECT * FROM users u LEFT JOIN banned_users bu ON bu.user_id = u.id WHERE bu.id IS NULL"));
 
-    spdlog::trace("[{}] contains {} entries", __FUNCTION__, result.size());
+    SPDLOG_TRACE("[{}] contains {} entries", __FUNCTION__, result.size());
 
     vector<db_user> users;
     users.reserve(result.size());
@@ -0,0 +1,619 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "registry_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <spdlog/spdlog.h>
+#include <ecs/components.h>
+#include <repositories/characters_repository.h>
+#include <repositories/companies_repository.h>
+#include <repositories/company_members_repository.h>
+#include <asset_loading/load_from_database.h>
+#include <tracing.h>
+
+using namespace std;
+using namespace ibh;
+
+namespace {
+    enum snapshot_flags : uint8_t {
+        has_battle = 1,
+        has_company = 2
+    };
+
+    template <typename... Tags>
+    struct tag_list {};
+
+    // order is part of the snapshot format, only append
+    using gathering_tags = tag_list<wood_gathering_component, ore_gathering_component, water_gathering_component, plants_gathering_component,
+            clay_gathering_component, paper_gathering_component, ink_gathering_component, metal_gathering_component, bricks_gathering_component,
+            gems_gathering_component, timber_gathering_component, item_gathering_component, working_component>;
+
+    class snapshot_writer {
+    public:
+        explicit snapshot_writer(vector<char> &buffer) : _buffer(buffer) {}
+
+        template <typename T>
+        void write(T val) {
+            static_assert(is_trivially_copyable_v<T>);
+            auto const *bytes = reinterpret_cast<char const *>(&val);
+            _buffer.insert(end(_buffer), bytes, bytes + sizeof(T));
+        }
+
+        void write(string const &val) {
+            write<uint64_t>(val.size());
+            _buffer.insert(end(_buffer), begin(val), end(val));
+        }
+
+        template <typename T>
+        void overwrite(size_t pos, T val) {
+            static_assert(is_trivially_copyable_v<T>);
+            memcpy(_buffer.data() + pos, &val, sizeof(T));
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _buffer.size();
+        }
+
+    private:
+        vector<char> &_buffer;
+    };
+
+    // Bounds checked reads over the mapped file. Once a read fails all subsequent reads fail as well,
+    // so callers only have to check failed() once per character.
+    class snapshot_reader {
+    public:
+        snapshot_reader(char const *data, size_t size) : _pos(data), _end(data + size), _failed(false) {}
+
+        template <typename T>
+        void read(T &val) {
+            static_assert(is_trivially_copyable_v<T>);
+            if(!has_remaining(sizeof(T))) {
+                return;
+            }
+            memcpy(&val, _pos, sizeof(T));
+            _pos += sizeof(T);
+        }
+
+        void read(string &val) {
+            uint64_t size = 0;
+            read(size);
+            if(!has_remaining(size)) {
+                return;
+            }
+            val.assign(_pos, size);
+            _pos += size;
+        }
+
+        // a count of elements of at least min_element_size bytes each, so corrupt counts can't cause huge allocations
+        void read_count(uint64_t &count, size_t min_element_size) {
+            read(count);
+            if(!_failed && count > static_cast<uint64_t>(_end - _pos) / min_element_size) {
+                _failed = true;
+            }
+            if(_failed) {
+                count = 0;
+            }
+        }
+
+        [[nodiscard]] bool failed() const noexcept {
+            return _failed;
+        }
+
+        [[nodiscard]] bool at_end() const noexcept {
+            return _pos == _end;
+        }
+
+    private:
+        bool has_remaining(uint64_t size) noexcept {
+            if(_failed || size > static_cast<uint64_t>(_end - _pos)) {
+                _failed = true;
+                return false;
+            }
+            return true;
+        }
+
+        char const *_pos;
+        char const *_end;
+        bool _failed;
+    };
+
+    void write_stats(snapshot_writer &writer, ibh_flat_map<uint32_t, int64_t> const &stats) {
+        writer.write<uint64_t>(stats.size());
+        for(auto const &[stat_id, value] : stats) {
+            writer.write(stat_id);
+            writer.write(value);
+        }
+    }
+
+    void read_stats(snapshot_reader &reader, ibh_flat_map<uint32_t, int64_t> &stats) {
+        uint64_t count = 0;
+        reader.read_count(count, sizeof(uint32_t) + sizeof(int64_t));
+        stats.reserve(count);
+        for(uint64_t i = 0; i < count; i++) {
+            uint32_t stat_id = 0;
+            int64_t value = 0;
+            reader.read(stat_id);
+            reader.read(value);
+            stats.emplace(stat_id, value);
+        }
+    }
+
+    void write_item(snapshot_writer &writer, item_component const &item) {
+        writer.write(item.name);
+        writer.write(item.desc);
+        writer.write(item.type);
+        writer.write(item.value);
+        writer.write(item.quality);
+        writer.write(item.enchant_level);
+        writer.write(item.required_level);
+        writer.write(item.tier);
+        writer.write(item.binds);
+        writer.write(item.tells_bind);
+        writer.write<uint64_t>(item.stats.size());
+        for(auto const &stat : item.stats) {
+            writer.write(stat.stat_id);
+            writer.write(stat.value);
+        }
+    }
+
+    void read_item(snapshot_reader &reader, item_component &item) {
+        reader.read(item.name);
+        reader.read(item.desc);
+        reader.read(item.type);
+        reader.read(item.value);
+        reader.read(item.quality);
+        reader.read(item.enchant_level);
+        reader.read(item.required_level);
+        reader.read(item.tier);
+        reader.read(item.binds);
+        reader.read(item.tells_bind);
+        uint64_t count = 0;
+        reader.read_count(count, sizeof(uint64_t) + sizeof(int64_t));
+        item.stats.reserve(count);
+        for(uint64_t i = 0; i < count; i++) {
+            uint64_t stat_id = 0;
+            int64_t value = 0;
+            reader.read(stat_id);
+            reader.read(value);
+            item.stats.emplace_back(stat_id, value);
+        }
+    }
+
+    // connection_id is not written, connections don't survive a restart
+    void write_pc(snapshot_writer &writer, pc_component const &pc) {
+        writer.write(pc.id);
+        writer.write(pc.name);
+        writer.write(pc.race);
+        writer.write(pc.dir);
+        writer.write(pc._class);
+        writer.write(pc.spawn_message);
+        writer.write(pc.level);
+        writer.write(pc.skill_points);
+        write_stats(writer, pc.stats);
+        writer.write<uint64_t>(pc.equipped_items.size());
+        for(auto const &[slot, item] : pc.equipped_items) {
+            writer.write(slot);
+            write_item(writer, item);
+        }
+        writer.write<uint64_t>(pc.inventory.size());
+        for(auto const &item : pc.inventory) {
+            write_item(writer, item);
+        }
+        writer.write<uint64_t>(pc.skills.size());
+        for(auto const &[name, skill] : pc.skills) {
+            writer.write(name);
+            writer.write(skill.name);
+            writer.write(skill.level);
+        }
+    }
+
+    void read_pc(snapshot_reader &reader, pc_component &pc) {
+        reader.read(pc.id);
+        reader.read(pc.name);
+        reader.read(pc.race);
+        reader.read(pc.dir);
+        reader.read(pc._class);
+        reader.read(pc.spawn_message);
+        reader.read(pc.level);
+        reader.read(pc.skill_points);
+        read_stats(reader, pc.stats);
+
+        // an item is at least its 3 string lengths, 5 integers, 2 bools and a stat count
+        constexpr size_t min_item_size = 3 * sizeof(uint64_t) + 5 * sizeof(uint64_t) + 2 * sizeof(bool) + sizeof(uint64_t);
+        uint64_t count = 0;
+        reader.read_count(count, sizeof(uint32_t) + min_item_size);
+        pc.equipped_items.reserve(count);
+        for(uint64_t i = 0; i < count; i++) {
+            uint32_t slot = 0;
+            item_component item;
+            reader.read(slot);
+            read_item(reader, item);
+            pc.equipped_items.emplace(slot, move(item));
+        }
+
+        reader.read_count(count, min_item_size);
+        pc.inventory.resize(count);
+        for(auto &item : pc.inventory) {
+            read_item(reader, item);
+        }
+
+        reader.read_count(count, 2 * sizeof(uint64_t) + sizeof(int64_t));
+        pc.skills.reserve(count);
+        for(uint64_t i = 0; i < count; i++) {
+            string name;
+            skill_component skill{};
+            reader.read(name);
+            reader.read(skill.name);
+            reader.read(skill.level);
+            pc.skills.emplace(move(name), move(skill));
+        }
+    }
+
+    void write_battle(snapshot_writer &writer, battle_component const &battle) {
+        writer.write(battle.done);
+        writer.write(battle.monster_name);
+        writer.write(battle.monster_level);
+        write_stats(writer, battle.monster_stats);
+        write_stats(writer, battle.total_player_stats);
+    }
+
+    void read_battle(snapshot_reader &reader, battle_component &battle) {
+        reader.read(battle.done);
+        reader.read(battle.monster_name);
+        reader.read(battle.monster_level);
+        read_stats(reader, battle.monster_stats);
+        read_stats(reader, battle.total_player_stats);
+    }
+
+    void write_company(snapshot_writer &writer, company_component const &company) {
+        writer.write(company.id);
+        writer.write(company.member_level);
+        writer.write(company.name);
+        write_stats(writer, company.stats);
+    }
+
+    void read_company(snapshot_reader &reader, company_component &company) {
+        reader.read(company.id);
+        reader.read(company.member_level);
+        reader.read(company.name);
+        read_stats(reader, company.stats);
+    }
+
+    template <typename... Tags>
+    uint16_t get_gathering_mask(entt::registry &registry, entt::entity entity, tag_list<Tags...>) {
+        static_assert(sizeof...(Tags) <= 16);
+        uint16_t mask = 0;
+        uint16_t bit = 1;
+        ([&] {
+            if(registry.has<Tags>(entity)) {
+                mask |= bit;
+            }
+            bit <<= 1u;
+        }(), ...);
+        return mask;
+    }
+
+    template <typename... Tags>
+    void emplace_gathering_mask(entt::registry &registry, entt::entity entity, uint16_t mask, tag_list<Tags...>) {
+        uint16_t bit = 1;
+        ([&] {
+            if((mask & bit) != 0) {
+                registry.emplace<Tags>(entity);
+            }
+            bit <<= 1u;
+        }(), ...);
+    }
+}
+
+void ibh::serialize_registry(entt::registry &registry, vector<char> &buffer) {
+    buffer.clear();
+    snapshot_writer writer(buffer);
+    writer.write(registry_snapshot_magic);
+    writer.write(registry_snapshot_version);
+    auto count_pos = writer.size();
+    writer.write<uint64_t>(0);
+
+    uint64_t count = 0;
+    auto pc_view = registry.view<pc_component>();
+    for(auto entity : pc_view) {
+        auto has_battle_component = registry.has<battle_component>(entity);
+        auto has_company_component = registry.has<company_component>(entity);
+        uint8_t flags = 0;
+        if(has_battle_component) {
+            flags |= has_battle;
+        }
+        if(has_company_component) {
+            flags |= has_company;
+        }
+
+        write_pc(writer, pc_view.get<pc_component>(entity));
+        writer.write(flags);
+        writer.write(get_gathering_mask(registry, entity, gathering_tags{}));
+        if(has_battle_component) {
+            write_battle(writer, registry.get<battle_component>(entity));
+        }
+        if(has_company_component) {
+            write_company(writer, registry.get<company_component>(entity));
+        }
+        count++;
+    }
+
+    writer.overwrite(count_pos, count);
+}
+
+optional<uint64_t> ibh::deserialize_registry(char const *data, size_t size, entt::registry &registry) {
+    snapshot_reader reader(data, size);
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    uint64_t count = 0;
+    reader.read(magic);
+    reader.read(version);
+    reader.read(count);
+
+    if(reader.failed() || magic != registry_snapshot_magic) {
+        spdlog::warn("[{}] not a registry snapshot", __FUNCTION__);
+        return {};
+    }
+
+    if(version != registry_snapshot_version) {
+        spdlog::warn("[{}] snapshot version {} does not match current version {}", __FUNCTION__, version, registry_snapshot_version);
+        return {};
+    }
+
+    // parse everything before touching the registry, a truncated file should not leave half its characters behind
+    struct character {
+        pc_component pc;
+        uint8_t flags;
+        uint16_t gathering_mask;
+        battle_component battle;
+        company_component company;
+    };
+    vector<character> characters;
+    characters.reserve(min<uint64_t>(count, size / sizeof(uint64_t)));
+
+    for(uint64_t i = 0; i < count && !reader.failed(); i++) {
+        auto &c = characters.emplace_back(character{pc_component{}, 0, 0, battle_component{}, company_component{}});
+        read_pc(reader, c.pc);
+        reader.read(c.flags);
+        reader.read(c.gathering_mask);
+        if((c.flags & has_battle) != 0) {
+            read_battle(reader, c.battle);
+        }
+        if((c.flags & has_company) != 0) {
+            read_company(reader, c.company);
+        }
+    }
+
+    if(reader.failed() || !reader.at_end()) {
+        spdlog::warn("[{}] snapshot is truncated or corrupt", __FUNCTION__);
+        return {};
+    }
+
+    for(auto &c : characters) {
+        auto entity = registry.create();
+        registry.emplace<pc_component>(entity, move(c.pc));
+        if((c.flags & has_battle) != 0) {
+            registry.emplace<battle_component>(entity, move(c.battle));
+        }
+        if((c.flags & has_company) != 0) {
+            registry.emplace<company_component>(entity, move(c.company));
+        }
+        emplace_gathering_mask(registry, entity, c.gathering_mask, gathering_tags{});
+    }
+
+    return count;
+}
+
+optional<uint64_t> ibh::load_registry_snapshot(string const &path, entt::registry &registry) {
+    auto loading_start = chrono::system_clock::now();
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        spdlog::info("[{}] no snapshot at {}: {}", __FUNCTION__, path, strerror(errno));
+        return {};
+    }
+
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        spdlog::warn("[{}] could not stat snapshot {} or it is empty", __FUNCTION__, path);
+        close(fd);
+        return {};
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    auto *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        spdlog::error("[{}] could not mmap snapshot {}: {}", __FUNCTION__, path, strerror(errno));
+        return {};
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    madvise(data, size, MADV_WILLNEED);
+
+    auto count = deserialize_registry(static_cast<char const *>(data), size, registry);
+    munmap(data, size);
+
+    if(count) {
+        auto loading_end = chrono::system_clock::now();
+        spdlog::info("[{}] {:n} characters loaded from snapshot in {:n} µs", __FUNCTION__, *count, chrono::duration_cast<chrono::microseconds>(loading_end - loading_start).count());
+    }
+
+    return count;
+}
+
+void ibh::reconcile_registry_snapshot(entt::registry &registry, unique_ptr<database_transaction> const &transaction) {
+    characters_repository<database_transaction> char_repo{};
+    auto db_ids = char_repo.get_all_ids(transaction);
+    sort(begin(db_ids), end(db_ids));
+
+    vector<uint64_t> snapshot_ids;
+    vector<entt::entity> deleted;
+    auto pc_view = registry.view<pc_component>();
+    snapshot_ids.reserve(pc_view.size());
+    for(auto entity : pc_view) {
+        auto id = pc_view.get<pc_component>(entity).id;
+        if(binary_search(begin(db_ids), end(db_ids), id)) {
+            snapshot_ids.push_back(id);
+        } else {
+            deleted.push_back(entity);
+        }
+    }
+    registry.destroy(begin(deleted), end(deleted));
+
+    sort(begin(snapshot_ids), end(snapshot_ids));
+    vector<uint64_t> missing;
+    set_difference(begin(db_ids), end(db_ids), begin(snapshot_ids), end(snapshot_ids), back_inserter(missing));
+    load_characters_from_database(registry, missing, transaction);
+
+    // company changes are committed as they happen but only reach the snapshot on the next write, so the database wins
+    auto companies = companies_repository<database_transaction>{}.get_listing(transaction);
+    ibh_flat_map<uint64_t, db_company_listing const *> companies_by_id;
+    companies_by_id.reserve(companies.size());
+    for(auto const &company : companies) {
+        companies_by_id.emplace(company.company.id, &company);
+    }
+
+    auto members = company_members_repository<database_transaction>{}.get_all(transaction);
+    ibh_flat_map<uint64_t, db_company_member const *> members_by_character_id;
+    members_by_character_id.reserve(members.size());
+    for(auto const &member : members) {
+        members_by_character_id.emplace(member.character_id, &member);
+    }
+
+    uint64_t company_members = 0;
+    for(auto entity : pc_view) {
+        auto member = members_by_character_id.find(pc_view.get<pc_component>(entity).id);
+        auto company = member != end(members_by_character_id) ? companies_by_id.find(member->second->company_id) : end(companies_by_id);
+        if(company == end(companies_by_id)) {
+            registry.remove_if_exists<company_component>(entity);
+            continue;
+        }
+
+        ibh_flat_map<uint32_t, int64_t> stats;
+        stats.reserve(company->second->stats.size());
+        for(auto const &stat : company->second->stats) {
+            stats.emplace(stat.stat_id, stat.value);
+        }
+        registry.emplace_or_replace<company_component>(entity, company_component{company->second->company.id, member->second->member_level, company->second->company.name, move(stats)});
+        company_members++;
+    }
+
+    spdlog::info("[{}] removed {} characters deleted since the snapshot, loaded {} created since, {} characters are in a company", __FUNCTION__, deleted.size(), missing.size(), company_members);
+}
+
+registry_snapshot_writer::registry_snapshot_writer(string path) : _path(move(path)), _capture_buffer(), _write_buffer(), _mutex(), _cv(), _pending(false), _stop(false), _thread() {
+    _thread = thread([this] { run(); });
+}
+
+registry_snapshot_writer::~registry_snapshot_writer() {
+    {
+        lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+bool registry_snapshot_writer::try_snapshot(entt::registry &registry) {
+    {
+        lock_guard lock(_mutex);
+        if(_pending) {
+            return false;
+        }
+    }
+
+    IBH_TRACE_SCOPE(tick, "registry_snapshot");
+    // only the game thread touches the capture buffer and the writer thread only touches the write buffer while pending
+    serialize_registry(registry, _capture_buffer);
+
+    {
+        lock_guard lock(_mutex);
+        swap(_capture_buffer, _write_buffer);
+        _pending = true;
+    }
+    _cv.notify_all();
+    return true;
+}
+
+void registry_snapshot_writer::snapshot(entt::registry &registry) {
+    {
+        unique_lock lock(_mutex);
+        _cv.wait(lock, [this] { return !_pending; });
+    }
+    // the game thread is the only one starting snapshots, so the writer is still idle here
+    try_snapshot(registry);
+}
+
+void registry_snapshot_writer::run() {
+    auto tmp_path = _path + ".tmp";
+    auto directory = filesystem::path(_path).parent_path();
+    if(directory.empty()) {
+        directory = ".";
+    }
+
+    unique_lock lock(_mutex);
+    while(true) {
+        _cv.wait(lock, [this] { return _pending || _stop; });
+        if(!_pending) {
+            return;
+        }
+        lock.unlock();
+
+        [[maybe_unused]] auto write_start = chrono::system_clock::now();
+        auto fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        bool written = fd >= 0;
+        for(size_t offset = 0; written && offset < _write_buffer.size();) {
+            auto ret = write(fd, _write_buffer.data() + offset, _write_buffer.size() - offset);
+            if(ret < 0 && errno == EINTR) {
+                continue;
+            }
+            written = ret > 0;
+            offset += written ? static_cast<size_t>(ret) : 0;
+        }
+        written = written && fsync(fd) == 0;
+        if(fd >= 0) {
+            close(fd);
+        }
+        written = written && rename(tmp_path.c_str(), _path.c_str()) == 0;
+
+        if(written) {
+            // make the rename itself durable
+            auto dir_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if(dir_fd >= 0) {
+                fsync(dir_fd);
+                close(dir_fd);
+            }
+            [[maybe_unused]] auto write_end = chrono::system_clock::now();
+            SPDLOG_DEBUG("[{}] wrote {:n} byte snapshot in {:n} µs", __FUNCTION__, _write_buffer.size(), chrono::duration_cast<chrono::microseconds>(write_end - write_start).count());
+        } else {
+            spdlog::error("[{}] writing snapshot {} failed: {}", __FUNCTION__, _path, strerror(errno));
+        }
+
+        lock.lock();
+        _pending = false;
+        _cv.notify_all();
+    }
+}
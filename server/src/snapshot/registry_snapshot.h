@@ -0,0 +1,81 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <entt/entity/registry.hpp>
+#include <database/database_transaction.h>
+
+using namespace std;
+
+namespace ibh {
+    // "IBHSNAP\0", bump the version whenever the layout of a snapshotted component changes
+    inline constexpr uint64_t registry_snapshot_magic = 0x0050414E53484249ULL;
+    inline constexpr uint32_t registry_snapshot_version = 1;
+
+    // Snapshots pc_component together with the optional battle, company and gathering components of each character.
+    // Integers are stored in host byte order, a snapshot is only meant to be loaded on the machine that wrote it.
+    void serialize_registry(entt::registry &registry, vector<char> &buffer);
+
+    // Returns the amount of characters created, empty when data is not a complete snapshot of the current version.
+    [[nodiscard]] optional<uint64_t> deserialize_registry(char const *data, size_t size, entt::registry &registry);
+
+    // mmaps the snapshot and deserializes it, empty when the file is missing or unusable.
+    [[nodiscard]] optional<uint64_t> load_registry_snapshot(string const &path, entt::registry &registry);
+
+    // The snapshot is authoritative for simulation state, the database for which characters exist and which company they are in.
+    // Removes characters deleted since the snapshot was written, loads the ones created since and replaces every character's
+    // company component with the membership, company name and company stats in the database.
+    void reconcile_registry_snapshot(entt::registry &registry, unique_ptr<database_transaction> const &transaction);
+
+    // Serializes on the game thread into a reused buffer, then hands it to a background thread that writes
+    // to a temporary file, fsyncs and renames it over the previous snapshot.
+    class registry_snapshot_writer {
+    public:
+        explicit registry_snapshot_writer(string path);
+        ~registry_snapshot_writer();
+
+        registry_snapshot_writer(registry_snapshot_writer const &) = delete;
+        registry_snapshot_writer& operator=(registry_snapshot_writer const &) = delete;
+
+        // Returns false without touching the registry when the previous snapshot is still being written.
+        bool try_snapshot(entt::registry &registry);
+
+        // Waits for the previous snapshot to be written first, used on shutdown.
+        void snapshot(entt::registry &registry);
+
+    private:
+        void run();
+
+        string _path;
+        vector<char> _capture_buffer;
+        vector<char> _write_buffer;
+        mutex _mutex;
+        condition_variable _cv;
+        bool _pending;
+        bool _stop;
+        thread _thread;
+    };
+}
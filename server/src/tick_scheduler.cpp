@@ -0,0 +1,110 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tick_scheduler.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+using namespace std;
+
+namespace ibh {
+    optional<tick_overrun_policy> parse_tick_overrun_policy(string const &policy) noexcept {
+        if(policy == "catch_up") {
+            return tick_overrun_policy::catch_up;
+        }
+
+        if(policy == "skip") {
+            return tick_overrun_policy::skip;
+        }
+
+        return {};
+    }
+
+    tick_scheduler::tick_scheduler(chrono::microseconds tick_length, tick_overrun_policy policy, uint32_t max_catch_up_ticks, uint32_t max_system_stretch, clock::time_point start) noexcept
+        : _tick_length(tick_length), _policy(policy), _max_catch_up_ticks(max_catch_up_ticks), _max_system_stretch(max(max_system_stretch, 1u)), _system_stretch(1),
+          _consecutive_overruns(0), _consecutive_underloads(0), _overruns_since_alert(0), _next_tick(start + tick_length), _tick_start(start), _next_alert(start), _stats() {}
+
+    void tick_scheduler::start_tick(clock::time_point now) noexcept {
+        _tick_start = now;
+    }
+
+    void tick_scheduler::end_tick(clock::time_point now) noexcept {
+        auto tick_duration = chrono::duration_cast<chrono::microseconds>(now - _tick_start);
+        _stats.ticks++;
+        _stats.max_tick_us = max(_stats.max_tick_us, static_cast<uint64_t>(tick_duration.count()));
+
+        if(tick_duration > _tick_length) {
+            _stats.overruns++;
+            alert_overrun(now, tick_duration);
+        }
+        adapt_system_stretch(tick_duration);
+
+        _next_tick += _tick_length;
+        if(now <= _next_tick) {
+            return;
+        }
+
+        // ticks that should already have started
+        auto late_ticks = static_cast<uint64_t>((now - _next_tick) / _tick_length) + 1;
+        if(_policy == tick_overrun_policy::skip) {
+            _next_tick += late_ticks * _tick_length;
+            _stats.skipped_ticks += late_ticks;
+        } else if(late_ticks > _max_catch_up_ticks) {
+            auto dropped_ticks = late_ticks - _max_catch_up_ticks;
+            _next_tick += dropped_ticks * _tick_length;
+            _stats.skipped_ticks += dropped_ticks;
+        }
+    }
+
+    void tick_scheduler::adapt_system_stretch(chrono::microseconds tick_duration) noexcept {
+        if(tick_duration > _tick_length) {
+            _consecutive_underloads = 0;
+            _consecutive_overruns++;
+            if(_consecutive_overruns >= overloaded_after_ticks && _system_stretch < _max_system_stretch) {
+                _system_stretch++;
+                _consecutive_overruns = 0;
+                spdlog::warn("[{}] overloaded, systems now run {}x less often", __FUNCTION__, _system_stretch);
+            }
+            return;
+        }
+
+        _consecutive_overruns = 0;
+        if(tick_duration < _tick_length / 2) {
+            _consecutive_underloads++;
+        } else {
+            _consecutive_underloads = 0;
+        }
+
+        if(_consecutive_underloads >= recovered_after_ticks && _system_stretch > 1) {
+            _system_stretch--;
+            _consecutive_underloads = 0;
+            spdlog::info("[{}] load recovered, systems now run {}x less often", __FUNCTION__, _system_stretch);
+        }
+    }
+
+    void tick_scheduler::alert_overrun(clock::time_point now, chrono::microseconds tick_duration) noexcept {
+        _overruns_since_alert++;
+        if(now < _next_alert) {
+            return;
+        }
+
+        spdlog::warn("[{}] tick took {} µs, over budget of {} µs. {} overruns since last alert", __FUNCTION__, tick_duration.count(), _tick_length.count(), _overruns_since_alert);
+        _overruns_since_alert = 0;
+        _next_alert = now + chrono::seconds(1);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+using namespace std;
+
+namespace ibh {
+    enum class tick_overrun_policy : uint32_t {
+        // run late ticks back to back until caught up, at most max_catch_up_ticks of them
+        catch_up,
+        // drop late ticks and continue at the next tick boundary
+        skip
+    };
+
+    [[nodiscard]] optional<tick_overrun_policy> parse_tick_overrun_policy(string const &policy) noexcept;
+
+    struct tick_scheduler_stats {
+        uint64_t ticks;
+        uint64_t overruns;
+        uint64_t skipped_ticks;
+        uint64_t max_tick_us;
+    };
+
+    // Fixed timestep scheduler on steady_clock, so wall clock jumps don't cause bursts or stalls.
+    //
+    // Usage per tick: sleep until next_tick(), start_tick(now), do the work, end_tick(now).
+    // Time points are passed in rather than read here, which keeps the scheduler deterministic for tests.
+    //
+    // When ticks keep overrunning, system_stretch() is increased so that systems can run less often,
+    // and decreased again once ticks comfortably fit in their budget.
+    class tick_scheduler {
+    public:
+        using clock = chrono::steady_clock;
+
+        static constexpr uint32_t overloaded_after_ticks = 10;
+        static constexpr uint32_t recovered_after_ticks = 100;
+
+        tick_scheduler(chrono::microseconds tick_length, tick_overrun_policy policy, uint32_t max_catch_up_ticks, uint32_t max_system_stretch, clock::time_point start) noexcept;
+
+        void start_tick(clock::time_point now) noexcept;
+        void end_tick(clock::time_point now) noexcept;
+
+        [[nodiscard]] clock::time_point next_tick() const noexcept {
+            return _next_tick;
+        }
+
+        [[nodiscard]] uint32_t system_stretch() const noexcept {
+            return _system_stretch;
+        }
+
+        [[nodiscard]] tick_scheduler_stats const & stats() const noexcept {
+            return _stats;
+        }
+
+        void reset_stats() noexcept {
+            _stats = tick_scheduler_stats{};
+        }
+
+    private:
+        void adapt_system_stretch(chrono::microseconds tick_duration) noexcept;
+        void alert_overrun(clock::time_point now, chrono::microseconds tick_duration) noexcept;
+
+        chrono::microseconds _tick_length;
+        tick_overrun_policy _policy;
+        uint32_t _max_catch_up_ticks;
+        uint32_t _max_system_stretch;
+        uint32_t _system_stretch;
+        uint32_t _consecutive_overruns;
+        uint32_t _consecutive_underloads;
+        uint64_t _overruns_since_alert;
+        clock::time_point _next_tick;
+        clock::time_point _tick_start;
+        clock::time_point _next_alert;
+        tick_scheduler_stats _stats;
+    };
+}
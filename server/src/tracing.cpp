@@ -0,0 +1,129 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tracing.h"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+using namespace std;
+
+namespace ibh {
+    atomic<bool> trace_dump_requested{false};
+
+    mutex trace_rings_mutex;
+    vector<unique_ptr<trace_ring>> trace_rings;
+
+    char const * trace_category_name(trace_category category) noexcept {
+        switch(category) {
+            case trace_category::tick:
+                return "tick";
+            case trace_category::systems:
+                return "systems";
+            case trace_category::handlers:
+                return "handlers";
+            case trace_category::database:
+                return "database";
+            case trace_category::network:
+                return "network";
+        }
+        return "unknown";
+    }
+
+    trace_ring* register_trace_ring() {
+        lock_guard lock(trace_rings_mutex);
+        // rings are kept after their thread exits, so that spans from finished threads still show up in a dump
+        trace_rings.emplace_back(make_unique<trace_ring>(static_cast<uint32_t>(trace_rings.size() + 1)));
+        return trace_rings.back().get();
+    }
+
+    trace_ring& thread_trace_ring() {
+        thread_local trace_ring *ring = register_trace_ring();
+        return *ring;
+    }
+
+    bool dump_chrome_trace(string const &path) {
+        rapidjson::StringBuffer sb;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+        uint64_t event_count = 0;
+
+        writer.StartObject();
+        writer.String("traceEvents");
+        writer.StartArray();
+        {
+            lock_guard lock(trace_rings_mutex);
+            for(auto const &ring : trace_rings) {
+                auto head = ring->head.load(memory_order_acquire);
+                auto first = head > trace_ring::ring_capacity ? head - trace_ring::ring_capacity : 0;
+                for(auto i = first; i < head; i++) {
+                    auto const &event = ring->events[i % trace_ring::ring_capacity];
+                    auto name = event.name.load(memory_order_relaxed);
+                    auto start_ns = event.start_ns.load(memory_order_relaxed);
+                    auto duration_ns = event.duration_ns.load(memory_order_relaxed);
+                    auto category = static_cast<trace_category>(event.category.load(memory_order_relaxed));
+
+                    // the owner may have lapped us while reading, skip anything that could have been overwritten
+                    atomic_thread_fence(memory_order_acquire);
+                    if(i + trace_ring::ring_capacity <= ring->head.load(memory_order_acquire)) {
+                        continue;
+                    }
+
+                    writer.StartObject();
+                    writer.String("name");
+                    writer.String(name);
+                    writer.String("cat");
+                    writer.String(trace_category_name(category));
+                    writer.String("ph");
+                    writer.String("X");
+                    writer.String("ts");
+                    writer.Double(static_cast<double>(start_ns) / 1'000.);
+                    writer.String("dur");
+                    writer.Double(static_cast<double>(duration_ns) / 1'000.);
+                    writer.String("pid");
+                    writer.Uint(1);
+                    writer.String("tid");
+                    writer.Uint(ring->thread_id);
+                    writer.EndObject();
+                    event_count++;
+                }
+            }
+        }
+        writer.EndArray();
+        writer.String("displayTimeUnit");
+        writer.String("ns");
+        writer.EndObject();
+
+        ofstream file(path, ios::out | ios::trunc);
+        if(!file) {
+            spdlog::error("[{}] could not open {}", __FUNCTION__, path);
+            return false;
+        }
+        file.write(sb.GetString(), sb.GetSize());
+        if(!file) {
+            spdlog::error("[{}] could not write {}", __FUNCTION__, path);
+            return false;
+        }
+
+        spdlog::info("[{}] wrote {} trace events to {}", __FUNCTION__, event_count, path);
+        return true;
+    }
+}
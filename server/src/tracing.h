@@ -0,0 +1,120 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+// Bitmask of trace_category values that are compiled in, the CMake IBH_TRACE_CATEGORIES cache variable sets it.
+// Disabled categories compile to nothing.
+#ifndef IBH_TRACE_CATEGORIES
+#define IBH_TRACE_CATEGORIES 0xFFFFFFFFu
+#endif
+
+namespace ibh {
+    enum class trace_category : uint32_t {
+        tick = 1u << 0,
+        systems = 1u << 1,
+        handlers = 1u << 2,
+        database = 1u << 3,
+        network = 1u << 4
+    };
+
+    [[nodiscard]] constexpr bool trace_enabled(trace_category category) noexcept {
+        return (static_cast<uint32_t>(IBH_TRACE_CATEGORIES) & static_cast<uint32_t>(category)) != 0;
+    }
+
+    [[nodiscard]] char const * trace_category_name(trace_category category) noexcept;
+
+    // Fields are relaxed atomics so that a dump can read a ring while its owner keeps writing.
+    struct trace_event {
+        atomic<char const *> name;
+        atomic<uint64_t> start_ns;
+        atomic<uint64_t> duration_ns;
+        atomic<uint32_t> category;
+    };
+
+    // Single writer ring buffer, one per thread. Old events are overwritten, so a dump contains the most recent ring_capacity spans per thread.
+    struct trace_ring {
+        static constexpr size_t ring_capacity = 1u << 13;
+
+        array<trace_event, ring_capacity> events;
+        atomic<uint64_t> head;
+        uint32_t thread_id;
+
+        explicit trace_ring(uint32_t thread_id) noexcept : events(), head(0), thread_id(thread_id) {}
+
+        void push(char const *name, trace_category category, uint64_t start_ns, uint64_t duration_ns) noexcept {
+            auto index = head.load(memory_order_relaxed);
+            auto &event = events[index % ring_capacity];
+            event.name.store(name, memory_order_relaxed);
+            event.start_ns.store(start_ns, memory_order_relaxed);
+            event.duration_ns.store(duration_ns, memory_order_relaxed);
+            event.category.store(static_cast<uint32_t>(category), memory_order_relaxed);
+            head.store(index + 1, memory_order_release);
+        }
+    };
+
+    // the calling thread's ring, allocated and registered on first use
+    [[nodiscard]] trace_ring& thread_trace_ring();
+
+    [[nodiscard]] inline uint64_t trace_now_ns() noexcept {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Writes every thread's ring as Chrome trace event JSON, loadable in chrome://tracing or Perfetto.
+    bool dump_chrome_trace(string const &path);
+
+    // Set from a signal handler, the game loop dumps on its next tick. Async signal safe.
+    extern atomic<bool> trace_dump_requested;
+
+    template <trace_category Category>
+    class trace_scope {
+    public:
+        explicit trace_scope(char const *name) noexcept : _name(name), _start(0) {
+            if constexpr (trace_enabled(Category)) {
+                _start = trace_now_ns();
+            }
+        }
+
+        ~trace_scope() {
+            if constexpr (trace_enabled(Category)) {
+                auto end = trace_now_ns();
+                thread_trace_ring().push(_name, Category, _start, end - _start);
+            }
+        }
+
+        trace_scope(trace_scope const &) = delete;
+        trace_scope& operator=(trace_scope const &) = delete;
+
+    private:
+        char const *_name;
+        uint64_t _start;
+    };
+}
+
+#define IBH_TRACE_CONCAT_INNER(a, b) a ## b
+#define IBH_TRACE_CONCAT(a, b) IBH_TRACE_CONCAT_INNER(a, b)
+
+// IBH_TRACE_SCOPE(tick, "battle_system") records a span from here to the end of the enclosing scope. name has to be a string literal.
+#define IBH_TRACE_SCOPE(category, name) ibh::trace_scope<ibh::trace_category::category> IBH_TRACE_CONCAT(ibh_trace_scope_, __LINE__){name}
@@ -0,0 +1,129 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wduplicated-branches"
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+#include <websocketpp/server.hpp>
+#include <websocketpp/config/asio.hpp>
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
+#pragma GCC diagnostic pop
+#include "outbound_queue.h"
+
+using namespace std;
+
+namespace ibh {
+    // Payloads smaller than this are sent uncompressed, deflate overhead isn't worth it for e.g. battle updates.
+    inline atomic<uint32_t> compression_threshold{1024};
+    // When false, every message is compressed with a fresh context (server_no_context_takeover), trading ratio for less memory per connection.
+    inline atomic<bool> compression_shared_context{true};
+    // Direct sends to a connection that already has this much buffered in websocketpp are dropped.
+    inline atomic<uint64_t> max_buffered_bytes{4 * 1024 * 1024};
+
+    template <typename config>
+    class ibh_permessage_deflate : public websocketpp::extensions::permessage_deflate::enabled<config> {
+    public:
+        websocketpp::extensions::permessage_deflate::err_str_pair negotiate(websocketpp::http::attribute_list const &offer) {
+            if(!compression_shared_context.load(memory_order_relaxed)) {
+                this->enable_server_no_context_takeover();
+            }
+            return websocketpp::extensions::permessage_deflate::enabled<config>::negotiate(offer);
+        }
+    };
+
+    // Lets on_message get at the connection id through the hdl it already has, instead of a map keyed by connection_hdl.
+    struct ibh_connection_base : public websocketpp::connection_base {
+        uint64_t connection_id{};
+    };
+
+    struct asio_tls_deflate : public websocketpp::config::asio_tls {
+        typedef asio_tls_deflate type;
+        typedef websocketpp::config::asio_tls base;
+
+        typedef base::concurrency_type concurrency_type;
+
+        typedef base::request_type request_type;
+        typedef base::response_type response_type;
+
+        typedef base::message_type message_type;
+        typedef base::con_msg_manager_type con_msg_manager_type;
+        typedef base::endpoint_msg_manager_type endpoint_msg_manager_type;
+
+        typedef base::alog_type alog_type;
+        typedef base::elog_type elog_type;
+
+        typedef base::rng_type rng_type;
+
+        typedef ibh_connection_base connection_base;
+
+        struct transport_config : public base::transport_config {
+            typedef type::concurrency_type concurrency_type;
+            typedef type::alog_type alog_type;
+            typedef type::elog_type elog_type;
+            typedef type::request_type request_type;
+            typedef type::response_type response_type;
+            typedef websocketpp::transport::asio::tls_socket::endpoint socket_type;
+        };
+
+        typedef websocketpp::transport::asio::endpoint<transport_config> transport_type;
+
+        struct permessage_deflate_config {
+            typedef type::request_type request_type;
+        };
+
+        typedef ibh_permessage_deflate<permessage_deflate_config> permessage_deflate_type;
+    };
+
+    // Hides endpoint::send(hdl, string, opcode) so that every handler gets the size threshold and backpressure without changing call sites.
+    template <typename config>
+    class compressing_server : public websocketpp::server<config> {
+    public:
+        using websocketpp::server<config>::send;
+
+        void send(websocketpp::connection_hdl hdl, string const &payload, websocketpp::frame::opcode::value op) {
+            auto con = this->get_con_from_hdl(hdl);
+            if(con->get_buffered_amount() > max_buffered_bytes.load(memory_order_relaxed)) {
+                outbound_stats.dropped_messages.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+
+            auto msg = con->get_message(op, payload.size());
+            msg->append_payload(payload);
+            msg->set_compressed(payload.size() >= compression_threshold.load(memory_order_relaxed));
+
+            auto ec = con->send(msg);
+            if(ec) {
+                throw websocketpp::exception(ec);
+            }
+        }
+
+        [[nodiscard]] size_t get_buffered_amount(websocketpp::connection_hdl hdl) {
+            websocketpp::lib::error_code ec;
+            auto con = this->get_con_from_hdl(hdl, ec);
+            if(ec) {
+                return 0;
+            }
+            return con->get_buffered_amount();
+        }
+    };
+}
@@ -18,8 +18,11 @@
 
 #include "websocket_thread.h"
 #include <spdlog/spdlog.h>
-#include <ibh_containers.h>
 #include <rapidjson/document.h>
+#include <dispatch_table.h>
+#include <json_arena.h>
+#include <metrics/metrics.h>
+#include "tracing.h"
 #include <message_handlers/user_access/login_handler.h>
 #include <message_handlers/user_access/register_handler.h>
 #include <message_handlers/user_access/play_character_handler.h>
@@ -57,8 +60,8 @@
 using namespace std;
 using namespace ibh;
 
-using message_router_type = ibh_flat_map<uint64_t, function<void(server*, rapidjson::Document const &, unique_ptr<database_transaction> const &, per_socket_data<websocketpp::connection_hdl>*,
-                                                               queue_abstraction<unique_ptr<queue_message>>*, ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &)>>;
+using message_handler_fn = void(*)(server*, rapidjson::Document const &, unique_ptr<database_transaction> const &, per_socket_data<websocketpp::connection_hdl>*,
+                                   queue_abstraction<queue_message>*, connection_registry<websocketpp::connection_hdl> &);
 
 using websocketpp::lib::placeholders::_1;
 using websocketpp::lib::placeholders::_2;
@@ -67,13 +70,10 @@ using websocketpp::lib::bind;
 using context_ptr = websocketpp::lib::shared_ptr<websocketpp::lib::asio::ssl::context>;
 
 namespace ibh {
-    atomic<uint64_t> connection_id_counter = 1;
-    ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> user_connections;
-    ibh_flat_map<websocketpp::connection_hdl, uint64_t> handle_to_connection_id_map;
-    moodycamel::ConcurrentQueue<unique_ptr<queue_message>> game_loop_queue;
+    connection_registry<websocketpp::connection_hdl> user_connections;
+    moodycamel::ConcurrentQueue<queue_message> game_loop_queue;
     string motd;
     character_select_response select_response{{}, {}};
-    shared_mutex user_connections_mutex;
     atomic<bool> init_done = false;
 
     string get_password(config &config, size_t max_len, asio::ssl::context::password_purpose purpose) {
@@ -82,7 +82,7 @@ namespace ibh {
 
 //bool verify_certificate(bool preverified, asio::ssl::verify_context& ssl_verify_ctx) {
 //    std::string errstr(X509_verify_cert_error_string(X509_STORE_CTX_get_error(ssl_verify_ctx.native_handle())));
-//    spdlog::debug("[{}] {} {}", __FUNCTION__, preverified, errstr);
+//    SPDLOG_DEBUG("[{}] {} {}", __FUNCTION__, preverified, errstr);
 //    return true;
 //}
 
@@ -113,66 +113,71 @@ namespace ibh {
         return ctx;
     }
 
-    void on_open(atomic<bool> const &quit, websocketpp::connection_hdl hdl) {
+    void on_open(server *s, atomic<bool> const &quit, websocketpp::connection_hdl hdl) {
         if (quit) {
-            spdlog::debug("[{}] new connection in closing state", __FUNCTION__);
+            SPDLOG_DEBUG("[{}] new connection in closing state", __FUNCTION__);
             return;
         }
 
-        per_socket_data<websocketpp::connection_hdl> user_data{};
         //only called on connect
-        user_data.connection_id = connection_id_counter.fetch_add(1, memory_order_relaxed);
-        user_data.user_id = 0;
-        user_data.playing_character_slot = -1;
-        user_data.username = "";
-        user_data.subscription_tier = 0;
-        user_data.ws = hdl;
-        spdlog::debug("[{}] conn {} open connection", __FUNCTION__, user_data.connection_id);
-        {
-            unique_lock lock(user_connections_mutex);
-            handle_to_connection_id_map[hdl] = user_data.connection_id;
-            user_connections[user_data.connection_id] = user_data;
-            spdlog::debug("[{}] conn {} inserted", __FUNCTION__, user_data.connection_id);
-        }
+        auto *user_data = user_connections.add(hdl);
+        s->get_con_from_hdl(hdl)->connection_id = user_data->connection_id;
+        SPDLOG_DEBUG("[{}] conn {} open connection", __FUNCTION__, user_data->connection_id);
     }
 
-    void on_message(shared_ptr<database_pool> pool, message_router_type &message_router, queue_abstraction<unique_ptr<queue_message>> *q, server *s, websocketpp::connection_hdl hdl, server::message_ptr msg) {
-        string const &message = msg->get_payload();
+    static constexpr auto message_router = make_dispatch_table<message_handler_fn>({
+        // UAC
+        {login_request::type, handle_login<server, websocketpp::connection_hdl>},
+        {register_request::type, handle_register<server, websocketpp::connection_hdl>},
+        {play_character_request::type, handle_play_character<server, websocketpp::connection_hdl>},
+        {create_character_request::type, handle_create_character<server, websocketpp::connection_hdl>},
+        {delete_character_request::type, handle_delete_character<server, websocketpp::connection_hdl>},
+        {character_select_request::type, handle_character_select<server, websocketpp::connection_hdl>},
+
+        // messaging
+        {message_request::type, handle_public_chat<server, websocketpp::connection_hdl>},
+
+        // admin/moderator
+        {set_motd_request::type, handle_set_motd<server, websocketpp::connection_hdl>},
+
+        // companies
+        {accept_application_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, accept_application_request>},
+        {create_company_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, create_company_request>},
+        {get_company_applications_request::type, handle_get_company_applications<server, websocketpp::connection_hdl>},
+        {get_company_listing_request::type, handle_get_company_listing<server, websocketpp::connection_hdl>},
+        {increase_bonus_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, increase_bonus_request>},
+        {join_company_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, join_company_request>},
+        {leave_company_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, leave_company_request>},
+        {reject_application_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, reject_application_request>},
+        {set_tax_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, set_tax_request>},
+
+        // resources
+        {set_action_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, set_action_request_view>},
+    });
+
+    void on_message(shared_ptr<database_pool> pool, queue_abstraction<queue_message> *q, server *s, websocketpp::connection_hdl hdl, server::message_ptr msg) {
+        string &message = msg->get_raw_payload();
 
         if (message.empty() || message.length() < 4) {
             spdlog::warn("[{}] deserialize encountered empty buffer", __FUNCTION__);
             return;
         }
 
-        auto id_map_it = handle_to_connection_id_map.find(hdl);
-        if (id_map_it == cend(handle_to_connection_id_map)) {
-            spdlog::warn("[{}] no id map", __FUNCTION__);
+        auto connection_id = s->get_con_from_hdl(hdl)->connection_id;
+        SPDLOG_TRACE("[{}] conn {} message {}", __FUNCTION__, connection_id, message);
+
+        auto *user_data = user_connections.find(connection_id);
+        if (user_data == nullptr) {
+            spdlog::warn("[{}] conn {} no user data", __FUNCTION__, connection_id);
             generic_error_response resp{"Unrecognized message", "", "", true};
             s->send(hdl, resp.serialize(), websocketpp::frame::opcode::value::TEXT);
             return;
         }
 
-        spdlog::trace("[{}] conn {} message {}", __FUNCTION__, id_map_it->second, message);
-
-        per_socket_data<websocketpp::connection_hdl> *user_data = nullptr;
-        {
-            shared_lock lock(user_connections_mutex);
-            auto user_data_it = user_connections.find(id_map_it->second);
-
-            if (user_data_it == cend(user_connections)) {
-                spdlog::warn("[{}] conn {} no user data", __FUNCTION__, id_map_it->second);
-                generic_error_response resp{"Unrecognized message", "", "", true};
-                s->send(hdl, resp.serialize(), websocketpp::frame::opcode::value::TEXT);
-                return;
-            }
-            user_data = &user_data_it->second;
-        }
-
-        rapidjson::Document d{};
-        d.Parse(&message[0], message.size());
+        auto &d = inbound_arena.parse_insitu(&message[0]);
 
         if (d.HasParseError() || !d.IsObject() || !d.HasMember("type") || !d["type"].IsUint64()) {
-            spdlog::warn("[{}] conn {} deserialize failed", __FUNCTION__, id_map_it->second);
+            spdlog::warn("[{}] conn {} deserialize failed", __FUNCTION__, connection_id);
             SEND_ERROR("Unrecognized message", "", "", true);
             return;
         }
@@ -180,111 +185,72 @@ namespace ibh {
         auto type = d["type"].GetUint64();
 
         auto handler = message_router.find(type);
-        if (handler != message_router.end()) {
+        if (handler != nullptr) {
+            scoped_histogram_timer timer(metrics.request_handler_us.find(type));
+            IBH_TRACE_SCOPE(handlers, "request_handler");
             auto transaction = pool->create_transaction();
             try {
-                handler->second(s, d, transaction, user_data, q, user_connections);
+                handler(s, d, transaction, user_data, q, user_connections);
                 transaction->commit();
             } catch (exception const &e) {
-                spdlog::error("[{}] some exception {} message_type {} user_id {} connection_id {} hdl_id {}", __FUNCTION__, e.what(), type, user_data->user_id,
-                              user_data->connection_id, id_map_it->second);
+                spdlog::error("[{}] some exception {} message_type {} user_id {} connection_id {}", __FUNCTION__, e.what(), type, user_data->user_id,
+                              user_data->connection_id);
                 SEND_ERROR("Server error, please report this as a bug.", "", "", true);
             }
         } else {
-            spdlog::trace("[{}] conn {} no handler for type {}", __FUNCTION__, id_map_it->second, type);
+            SPDLOG_TRACE("[{}] conn {} no handler for type {}", __FUNCTION__, connection_id, type);
             SEND_ERROR("Unknown message type", "", "", true);
         }
     }
 
     void on_close(server *s, websocketpp::connection_hdl hdl) {
-        auto id_map_it = handle_to_connection_id_map.find(hdl);
-        if (id_map_it == cend(handle_to_connection_id_map)) {
-            spdlog::warn("[{}] no id map", __FUNCTION__);
+        auto connection_id = s->get_con_from_hdl(hdl)->connection_id;
+        auto *user_data = user_connections.find(connection_id);
+        if (user_data == nullptr) {
+            spdlog::warn("[{}] conn {} no user data", __FUNCTION__, connection_id);
             return;
         }
-        {
-            unique_lock lock(user_connections_mutex);
-            auto user_data = user_connections.find(id_map_it->second);
-            if (user_data == cend(user_connections)) {
-                spdlog::warn("[{}] conn {} no user data", __FUNCTION__, id_map_it->second);
-                for (auto const &[key, val] : user_connections) {
-                    spdlog::warn("[{}] conn {} no user data {}", __FUNCTION__, id_map_it->second, key);
-                }
-                handle_to_connection_id_map.erase(hdl);
-                return;
-            }
-            if (user_data->second.playing_character_slot >= 0) {
-                // TODO improve performance by using queue tokens
-                game_loop_queue.enqueue(make_unique<player_leave_message>(user_data->second.connection_id));
-            }
-            if (!user_data->second.username.empty()) {
-                auto same_user_id_it = find_if(begin(user_connections), end(user_connections),
-                                               [&user_data](user_connections_type const &vt) noexcept {
-                                                   return vt.second.user_id == user_data->second.user_id && vt.second.connection_id != user_data->second.connection_id;
-                                               });
-
-                if (same_user_id_it == end(user_connections)) {
-                    user_left_game_response join_msg(user_data->second.username);
-                    auto join_msg_str = join_msg.serialize();
-                    for (auto &[conn_id, other_user_data] : user_connections) {
-                        if (other_user_data.user_id != user_data->second.user_id) {
-                            s->send(other_user_data.ws, join_msg_str, websocketpp::frame::opcode::value::TEXT);
-                        }
+
+        if (user_data->playing_character_slot >= 0) {
+            // TODO improve performance by using queue tokens
+            game_loop_queue.enqueue(player_leave_message(user_data->connection_id));
+        }
+        if (!user_data->username.empty()) {
+            auto same_user_id_it = find_if(begin(user_connections), end(user_connections),
+                                           [&user_data](per_socket_data<websocketpp::connection_hdl> const &other_user_data) noexcept {
+                                               return other_user_data.user_id == user_data->user_id && other_user_data.connection_id != user_data->connection_id;
+                                           });
+
+            if (same_user_id_it == end(user_connections)) {
+                user_left_game_response join_msg(user_data->username);
+                auto join_msg_str = join_msg.serialize();
+                for (auto &other_user_data : user_connections) {
+                    if (other_user_data.user_id != user_data->user_id) {
+                        s->send(other_user_data.ws, join_msg_str, websocketpp::frame::opcode::value::TEXT);
                     }
                 }
             }
-            spdlog::trace("[{}] conn {} close connection {}", __FUNCTION__, user_data->second.connection_id, user_data->second.user_id);
-            user_connections.erase(id_map_it->second);
-            handle_to_connection_id_map.erase(hdl);
         }
+        SPDLOG_TRACE("[{}] conn {} close connection {}", __FUNCTION__, user_data->connection_id, user_data->user_id);
+        user_connections.remove(connection_id);
     }
 
     void on_fail(server *s, websocketpp::connection_hdl hdl) {
         server::connection_ptr con = s->get_con_from_hdl(hdl);
-        auto id_map = handle_to_connection_id_map.find(hdl);
-        if (id_map == cend(handle_to_connection_id_map)) {
+        auto *user_data = user_connections.find(con->connection_id);
+        if (user_data == nullptr) {
             spdlog::error("[{}] fail connection {} {}", __FUNCTION__, con->get_ec().value(), con->get_ec().message());
             return;
         }
 
-
-        auto user_data = user_connections.find(id_map->second);
-        if (user_data == cend(user_connections)) {
-            spdlog::error("[{}] fail connection {} {}", __FUNCTION__, con->get_ec().value(), con->get_ec().message());
-            return;
-        }
-
-        spdlog::error("[{}] fail connection {} {} {}", __FUNCTION__, con->get_ec().value(), con->get_ec().message(), user_data->second.user_id);
+        spdlog::error("[{}] fail connection {} {} {}", __FUNCTION__, con->get_ec().value(), con->get_ec().message(), user_data->user_id);
     }
 
-    void add_routes(message_router_type &message_router) {
-        // UAC
-        message_router.emplace(login_request::type, handle_login<server, websocketpp::connection_hdl>);
-        message_router.emplace(register_request::type, handle_register<server, websocketpp::connection_hdl>);
-        message_router.emplace(play_character_request::type, handle_play_character<server, websocketpp::connection_hdl>);
-        message_router.emplace(create_character_request::type, handle_create_character<server, websocketpp::connection_hdl>);
-        message_router.emplace(delete_character_request::type, handle_delete_character<server, websocketpp::connection_hdl>);
-        message_router.emplace(character_select_request::type, handle_character_select<server, websocketpp::connection_hdl>);
-
-        // messaging
-        message_router.emplace(message_request::type, handle_public_chat<server, websocketpp::connection_hdl>);
-
-        // admin/moderator
-        message_router.emplace(set_motd_request::type, handle_set_motd<server, websocketpp::connection_hdl>);
-
-        // companies
-        message_router.emplace(accept_application_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, accept_application_request>);
-        message_router.emplace(create_company_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, create_company_request>);
-        message_router.emplace(get_company_applications_request::type, handle_get_company_applications<server, websocketpp::connection_hdl>);
-        message_router.emplace(get_company_listing_request::type, handle_get_company_listing<server, websocketpp::connection_hdl>);
-        message_router.emplace(increase_bonus_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, increase_bonus_request>);
-        message_router.emplace(join_company_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, join_company_request>);
-        message_router.emplace(leave_company_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, leave_company_request>);
-        message_router.emplace(reject_application_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, reject_application_request>);
-        message_router.emplace(set_tax_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, set_tax_request>);
-
-        // resources
-        message_router.emplace(set_action_request::type, playing_passthrough_handler<server, websocketpp::connection_hdl, set_action_request>);
+    void add_request_handler_labels() {
+        add_message_labels<login_request, register_request, play_character_request, create_character_request, delete_character_request, character_select_request,
+                           message_request, set_motd_request, accept_application_request, create_company_request, get_company_applications_request,
+                           get_company_listing_request, increase_bonus_request, join_company_request, leave_company_request, reject_application_request,
+                           set_tax_request, set_action_request>(metrics.request_handler_us);
     }
 
     thread run_websocket(config const &config, shared_ptr<database_pool> pool, server_handle &s_handle, atomic<bool> &quit) {
@@ -292,11 +258,8 @@ namespace ibh {
             server roa_server;
             s_handle.s = &roa_server;
 
-            message_router_type message_router;
-            add_routes(message_router);
-
             try {
-                queue_abstraction<unique_ptr<queue_message>> game_loop_queue_abstraction(&game_loop_queue);
+                queue_abstraction<queue_message> game_loop_queue_abstraction(&game_loop_queue);
                 // Set logging settings
                 //roa_server.set_access_channels(websocketpp::log::alevel::none);
                 roa_server.clear_access_channels(websocketpp::log::alevel::all);
@@ -306,15 +269,17 @@ namespace ibh {
                 roa_server.set_reuse_addr(true);
 
                 // Register our message handler
-                roa_server.set_message_handler(bind(&on_message, pool, message_router, &game_loop_queue_abstraction, &roa_server, ::_1, ::_2));
+                roa_server.set_message_handler(bind(&on_message, pool, &game_loop_queue_abstraction, &roa_server, ::_1, ::_2));
 
                 roa_server.set_fail_handler(bind(&on_fail, &roa_server, ::_1));
-                roa_server.set_open_handler(bind(&on_open, cref(quit), ::_1));
+                roa_server.set_open_handler(bind(&on_open, &roa_server, cref(quit), ::_1));
                 roa_server.set_close_handler(bind(&on_close, &roa_server, ::_1));
                 roa_server.set_tls_init_handler(bind(&on_tls_init, config, ::_1));
                 roa_server.set_pong_timeout(2500);
                 roa_server.set_open_handshake_timeout(2500);
                 roa_server.set_close_handshake_timeout(2500);
+                compression_threshold.store(config.compression_threshold, memory_order_relaxed);
+                compression_shared_context.store(config.compression_shared_context, memory_order_relaxed);
 
 
                 roa_server.listen(config.port);
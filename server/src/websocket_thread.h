@@ -18,14 +18,13 @@
 
 #pragma once
 
-#include <shared_mutex>
 #include <config.h>
 #include <database/database_pool.h>
 #include <ibh_containers.h>
 #include <concurrentqueue.h>
 
 #include <game_queue_messages/messages.h>
-#include "per_socket_data.h"
+#include "connection_registry.h"
 
 namespace ibh {
     struct server_handle {
@@ -34,13 +33,12 @@ namespace ibh {
 
     struct character_select_response;
 
-    extern ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> user_connections;
-    extern moodycamel::ConcurrentQueue<unique_ptr<queue_message>> game_loop_queue;
+    extern connection_registry<websocketpp::connection_hdl> user_connections;
+    extern moodycamel::ConcurrentQueue<queue_message> game_loop_queue;
     extern string motd;
     extern character_select_response select_response;
-    extern shared_mutex user_connections_mutex;
-
-    using user_connections_type = ibh_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>>::value_type;
 
+    // labels metrics.request_handler_us, has to run before the metrics endpoint starts reading it
+    void add_request_handler_labels();
     thread run_websocket(config const &config, shared_ptr<database_pool> pool, server_handle &s_handle, atomic<bool> &quit);
 }
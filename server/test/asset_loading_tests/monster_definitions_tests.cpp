@@ -0,0 +1,74 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <ecs/components.h>
+#include "asset_loading/monster_definitions.h"
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("monster definitions loading tests") {
+    atomic<bool> quit{false};
+    auto directory = filesystem::temp_directory_path() / "ibh_monster_definitions_test";
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory / "monsters" / "nested");
+    filesystem::create_directories(directory / "specials");
+    auto monsters_directory = (directory / "monsters").string();
+    auto specials_directory = (directory / "specials").string();
+
+    ofstream(directory / "monsters" / "b.json") << R"({"name": "Beta", "stats": {"str": 20}})";
+    ofstream(directory / "monsters" / "nested" / "a.json") << R"({"name": "Alpha", "stats": {"str": 10, "agi": 5}})";
+    ofstream(directory / "monsters" / "broken.json") << R"({"stats": {}})";
+    ofstream(directory / "specials" / "a.json") << R"({"name": "Shiny", "teleport_when_beat": true, "stats": {"str": 150}})";
+
+    SECTION("all valid files are loaded, in path order") {
+        auto table = load_monster_definitions(monsters_directory, specials_directory, quit);
+        REQUIRE(table->monsters.size() == 2);
+        REQUIRE(table->monsters[0].name == "Beta");
+        REQUIRE(table->monsters[1].name == "Alpha");
+        REQUIRE(table->monsters[1].stats.size() == 2);
+        REQUIRE(table->specials.size() == 1);
+        REQUIRE(table->specials[0].teleport_when_beat);
+    }
+
+    SECTION("watcher publishes a new table after a change") {
+        monster_definitions_watcher watcher(monsters_directory, specials_directory);
+        REQUIRE(watcher.take_reloaded() == nullptr);
+
+        // give the watcher thread time to set up its watches
+        this_thread::sleep_for(chrono::milliseconds(100));
+        ofstream(directory / "monsters" / "c.json") << R"({"name": "Gamma", "stats": {"str": 30}})";
+
+        shared_ptr<monster_definition_table const> table;
+        for(int i = 0; i < 100 && !table; i++) {
+            this_thread::sleep_for(chrono::milliseconds(50));
+            table = watcher.take_reloaded();
+        }
+        REQUIRE(table != nullptr);
+        REQUIRE(table->monsters.size() == 3);
+        REQUIRE(watcher.take_reloaded() == nullptr);
+    }
+
+    filesystem::remove_all(directory);
+}
@@ -0,0 +1,74 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include "game_logic/ban_list.h"
+#include <repositories/models.h>
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("ban list tests") {
+    auto now = chrono::system_clock::now();
+    db_user usr{1, "User", "pass", "email", 0, "code", 0, 0};
+
+    SECTION( "empty list bans nobody" ) {
+        ban_list list{};
+        REQUIRE(list.size() == 0);
+        REQUIRE(!list.is_banned("user", "ip", now));
+    }
+
+    SECTION( "bans by username case insensitively and by ip" ) {
+        ban_list list{};
+        list.load({db_banned_user{1, "", usr, now + 10s}, db_banned_user{2, "1.2.3.4", {}, now + 10s}});
+
+        REQUIRE(list.size() == 2);
+        REQUIRE(list.is_banned("user", {}, now));
+        REQUIRE(list.is_banned("USER", {}, now));
+        REQUIRE(list.is_banned({}, "1.2.3.4", now));
+        REQUIRE(list.is_banned("someone_else", "1.2.3.4", now));
+        REQUIRE(!list.is_banned("someone_else", "1.2.3.5", now));
+        REQUIRE(!list.is_banned({}, {}, now));
+    }
+
+    SECTION( "expired bans don't match" ) {
+        ban_list list{};
+        list.load({db_banned_user{1, "ip", usr, now + 10s}, db_banned_user{2, "", {}, {}}});
+
+        REQUIRE(list.is_banned("user", "ip", now + 10s));
+        REQUIRE(!list.is_banned("user", {}, now + 11s));
+        REQUIRE(!list.is_banned({}, "ip", now + 11s));
+    }
+
+    SECTION( "latest ban wins and reload replaces" ) {
+        ban_list list{};
+        list.load({db_banned_user{1, "", usr, now + 100s}});
+        list.add(db_banned_user{2, "", usr, now + 10s});
+        REQUIRE(list.is_banned("user", {}, now + 50s));
+
+        list.load({});
+        REQUIRE(list.size() == 0);
+        REQUIRE(!list.is_banned("user", {}, now));
+
+        list.add(db_banned_user{3, "", usr, now + 10s});
+        REQUIRE(list.is_banned("user", {}, now));
+        list.clear();
+        REQUIRE(!list.is_banned("user", {}, now));
+    }
+}
@@ -0,0 +1,132 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <optional>
+#include <rapidjson/document.h>
+#include <spdlog/spdlog.h>
+#include "game_logic/company_listing.h"
+#include <repositories/models.h>
+#include <messages/company/get_company_listing_response.h>
+
+using namespace std;
+using namespace ibh;
+
+unique_ptr<get_company_listing_response> parse_page(shared_ptr<string const> const &page) {
+    rapidjson::Document d;
+    d.Parse(page->c_str(), page->size());
+    return get_company_listing_response::deserialize(d);
+}
+
+TEST_CASE("company listing tests") {
+    SECTION( "loads companies with members and bonuses" ) {
+        company_listing listing{};
+        vector<db_company_listing> companies;
+        companies.emplace_back(db_company{1, "Beta", 0, 2}, vector<uint64_t>{10, 11}, vector<string>{"m1", "m2"}, vector<db_company_stat>{db_company_stat{0, 1, 2, 20}});
+        companies.emplace_back(db_company{2, "alpha", 0, 2}, vector<uint64_t>{}, vector<string>{}, vector<db_company_stat>{});
+        listing.load(companies);
+
+        REQUIRE(listing.size() == 2);
+        auto page = parse_page(listing.get_page(0, ""));
+        REQUIRE(page);
+        REQUIRE(page->page == 0);
+        REQUIRE(page->page_count == 1);
+        REQUIRE(page->version == listing.version());
+        REQUIRE(page->companies.size() == 2);
+        REQUIRE(page->companies[0].name == "alpha");
+        REQUIRE(page->companies[1].name == "Beta");
+        REQUIRE(page->companies[1].members.size() == 2);
+        REQUIRE(page->companies[1].members[0] == "m1");
+        REQUIRE(page->companies[1].bonuses.size() == 1);
+        REQUIRE(page->companies[1].bonuses[0].stat_id == 2);
+        REQUIRE(page->companies[1].bonuses[0].value == 20);
+    }
+
+    SECTION( "paginates" ) {
+        company_listing listing{};
+        for(uint64_t i = 0; i < company_listing::page_size + 1; i++) {
+            listing.add_company(i, fmt::format("company {:03}", i), {});
+        }
+
+        auto first = parse_page(listing.get_page(0, ""));
+        REQUIRE(first->page_count == 2);
+        REQUIRE(first->companies.size() == company_listing::page_size);
+        REQUIRE(first->companies[0].name == "company 000");
+
+        auto second = parse_page(listing.get_page(1, ""));
+        REQUIRE(second->page == 1);
+        REQUIRE(second->companies.size() == 1);
+        REQUIRE(second->companies[0].name == fmt::format("company {:03}", company_listing::page_size));
+
+        auto past_end = parse_page(listing.get_page(5, ""));
+        REQUIRE(past_end->page_count == 2);
+        REQUIRE(past_end->companies.empty());
+    }
+
+    SECTION( "searches by case insensitive prefix" ) {
+        company_listing listing{};
+        listing.add_company(1, "Hunters", {});
+        listing.add_company(2, "hunting party", {});
+        listing.add_company(3, "Hunt", {});
+        listing.add_company(4, "Gatherers", {});
+
+        auto page = parse_page(listing.get_page(0, "HUNT"));
+        REQUIRE(page->page_count == 1);
+        REQUIRE(page->companies.size() == 3);
+        REQUIRE(page->companies[0].name == "Hunt");
+        REQUIRE(page->companies[1].name == "Hunters");
+        REQUIRE(page->companies[2].name == "hunting party");
+
+        auto none = parse_page(listing.get_page(0, "z"));
+        REQUIRE(none->page_count == 0);
+        REQUIRE(none->companies.empty());
+    }
+
+    SECTION( "changes invalidate cached pages" ) {
+        company_listing listing{};
+        listing.add_company(1, "company", {stat_component{2, 5}});
+        auto version = listing.version();
+        auto cached = listing.get_page(0, "");
+        REQUIRE(listing.get_page(0, "") == cached);
+
+        listing.add_member(1, 10, "member");
+        REQUIRE(listing.version() > version);
+        auto page = listing.get_page(0, "");
+        REQUIRE(page != cached);
+        REQUIRE(parse_page(page)->companies[0].members.size() == 1);
+
+        listing.set_bonus(1, 2, 6);
+        listing.set_bonus(1, 3, 1);
+        auto bonuses = parse_page(listing.get_page(0, ""))->companies[0].bonuses;
+        REQUIRE(bonuses.size() == 2);
+        REQUIRE(bonuses[0].value == 6);
+        REQUIRE(bonuses[1].stat_id == 3);
+
+        listing.remove_member(1, 10);
+        REQUIRE(parse_page(listing.get_page(0, ""))->companies[0].members.empty());
+    }
+
+    SECTION( "ignores unknown companies" ) {
+        company_listing listing{};
+        listing.add_member(1, 10, "member");
+        listing.set_bonus(1, 2, 6);
+        listing.remove_member(1, 10);
+        REQUIRE(listing.size() == 0);
+    }
+}
@@ -0,0 +1,84 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <connection_registry.h>
+#include "custom_server.h"
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("connection registry tests") {
+    SECTION( "add, find and remove" ) {
+        connection_registry<custom_hdl> registry;
+        custom_hdl hdl{};
+        hdl = 5;
+
+        auto *user_data = registry.add(hdl);
+        REQUIRE(user_data != nullptr);
+        REQUIRE(user_data->connection_id != 0);
+        REQUIRE(user_data->playing_character_slot == -1);
+        REQUIRE(user_data->ws._id == 5);
+        REQUIRE(registry.size() == 1);
+        REQUIRE(registry.find(user_data->connection_id) == user_data);
+
+        auto connection_id = user_data->connection_id;
+        REQUIRE(registry.remove(connection_id));
+        REQUIRE(!registry.remove(connection_id));
+        REQUIRE(registry.find(connection_id) == nullptr);
+        REQUIRE(registry.empty());
+    }
+
+    SECTION( "iterates only live connections" ) {
+        connection_registry<custom_hdl> registry;
+        vector<uint64_t> connection_ids;
+        for(uint64_t i = 0; i < 2'000; i++) {
+            custom_hdl hdl{};
+            hdl = i;
+            connection_ids.push_back(registry.add(hdl)->connection_id);
+        }
+
+        for(uint64_t i = 0; i < 2'000; i += 2) {
+            REQUIRE(registry.remove(connection_ids[i]));
+        }
+
+        uint64_t count = 0;
+        for(auto &user_data : registry) {
+            REQUIRE(user_data.ws._id % 2 == 1);
+            count++;
+        }
+        REQUIRE(count == 1'000);
+        REQUIRE(registry.size() == 1'000);
+    }
+
+    SECTION( "slots are only reused after a quiescent state" ) {
+        connection_registry<custom_hdl> registry;
+        auto *first = registry.add(custom_hdl{});
+        auto first_id = first->connection_id;
+        REQUIRE(registry.remove(first_id));
+
+        auto *second = registry.add(custom_hdl{});
+        REQUIRE(second != first);
+
+        registry.quiescent_state();
+        auto *third = registry.add(custom_hdl{});
+        REQUIRE(third == first);
+        REQUIRE(third->connection_id != first_id);
+        REQUIRE(registry.find(first_id) == nullptr);
+    }
+}
@@ -46,7 +46,12 @@ namespace ibh {
             close_message = message;
         }
 
+        [[nodiscard]] size_t get_buffered_amount([[maybe_unused]] custom_hdl handle) const noexcept {
+            return buffered_amount;
+        }
+
         string sent_message;
         string close_message;
+        size_t buffered_amount{};
     };
 }
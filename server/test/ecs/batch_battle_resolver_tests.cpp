@@ -0,0 +1,143 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <ecs/batch_battle_resolver.h>
+
+using namespace std;
+using namespace ibh;
+battle_turn_result resolve_battle_turns(pc_component &pc, battle_component &bc);
+
+battle_component create_battle(int64_t player_spd, int64_t mob_spd, int64_t hp, int64_t player_str = 100, int64_t mob_str = 100) {
+    battle_component bc{};
+    bc.monster_name = "mob";
+    bc.total_player_stats.emplace(stat_str_id, player_str);
+    bc.total_player_stats.emplace(stat_agi_id, 100);
+    bc.total_player_stats.emplace(stat_hp_id, hp);
+    bc.total_player_stats.emplace(stat_spd_id, player_spd);
+    bc.monster_stats.emplace(stat_str_id, mob_str);
+    bc.monster_stats.emplace(stat_agi_id, 100);
+    bc.monster_stats.emplace(stat_hp_id, hp);
+    bc.monster_stats.emplace(stat_spd_id, mob_spd);
+    return bc;
+}
+
+TEST_CASE("batch battle resolver tests") {
+    batch_battle_resolver resolver;
+    pc_component pc{};
+
+    SECTION("rejects battles it can't represent") {
+        auto no_speed = create_battle(0, 10, 1'000);
+        auto missing_stat = create_battle(10, 10, 1'000);
+        missing_stat.monster_stats.erase(stat_agi_id);
+        auto too_many_turns = create_battle((batch_battle_resolver::max_batched_turns + 2) * 10, 10, 1'000);
+        auto too_large = create_battle(10, 10, int64_t{1} << 60);
+        auto too_strong = create_battle(10, 10, 1'000, int64_t{1} << 40);
+
+        REQUIRE(!resolver.add(no_speed));
+        REQUIRE(!resolver.add(missing_stat));
+        REQUIRE(!resolver.add(too_many_turns));
+        REQUIRE(!resolver.add(too_large));
+        REQUIRE(!resolver.add(too_strong));
+        REQUIRE(resolver.size() == 0);
+    }
+
+    SECTION("turn counts match the scalar resolver") {
+        vector<pair<int64_t, int64_t>> speeds{{10, 10}, {11, 10}, {30, 10}, {31, 10}, {10, 11}, {10, 95}, {1, 33}, {7, 3}};
+        vector<battle_component> batched;
+        vector<battle_component> scalar;
+        for(auto [player_spd, mob_spd] : speeds) {
+            batched.push_back(create_battle(player_spd, mob_spd, 1'000'000'000));
+            scalar.push_back(create_battle(player_spd, mob_spd, 1'000'000'000));
+        }
+        for(auto &bc : batched) {
+            REQUIRE(resolver.add(bc));
+        }
+
+        auto const &results = resolver.resolve();
+        REQUIRE(results.size() == speeds.size());
+        for(size_t i = 0; i < speeds.size(); i++) {
+            auto expected = resolve_battle_turns(pc, scalar[i]);
+            REQUIRE(results[i].player_turns == expected.player_turns);
+            REQUIRE(results[i].mob_turns == expected.mob_turns);
+            REQUIRE(!results[i].mob_dead);
+            REQUIRE(!results[i].plyr_dead);
+            REQUIRE(batched[i].total_player_stats[stat_hp_id] == 1'000'000'000 - static_cast<int64_t>(results[i].mob_dmg_to_player));
+            REQUIRE(batched[i].monster_stats[stat_hp_id] == 1'000'000'000 - static_cast<int64_t>(results[i].player_dmg_to_mob));
+        }
+    }
+
+    SECTION("dead sides stop attacking") {
+        auto bc = create_battle(50, 10, 1'000, 1'000'000, 0);
+        bc.monster_stats[stat_agi_id] = 0;
+        bc.monster_stats[stat_hp_id] = 1;
+        REQUIRE(resolver.add(bc));
+
+        auto const &results = resolver.resolve();
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].mob_dead);
+        REQUIRE(!results[0].plyr_dead);
+        REQUIRE(results[0].player_turns == 1);
+        REQUIRE(results[0].mob_turns == 0);
+        REQUIRE(bc.monster_stats[stat_hp_id] <= 0);
+    }
+
+    SECTION("damage and hit rate match the scalar resolver") {
+        const size_t battle_count = 100'000;
+        vector<battle_component> batched;
+        batched.reserve(battle_count);
+        uint64_t scalar_turns = 0;
+        uint64_t scalar_hits = 0;
+        uint64_t scalar_dmg = 0;
+        for(size_t i = 0; i < battle_count; i++) {
+            batched.push_back(create_battle(20, 10, 1'000'000'000, 100, 80));
+            auto bc = create_battle(20, 10, 1'000'000'000, 100, 80);
+            auto result = resolve_battle_turns(pc, bc);
+            scalar_turns += result.player_turns + result.mob_turns;
+            scalar_hits += result.player_hits + result.mob_hits;
+            scalar_dmg += result.player_dmg_to_mob + result.mob_dmg_to_player;
+        }
+        size_t added = 0;
+        for(auto &bc : batched) {
+            added += resolver.add(bc) ? 1 : 0;
+        }
+        REQUIRE(added == battle_count);
+
+        uint64_t batched_turns = 0;
+        uint64_t batched_hits = 0;
+        uint64_t batched_dmg = 0;
+        for(auto const &result : resolver.resolve()) {
+            batched_turns += result.player_turns + result.mob_turns;
+            batched_hits += result.player_hits + result.mob_hits;
+            batched_dmg += result.player_dmg_to_mob + result.mob_dmg_to_player;
+        }
+
+        REQUIRE(batched_turns == scalar_turns);
+        REQUIRE(static_cast<double>(batched_hits) / batched_turns == Approx(static_cast<double>(scalar_hits) / scalar_turns).epsilon(0.02));
+        REQUIRE(static_cast<double>(batched_dmg) / batched_hits == Approx(static_cast<double>(scalar_dmg) / scalar_hits).epsilon(0.02));
+    }
+
+    SECTION("clear removes all battles") {
+        auto bc = create_battle(10, 10, 1'000);
+        REQUIRE(resolver.add(bc));
+        resolver.clear();
+        REQUIRE(resolver.size() == 0);
+        REQUIRE(resolver.resolve().empty());
+    }
+}
@@ -17,6 +17,7 @@
 */
 
 #include <catch2/catch.hpp>
+#include <numeric>
 #include <ecs/battle_system.h>
 #include <game_queue_messages/messages.h>
 
@@ -24,7 +25,7 @@ using namespace std;
 using namespace ibh;
 int64_t battle_turn(pc_component &pc, ibh_flat_map<uint32_t, int64_t> &attacker, ibh_flat_map<uint32_t, int64_t> &defender, bool &attacker_dead, bool &defender_dead, string const &attacker_name, string const &defender_name);
 void set_hp_mp(pc_component &pc, ibh_flat_map<uint32_t, int64_t> &stats);
-void simulate_battle(pc_component &pc, entt::registry &es, ibh::outward_queues *outward_queue);
+ibh_flat_map<uint32_t, int64_t> const & get_total_stats(pc_component &pc);
 
 TEST_CASE("set hp/mp test") {
     pc_component pc{};
@@ -72,4 +73,82 @@ TEST_CASE("battle_turn dmg test") {
             REQUIRE(defender_dead == false);
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("total stats are cached until invalidated") {
+    pc_component pc{};
+    pc.stats.emplace(stat_str_id, 10);
+    pc.stats.emplace(stat_vit_id, 10);
+    pc.stats.emplace(stat_hp_id, 0);
+    pc.stats.emplace(stat_mp_id, 0);
+    pc.stats.emplace(stat_xp_id, 50);
+    pc.equipped_items.emplace(gear_slot_armor_id, item_component{"armor", "", "armor", 0, 0, 0, 0, 0, false, false, {stat_component{stat_str_id, 5}}});
+
+    auto &total_stats = get_total_stats(pc);
+    REQUIRE(total_stats.find(stat_str_id)->second == 15);
+    REQUIRE(total_stats.find(stat_hp_id)->second == 170);
+    REQUIRE(total_stats.find(stat_xp_id) == end(total_stats));
+    REQUIRE(pc.stats.find(stat_str_id)->second == 10);
+
+    pc.stats.find(stat_str_id)->second = 20;
+    REQUIRE(get_total_stats(pc).find(stat_str_id)->second == 15);
+
+    invalidate_total_stats(pc);
+    REQUIRE(get_total_stats(pc).find(stat_str_id)->second == 25);
+}
+
+TEST_CASE("battle_system runs every entity once per cycle") {
+    auto definitions = make_shared<monster_definition_table>();
+    ibh_flat_map<uint32_t, int64_t> mob_stats;
+    for(auto &stat : stat_name_ids) {
+        mob_stats.emplace(stat, 10);
+    }
+    definitions->monsters.emplace_back("mob", mob_stats);
+    definitions->specials.emplace_back("special", mob_stats, false);
+
+    for(auto engine : {battle_engine::scalar, battle_engine::batched}) {
+        moodycamel::ConcurrentQueue<outward_message> cq;
+        entt::registry es;
+        es.group<battle_component>(entt::get<pc_component>);
+
+        for(uint64_t i = 0; i < 6; i++) {
+            auto entt = es.create();
+            ibh_flat_map<uint32_t, int64_t> stats;
+            for(auto &stat : stat_name_ids) {
+                stats.emplace(stat, 10);
+            }
+            es.emplace<pc_component>(entt, i, i + 1, "pc"s + to_string(i), "race", "dir", "class", "spawn", 5, 0, stats, ibh_flat_map<uint32_t, item_component>{}, vector<item_component>{}, ibh_flat_map<string, skill_component>{});
+            es.emplace<battle_component>(entt);
+        }
+
+        // every simulated battle ends in exactly one update or finished message for its connection
+        auto take_runs = [&cq]() {
+            vector<uint64_t> runs(6);
+            outward_message msg;
+            while(cq.try_dequeue(msg)) {
+                if(holds_alternative<battle_update_response>(msg.msg) || holds_alternative<battle_finished_response>(msg.msg)) {
+                    runs[msg.conn_id - 1]++;
+                }
+            }
+            return runs;
+        };
+
+        battle_system bs{3, &cq, engine};
+        bs.set_definitions(definitions);
+
+        // the stretch changes mid-cycle, the current cycle still finishes with 3 buckets
+        bs.do_tick(es);
+        bs.set_stretch(2);
+        bs.do_tick(es);
+        bs.do_tick(es);
+        REQUIRE(take_runs() == vector<uint64_t>(6, 1));
+
+        // 6 buckets from here on, one entity per tick
+        for(uint32_t i = 0; i < 6; i++) {
+            bs.do_tick(es);
+            auto runs = take_runs();
+            REQUIRE(accumulate(begin(runs), end(runs), 0UL) == 1);
+            REQUIRE(runs[i] == 1);
+        }
+    }
+}
@@ -50,4 +50,69 @@ TEST_CASE("simulate_resource test") {
 
     auto resource_level = pc.stats.find(resource_wood_id + 600u);
     REQUIRE(resource_level->second == 2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("resource_system spreads entities over phase buckets") {
+    moodycamel::ConcurrentQueue<outward_message> cq;
+    entt::registry es;
+    es.group<wood_gathering_component>(entt::get<pc_component>);
+
+    for(uint64_t i = 0; i < 6; i++) {
+        auto entt = es.create();
+        es.emplace<pc_component>(entt, i, i, "pc"s + to_string(i), "race", "dir", "class", "spawn", 1, 0, ibh_flat_map<uint32_t, int64_t>{}, ibh_flat_map<uint32_t, item_component>{}, vector<item_component>{}, ibh_flat_map<string, skill_component>{});
+        es.emplace<wood_gathering_component>(entt);
+    }
+
+    auto pc_view = es.view<pc_component>();
+    auto wood_gathered = [&pc_view]() {
+        uint64_t gathered = 0;
+        for(auto entity : pc_view) {
+            auto &pc = pc_view.get(entity);
+            auto resource = pc.stats.find(resource_wood_id);
+            gathered += resource == end(pc.stats) ? 0 : resource->second;
+        }
+        return gathered;
+    };
+
+    resource_system rs{3, &cq};
+    rs.do_tick(es);
+    REQUIRE(wood_gathered() == 2);
+    rs.do_tick(es);
+    rs.do_tick(es);
+    REQUIRE(wood_gathered() == 6);
+
+    for(auto entity : pc_view) {
+        REQUIRE(pc_view.get(entity).stats.find(resource_wood_id)->second == 1);
+    }
+}
+
+TEST_CASE("resource_system applies a new stretch when the cycle wraps") {
+    moodycamel::ConcurrentQueue<outward_message> cq;
+    entt::registry es;
+    es.group<wood_gathering_component>(entt::get<pc_component>);
+
+    for(uint64_t i = 0; i < 6; i++) {
+        auto entt = es.create();
+        es.emplace<pc_component>(entt, i, i, "pc"s + to_string(i), "race", "dir", "class", "spawn", 1, 0, ibh_flat_map<uint32_t, int64_t>{}, ibh_flat_map<uint32_t, item_component>{}, vector<item_component>{}, ibh_flat_map<string, skill_component>{});
+        es.emplace<wood_gathering_component>(entt);
+    }
+
+    auto pc_view = es.view<pc_component>();
+    auto require_gathered = [&pc_view](int64_t expected) {
+        for(auto entity : pc_view) {
+            REQUIRE(pc_view.get(entity).stats.find(resource_wood_id)->second == expected);
+        }
+    };
+
+    resource_system rs{3, &cq};
+    rs.do_tick(es);
+    rs.set_stretch(2);
+    rs.do_tick(es);
+    rs.do_tick(es);
+    require_gathered(1);
+
+    for(uint32_t i = 0; i < 6; i++) {
+        rs.do_tick(es);
+    }
+    require_gathered(2);
+}
@@ -24,6 +24,8 @@
 #include <repositories/characters_repository.h>
 #include <repositories/users_repository.h>
 #include <messages/company/create_company_response.h>
+#include <game_logic/company_listing.h>
+#include <game_queue_message_handlers/game_state_changes.h>
 #include "../game_queue_helpers.h"
 
 using namespace std;
@@ -70,6 +72,45 @@ TEST_CASE("create company handler tests") {
         REQUIRE(current_companies.size() == existing_companies.size() + 1);
     }
 
+    SECTION( "listing waits for the commit and undo refunds the gold" ) {
+        entt::registry registry;
+        auto &changes = registry.set<game_state_changes>();
+        moodycamel::ConcurrentQueue<outward_message> cq;
+        outward_queues q(&cq);
+        create_company_message msg(1, "company_name_undone", 2);
+        characters_repository<database_transaction> char_repo{};
+        users_repository<database_transaction> user_repo{};
+        auto transaction = db_pool->create_transaction();
+
+        db_user user{};
+        user_repo.insert_if_not_exists(user, transaction);
+        REQUIRE(user.id > 0);
+        db_character player{0, user.id, 0, 0, 0, 0, 0, 0, 0, "", "", "", "", vector<db_character_stat> {}, vector<db_item> {}};
+        char_repo.insert(player, transaction);
+        REQUIRE(player.id > 0);
+
+        auto entt = registry.create();
+        {
+            pc_component pc{};
+            pc.id = player.id;
+            pc.connection_id = 1;
+            pc.stats.emplace(stat_gold_id, 10'001);
+            registry.emplace<pc_component>(entt, move(pc));
+        }
+
+        auto listing_version = company_list.version();
+        auto ret = handle_create_company(&msg, registry, q, transaction);
+        REQUIRE(ret == true);
+        REQUIRE(registry.has<company_component>(entt));
+        REQUIRE(company_list.version() == listing_version);
+        REQUIRE(changes.commit_steps.size() == 1);
+
+        changes.undo(registry);
+        REQUIRE(!registry.has<company_component>(entt));
+        REQUIRE(registry.get<pc_component>(entt).stats[stat_gold_id] == 10'001);
+        REQUIRE(company_list.version() == listing_version);
+    }
+
     SECTION( "not enough gold" ) {
         entt::registry registry;
         moodycamel::ConcurrentQueue<outward_message> cq;
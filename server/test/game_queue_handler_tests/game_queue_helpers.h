@@ -22,10 +22,9 @@
 namespace ibh {
     template <class T>
     void test_outmsg(outward_queues &q, bool should_be_empty) {
-        outward_message outmsg(0, nullptr);
+        outward_message outmsg{};
         REQUIRE(q.try_dequeue_from_producer(outmsg) == true);
-        REQUIRE(outmsg.msg);
-        auto *outmsgptr = dynamic_cast<T*>(outmsg.msg.get());
+        auto *outmsgptr = get_if<T>(&outmsg.msg);
         REQUIRE(outmsgptr != nullptr);
         REQUIRE(outmsgptr->error.empty() == should_be_empty);
     }
@@ -0,0 +1,147 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include "test_helpers/startup_helper.h"
+#include <group_commit.h>
+#include <messages/generic_error_response.h>
+#include <messages/company/set_tax_response.h>
+#include <ecs/components.h>
+#include <repositories/companies_repository.h>
+#include <repositories/company_stats_repository.h>
+#include <magic_enum.hpp>
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("group commit tests") {
+    SECTION( "parses commit modes" ) {
+        REQUIRE(parse_game_queue_commit_mode("per_message") == game_queue_commit_mode::per_message);
+        REQUIRE(parse_game_queue_commit_mode("group") == game_queue_commit_mode::group);
+        REQUIRE(!parse_game_queue_commit_mode("batched"));
+    }
+
+    SECTION( "releases responses after commit" ) {
+        moodycamel::ConcurrentQueue<outward_message> cq;
+        auto commits_before = commit_stats.commits.load();
+        auto messages_before = commit_stats.committed_messages.load();
+        {
+            group_committer committer{&cq};
+            vector<outward_message> responses;
+            responses.emplace_back(outward_message{1, set_tax_response("")});
+            responses.emplace_back(outward_message{2, set_tax_response("")});
+            committer.commit_async(db_pool->create_transaction(), move(responses), 2, {});
+            committer.wait_idle();
+        }
+
+        REQUIRE(commit_stats.commits.load() == commits_before + 1);
+        REQUIRE(commit_stats.committed_messages.load() == messages_before + 2);
+        outward_message msg{};
+        REQUIRE(cq.try_dequeue(msg));
+        REQUIRE(msg.conn_id == 1);
+        REQUIRE(holds_alternative<set_tax_response>(msg.msg));
+        REQUIRE(cq.try_dequeue(msg));
+        REQUIRE(msg.conn_id == 2);
+        REQUIRE(!cq.try_dequeue(msg));
+    }
+
+    SECTION( "failed commit sends one error per connection" ) {
+        moodycamel::ConcurrentQueue<outward_message> cq;
+        auto failed_before = commit_stats.failed_commits.load();
+        {
+            group_committer committer{&cq};
+            auto transaction = db_pool->create_transaction();
+            REQUIRE_THROWS(transaction->execute("SELECT * FROM table_that_does_not_exist"));
+            vector<outward_message> responses;
+            responses.emplace_back(outward_message{1, set_tax_response("")});
+            responses.emplace_back(outward_message{1, set_tax_response("")});
+            committer.commit_async(move(transaction), move(responses), 2, {});
+        }
+
+        REQUIRE(commit_stats.failed_commits.load() == failed_before + 1);
+        outward_message msg{};
+        REQUIRE(cq.try_dequeue(msg));
+        REQUIRE(msg.conn_id == 1);
+        REQUIRE(holds_alternative<generic_error_response>(msg.msg));
+        REQUIRE(!cq.try_dequeue(msg));
+    }
+
+    SECTION( "runs commit steps after commit" ) {
+        moodycamel::ConcurrentQueue<outward_message> cq;
+        atomic<bool> committed = false;
+        {
+            group_committer committer{&cq};
+            game_state_changes changes;
+            changes.commit_steps.emplace_back([&committed] { committed = true; });
+            changes.undo_steps.emplace_back([](entt::registry &) { FAIL("undo step ran after a successful commit"); });
+            committer.commit_async(db_pool->create_transaction(), {}, 1, move(changes));
+            committer.wait_idle();
+            REQUIRE(committer.take_rolled_back().empty());
+        }
+
+        REQUIRE(committed);
+    }
+
+    SECTION( "rolls back failed messages and undoes failed commits" ) {
+        entt::registry registry;
+        moodycamel::ConcurrentQueue<outward_message> cq;
+        moodycamel::ConcurrentQueue<outward_message> staged_cq;
+        outward_queues staged_q(&staged_cq);
+        companies_repository<database_transaction> company_repo{};
+        company_stats_repository<database_transaction> company_stats_repo{};
+        auto transaction = db_pool->create_transaction();
+
+        db_company existing_company{0, "group_commit_company", 0, 2};
+        company_repo.insert(existing_company, transaction);
+        REQUIRE(existing_company.id > 0);
+        db_company_stat existing_stat{0, existing_company.id, company_stat_tax_id, 5};
+        company_stats_repo.insert(existing_stat, transaction);
+
+        auto entt = registry.create();
+        {
+            pc_component pc{};
+            pc.id = 1;
+            pc.connection_id = 1;
+            registry.emplace<pc_component>(entt, move(pc));
+
+            company_component company{existing_company.id, magic_enum::enum_integer(company_member_level::COMPANY_ADMIN), existing_company.name, ibh_flat_map<uint32_t, int64_t>{{company_stat_tax_id, 5}}};
+            registry.emplace<company_component>(entt, move(company));
+        }
+
+        game_state_changes tick_changes;
+        queue_message set_tax = set_tax_message(1, 50);
+        queue_message unknown_connection = set_tax_message(2, 60);
+        REQUIRE(handle_grouped_game_queue_message(set_tax, registry, staged_q, transaction, tick_changes));
+        REQUIRE(!handle_grouped_game_queue_message(unknown_connection, registry, staged_q, transaction, tick_changes));
+        REQUIRE(tick_changes.undo_steps.size() == 1);
+        REQUIRE(company_stats_repo.get_by_stat(existing_company.id, company_stat_tax_id, transaction)->value == 50);
+        REQUIRE(registry.get<company_component>(entt).stats[company_stat_tax_id] == 50);
+
+        // breaks the transaction outside of any savepoint, so the commit fails
+        REQUIRE_THROWS(transaction->execute("SELECT * FROM table_that_does_not_exist"));
+        group_committer committer{&cq};
+        committer.commit_async(move(transaction), {}, 1, move(tick_changes));
+        committer.wait_idle();
+
+        auto rolled_back = committer.take_rolled_back();
+        REQUIRE(rolled_back.size() == 1);
+        rolled_back[0].undo(registry);
+        REQUIRE(registry.get<company_component>(entt).stats[company_stat_tax_id] == 5);
+    }
+}
@@ -0,0 +1,88 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <metrics/histogram.h>
+#include <metrics/metrics.h>
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("histogram tests") {
+    SECTION( "buckets are contiguous and ordered" ) {
+        for(uint32_t i = 0; i + 1 < histogram::bucket_count; i++) {
+            REQUIRE(histogram::bucket_index(histogram::bucket_upper_bound(i)) == i);
+            REQUIRE(histogram::bucket_index(histogram::bucket_upper_bound(i) + 1) == i + 1);
+        }
+        REQUIRE(histogram::bucket_index(numeric_limits<uint64_t>::max()) == histogram::bucket_count - 1);
+        REQUIRE(histogram::bucket_upper_bound(histogram::bucket_count - 1) == numeric_limits<uint64_t>::max());
+    }
+
+    SECTION( "relative error is bounded by the sub bucket count" ) {
+        for(uint64_t value : {9ul, 100ul, 1'234ul, 99'999ul, 12'345'678ul}) {
+            auto upper = histogram::bucket_upper_bound(histogram::bucket_index(value));
+            REQUIRE(upper >= value);
+            REQUIRE(upper - value <= value / histogram::sub_buckets);
+        }
+    }
+
+    SECTION( "records count, sum and percentiles" ) {
+        histogram h;
+        REQUIRE(h.value_at_percentile(50) == 0);
+
+        for(uint64_t i = 1; i <= 100; i++) {
+            h.record(i);
+        }
+        REQUIRE(h.count() == 100);
+        REQUIRE(h.sum() == 5'050);
+        REQUIRE(h.value_at_percentile(50) >= 50);
+        REQUIRE(h.value_at_percentile(50) <= 55);
+        REQUIRE(h.value_at_percentile(100) >= 100);
+        REQUIRE(h.value_at_percentile(100) <= 111);
+    }
+
+    SECTION( "families find registered keys only" ) {
+        histogram_family<2> family;
+        REQUIRE(family.add(1, "one"));
+        REQUIRE(family.add(1, "one"));
+        REQUIRE(family.add(2, "two"));
+        REQUIRE(!family.add(3, "three"));
+        REQUIRE(family.size() == 2);
+        REQUIRE(family.find(3) == nullptr);
+
+        family.find(2)->record(10);
+        REQUIRE(family.at(1).count() == 1);
+        REQUIRE(family.label(1) == "two");
+    }
+
+    SECTION( "message labels drop the namespace" ) {
+        REQUIRE(message_label("ibh::login_request") == "login_request");
+        REQUIRE(message_label("login_request") == "login_request");
+    }
+
+    SECTION( "renders prometheus text" ) {
+        // a local instance, the global one also sees the queries of whichever tests ran before
+        auto local_metrics = make_unique<server_metrics>();
+        local_metrics->phase(tick_phase::battle).record(5);
+        auto text = render_prometheus_metrics(*local_metrics);
+        REQUIRE(text.find("# TYPE ibh_tick_phase_microseconds histogram\n") != string::npos);
+        REQUIRE(text.find("ibh_tick_phase_microseconds_bucket{phase=\"battle\",le=\"7\"} 1\n") != string::npos);
+        REQUIRE(text.find("ibh_tick_phase_microseconds_bucket{phase=\"battle\",le=\"+Inf\"} 1\n") != string::npos);
+        REQUIRE(text.find("ibh_db_query_microseconds_count 0\n") != string::npos);
+    }
+}
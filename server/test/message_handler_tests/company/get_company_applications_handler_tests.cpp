@@ -37,9 +37,9 @@ TEST_CASE("get company applications handler tests") {
     SECTION("Should return applicant") {
         string message = get_company_applications_request().serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         custom_server s;
         companies_repository<database_transaction> companies_repo{};
         company_members_repository<database_transaction> company_members_repo{};
@@ -90,9 +90,9 @@ TEST_CASE("get company applications handler tests") {
     SECTION("Only sages and admins can retrieve applications") {
         string message = get_company_applications_request().serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         custom_server s;
         companies_repository<database_transaction> companies_repo{};
         company_members_repository<database_transaction> company_members_repo{};
@@ -21,7 +21,7 @@
 #include <message_handlers/company/get_company_listing_handler.h>
 #include <messages/company/get_company_listing_request.h>
 #include <messages/company/get_company_listing_response.h>
-#include <repositories/companies_repository.h>
+#include <game_logic/company_listing.h>
 #include <common_components.h>
 #include "../../custom_server.h"
 
@@ -30,13 +30,12 @@ using namespace ibh;
 
 TEST_CASE("get company listing handler tests") {
     SECTION("Should return company") {
-        string message = get_company_listing_request().serialize();
+        string message = get_company_listing_request(0, "").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         custom_server s;
-        companies_repository<database_transaction> companies_repo{};
         user_data.ws = 1;
         user_data.username = "test_user";
 
@@ -44,9 +43,10 @@ TEST_CASE("get company listing handler tests") {
         d.Parse(&message[0], message.size());
 
         auto transaction = db_pool->create_transaction();
-        db_company new_company{0, "test", 0, 2};
-        companies_repo.insert(new_company, transaction);
-        REQUIRE(new_company.id > 0);
+        db_company new_company{1, "test", 0, 2};
+        company_list.clear();
+        company_list.add_company(new_company.id, new_company.name, {});
+        company_list.add_member(new_company.id, 2, "member");
 
         handle_get_company_listing(&s, d, transaction, &user_data, &q, user_connections);
 
@@ -58,5 +58,8 @@ TEST_CASE("get company listing handler tests") {
         auto inserted_company = find_if(begin(new_msg->companies), end(new_msg->companies), [company_name = new_company.name](company_object const &c){ return c.name == company_name; });
         REQUIRE(inserted_company != end(new_msg->companies));
         REQUIRE(inserted_company->name == new_company.name);
+        REQUIRE(inserted_company->members.size() == 1);
+        REQUIRE(new_msg->version == company_list.version());
+        company_list.clear();
     }
 }
@@ -33,13 +33,13 @@
 using namespace std;
 using namespace ibh;
 
-template<class MsgT, class convertT, class ...Args>
-unique_ptr<queue_message> do_passthrough_test_for(Args... args) {
+template<class MsgT, class convertT, class HandlerMsgT = MsgT, class ...Args>
+convertT do_passthrough_test_for(Args... args) {
     string message = MsgT(args...).serialize();
     per_socket_data<custom_hdl> user_data;
-    moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-    queue_abstraction<unique_ptr<queue_message>> q(&cq);
-    ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+    moodycamel::ConcurrentQueue<queue_message> cq;
+    queue_abstraction<queue_message> q(&cq);
+    connection_registry<custom_hdl> user_connections;
     custom_server s;
     user_data.ws = 1;
     user_data.connection_id = 1;
@@ -49,69 +49,55 @@ unique_ptr<queue_message> do_passthrough_test_for(Args... args) {
     d.Parse(&message[0], message.size());
     auto transaction = db_pool->create_transaction();
 
-    playing_passthrough_handler<custom_server, custom_hdl, MsgT>(&s, d, transaction, &user_data, &q, user_connections);
+    playing_passthrough_handler<custom_server, custom_hdl, HandlerMsgT>(&s, d, transaction, &user_data, &q, user_connections);
 
-    unique_ptr<queue_message> msg(nullptr);
+    queue_message msg;
     REQUIRE(q.try_dequeue(msg));
-    REQUIRE(msg->connection_id == 1);
-    REQUIRE(msg->type == convertT::_type);
-    return msg;
+    auto *conv_msg = get_if<convertT>(&msg);
+    REQUIRE(conv_msg != nullptr);
+    REQUIRE(conv_msg->connection_id == 1);
+    REQUIRE(conv_msg->type == convertT::_type);
+    return *conv_msg;
 }
 
 TEST_CASE("playing passthrough handler tests") {
     SECTION("Should passthrough select_action_message") {
-        auto msg = do_passthrough_test_for<set_action_request, set_action_message>(1);
-        auto *conv_msg = dynamic_cast<set_action_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->action_id == 1);
+        auto conv_msg = do_passthrough_test_for<set_action_request, set_action_message, set_action_request_view>(1);
+        REQUIRE(conv_msg.action_id == 1);
     }
 
     SECTION("Should passthrough accept_application_request") {
-        auto msg = do_passthrough_test_for<accept_application_request, accept_application_message>(1);
-        auto *conv_msg = dynamic_cast<accept_application_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->applicant_id == 1);
+        auto conv_msg = do_passthrough_test_for<accept_application_request, accept_application_message>(1);
+        REQUIRE(conv_msg.applicant_id == 1);
     }
 
     SECTION("Should passthrough create_company_request") {
-        auto msg = do_passthrough_test_for<create_company_request, create_company_message>("name", 1);
-        auto *conv_msg = dynamic_cast<create_company_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->company_name == "name");
-        REQUIRE(conv_msg->company_type == 1);
+        auto conv_msg = do_passthrough_test_for<create_company_request, create_company_message>("name", 1);
+        REQUIRE(conv_msg.company_name == "name");
+        REQUIRE(conv_msg.company_type == 1);
     }
 
     SECTION("Should passthrough increase_bonus_request") {
-        auto msg = do_passthrough_test_for<increase_bonus_request, increase_bonus_message>(1);
-        auto *conv_msg = dynamic_cast<increase_bonus_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->bonus_type == 1);
+        auto conv_msg = do_passthrough_test_for<increase_bonus_request, increase_bonus_message>(1);
+        REQUIRE(conv_msg.bonus_type == 1);
     }
 
     SECTION("Should passthrough join_company_request") {
-        auto msg = do_passthrough_test_for<join_company_request, join_company_message>("name");
-        auto *conv_msg = dynamic_cast<join_company_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->company_name == "name");
+        auto conv_msg = do_passthrough_test_for<join_company_request, join_company_message>("name");
+        REQUIRE(conv_msg.company_name == "name");
     }
 
     SECTION("Should passthrough leave_company_request") {
-        auto msg = do_passthrough_test_for<leave_company_request, leave_company_message>();
-        auto *conv_msg = dynamic_cast<leave_company_message*>(msg.get());
-        REQUIRE(conv_msg);
+        do_passthrough_test_for<leave_company_request, leave_company_message>();
     }
 
     SECTION("Should passthrough reject_application_request") {
-        auto msg = do_passthrough_test_for<reject_application_request, reject_application_message>(1);
-        auto *conv_msg = dynamic_cast<reject_application_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->applicant_id == 1);
+        auto conv_msg = do_passthrough_test_for<reject_application_request, reject_application_message>(1);
+        REQUIRE(conv_msg.applicant_id == 1);
     }
 
     SECTION("Should passthrough set_tax_request") {
-        auto msg = do_passthrough_test_for<set_tax_request, set_tax_message>(1);
-        auto *conv_msg = dynamic_cast<set_tax_message*>(msg.get());
-        REQUIRE(conv_msg);
-        REQUIRE(conv_msg->tax_percentage == 1);
+        auto conv_msg = do_passthrough_test_for<set_tax_request, set_tax_message>(1);
+        REQUIRE(conv_msg.tax_percentage == 1);
     }
 }
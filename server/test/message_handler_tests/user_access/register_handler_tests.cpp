@@ -31,9 +31,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short usernames") {
         string message = register_request("a", "okay_password", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
@@ -52,9 +52,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short usernames utf8") {
         string message = register_request("漢", "okay_password", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
@@ -73,9 +73,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too long usernames") {
         string message = register_request("aalishdiquwhgebilugfhkjsdhasdasd", "okay_password", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
@@ -94,9 +94,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short password") {
         string message = register_request("ab", "shortpw", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
@@ -115,9 +115,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short password utf8") {
         string message = register_request("ab", "漢字漢字漢字", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
@@ -136,9 +136,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit password equal to username") {
         string message = register_request("okay_p$ssword", "okay_p$ssword", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
@@ -157,9 +157,9 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit password equal to email") {
         string message = register_request("ab", "an_email", "an_email").serialize();
         per_socket_data<custom_hdl> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> cq;
-        queue_abstraction<unique_ptr<queue_message>> q(&cq);
-        ibh_flat_map<uint64_t, per_socket_data<custom_hdl>> user_connections;
+        moodycamel::ConcurrentQueue<queue_message> cq;
+        queue_abstraction<queue_message> q(&cq);
+        connection_registry<custom_hdl> user_connections;
         auto transaction = db_pool->create_transaction();
         custom_server s;
         user_data.ws = 1;
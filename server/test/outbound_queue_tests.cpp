@@ -0,0 +1,152 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <outbound_queue.h>
+#include "custom_server.h"
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("outbound queue tests") {
+    outward_response const other = generic_error_response{"", "", "", false};
+
+    SECTION( "sends queued messages in order" ) {
+        custom_server s;
+        outbound_queue q{1024, 1024, slow_consumer_policy::drop};
+        q.push(other, make_shared<string const>("first"));
+        q.push(other, make_shared<string const>("second"));
+        REQUIRE(q.size() == 2);
+        REQUIRE(q.queued_bytes() == 11);
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(q.size() == 0);
+        REQUIRE(q.queued_bytes() == 0);
+        REQUIRE(s.sent_message == "second");
+    }
+
+    SECTION( "recognizes battle messages" ) {
+        outward_response battle_resp = battle_update_response{1, 1, 1, 1, 1, 1};
+        outward_response finished_resp = battle_finished_response{true, false, 1, 1};
+        REQUIRE(get_battle_message_type(battle_resp) == battle_update_response::type);
+        REQUIRE(get_battle_message_type(finished_resp) == battle_finished_response::type);
+        REQUIRE(get_battle_message_type(other) == 0);
+    }
+
+    SECTION( "merges battle updates into the pending one" ) {
+        custom_server s;
+        // only one message is sent per flush, as the slow consumer limit is hit right away
+        outbound_queue q{1024, 1, slow_consumer_policy::drop};
+        battle_update_response first{1, 1, 1, 0, 2, 0};
+        battle_update_response second{1, 1, 0, 1, 0, 5};
+        auto merged = battle_update_response{2, 2, 1, 1, 2, 5}.serialize();
+        q.push(first, make_shared<string const>(first.serialize()));
+        q.push(other, make_shared<string const>("other"));
+        q.push(second, make_shared<string const>(second.serialize()));
+        REQUIRE(q.size() == 2);
+        REQUIRE(q.queued_bytes() == merged.size() + 5);
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(s.sent_message == merged);
+        q.flush(&s, custom_hdl{});
+        REQUIRE(s.sent_message == "other");
+        REQUIRE(q.queued_bytes() == 0);
+    }
+
+    SECTION( "doesn't merge battle updates across the end of a battle" ) {
+        custom_server s;
+        outbound_queue q{1024, 1, slow_consumer_policy::drop};
+        battle_update_response first{1, 1, 1, 0, 2, 0};
+        battle_finished_response finished{true, false, 1, 1};
+        battle_update_response second{1, 1, 0, 1, 0, 5};
+        q.push(first, make_shared<string const>(first.serialize()));
+        q.push(finished, make_shared<string const>(finished.serialize()));
+        q.push(second, make_shared<string const>(second.serialize()));
+        REQUIRE(q.size() == 3);
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(s.sent_message == first.serialize());
+        q.flush(&s, custom_hdl{});
+        REQUIRE(s.sent_message == finished.serialize());
+        q.flush(&s, custom_hdl{});
+        REQUIRE(s.sent_message == second.serialize());
+    }
+
+    SECTION( "drops messages over byte budget" ) {
+        outbound_queue q{10, 1024, slow_consumer_policy::drop};
+        q.push(other, make_shared<string const>("0123456789"));
+        q.push(other, make_shared<string const>("a"));
+        REQUIRE(q.size() == 1);
+        REQUIRE(!q.should_disconnect());
+    }
+
+    SECTION( "holds back messages for slow consumer" ) {
+        custom_server s;
+        s.buffered_amount = 2048;
+        outbound_queue q{1024, 1024, slow_consumer_policy::drop};
+        q.push(other, make_shared<string const>("first"));
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(q.size() == 1);
+        REQUIRE(s.sent_message.empty());
+        REQUIRE(s.close_message.empty());
+
+        s.buffered_amount = 0;
+        q.flush(&s, custom_hdl{});
+        REQUIRE(q.size() == 0);
+        REQUIRE(s.sent_message == "first");
+    }
+
+    SECTION( "sends messages larger than the slow consumer limit when nothing is buffered" ) {
+        custom_server s;
+        outbound_queue q{1024, 8, slow_consumer_policy::drop};
+        q.push(other, make_shared<string const>("larger than eight bytes"));
+        q.push(other, make_shared<string const>("next"));
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(q.size() == 1);
+        REQUIRE(s.sent_message == "larger than eight bytes");
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(q.size() == 0);
+        REQUIRE(s.sent_message == "next");
+    }
+
+    SECTION( "disconnects slow consumer" ) {
+        custom_server s;
+        s.buffered_amount = 2048;
+        outbound_queue q{1024, 1024, slow_consumer_policy::disconnect};
+        q.push(other, make_shared<string const>("first"));
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(q.size() == 0);
+        REQUIRE(s.sent_message.empty());
+        REQUIRE(s.close_message == "slow consumer");
+    }
+
+    SECTION( "disconnects when over byte budget" ) {
+        custom_server s;
+        outbound_queue q{10, 1024, slow_consumer_policy::disconnect};
+        q.push(other, make_shared<string const>("0123456789"));
+        q.push(other, make_shared<string const>("a"));
+        REQUIRE(q.should_disconnect());
+
+        q.flush(&s, custom_hdl{});
+        REQUIRE(s.close_message == "slow consumer");
+    }
+}
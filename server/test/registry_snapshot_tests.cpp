@@ -0,0 +1,165 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <snapshot/registry_snapshot.h>
+#include <ecs/components.h>
+
+#ifndef EXCLUDE_PSQL_TESTS
+#include "test_helpers/startup_helper.h"
+#include <repositories/users_repository.h>
+#include <repositories/characters_repository.h>
+#include <repositories/companies_repository.h>
+#include <repositories/company_members_repository.h>
+#include <repositories/company_stats_repository.h>
+#endif
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("registry snapshot tests") {
+    entt::registry es;
+    auto entity = es.create();
+    ibh_flat_map<string, skill_component> skills;
+    skills.emplace("fishing", skill_component{"fishing", 3});
+    ibh_flat_map<uint32_t, item_component> equipped_items;
+    equipped_items.emplace(3, item_component{"helmet", "desc", "head", 1, 2, 3, 4, 5, true, false, {stat_component{1, 2}}});
+    es.emplace<pc_component>(entity, pc_component{1, 5, "name", "race", "dir", "class", "spawn", 10, 2, ibh_flat_map<uint32_t, int64_t>{{1, 100}, {2, -5}}, equipped_items,
+                                                  vector<item_component>{item_component{"sword", "", "hand", 0, 0, 0, 0, 0, false, true, {}}}, skills});
+    es.emplace<battle_component>(entity, "monster", 4, ibh_flat_map<uint32_t, int64_t>{{1, 50}});
+    es.emplace<company_component>(entity, company_component{7, 1, "company", ibh_flat_map<uint32_t, int64_t>{{9, 9}}});
+    es.emplace<ore_gathering_component>(entity);
+    auto entity2 = es.create();
+    es.emplace<pc_component>(entity2, pc_component{2, 0, "name2", "race", "", "class", "", 1, 0, {}, {}, {}, {}});
+    es.emplace<working_component>(entity2);
+
+    vector<char> buffer;
+    serialize_registry(es, buffer);
+
+    SECTION("round trip keeps components") {
+        entt::registry es2;
+        auto count = deserialize_registry(buffer.data(), buffer.size(), es2);
+        REQUIRE(count == 2);
+
+        auto pc_view = es2.view<pc_component>();
+        REQUIRE(pc_view.size() == 2);
+        for(auto e : pc_view) {
+            auto &pc = pc_view.get<pc_component>(e);
+            REQUIRE(pc.connection_id == 0);
+            if(pc.id == 2) {
+                REQUIRE(pc.name == "name2");
+                REQUIRE(es2.has<working_component>(e));
+                REQUIRE(!es2.has<battle_component>(e));
+                REQUIRE(!es2.has<company_component>(e));
+                continue;
+            }
+
+            REQUIRE(pc.name == "name");
+            REQUIRE(pc.spawn_message == "spawn");
+            REQUIRE(pc.level == 10);
+            REQUIRE(pc.stats[2] == -5);
+            REQUIRE(pc.equipped_items[3].name == "helmet");
+            REQUIRE(pc.equipped_items[3].binds);
+            REQUIRE(pc.equipped_items[3].stats.size() == 1);
+            REQUIRE(pc.inventory.size() == 1);
+            REQUIRE(pc.inventory[0].tells_bind);
+            REQUIRE(pc.skills["fishing"].level == 3);
+            REQUIRE(es2.has<ore_gathering_component>(e));
+            REQUIRE(!es2.has<wood_gathering_component>(e));
+            REQUIRE(!es2.has<working_component>(e));
+
+            auto &bc = es2.get<battle_component>(e);
+            REQUIRE(!bc.done);
+            REQUIRE(bc.monster_name == "monster");
+            REQUIRE(bc.monster_stats[1] == 50);
+
+            auto &cc = es2.get<company_component>(e);
+            REQUIRE(cc.id == 7);
+            REQUIRE(cc.name == "company");
+            REQUIRE(cc.stats[9] == 9);
+        }
+    }
+
+    SECTION("other versions are rejected") {
+        auto version = registry_snapshot_version + 1;
+        memcpy(buffer.data() + sizeof(registry_snapshot_magic), &version, sizeof(version));
+        entt::registry es2;
+        REQUIRE(!deserialize_registry(buffer.data(), buffer.size(), es2));
+    }
+
+    SECTION("truncated snapshots don't create entities") {
+        entt::registry es2;
+        REQUIRE(!deserialize_registry(buffer.data(), buffer.size() - 1, es2));
+        REQUIRE(es2.view<pc_component>().size() == 0);
+    }
+
+    SECTION("writer output can be loaded") {
+        auto path = (filesystem::temp_directory_path() / "ibh_registry_snapshot_test.bin").string();
+        {
+            registry_snapshot_writer writer(path);
+            writer.snapshot(es);
+        }
+
+        entt::registry es2;
+        REQUIRE(load_registry_snapshot(path, es2) == 2);
+        filesystem::remove(path);
+    }
+}
+
+#ifndef EXCLUDE_PSQL_TESTS
+TEST_CASE("registry snapshot reconcile tests") {
+    SECTION("company components are replaced by the database") {
+        auto transaction = db_pool->create_transaction();
+        db_user user{};
+        users_repository<database_transaction>{}.insert_if_not_exists(user, transaction);
+        REQUIRE(user.id > 0);
+        db_character player{0, user.id, 0, 0, 0, 0, 0, 0, 0, "player", "", "", "", vector<db_character_stat> {}, vector<db_item> {}};
+        db_character player2{0, user.id, 1, 0, 0, 0, 0, 0, 0, "player2", "", "", "", vector<db_character_stat> {}, vector<db_item> {}};
+        characters_repository<database_transaction> char_repo{};
+        char_repo.insert(player, transaction);
+        char_repo.insert(player2, transaction);
+        REQUIRE(player.id > 0);
+        REQUIRE(player2.id > 0);
+        db_company company{0, "company", 0, 2};
+        companies_repository<database_transaction>{}.insert(company, transaction);
+        REQUIRE(company.id > 0);
+        db_company_stat stat{0, company.id, 3, 30};
+        company_stats_repository<database_transaction>{}.insert(stat, transaction);
+        REQUIRE(company_members_repository<database_transaction>{}.insert(db_company_member{company.id, player2.id, 2, 0}, transaction));
+
+        entt::registry es;
+        auto left_entity = es.create();
+        es.emplace<pc_component>(left_entity, pc_component{player.id, 0, "player", "", "", "", "", 0, 0, {}, {}, {}, {}});
+        es.emplace<company_component>(left_entity, company_component{company.id, 1, "company", {}});
+        auto joined_entity = es.create();
+        es.emplace<pc_component>(joined_entity, pc_component{player2.id, 0, "player2", "", "", "", "", 0, 0, {}, {}, {}, {}});
+
+        reconcile_registry_snapshot(es, transaction);
+
+        REQUIRE(!es.has<company_component>(left_entity));
+        REQUIRE(es.has<company_component>(joined_entity));
+        auto &cc = es.get<company_component>(joined_entity);
+        REQUIRE(cc.id == company.id);
+        REQUIRE(cc.member_level == 2);
+        REQUIRE(cc.name == "company");
+        REQUIRE(cc.stats[3] == 30);
+    }
+}
+#endif
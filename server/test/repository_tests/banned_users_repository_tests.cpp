@@ -108,6 +108,29 @@ TEST_CASE("banned users repository tests") {
         REQUIRE(busr2);
         REQUIRE(busr2->id == busr.id);
     }
+
+    SECTION( "get active bans" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user usr{0, "user", "pass", "email", 0, "code", 0, 0};
+        user_repo.insert_if_not_exists(usr, transaction);
+        REQUIRE(usr.id != 0);
+
+        auto existing_bans = banned_user_repo.get_active(transaction);
+
+        db_banned_user active{0, "", usr, chrono::system_clock::now() + 200s};
+        db_banned_user expired{0, "ip", {}, chrono::system_clock::now() - 200s};
+        REQUIRE(banned_user_repo.insert_if_not_exists(active, transaction));
+        REQUIRE(banned_user_repo.insert_if_not_exists(expired, transaction));
+
+        auto bans = banned_user_repo.get_active(transaction);
+        REQUIRE(bans.size() == existing_bans.size() + 1);
+        auto ban = find_if(begin(bans), end(bans), [&active](db_banned_user const &b) { return b.id == active.id; });
+        REQUIRE(ban != end(bans));
+        REQUIRE(ban->_user);
+        REQUIRE(ban->_user->id == usr.id);
+        REQUIRE(ban->_user->username == "user");
+        REQUIRE(ban->until == active.until);
+    }
 }
 
 #endif
@@ -19,6 +19,7 @@
 #ifndef EXCLUDE_PSQL_TESTS
 
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include "../test_helpers/startup_helper.h"
 #include "repositories/character_stats_repository.h"
 #include "repositories/users_repository.h"
@@ -99,6 +100,50 @@ TEST_CASE("character stats repository tests") {
         REQUIRE(stats[1].stat_id == stat2.stat_id);
         REQUIRE(stats[1].value == stat2.value);
     }
+
+    SECTION( "get stats for multiple characters in a single query" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user usr{0, "test", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        db_character character2{0, usr.id, 8, 2, 3, 4, 5, 6, 7, "john doe2"s, "race", "class", "map", {}, {}};
+        characters_repo.insert(character, transaction);
+        characters_repo.insert(character2, transaction);
+
+        db_character_stat stat{0, character.id, 1, 10};
+        db_character_stat stat2{0, character2.id, 1, 20};
+        db_character_stat stat3{0, character2.id, 2, 30};
+        stat_repo.insert(stat, transaction);
+        stat_repo.insert(stat2, transaction);
+        stat_repo.insert(stat3, transaction);
+
+        auto queries_before = transaction->executed_queries();
+        vector<uint64_t> ids{character.id, character2.id};
+        auto stats = stat_repo.get_by_character_ids(ids, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+        REQUIRE(stats.size() == 3);
+        REQUIRE(count_if(begin(stats), end(stats), [&](db_character_stat const &s) { return s.character_id == character.id; }) == 1);
+        REQUIRE(count_if(begin(stats), end(stats), [&](db_character_stat const &s) { return s.character_id == character2.id; }) == 2);
+    }
+
+    SECTION( "insert many stats in a single query" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user usr{0, "test", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        characters_repo.insert(character, transaction);
+
+        vector<db_character_stat> stats{{0, character.id, 1, 10}, {0, character.id, 2, -20}, {0, character.id, 3001, 30}};
+        auto queries_before = transaction->executed_queries();
+        stat_repo.insert_many(stats, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+
+        auto stats2 = stat_repo.get_by_character_id(character.id, transaction);
+        REQUIRE(stats2.size() == 3);
+        for(auto const &stat : stats) {
+            REQUIRE(count_if(begin(stats2), end(stats2), [&](db_character_stat const &s) { return s.stat_id == stat.stat_id && s.value == stat.value; }) == 1);
+        }
+    }
 }
 
 #endif
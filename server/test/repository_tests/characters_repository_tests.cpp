@@ -19,10 +19,14 @@
 #ifndef EXCLUDE_PSQL_TESTS
 
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include <spdlog/spdlog.h>
 #include "../test_helpers/startup_helper.h"
 #include "repositories/users_repository.h"
 #include "repositories/characters_repository.h"
+#include "repositories/character_stats_repository.h"
+#include "repositories/companies_repository.h"
+#include "repositories/company_members_repository.h"
 
 using namespace std;
 using namespace ibh;
@@ -180,6 +184,64 @@ TEST_CASE("characters repository tests") {
         REQUIRE(characters[0].stats.empty());
     }
 
+    SECTION( "all ids retrieved" ) {
+        db_user usr{0, "user", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        db_character character2{0, usr.id, 8, 9, 10, 11, 12, 13, 14, "john doe2"s, "race2", "class2", "map2", {}, {}};
+        characters_repo.insert_or_update_character(character, transaction);
+        characters_repo.insert_or_update_character(character2, transaction);
+
+        auto ids = characters_repo.get_all_ids(transaction);
+        REQUIRE(find(begin(ids), end(ids), character.id) != end(ids));
+        REQUIRE(find(begin(ids), end(ids), character2.id) != end(ids));
+    }
+
+    SECTION( "character summaries retrieved with stats and company" ) {
+        character_stats_repository<database_transaction> stats_repo{};
+        companies_repository<database_transaction> companies_repo{};
+        company_members_repository<database_transaction> members_repo{};
+        db_user usr{0, "user", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        db_character character2{0, usr.id, 8, 9, 10, 11, 12, 13, 14, "john doe2"s, "race2", "class2", "map2", {}, {}};
+        characters_repo.insert_or_update_character(character, transaction);
+        characters_repo.insert_or_update_character(character2, transaction);
+
+        db_character_stat stat{0, character.id, 2, 20};
+        db_character_stat stat2{0, character.id, 1, 10};
+        stats_repo.insert(stat, transaction);
+        stats_repo.insert(stat2, transaction);
+
+        // membership points at the second company, so looking it up by character id would find the wrong one
+        db_company other_company{0, "other company", 0, 2};
+        db_company company{0, "company", 0, 2};
+        companies_repo.insert(other_company, transaction);
+        companies_repo.insert(company, transaction);
+        members_repo.insert(db_company_member{company.id, character.id, 1, 0}, transaction);
+
+        auto summaries = characters_repo.get_summaries_by_user_id(usr.id, transaction);
+        REQUIRE(summaries.size() == 2);
+        sort(begin(summaries), end(summaries), [](db_character_summary const &a, db_character_summary const &b) { return a.character.slot < b.character.slot; });
+
+        REQUIRE(summaries[0].character.id == character.id);
+        REQUIRE(summaries[0].character.level == character.level);
+        REQUIRE(summaries[0].character.name == character.name);
+        REQUIRE(summaries[0].company_name == "company");
+        REQUIRE(summaries[0].character.stats.size() == 2);
+        REQUIRE(summaries[0].character.stats[0].stat_id == 1);
+        REQUIRE(summaries[0].character.stats[0].value == 10);
+        REQUIRE(summaries[0].character.stats[1].stat_id == 2);
+        REQUIRE(summaries[0].character.stats[1].value == 20);
+
+        REQUIRE(summaries[1].character.id == character2.id);
+        REQUIRE(summaries[1].character.map == character2.map);
+        REQUIRE(summaries[1].company_name.empty());
+        REQUIRE(summaries[1].character.stats.empty());
+    }
+
     SECTION( "Get character by slot" ) {
         db_user usr{0, "user", "pass", "email", 0, "code", 0, 0};
         users_repo.insert_if_not_exists(usr, transaction);
@@ -288,6 +350,32 @@ TEST_CASE("characters repository tests") {
         REQUIRE(character_by_slot->_class == character2._class);
         REQUIRE(character_by_slot->map == character2.map);
     }
+
+    SECTION( "get characters by ids in a single query" ) {
+        db_user usr{0, "user", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        db_character character2{0, usr.id, 8, 9, 10, 11, 12, 13, 14, "john doe2"s, "race2", "class2", "map2", {}, {}};
+        db_character character3{0, usr.id, 15, 16, 17, 18, 19, 20, 21, "john doe3"s, "race3", "class3", "map3", {}, {}};
+        characters_repo.insert(character, transaction);
+        characters_repo.insert(character2, transaction);
+        characters_repo.insert(character3, transaction);
+
+        auto queries_before = transaction->executed_queries();
+        vector<uint64_t> ids{character.id, character3.id};
+        auto characters = characters_repo.get_characters(ids, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+        REQUIRE(characters.size() == 2);
+        sort(begin(characters), end(characters), [](db_character const &a, db_character const &b) { return a.id < b.id; });
+        REQUIRE(characters[0].id == character.id);
+        REQUIRE(characters[0].name == character.name);
+        REQUIRE(characters[1].id == character3.id);
+        REQUIRE(characters[1].name == character3.name);
+
+        REQUIRE(characters_repo.get_characters({}, transaction).empty());
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+    }
 }
 
 #endif
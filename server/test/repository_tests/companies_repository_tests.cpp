@@ -19,8 +19,13 @@
 #ifndef EXCLUDE_PSQL_TESTS
 
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include "../test_helpers/startup_helper.h"
 #include "repositories/companies_repository.h"
+#include "repositories/company_members_repository.h"
+#include "repositories/company_stats_repository.h"
+#include "repositories/users_repository.h"
+#include "repositories/characters_repository.h"
 
 using namespace std;
 using namespace ibh;
@@ -80,6 +85,47 @@ TEST_CASE("companies repository tests") {
         auto companies = companies_repo.get_all(transaction);
         REQUIRE(companies.size() == companies_existing.size() + 1);
     }
+
+    SECTION( "get listing with members and stats" ) {
+        users_repository<database_transaction> users_repo{};
+        characters_repository<database_transaction> characters_repo{};
+        company_members_repository<database_transaction> members_repo{};
+        company_stats_repository<database_transaction> stats_repo{};
+        auto transaction = db_pool->create_transaction();
+
+        db_user usr{0, "user", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        characters_repo.insert_or_update_character(character, transaction);
+
+        db_company company{0, "company", 0, 2};
+        db_company empty_company{0, "empty company", 0, 2};
+        companies_repo.insert(company, transaction);
+        companies_repo.insert(empty_company, transaction);
+        members_repo.insert(db_company_member{company.id, character.id, 1, 0}, transaction);
+        db_company_stat stat{0, company.id, 2, 20};
+        db_company_stat stat2{0, company.id, 1, 10};
+        stats_repo.insert(stat, transaction);
+        stats_repo.insert(stat2, transaction);
+
+        auto listing = companies_repo.get_listing(transaction);
+        auto listed = find_if(begin(listing), end(listing), [&](db_company_listing const &c) { return c.company.id == company.id; });
+        REQUIRE(listed != end(listing));
+        REQUIRE(listed->company.name == company.name);
+        REQUIRE(listed->member_ids.size() == 1);
+        REQUIRE(listed->member_ids[0] == character.id);
+        REQUIRE(listed->member_names[0] == character.name);
+        REQUIRE(listed->stats.size() == 2);
+        REQUIRE(listed->stats[0].stat_id == 1);
+        REQUIRE(listed->stats[0].value == 10);
+        REQUIRE(listed->stats[1].stat_id == 2);
+        REQUIRE(listed->stats[1].value == 20);
+
+        auto listed_empty = find_if(begin(listing), end(listing), [&](db_company_listing const &c) { return c.company.id == empty_company.id; });
+        REQUIRE(listed_empty != end(listing));
+        REQUIRE(listed_empty->member_ids.empty());
+        REQUIRE(listed_empty->stats.empty());
+    }
 }
 
 #endif
@@ -123,6 +123,54 @@ TEST_CASE("company member applications repository tests") {
         REQUIRE(members[1].member_level == 0);
     }
 
+    SECTION( "pipelined lookups return the same as direct ones" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user user{};
+        user_repo.insert_if_not_exists(user, transaction);
+        REQUIRE(user.id > 0);
+        db_character player{0, user.id, 0, 0, 0, 0, 0, 0, 0, "", "", "", "", vector<db_character_stat> {}, vector<db_item> {}};
+        char_repo.insert(player, transaction);
+        REQUIRE(player.id > 0);
+        db_company company{0, "company", 0, 2};
+        company_repo.insert(company, transaction);
+        REQUIRE(company.id > 0);
+        db_company_member member{company.id, player.id, 1, 0};
+        REQUIRE(member_repo.insert(member, transaction) == true);
+
+        optional<db_company> company2;
+        optional<db_company_member> member2;
+        optional<db_company_member> missing_member;
+        vector<db_company_member> members;
+        auto queries_before = transaction->executed_queries();
+        {
+            auto pipeline = transaction->create_pipeline();
+            auto company_result = company_repo.get_async(company.id, *pipeline);
+            auto member_result = member_repo.get_async(company.id, player.id, *pipeline);
+            auto missing_member_result = member_repo.get_async(company.id, player.id + 1, *pipeline);
+            auto members_result = member_repo.get_by_company_id_async(company.id, *pipeline);
+            REQUIRE(pipeline->inserted_queries() == 4);
+
+            // retrieving out of order is fine
+            members = members_result.get();
+            company2 = company_result.get();
+            missing_member = missing_member_result.get();
+            member2 = member_result.get();
+            REQUIRE_THROWS(member_result.get());
+        }
+        REQUIRE(transaction->executed_queries() == queries_before + 4);
+
+        REQUIRE(company2);
+        REQUIRE(company2->name == company.name);
+        REQUIRE(member2);
+        REQUIRE(member2->character_id == player.id);
+        REQUIRE(!missing_member);
+        REQUIRE(members.size() == 1);
+        REQUIRE(members[0].character_id == player.id);
+
+        // the transaction is usable again once the pipeline is gone
+        REQUIRE(member_repo.get_by_company_id(company.id, transaction).size() == 1);
+    }
+
     SECTION( "get all character member applications by char id" ) {
         auto transaction = db_pool->create_transaction();
         db_user user{};
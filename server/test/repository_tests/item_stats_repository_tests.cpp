@@ -19,6 +19,7 @@
 #ifndef EXCLUDE_PSQL_TESTS
 
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include "../test_helpers/startup_helper.h"
 #include "repositories/item_stats_repository.h"
 #include "repositories/items_repository.h"
@@ -113,6 +114,33 @@ TEST_CASE("item stats repository tests") {
         REQUIRE(stats[1].stat_id == stat2.stat_id);
         REQUIRE(stats[1].value == stat2.value);
     }
+
+    SECTION( "get stats for multiple items in a single query" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user u{};
+        user_repo.insert_if_not_exists(u, transaction);
+        db_character c{};
+        c.user_id = u.id;
+        char_repo.insert(c, transaction);
+        db_item item{0, c.id, "item", "slot", "equip"};
+        db_item item2{0, c.id, "item2", "slot", "equip"};
+        items_repo.insert(item, transaction);
+        items_repo.insert(item2, transaction);
+        db_item_stat stat{0, item.id, 121, 2};
+        db_item_stat stat2{0, item2.id, 121, 3};
+        db_item_stat stat3{0, item2.id, 122, 4};
+        stat_repo.insert(stat, transaction);
+        stat_repo.insert(stat2, transaction);
+        stat_repo.insert(stat3, transaction);
+
+        auto queries_before = transaction->executed_queries();
+        vector<uint64_t> ids{item.id, item2.id};
+        auto stats = stat_repo.get_by_item_ids(ids, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+        REQUIRE(stats.size() == 3);
+        REQUIRE(stats[0].item_id == item.id);
+        REQUIRE(count_if(begin(stats), end(stats), [&](db_item_stat const &s) { return s.item_id == item2.id; }) == 2);
+    }
 }
 
 #endif
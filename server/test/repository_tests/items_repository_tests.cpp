@@ -19,6 +19,7 @@
 #ifndef EXCLUDE_PSQL_TESTS
 
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include "../test_helpers/startup_helper.h"
 #include "repositories/items_repository.h"
 #include "repositories/characters_repository.h"
@@ -145,6 +146,33 @@ TEST_CASE("items repository tests") {
         auto items = items_repo.get_by_character_id(c.id, transaction);
         REQUIRE(items.size() == 2);
     }
+
+    SECTION( "get items for multiple characters in a single query" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user u{};
+        user_repo.insert_if_not_exists(u, transaction);
+        db_character c{};
+        c.user_id = u.id;
+        c.slot = 0;
+        db_character c2{};
+        c2.user_id = u.id;
+        c2.slot = 1;
+        char_repo.insert(c, transaction);
+        char_repo.insert(c2, transaction);
+        db_item item{0, c.id, "item", "slot", "equip"};
+        db_item item2{0, c2.id, "item2", "slot", "equip"};
+        db_item item3{0, c2.id, "item3", "slot", "equip"};
+        items_repo.insert(item, transaction);
+        items_repo.insert(item2, transaction);
+        items_repo.insert(item3, transaction);
+
+        auto queries_before = transaction->executed_queries();
+        vector<uint64_t> ids{c.id, c2.id};
+        auto items = items_repo.get_by_character_ids(ids, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+        REQUIRE(items.size() == 3);
+        REQUIRE(count_if(begin(items), end(items), [&](db_item const &i) { return i.character_id == c2.id; }) == 2);
+    }
 }
 
 #endif
@@ -0,0 +1,104 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef EXCLUDE_PSQL_TESTS
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include "../test_helpers/startup_helper.h"
+#include "repositories/packed_character_stats_repository.h"
+#include "repositories/users_repository.h"
+#include "repositories/characters_repository.h"
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("packed character stats repository tests") {
+    packed_character_stats_repository<database_transaction> stat_repo{};
+    users_repository<database_transaction> users_repo{};
+    characters_repository<database_transaction> characters_repo{};
+
+    SECTION( "saves and loads all stats of a character" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user usr{0, "test", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+        REQUIRE(usr.id > 0);
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        characters_repo.insert(character, transaction);
+        REQUIRE(character.id > 0);
+
+        vector<db_character_stat> stats{{0, character.id, 1, 10}, {0, character.id, 2, -20}, {0, character.id, 3001, 30}};
+        auto queries_before = transaction->executed_queries();
+        stat_repo.save(stats, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+
+        auto stats2 = stat_repo.get_by_character_id(character.id, transaction);
+        REQUIRE(stats2.size() == 3);
+        for(size_t i = 0; i < stats.size(); i++) {
+            REQUIRE(stats2[i].id == 0);
+            REQUIRE(stats2[i].character_id == character.id);
+            REQUIRE(stats2[i].stat_id == stats[i].stat_id);
+            REQUIRE(stats2[i].value == stats[i].value);
+        }
+    }
+
+    SECTION( "saving replaces existing stats" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user usr{0, "test", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        characters_repo.insert(character, transaction);
+
+        vector<db_character_stat> stats{{0, character.id, 1, 10}, {0, character.id, 2, 20}};
+        stat_repo.save(stats, transaction);
+        vector<db_character_stat> new_stats{{0, character.id, 1, 15}};
+        stat_repo.save(new_stats, transaction);
+
+        auto stats2 = stat_repo.get_by_character_id(character.id, transaction);
+        REQUIRE(stats2.size() == 1);
+        REQUIRE(stats2[0].stat_id == 1);
+        REQUIRE(stats2[0].value == 15);
+
+        stat_repo.remove(character.id, transaction);
+        REQUIRE(stat_repo.get_by_character_id(character.id, transaction).empty());
+    }
+
+    SECTION( "saves and loads multiple characters in a single query" ) {
+        auto transaction = db_pool->create_transaction();
+        db_user usr{0, "test", "pass", "email", 0, "code", 0, 0};
+        users_repo.insert_if_not_exists(usr, transaction);
+        db_character character{0, usr.id, 1, 2, 3, 4, 5, 6, 7, "john doe"s, "race", "class", "map", {}, {}};
+        db_character character2{0, usr.id, 8, 2, 3, 4, 5, 6, 7, "john doe2"s, "race", "class", "map", {}, {}};
+        characters_repo.insert(character, transaction);
+        characters_repo.insert(character2, transaction);
+
+        vector<db_character_stat> stats{{0, character2.id, 1, 20}, {0, character.id, 1, 10}, {0, character2.id, 2, 30}};
+        auto queries_before = transaction->executed_queries();
+        stat_repo.save(stats, transaction);
+        vector<uint64_t> ids{character.id, character2.id};
+        auto stats2 = stat_repo.get_by_character_ids(ids, transaction);
+        REQUIRE(transaction->executed_queries() == queries_before + 2);
+        REQUIRE(stats2.size() == 3);
+        REQUIRE(is_sorted(begin(stats2), end(stats2), [](db_character_stat const &a, db_character_stat const &b) { return a.character_id < b.character_id; }));
+        REQUIRE(count_if(begin(stats2), end(stats2), [&](db_character_stat const &s) { return s.character_id == character.id; }) == 1);
+        REQUIRE(count_if(begin(stats2), end(stats2), [&](db_character_stat const &s) { return s.character_id == character2.id; }) == 2);
+    }
+}
+
+#endif
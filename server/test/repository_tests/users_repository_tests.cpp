@@ -22,6 +22,7 @@
 #include "../test_helpers/startup_helper.h"
 #include "repositories/users_repository.h"
 #include "repositories/banned_users_repository.h"
+#include "repositories/user_cache.h"
 
 using namespace std;
 using namespace ibh;
@@ -77,6 +78,64 @@ TEST_CASE("users repository tests") {
         REQUIRE(usr2->max_characters == usr.max_characters);
     }
 
+    SECTION( "copy users and log queries" ) {
+        auto transaction = db_pool->create_transaction();
+        {
+            auto stream = transaction->create_copy_stream("users", {"username", "password", "email"});
+            *stream << make_tuple("copied_user"s, "pass"s, "email"s);
+            stream->complete();
+        }
+
+        vector<string> queries;
+        transaction->set_query_log(&queries);
+        auto usr = user_repo.get("copied_user", transaction);
+        transaction->set_query_log(nullptr);
+        REQUIRE(usr);
+        REQUIRE(usr->email == "email");
+        REQUIRE(queries.size() == 1);
+
+        (void)user_repo.get("copied_user", transaction);
+        REQUIRE(queries.size() == 1);
+    }
+
+    SECTION( "subtransaction queries count towards the transaction" ) {
+        users_repository<database_subtransaction> sub_user_repo{};
+        auto transaction = db_pool->create_transaction();
+        auto queries_before = transaction->executed_queries();
+        vector<string> queries;
+        transaction->set_query_log(&queries);
+        {
+            auto subtransaction = transaction->create_subtransaction();
+            (void)sub_user_repo.get("missing_user", subtransaction);
+            subtransaction->commit();
+        }
+        transaction->set_query_log(nullptr);
+        REQUIRE(transaction->executed_queries() == queries_before + 1);
+        REQUIRE(queries.size() == 1);
+    }
+
+    SECTION( "insert invalidates cached user once committed" ) {
+        db_user usr{0, "cached_user", "pass", "email", 0, "code", 0, 0};
+        {
+            auto transaction = db_pool->create_transaction();
+            auto load = [&] { return user_repo.get("cached_user", transaction); };
+            REQUIRE(!cached_users.get_or_load("cached_user", load));
+
+            user_repo.insert_if_not_exists(usr, transaction);
+            REQUIRE(usr.id != 0);
+            REQUIRE(!cached_users.get_or_load("cached_user", load));
+            transaction->commit();
+        }
+
+        auto transaction = db_pool->create_transaction();
+        auto usr2 = cached_users.get_or_load("cached_user", [&] { return user_repo.get("cached_user", transaction); });
+        REQUIRE(usr2);
+        REQUIRE(usr2->id == usr.id);
+        transaction->execute("DELETE FROM users WHERE id = " + to_string(usr.id));
+        transaction->commit();
+        cached_users.clear();
+    }
+
     SECTION( "get all users" ) {
         auto transaction = db_pool->create_transaction();
         auto existing_usrs = user_repo.get_all(transaction);
@@ -0,0 +1,96 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <tick_scheduler.h>
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("tick scheduler tests") {
+    auto start = tick_scheduler::clock::time_point{};
+    auto ms = [](uint32_t n) { return chrono::milliseconds(n); };
+
+    SECTION( "parses overrun policies" ) {
+        REQUIRE(parse_tick_overrun_policy("catch_up") == tick_overrun_policy::catch_up);
+        REQUIRE(parse_tick_overrun_policy("skip") == tick_overrun_policy::skip);
+        REQUIRE(!parse_tick_overrun_policy("wait"));
+    }
+
+    SECTION( "keeps a fixed timestep when ticks fit in budget" ) {
+        tick_scheduler s{ms(100), tick_overrun_policy::catch_up, 5, 1, start};
+        REQUIRE(s.next_tick() == start + ms(100));
+
+        s.start_tick(start + ms(100));
+        s.end_tick(start + ms(130));
+        REQUIRE(s.next_tick() == start + ms(200));
+        REQUIRE(s.stats().ticks == 1);
+        REQUIRE(s.stats().overruns == 0);
+        REQUIRE(s.stats().max_tick_us == 30'000);
+    }
+
+    SECTION( "catch up runs late ticks back to back" ) {
+        tick_scheduler s{ms(100), tick_overrun_policy::catch_up, 5, 1, start};
+        s.start_tick(start + ms(100));
+        s.end_tick(start + ms(350));
+        REQUIRE(s.stats().overruns == 1);
+        REQUIRE(s.stats().skipped_ticks == 0);
+        REQUIRE(s.next_tick() == start + ms(200));
+    }
+
+    SECTION( "catch up drops ticks beyond the limit" ) {
+        tick_scheduler s{ms(100), tick_overrun_policy::catch_up, 2, 1, start};
+        s.start_tick(start + ms(100));
+        s.end_tick(start + ms(650));
+        // ticks at 200, 300, 400, 500 and 600 are late, only the last two are kept
+        REQUIRE(s.stats().skipped_ticks == 3);
+        REQUIRE(s.next_tick() == start + ms(500));
+    }
+
+    SECTION( "skip continues at the next tick boundary" ) {
+        tick_scheduler s{ms(100), tick_overrun_policy::skip, 5, 1, start};
+        s.start_tick(start + ms(100));
+        s.end_tick(start + ms(350));
+        REQUIRE(s.stats().skipped_ticks == 2);
+        REQUIRE(s.next_tick() == start + ms(400));
+    }
+
+    SECTION( "stretches systems under sustained overload and recovers" ) {
+        tick_scheduler s{ms(100), tick_overrun_policy::skip, 5, 3, start};
+        auto now = start;
+        auto run_tick = [&](uint32_t duration) {
+            now = s.next_tick();
+            s.start_tick(now);
+            now += ms(duration);
+            s.end_tick(now);
+        };
+
+        for(uint32_t i = 0; i < tick_scheduler::overloaded_after_ticks * 5; i++) {
+            run_tick(150);
+        }
+        REQUIRE(s.system_stretch() == 3);
+
+        for(uint32_t i = 0; i < tick_scheduler::recovered_after_ticks; i++) {
+            run_tick(10);
+        }
+        REQUIRE(s.system_stretch() == 2);
+
+        s.reset_stats();
+        REQUIRE(s.stats().ticks == 0);
+    }
+}
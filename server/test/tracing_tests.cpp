@@ -0,0 +1,75 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <tracing.h>
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("tracing tests") {
+    SECTION( "spans are recorded in the calling thread's ring" ) {
+        auto &ring = thread_trace_ring();
+        auto head = ring.head.load();
+        {
+            IBH_TRACE_SCOPE(tick, "test_span");
+        }
+        REQUIRE(ring.head.load() == head + 1);
+        auto &event = ring.events[head % trace_ring::ring_capacity];
+        REQUIRE(string(event.name.load()) == "test_span");
+        REQUIRE(event.category.load() == static_cast<uint32_t>(trace_category::tick));
+    }
+
+    SECTION( "threads get their own ring" ) {
+        trace_ring *other_ring = nullptr;
+        thread t([&other_ring] {
+            IBH_TRACE_SCOPE(systems, "worker_span");
+            other_ring = &thread_trace_ring();
+        });
+        t.join();
+        REQUIRE(other_ring != &thread_trace_ring());
+        REQUIRE(other_ring->thread_id != thread_trace_ring().thread_id);
+    }
+
+    SECTION( "ring overwrites the oldest events" ) {
+        trace_ring ring{1};
+        for(uint64_t i = 0; i < trace_ring::ring_capacity + 1; i++) {
+            ring.push("span", trace_category::tick, i, 1);
+        }
+        REQUIRE(ring.events[0].start_ns.load() == trace_ring::ring_capacity);
+        REQUIRE(ring.events[1].start_ns.load() == 1);
+    }
+
+    SECTION( "dumps chrome trace json" ) {
+        {
+            IBH_TRACE_SCOPE(database, "dumped_span");
+        }
+        auto path = filesystem::temp_directory_path() / "ibh_trace_test.json";
+        REQUIRE(dump_chrome_trace(path.string()));
+
+        ifstream file(path);
+        stringstream contents;
+        contents << file.rdbuf();
+        REQUIRE(contents.str().find(R"("name":"dumped_span","cat":"database","ph":"X")") != string::npos);
+        filesystem::remove(path);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+    IdleBossHunter
+    Copyright (C) 2020 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include "repositories/user_cache.h"
+
+using namespace std;
+using namespace ibh;
+
+TEST_CASE("user cache tests") {
+    auto now = chrono::steady_clock::now();
+    uint32_t loads = 0;
+    auto load_user = [&loads](string name) {
+        return [&loads, name = move(name)]() -> optional<db_user> {
+            loads++;
+            return db_user{1, name, "pass", "email", 0, "code", 0, 0};
+        };
+    };
+    auto load_nobody = [&loads]() -> optional<db_user> {
+        loads++;
+        return {};
+    };
+
+    SECTION( "caches users case insensitively" ) {
+        user_cache cache{100, 60s, 10s};
+        auto usr = cache.get_or_load("User", load_user("User"), now);
+        REQUIRE(usr);
+        REQUIRE(usr->username == "User");
+
+        auto usr2 = cache.get_or_load("USER", load_user("User"), now);
+        REQUIRE(usr2);
+        REQUIRE(usr2->id == usr->id);
+        REQUIRE(loads == 1);
+        REQUIRE(cache.counters().misses == 1);
+        REQUIRE(cache.counters().hits == 1);
+        REQUIRE(cache.size() == 1);
+
+        (void)cache.get_or_load("user", load_user("User"), now + 61s);
+        REQUIRE(loads == 2);
+    }
+
+    SECTION( "caches unknown users for a shorter time" ) {
+        user_cache cache{100, 60s, 10s};
+        REQUIRE(!cache.get_or_load("nobody", load_nobody, now));
+        REQUIRE(!cache.get_or_load("nobody", load_nobody, now + 5s));
+        REQUIRE(loads == 1);
+        REQUIRE(cache.counters().negative_hits == 1);
+
+        REQUIRE(!cache.get_or_load("nobody", load_nobody, now + 11s));
+        REQUIRE(loads == 2);
+    }
+
+    SECTION( "invalidate drops the entry" ) {
+        user_cache cache{100, 60s, 10s};
+        REQUIRE(!cache.get_or_load("user", load_nobody, now));
+        cache.invalidate("USER");
+        REQUIRE(cache.get_or_load("user", load_user("user"), now));
+        REQUIRE(loads == 2);
+
+        // other spellings of non-ascii names can't be found, so everything goes
+        (void)cache.get_or_load("other", load_user("other"), now);
+        cache.invalidate("Élan");
+        REQUIRE(cache.size() == 0);
+    }
+
+    SECTION( "doesn't cache a load that raced with an invalidation" ) {
+        user_cache cache{100, 60s, 10s};
+        REQUIRE(!cache.get_or_load("user", [&]() -> optional<db_user> {
+            cache.invalidate("user");
+            return {};
+        }, now));
+        REQUIRE(cache.size() == 0);
+    }
+
+    SECTION( "evicts the least recently used user" ) {
+        user_cache cache{user_cache::shard_count, 60s, 10s};
+        // with one entry per shard, a full shard evicts on every new user that lands in it
+        for(uint32_t i = 0; i < 1'000; i++) {
+            (void)cache.get_or_load("user" + to_string(i), load_user("user" + to_string(i)), now);
+        }
+        REQUIRE(cache.size() <= user_cache::shard_count);
+        REQUIRE(cache.counters().evictions == 1'000 - cache.size());
+    }
+
+    SECTION( "capacity of 0 disables caching" ) {
+        user_cache cache{0, 60s, 10s};
+        (void)cache.get_or_load("user", load_user("user"), now);
+        (void)cache.get_or_load("user", load_user("user"), now);
+        REQUIRE(loads == 2);
+        REQUIRE(cache.size() == 0);
+    }
+}